@@ -26,6 +26,8 @@
 #include "omega_edit/search.h"
 #include "omega_edit/segment.h"
 #include "omega_edit/session.h"
+#include "omega_edit/snapshot.h"
+#include "omega_edit/transform.h"
 #include "omega_edit/version.h"
 #include "omega_edit/viewport.h"
 #include "omega_edit/visit.h"
@@ -70,7 +70,9 @@ char omega_change_get_kind_as_char(const omega_change_t *change_ptr);
 int omega_change_get_transaction_bit(const omega_change_t *change_ptr);
 
 /**
- * Given a change, return a pointer to the byte data
+ * Given a change, return a pointer to the byte data.  If the change payload is compressed (see
+ * omega_session_set_payload_compression_threshold) or a fill, it is decoded into a copy that lives as long as the
+ * change, and the payload itself is left as is, so this is safe to call while snapshots are read on other threads.
  * @param change_ptr change to get the bytes data from
  * @return pointer to the byte data
  */
@@ -47,6 +47,61 @@
 #define OMEGA_VIEWPORT_CAPACITY_LIMIT (1024 * 1024)
 #endif//OMEGA_VIEWPORT_CAPACITY_LIMIT
 
+#ifndef OMEGA_PAGED_VIEWPORT_CAPACITY_LIMIT
+/** Default maximum paged viewport capacity */
+#define OMEGA_PAGED_VIEWPORT_CAPACITY_LIMIT (1024 * 1024 * 1024)
+#endif//OMEGA_PAGED_VIEWPORT_CAPACITY_LIMIT
+
+#ifndef OMEGA_VIEWPORT_PAGE_SIZE
+/** Default page size for paged viewports */
+#define OMEGA_VIEWPORT_PAGE_SIZE (64 * 1024)
+#endif//OMEGA_VIEWPORT_PAGE_SIZE
+
+#ifndef OMEGA_SUMMARY_BLOCK_SIZE
+/** Size of the file blocks summarized by the block summary index */
+#define OMEGA_SUMMARY_BLOCK_SIZE (64 * 1024)
+#endif//OMEGA_SUMMARY_BLOCK_SIZE
+
+#ifndef OMEGA_TRANSFORM_CHANGE_LENGTH_LIMIT
+/** Maximum length of a range that is transformed into an overwrite change instead of rewriting a checkpoint file */
+#define OMEGA_TRANSFORM_CHANGE_LENGTH_LIMIT (64 * 1024 * 1024)
+#endif//OMEGA_TRANSFORM_CHANGE_LENGTH_LIMIT
+
+#ifndef OMEGA_SHIFT_BITS_BLOCK_SIZE
+/** Size of the blocks a range is streamed through when its bits are shifted */
+#define OMEGA_SHIFT_BITS_BLOCK_SIZE (1024 * 1024)
+#endif//OMEGA_SHIFT_BITS_BLOCK_SIZE
+
+#ifndef OMEGA_COMPRESSION_BLOCK_SIZE
+/** Number of bytes in each independently compressed block of a compressed change payload (at most 64 KiB) */
+#define OMEGA_COMPRESSION_BLOCK_SIZE (INT64_C(64) * 1024)
+#endif//OMEGA_COMPRESSION_BLOCK_SIZE
+
+#ifndef OMEGA_COMPRESSION_STREAM_SIZE
+/** Number of bytes produced at a time when a change payload is compressed as it is produced */
+#define OMEGA_COMPRESSION_STREAM_SIZE (16 * OMEGA_COMPRESSION_BLOCK_SIZE)
+#endif//OMEGA_COMPRESSION_STREAM_SIZE
+
+#ifndef OMEGA_PAYLOAD_STORE_EXTENT_SIZE
+/** Number of bytes of the payload store file mapped at a time (a multiple of 64 KiB) */
+#define OMEGA_PAYLOAD_STORE_EXTENT_SIZE (INT64_C(64) * 1024 * 1024)
+#endif//OMEGA_PAYLOAD_STORE_EXTENT_SIZE
+
+#ifndef OMEGA_COALESCE_CHANGE_LENGTH_LIMIT
+/** Maximum length of the payload of a change that new contiguous changes are coalesced into */
+#define OMEGA_COALESCE_CHANGE_LENGTH_LIMIT (64 * 1024)
+#endif//OMEGA_COALESCE_CHANGE_LENGTH_LIMIT
+
+#ifndef OMEGA_BINARY_CONTROL_BYTE_PERCENT
+/** Percentage of control bytes (other than common whitespace) at or above which content is classified as binary */
+#define OMEGA_BINARY_CONTROL_BYTE_PERCENT 10
+#endif//OMEGA_BINARY_CONTROL_BYTE_PERCENT
+
+#ifndef OMEGA_INTERN_MIN_LENGTH
+/** Minimum length of a change payload that is interned so that identical payloads share their bytes */
+#define OMEGA_INTERN_MIN_LENGTH 64
+#endif//OMEGA_INTERN_MIN_LENGTH
+
 #ifndef OMEGA_SEARCH_PATTERN_LENGTH_LIMIT
 /** Define the maximum length of a pattern for searching */
 #define OMEGA_SEARCH_PATTERN_LENGTH_LIMIT (OMEGA_VIEWPORT_CAPACITY_LIMIT / 2)
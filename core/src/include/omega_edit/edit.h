@@ -74,6 +74,26 @@ omega_viewport_t *omega_edit_create_viewport(omega_session_t *session_ptr, int64
                                              int is_floating, omega_viewport_event_cbk_t cbk, void *user_data_ptr,
                                              int32_t event_interest);
 
+/**
+ * Create a new paged viewport, returns a pointer to the new viewport.  Paged viewports store their data as a list of
+ * fixed-size pages that are populated on demand, so they can have capacities up to OMEGA_PAGED_VIEWPORT_CAPACITY_LIMIT
+ * without requiring a single contiguous allocation.  Paged viewport data is accessed using
+ * omega_viewport_get_page_data.
+ * @param session_ptr session to create the new viewport in
+ * @param offset offset for the new viewport
+ * @param capacity desired capacity of the new viewport
+ * @param page_size desired page size, or zero to use OMEGA_VIEWPORT_PAGE_SIZE
+ * @param is_floating 0 if the viewport is to remain fixed at the given offset, non-zero if the viewport is expected to
+ * "float" as bytes are inserted or deleted before the start of this viewport
+ * @param cbk user-defined callback function called whenever the viewport gets updated
+ * @param user_data_ptr pointer to user-defined data to associate with this new viewport
+ * @param event_interest oring together the viewport events of interest, or zero if all viewport events are desired
+ * @return pointer to the new viewport, or NULL on failure
+ */
+omega_viewport_t *omega_edit_create_paged_viewport(omega_session_t *session_ptr, int64_t offset, int64_t capacity,
+                                                   int64_t page_size, int is_floating, omega_viewport_event_cbk_t cbk,
+                                                   void *user_data_ptr, int32_t event_interest);
+
 /**
  * Destroy a given viewport
  * @param viewport_ptr viewport to destroy
@@ -101,6 +121,13 @@ int64_t omega_edit_undo_last_change(omega_session_t *session_ptr);
  */
 int64_t omega_edit_redo_last_undo(omega_session_t *session_ptr);
 
+/**
+ * Given a session, discard the undone changes eligible for being redone, so they can no longer be redone
+ * @param session_ptr session to discard the undone changes of
+ * @return number of undone changes discarded, or -1 if changes to the session are paused
+ */
+int64_t omega_edit_discard_undone_changes(omega_session_t *session_ptr);
+
 /**
  * Save a segment of the the given session (the edited file) to the given file path.  If the save file already exists,
  * it can be overwritten if overwrite is non zero.  If the file exists and overwrite is zero, a new unique file name
@@ -196,20 +223,94 @@ int64_t omega_edit_overwrite_bytes(omega_session_t *session_ptr, int64_t offset,
 int64_t omega_edit_overwrite(omega_session_t *session_ptr, int64_t offset, const char *cstr, int64_t length);
 
 /**
- * Checkpoint and apply the given mask of the given mask type to the bytes starting at the given offset up to the given
- * length
+ * Insert the given pattern repeated the given number of times at the given offset.  The change stores the pattern
+ * rather than the repeated bytes, so large fills cost little memory
+ * @param session_ptr session to make the change in
+ * @param offset location offset to make the change
+ * @param pattern pattern of bytes to repeat
+ * @param pattern_length number of bytes in the pattern (must be positive)
+ * @param repeat_count number of times to repeat the pattern (must be positive)
+ * @return positive change serial number on success, zero otherwise
+ */
+int64_t omega_edit_insert_fill(omega_session_t *session_ptr, int64_t offset, const omega_byte_t *pattern,
+                               int64_t pattern_length, int64_t repeat_count);
+
+/**
+ * Overwrite bytes at the given offset with the given pattern repeated the given number of times.  The change stores
+ * the pattern rather than the repeated bytes, so large fills cost little memory
+ * @param session_ptr session to make the change in
+ * @param offset location offset to make the change
+ * @param pattern pattern of bytes to repeat
+ * @param pattern_length number of bytes in the pattern (must be positive)
+ * @param repeat_count number of times to repeat the pattern (must be positive)
+ * @return positive change serial number on success, zero otherwise
+ */
+int64_t omega_edit_overwrite_fill(omega_session_t *session_ptr, int64_t offset, const omega_byte_t *pattern,
+                                  int64_t pattern_length, int64_t repeat_count);
+
+/**
+ * Apply the given byte transform to the bytes starting at the given offset up to the given length.  Ranges of up to
+ * OMEGA_TRANSFORM_CHANGE_LENGTH_LIMIT bytes become an overwrite change that can be undone, larger ranges checkpoint the
+ * session and transform the checkpoint file
  * @param session_ptr session to make the change in
  * @param transform byte transform to apply
  * @param user_data_ptr pointer to user data that will be sent through to the given transform
  * @param offset location offset to make the change
- * @param length the number of bytes from the given offset to apply the mask to
+ * @param length the number of bytes from the given offset to apply the transform to, if zero, the transform is applied
+ * to the end of the session
  * @return zero on success, non-zero otherwise
  */
 int omega_edit_apply_transform(omega_session_t *session_ptr, omega_util_byte_transform_t transform, void *user_data_ptr,
                                int64_t offset, int64_t length);
 
 /**
- * Creates a session checkpoint.
+ * Apply the given transform (see transform.h) to the bytes starting at the given offset up to the given length, using
+ * up to the given number of threads.  Repeating keys start with the first key byte at the given offset.  Ranges are
+ * handled like omega_edit_apply_transform.
+ * @param session_ptr session to make the change in
+ * @param transform_ptr transform to apply
+ * @param offset location offset to make the change
+ * @param length the number of bytes from the given offset to apply the transform to, if zero, the transform is applied
+ * to the end of the session
+ * @param num_threads maximum number of threads to use, if zero or negative, the hardware concurrency is used
+ * @return zero on success, non-zero otherwise
+ */
+int omega_edit_apply_transform_parallel(omega_session_t *session_ptr, const omega_transform_t *transform_ptr,
+                                        int64_t offset, int64_t length, int num_threads);
+
+/**
+ * Shift the bits of the bytes starting at the given offset up to the given length to the left, towards the start of the
+ * session.  The range is streamed through in blocks, so the only copy of the range held in memory is the shifted bytes
+ * recorded as a single overwrite change.
+ * @param session_ptr session to make the change in
+ * @param offset location offset to make the change
+ * @param length the number of bytes from the given offset to shift, if zero, the bytes are shifted to the end of the
+ * session
+ * @param shift_left number of bits (greater than 0) to shift to the left
+ * @param fill_bit bit to fill the shifted bit vacancies created at the end of the range with (0 or 1)
+ * @return positive change serial number on success, zero otherwise
+ */
+int64_t omega_edit_left_shift_bits(omega_session_t *session_ptr, int64_t offset, int64_t length, int64_t shift_left,
+                                   int fill_bit);
+
+/**
+ * Shift the bits of the bytes starting at the given offset up to the given length to the right, towards the end of the
+ * session.  The range is streamed through in blocks, so the only copy of the range held in memory is the shifted bytes
+ * recorded as a single overwrite change.
+ * @param session_ptr session to make the change in
+ * @param offset location offset to make the change
+ * @param length the number of bytes from the given offset to shift, if zero, the bytes are shifted to the end of the
+ * session
+ * @param shift_right number of bits (greater than 0) to shift to the right
+ * @param fill_bit bit to fill the shifted bit vacancies created at the beginning of the range with (0 or 1)
+ * @return positive change serial number on success, zero otherwise
+ */
+int64_t omega_edit_right_shift_bits(omega_session_t *session_ptr, int64_t offset, int64_t length, int64_t shift_right,
+                                    int fill_bit);
+
+/**
+ * Creates a session checkpoint.  The checkpoint freezes the current model of the session without writing its data out,
+ * so it costs time proportional to the number of model segments rather than the size of the file.
  * @param session_ptr session to checkpoint
  * @return zero on success, non-zero otherwise
  */
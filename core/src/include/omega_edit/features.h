@@ -0,0 +1,36 @@
+/**********************************************************************************************************************
+* Copyright (c) 2021 Concurrent Technologies Corporation.                                                            *
+*                                                                                                                    *
+* Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance     *
+* with the License.  You may obtain a copy of the License at                                                         *
+*                                                                                                                    *
+*     http://www.apache.org/licenses/LICENSE-2.0                                                                     *
+*                                                                                                                    *
+* Unless required by applicable law or agreed to in writing, software is distributed under the License is            *
+* distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or                   *
+* implied.  See the License for the specific language governing permissions and limitations under the License.       *
+*                                                                                                                    *
+**********************************************************************************************************************/
+/*********************************************************************************************************************
+* !!!DO NOT CHECK THIS GENERATED FILE INTO SOURCE CONTROL!!!                                                         *
+*                                                                                                                    *
+* This file is generated by CMake and should not be checked into source control.                                     *
+* It is only provided in the source tree so that it can be used by IDEs.                                             *
+*                                                                                                                    *
+* To ignore changes to this file, use:                                                                               *
+* git update-index --assume-unchanged core/src/include/omega_edit/features.h                                         *
+**********************************************************************************************************************/
+
+/**
+* @file features.h
+* @brief Features that are available on the current platform.
+*/
+
+#ifndef OMEGA_EDIT_FEATURES_H
+#define OMEGA_EDIT_FEATURES_H
+
+/* #undef HAVE_FOPEN_S */
+#define HAVE_FSEEKO
+#define HAVE_FTELLO
+
+#endif//OMEGA_EDIT_FEATURES_H
@@ -80,6 +80,17 @@ typedef enum {
     BOM_UNKNOWN = 0, BOM_NONE, BOM_UTF8, BOM_UTF16LE, BOM_UTF16BE, BOM_UTF32LE, BOM_UTF32BE
 } omega_bom_t;
 
+/** Content classes determined from the bytes alone, to short-circuit more expensive content detection */
+typedef enum {
+    CONTENT_CLASS_UNKNOWN = 0,//< Content could not be classified
+    CONTENT_CLASS_EMPTY,//< Content is empty
+    CONTENT_CLASS_BINARY,//< Content has NUL bytes or too many control bytes to be text
+    CONTENT_CLASS_TEXT_UTF8,//< Content is valid UTF-8 (including ASCII) text
+    CONTENT_CLASS_TEXT_UTF16,//< Content starts with a UTF-16 byte order mark
+    CONTENT_CLASS_TEXT_UTF32,//< Content starts with a UTF-32 byte order mark
+    CONTENT_CLASS_TEXT_OTHER//< Content is text, but not valid UTF-8, so likely in a single-byte encoding
+} omega_content_class_t;
+
 /** Opaque character counts */
 typedef struct omega_character_counts_struct omega_character_counts_t;
 
@@ -95,6 +106,15 @@ typedef struct omega_segment_struct omega_segment_t;
 /** Opaque session */
 typedef struct omega_session_struct omega_session_t;
 
+/** Opaque session snapshot */
+typedef struct omega_snapshot_struct omega_snapshot_t;
+
+/** Opaque snapshot search context */
+typedef struct omega_snapshot_search_context_struct omega_snapshot_search_context_t;
+
+/** Opaque byte transform */
+typedef struct omega_transform_struct omega_transform_t;
+
 /** Opaque viewport */
 typedef struct omega_viewport_struct omega_viewport_t;
 
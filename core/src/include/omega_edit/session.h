@@ -245,6 +245,85 @@ int64_t omega_session_get_num_undone_change_transactions(const omega_session_t *
  */
 int64_t omega_session_get_num_checkpoints(const omega_session_t *session_ptr);
 
+/**
+ * Set whether new changes are coalesced into the last change.  When coalescing, a change of the same kind as the last
+ * change of the session that continues it (an insert or overwrite that starts where the last one ends, or a delete at
+ * or just before the last one) in the same transaction, or outside any transaction, is merged into the last change
+ * instead of becoming a change of its own, so typing or patching byte by byte makes one change rather than thousands.
+ * Insert and overwrite changes are not grown past OMEGA_COALESCE_CHANGE_LENGTH_LIMIT bytes.
+ * @param session_ptr session to set change coalescing on
+ * @param coalesce non-zero to coalesce changes and zero otherwise
+ * @note The session and viewport events of a coalesced change describe the new change, with the serial number of the
+ * change it was merged into
+ */
+void omega_session_set_change_coalescing(omega_session_t *session_ptr, int coalesce);
+
+/**
+ * Determine if the session coalesces new changes into the last change or not
+ * @param session_ptr session to determine if changes are coalesced or not
+ * @return non-zero if changes are coalesced and zero if they are not
+ */
+int omega_session_get_change_coalescing(const omega_session_t *session_ptr);
+
+/**
+ * Squash the changes of the session up to and including the given serial number into the model the session starts
+ * from, flattening it without writing a checkpoint.  Squashed changes can no longer be undone, cleared, or looked up,
+ * and the serial numbers of the changes after them are unchanged.  Changes in checkpoints are not squashed.
+ * @param session_ptr session to compact
+ * @param serial serial number of the last change to squash
+ * @return zero on success and non-zero otherwise
+ */
+int omega_session_compact(omega_session_t *session_ptr, int64_t serial);
+
+/**
+ * Set the number of changes the session keeps for undo.  When a new change takes the session past the limit, its
+ * oldest changes are folded into the model it starts from (see omega_session_compact), an eighth of the limit more
+ * than needed so folding is not repeated on every change.  Transactions are folded whole, and not while open.
+ * @param session_ptr session to set the undo depth limit for
+ * @param limit maximum number of changes kept for undo, or negative (the default) for no limit
+ */
+void omega_session_set_undo_depth_limit(omega_session_t *session_ptr, int64_t limit);
+
+/**
+ * Given a session, return the undo depth limit
+ * @param session_ptr session to get the undo depth limit for
+ * @return maximum number of changes kept for undo, negative if there is no limit
+ */
+int64_t omega_session_get_undo_depth_limit(const omega_session_t *session_ptr);
+
+/**
+ * Set the memory the undo history of the session may hold.  When a new change takes the undo history past the budget,
+ * the oldest changes are folded into the model the session starts from (see omega_session_compact), releasing the
+ * payloads the session no longer needs, until the history is an eighth under the budget.  Undone changes are not
+ * folded.
+ * @param session_ptr session to set the history memory budget for
+ * @param budget history memory budget in bytes, or negative (the default) for no budget
+ */
+void omega_session_set_history_memory_budget(omega_session_t *session_ptr, int64_t budget);
+
+/**
+ * Given a session, return the history memory budget
+ * @param session_ptr session to get the history memory budget for
+ * @return history memory budget in bytes, negative if there is no budget
+ */
+int64_t omega_session_get_history_memory_budget(const omega_session_t *session_ptr);
+
+/**
+ * Given a session, return the memory held by its undo history: its changes (done and undone) and the payloads they
+ * hold in memory.  Compressed payloads count their compressed size, fills the size of their pattern, and spilled
+ * payloads nothing.
+ * @param session_ptr session to get the history memory for
+ * @return history memory in bytes
+ */
+int64_t omega_session_get_history_memory(const omega_session_t *session_ptr);
+
+/**
+ * Given a session, return the number of changes squashed by compacting it, or folded to bound its undo history
+ * @param session_ptr session to get the number of folded changes for
+ * @return number of folded changes
+ */
+int64_t omega_session_get_num_folded_changes(const omega_session_t *session_ptr);
+
 /**
  * Call the registered session event handler
  * @param session_ptr session whose event handler to call
@@ -262,6 +341,27 @@ void omega_session_notify(const omega_session_t *session_ptr, omega_session_even
  */
 omega_bom_t omega_session_detect_BOM(const omega_session_t *session_ptr, int64_t offset);
 
+/**
+ * Determine if the session is tracking its byte frequency profile or not
+ * @param session_ptr session to determine if the byte frequency profile is being tracked or not
+ * @return non-zero if the byte frequency profile is being tracked and zero if it is not
+ */
+int omega_session_byte_frequency_profile_tracking(const omega_session_t *session_ptr);
+
+/**
+ * Start tracking the byte frequency profile of the whole session.  The profile is computed once, the next time it is
+ * needed, and is then updated from the bytes removed and added by each change, so profiling the whole session costs
+ * time proportional to the size of the change rather than the size of the session.
+ * @param session_ptr session to start tracking the byte frequency profile on
+ */
+void omega_session_start_byte_frequency_profile_tracking(omega_session_t *session_ptr);
+
+/**
+ * Stop tracking the byte frequency profile of the whole session
+ * @param session_ptr session to stop tracking the byte frequency profile on
+ */
+void omega_session_stop_byte_frequency_profile_tracking(omega_session_t *session_ptr);
+
 /**
  * Given a session, offset and length, populate a byte frequency profile
  * @param session_ptr session to profile
@@ -269,10 +369,25 @@ omega_bom_t omega_session_detect_BOM(const omega_session_t *session_ptr, int64_t
  * @param offset where in the session to begin profiling
  * @param length number of bytes from the offset to stop profiling (if 0, it will profile to the end of the session)
  * @return zero on success and non-zero otherwise
+ * @note If the session is tracking its byte frequency profile, profiling the whole session uses the tracked profile
  */
 int omega_session_byte_frequency_profile(const omega_session_t *session_ptr,
                                          omega_byte_frequency_profile_t *profile_ptr, int64_t offset, int64_t length);
 
+/**
+ * Given a session, offset and length, populate a byte frequency profile using multiple threads
+ * @param session_ptr session to profile
+ * @param profile_ptr pointer to the byte frequency profile to populate
+ * @param offset where in the session to begin profiling
+ * @param length number of bytes from the offset to stop profiling (if 0, it will profile to the end of the session)
+ * @param num_threads maximum number of threads to use (if 0, it will use the available hardware concurrency)
+ * @return zero on success and non-zero otherwise
+ * @note If the session is tracking its byte frequency profile, profiling the whole session uses the tracked profile
+ */
+int omega_session_byte_frequency_profile_parallel(const omega_session_t *session_ptr,
+                                                  omega_byte_frequency_profile_t *profile_ptr, int64_t offset,
+                                                  int64_t length, int num_threads);
+
 /**
  * Given a session, offset and length, populate character counts
  * @param session_ptr session to count characters in
@@ -285,6 +400,33 @@ int omega_session_byte_frequency_profile(const omega_session_t *session_ptr,
 int omega_session_character_counts(const omega_session_t *session_ptr, omega_character_counts_t *counts_ptr,
                                    int64_t offset, int64_t length, omega_bom_t bom);
 
+/**
+ * Given a session, offset and length, populate character counts using multiple threads
+ * @param session_ptr session to count characters in
+ * @param counts_ptr pointer to the character counts to populate
+ * @param offset where in the session to begin counting characters
+ * @param length number of bytes from the offset to stop counting characters (if 0, it will count to the end of the session)
+ * @param bom byte order marker (BOM) to use when counting characters
+ * @param num_threads maximum number of threads to use (if 0, it will use the available hardware concurrency)
+ * @return zero on success and non-zero otherwise
+ * @note only UTF-8 (and unknown or no BOM) character counting is split across threads
+ */
+int omega_session_character_counts_parallel(const omega_session_t *session_ptr, omega_character_counts_t *counts_ptr,
+                                            int64_t offset, int64_t length, omega_bom_t bom, int num_threads);
+
+/**
+ * Given a session, offset and length, cheaply classify the content from its byte order mark (BOM), byte frequency
+ * profile, and UTF-8 validity, so that obvious cases can skip more expensive content type and language detection.  A
+ * UTF-8 character cut off by the end of the range does not make the content invalid UTF-8, so a range can be a prefix
+ * of longer content.
+ * @param session_ptr session to classify the content of
+ * @param offset where in the session to begin classifying
+ * @param length number of bytes from the offset to classify (if 0, it will classify to the end of the session)
+ * @return content class, CONTENT_CLASS_UNKNOWN on failure
+ */
+omega_content_class_t omega_session_classify_content(const omega_session_t *session_ptr, int64_t offset,
+                                                     int64_t length);
+
 /**
  * Given a session, return the checkpoint directory
  * @param session_ptr  session to get the checkpoint directory for
@@ -299,6 +441,127 @@ const char *omega_session_get_checkpoint_directory(const omega_session_t *sessio
  */
 int64_t omega_session_get_checkpoint_directory_length(const omega_session_t *session_ptr);
 
+/**
+ * Set the length at or above which new INSERT and OVERWRITE payloads are candidates for compression.  Compressed
+ * payloads are stored in independently compressed blocks, so reading a range of one only decompresses the blocks it
+ * overlaps.
+ * @param session_ptr session to set the payload compression threshold for
+ * @param threshold payload length at or above which payloads are compressed, or zero (the default) to not compress
+ * payloads
+ */
+void omega_session_set_payload_compression_threshold(omega_session_t *session_ptr, int64_t threshold);
+
+/**
+ * Given a session, return the payload compression threshold
+ * @param session_ptr session to get the payload compression threshold for
+ * @return payload compression threshold, zero if payloads are not compressed
+ */
+int64_t omega_session_get_payload_compression_threshold(const omega_session_t *session_ptr);
+
+/**
+ * Set the number of bytes of uncompressed payloads the session may hold before new payloads at or above the compression
+ * threshold are compressed
+ * @param session_ptr session to set the payload memory budget for
+ * @param budget payload memory budget in bytes, zero (the default) to compress every payload at or above the threshold
+ */
+void omega_session_set_payload_memory_budget(omega_session_t *session_ptr, int64_t budget);
+
+/**
+ * Given a session, return the payload memory budget
+ * @param session_ptr session to get the payload memory budget for
+ * @return payload memory budget in bytes
+ */
+int64_t omega_session_get_payload_memory_budget(const omega_session_t *session_ptr);
+
+/**
+ * Set the length at or above which new INSERT and OVERWRITE payloads are spilled to the payload store of the session,
+ * an append-only, memory-mapped file in the checkpoint directory, so the operating system can page them out instead of
+ * holding them in memory.  Space in the payload store is reclaimed when the session is destroyed.
+ * @param session_ptr session to set the payload spill threshold for
+ * @param threshold payload length at or above which payloads are spilled, or zero (the default) to not spill payloads
+ */
+void omega_session_set_payload_spill_threshold(omega_session_t *session_ptr, int64_t threshold);
+
+/**
+ * Given a session, return the payload spill threshold
+ * @param session_ptr session to get the payload spill threshold for
+ * @return payload spill threshold, zero if payloads are not spilled
+ */
+int64_t omega_session_get_payload_spill_threshold(const omega_session_t *session_ptr);
+
+/**
+ * Given a session, return the number of its change payloads (done and undone) that are spilled to its payload store
+ * @param session_ptr session to get the number of spilled payloads for
+ * @return number of spilled payloads
+ */
+int64_t omega_session_get_num_spilled_payloads(const omega_session_t *session_ptr);
+
+/**
+ * Given a session, return the number of bytes that have been written to its payload store
+ * @param session_ptr session to get the payload store size for
+ * @return payload store size in bytes
+ */
+int64_t omega_session_get_payload_store_size(const omega_session_t *session_ptr);
+
+/**
+ * Set the number of bytes the checkpoint files of the session may take on disk.  A transform of a range too large to be
+ * recorded as an ordinary change rewrites the session into a checkpoint file, unless that would exceed this budget, in
+ * which case the transformed range is recorded as a compressed change instead.
+ * @param session_ptr session to set the checkpoint disk budget for
+ * @param budget checkpoint disk budget in bytes, or negative (the default) for no budget
+ */
+void omega_session_set_checkpoint_disk_budget(omega_session_t *session_ptr, int64_t budget);
+
+/**
+ * Given a session, return the checkpoint disk budget
+ * @param session_ptr session to get the checkpoint disk budget for
+ * @return checkpoint disk budget in bytes, negative if there is no budget
+ */
+int64_t omega_session_get_checkpoint_disk_budget(const omega_session_t *session_ptr);
+
+/**
+ * Given a session, return the number of bytes its checkpoint files take on disk
+ * @param session_ptr session to get the checkpoint disk usage for
+ * @return checkpoint disk usage in bytes
+ */
+int64_t omega_session_get_checkpoint_disk_usage(const omega_session_t *session_ptr);
+
+/**
+ * Given a session, return the number of its change payloads (done and undone) that are compressed
+ * @param session_ptr session to get the number of compressed payloads for
+ * @return number of compressed payloads
+ */
+int64_t omega_session_get_num_compressed_payloads(const omega_session_t *session_ptr);
+
+/**
+ * Given a session, return the total length of its change payloads (done and undone)
+ * @param session_ptr session to get the payload bytes for
+ * @return total uncompressed length of the change payloads
+ */
+int64_t omega_session_get_payload_bytes(const omega_session_t *session_ptr);
+
+/**
+ * Given a session, return the total uncompressed length of its compressed change payloads (done and undone)
+ * @param session_ptr session to get the compressed payload bytes for
+ * @return total uncompressed length of the compressed change payloads
+ */
+int64_t omega_session_get_compressed_payload_bytes(const omega_session_t *session_ptr);
+
+/**
+ * Given a session, return the number of bytes its compressed change payloads take in memory, so the compression ratio
+ * is the compressed payload bytes over the stored compressed payload bytes
+ * @param session_ptr session to get the stored compressed payload bytes for
+ * @return number of bytes the compressed change payloads take, including their block indexes
+ */
+int64_t omega_session_get_stored_compressed_payload_bytes(const omega_session_t *session_ptr);
+
+/**
+ * Get the number of distinct payloads the session shares among changes with identical payloads
+ * @param session_ptr session to get the number of interned payloads from
+ * @return number of interned payloads
+ */
+int64_t omega_session_get_num_interned_payloads(const omega_session_t *session_ptr);
+
 #ifdef __cplusplus
 }
 #endif
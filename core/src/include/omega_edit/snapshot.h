@@ -0,0 +1,146 @@
+/**********************************************************************************************************************
+ * Copyright (c) 2021 Concurrent Technologies Corporation.                                                            *
+ *                                                                                                                    *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance     *
+ * with the License.  You may obtain a copy of the License at                                                         *
+ *                                                                                                                    *
+ *     http://www.apache.org/licenses/LICENSE-2.0                                                                     *
+ *                                                                                                                    *
+ * Unless required by applicable law or agreed to in writing, software is distributed under the License is            *
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or                   *
+ * implied.  See the License for the specific language governing permissions and limitations under the License.       *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+
+/**
+ * @file snapshot.h
+ * @brief Functions that read immutable snapshots of editing sessions from any thread.
+ */
+
+#ifndef OMEGA_EDIT_SNAPSHOT_H
+#define OMEGA_EDIT_SNAPSHOT_H
+
+#include "byte.h"
+#include "fwd_defs.h"
+#include "session.h"
+
+#ifdef __cplusplus
+
+#include <cstdint>
+
+extern "C" {
+#else
+
+#include <stdint.h>
+
+#endif
+
+/**
+ * Take a snapshot of the current state of the given session.  The snapshot shares the changes of the session instead
+ * of copying their bytes, so it is cheap to take, and it is unaffected by later edits, undos, checkpoints, or the
+ * destruction of the session.  A snapshot can be read from any thread while the session keeps being edited on its own
+ * thread, and reads of the same snapshot from several threads are serialized.
+ * @param session_ptr session to take a snapshot of
+ * @return snapshot of the session, or NULL on failure
+ */
+omega_snapshot_t *omega_session_snapshot(const omega_session_t *session_ptr);
+
+/**
+ * Destroy the given snapshot
+ * @param snapshot_ptr snapshot to destroy
+ */
+void omega_snapshot_destroy(omega_snapshot_t *snapshot_ptr);
+
+/**
+ * Given a snapshot, return the computed file size at the time the snapshot was taken
+ * @param snapshot_ptr snapshot to get the computed file size from
+ * @return computed file size
+ */
+int64_t omega_snapshot_get_computed_file_size(const omega_snapshot_t *snapshot_ptr);
+
+/**
+ * Given a snapshot, return the number of active changes at the time the snapshot was taken
+ * @param snapshot_ptr snapshot to get the number of active changes from
+ * @return number of active changes
+ */
+int64_t omega_snapshot_get_num_changes(const omega_snapshot_t *snapshot_ptr);
+
+/**
+ * Populate the given data segment with the snapshot bytes at the given offset
+ * @param snapshot_ptr snapshot to read from
+ * @param data_segment_ptr data segment to populate, created with omega_segment_create
+ * @param offset offset in the snapshot to read from
+ * @return zero on success and non-zero otherwise
+ */
+int omega_snapshot_get_segment(omega_snapshot_t *snapshot_ptr, omega_segment_t *data_segment_ptr, int64_t offset);
+
+/**
+ * Given a snapshot, offset and length, populate a byte frequency profile
+ * @param snapshot_ptr snapshot to profile
+ * @param profile_ptr pointer to the byte frequency profile to populate
+ * @param offset where in the snapshot to begin profiling
+ * @param length number of bytes from the offset to stop profiling (if 0, it will profile to the end of the snapshot)
+ * @return zero on success and non-zero otherwise
+ */
+int omega_snapshot_byte_frequency_profile(omega_snapshot_t *snapshot_ptr, omega_byte_frequency_profile_t *profile_ptr,
+                                          int64_t offset, int64_t length);
+
+/**
+ * Given a snapshot, offset and length, populate character counts
+ * @param snapshot_ptr snapshot to count characters in
+ * @param counts_ptr pointer to the character counts to populate
+ * @param offset where in the snapshot to begin counting characters
+ * @param length number of bytes from the offset to stop counting characters (if 0, it will count to the end of the
+ * snapshot)
+ * @param bom byte order marker (BOM) to use when counting characters
+ * @return zero on success and non-zero otherwise
+ */
+int omega_snapshot_character_counts(omega_snapshot_t *snapshot_ptr, omega_character_counts_t *counts_ptr,
+                                    int64_t offset, int64_t length, omega_bom_t bom);
+
+/**
+ * Find the first occurrence of the given pattern in the given range of the snapshot
+ * @param snapshot_ptr snapshot to search
+ * @param pattern pattern to find (as a sequence of bytes)
+ * @param pattern_length length of the pattern, less than OMEGA_SEARCH_PATTERN_LENGTH_LIMIT
+ * @param offset where in the snapshot to begin searching
+ * @param length number of bytes from the offset to search (if 0, it will search to the end of the snapshot)
+ * @return offset of the first match, -1 if the pattern is not found, or -2 on failure
+ */
+int64_t omega_snapshot_search(omega_snapshot_t *snapshot_ptr, const omega_byte_t *pattern, int64_t pattern_length,
+                              int64_t offset, int64_t length);
+
+/**
+ * Create a context to find the successive occurrences of the given pattern in the given range of the snapshot.  The
+ * context keeps the window of the snapshot it is searching, so finding every match reads the range once.
+ * @param snapshot_ptr snapshot to search, which must outlive the context
+ * @param pattern pattern to find (as a sequence of bytes)
+ * @param pattern_length length of the pattern, less than OMEGA_SEARCH_PATTERN_LENGTH_LIMIT
+ * @param offset where in the snapshot to begin searching
+ * @param length number of bytes from the offset to search (if 0, it will search to the end of the snapshot)
+ * @return search context, or NULL on failure
+ */
+omega_snapshot_search_context_t *omega_snapshot_search_create_context(omega_snapshot_t *snapshot_ptr,
+                                                                      const omega_byte_t *pattern,
+                                                                      int64_t pattern_length, int64_t offset,
+                                                                      int64_t length);
+
+/**
+ * Find the next occurrence of the pattern of the given search context, starting one byte after the previous match, so
+ * overlapping matches are found
+ * @param search_context_ptr search context to find the next match of
+ * @return offset of the next match, -1 if there are no more matches, or -2 on failure
+ */
+int64_t omega_snapshot_search_next_match(omega_snapshot_search_context_t *search_context_ptr);
+
+/**
+ * Destroy the given snapshot search context
+ * @param search_context_ptr search context to destroy
+ */
+void omega_snapshot_search_destroy_context(omega_snapshot_search_context_t *search_context_ptr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif//OMEGA_EDIT_SNAPSHOT_H
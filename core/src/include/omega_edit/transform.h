@@ -0,0 +1,138 @@
+/**********************************************************************************************************************
+ * Copyright (c) 2021 Concurrent Technologies Corporation.                                                            *
+ *                                                                                                                    *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance     *
+ * with the License.  You may obtain a copy of the License at                                                         *
+ *                                                                                                                    *
+ *     http://www.apache.org/licenses/LICENSE-2.0                                                                     *
+ *                                                                                                                    *
+ * Unless required by applicable law or agreed to in writing, software is distributed under the License is            *
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or                   *
+ * implied.  See the License for the specific language governing permissions and limitations under the License.       *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+
+/**
+ * @file transform.h
+ * @brief Built-in byte transforms (omega_transform_t) that are applied to whole buffers at a time.
+ */
+
+#ifndef OMEGA_EDIT_TRANSFORM_H
+#define OMEGA_EDIT_TRANSFORM_H
+
+#include "byte.h"
+#include "fwd_defs.h"
+#include "utility.h"
+
+#ifdef __cplusplus
+
+#include <cstdint>
+
+extern "C" {
+#else
+
+#include <stdint.h>
+
+#endif
+
+/**
+ * Create a transform that combines the bytes with a repeating key using the given mask kind
+ * @param mask_kind mask kind (e.g., MASK_AND, MASK_OR, MASK_XOR)
+ * @param key key bytes, the first key byte is combined with the first byte the transform is applied to
+ * @param key_length number of key bytes, must be positive
+ * @return new transform, or null if the key is empty
+ */
+omega_transform_t *omega_transform_create_mask(omega_mask_kind_t mask_kind, const omega_byte_t *key,
+                                               int64_t key_length);
+
+/**
+ * Create a transform that adds a repeating key to the bytes (modulo 256)
+ * @param key key bytes, the first key byte is added to the first byte the transform is applied to
+ * @param key_length number of key bytes, must be positive
+ * @return new transform, or null if the key is empty
+ */
+omega_transform_t *omega_transform_create_add(const omega_byte_t *key, int64_t key_length);
+
+/**
+ * Create a transform that subtracts a repeating key from the bytes (modulo 256)
+ * @param key key bytes, the first key byte is subtracted from the first byte the transform is applied to
+ * @param key_length number of key bytes, must be positive
+ * @return new transform, or null if the key is empty
+ */
+omega_transform_t *omega_transform_create_subtract(const omega_byte_t *key, int64_t key_length);
+
+/**
+ * Create a transform that replaces each byte with its entry in the given lookup table
+ * @param table lookup table of 256 bytes
+ * @return new transform
+ */
+omega_transform_t *omega_transform_create_lookup_table(const omega_byte_t *table);
+
+/**
+ * Create a transform that converts ASCII letters to upper case
+ * @return new transform
+ */
+omega_transform_t *omega_transform_create_to_upper();
+
+/**
+ * Create a transform that converts ASCII letters to lower case
+ * @return new transform
+ */
+omega_transform_t *omega_transform_create_to_lower();
+
+/**
+ * Create a transform that calls the given byte transform function for each byte
+ * @param transform byte transform function
+ * @param user_data_ptr pointer to user-defined data to associate with the transformer
+ * @return new transform
+ * @note transforms created with this function are always applied on the calling thread
+ */
+omega_transform_t *omega_transform_create_callback(omega_util_byte_transform_t transform, void *user_data_ptr);
+
+/**
+ * Destroy the given transform
+ * @param transform_ptr transform to destroy
+ */
+void omega_transform_destroy(omega_transform_t *transform_ptr);
+
+/**
+ * Apply the given transform to the bytes in the given buffer
+ * @param transform_ptr transform to apply
+ * @param buffer buffer of bytes to apply the transform to
+ * @param length number of bytes in the buffer to apply the transform to
+ * @param key_offset position of the first byte of the buffer in the transformed range, which selects the key byte
+ * combined with it
+ */
+void omega_transform_apply(const omega_transform_t *transform_ptr, omega_byte_t *buffer, int64_t length,
+                           int64_t key_offset);
+
+/**
+ * Apply the given transform to the bytes in the given buffer, splitting large buffers among threads
+ * @param transform_ptr transform to apply
+ * @param buffer buffer of bytes to apply the transform to
+ * @param length number of bytes in the buffer to apply the transform to
+ * @param key_offset position of the first byte of the buffer in the transformed range, which selects the key byte
+ * combined with it
+ * @param num_threads maximum number of threads to use, if zero or negative, the hardware concurrency is used
+ */
+void omega_transform_apply_parallel(const omega_transform_t *transform_ptr, omega_byte_t *buffer, int64_t length,
+                                    int64_t key_offset, int num_threads);
+
+/**
+ * Apply the given transform to the input file and write the transformed data to the output file
+ * @param transform_ptr transform to apply
+ * @param in_path path of the file to apply the transform to
+ * @param out_path path of the file to write the transformed data to
+ * @param offset where to begin transforming bytes
+ * @param length number of bytes to transform from the given offset, if zero, transform to the end of the file
+ * @param num_threads maximum number of threads to use, if zero or negative, the hardware concurrency is used
+ * @return zero on success, non-zero otherwise
+ */
+int omega_transform_apply_to_file(const omega_transform_t *transform_ptr, char const *in_path, char const *out_path,
+                                  int64_t offset, int64_t length, int num_threads);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif//OMEGA_EDIT_TRANSFORM_H
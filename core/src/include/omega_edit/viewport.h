@@ -58,12 +58,51 @@ int64_t omega_viewport_get_length(const omega_viewport_t *viewport_ptr);
 /**
  * Given a viewport, return the viewport data
  * @param viewport_ptr viewport to get the viewport data from
- * @return viewport data
+ * @return viewport data, or NULL for paged viewports (use omega_viewport_get_page_data instead)
  */
 const omega_byte_t *omega_viewport_get_data(const omega_viewport_t *viewport_ptr);
 
 /**
- * Given a viewport, determine if it contains changes since the last omega_viewport_get_data call
+ * Given a viewport, return non-zero if the viewport is paged and zero if the viewport is contiguous
+ * @param viewport_ptr viewport to determine if it's paged or not
+ * @return non-zero if the viewport is paged and zero if the viewport is contiguous
+ */
+int omega_viewport_is_paged(const omega_viewport_t *viewport_ptr);
+
+/**
+ * Given a viewport, return the viewport page size
+ * @param viewport_ptr viewport to get the page size from
+ * @return viewport page size, which is the viewport capacity for contiguous viewports
+ */
+int64_t omega_viewport_get_page_size(const omega_viewport_t *viewport_ptr);
+
+/**
+ * Given a viewport, return the number of pages spanning the viewport data
+ * @param viewport_ptr viewport to get the number of pages from
+ * @return number of pages spanning the viewport data
+ */
+int64_t omega_viewport_get_num_pages(const omega_viewport_t *viewport_ptr);
+
+/**
+ * Given a viewport, return the number of pages currently populated
+ * @param viewport_ptr viewport to get the number of populated pages from
+ * @return number of pages currently populated, contiguous viewports report a single page when their data is current
+ */
+int64_t omega_viewport_get_num_populated_pages(const omega_viewport_t *viewport_ptr);
+
+/**
+ * Given a viewport, return the data for the given page, populating the page if needed
+ * @param viewport_ptr viewport to get the page data from
+ * @param page_index index of the page to get the data for
+ * @param page_length_ptr if not NULL, the length of the page data is written here
+ * @return page data, or NULL if the page index is out of range or the page could not be populated
+ */
+const omega_byte_t *omega_viewport_get_page_data(const omega_viewport_t *viewport_ptr, int64_t page_index,
+                                                 int64_t *page_length_ptr);
+
+/**
+ * Given a viewport, determine if it contains changes since the last omega_viewport_get_data or
+ * omega_viewport_get_page_data call
  * @param viewport_ptr viewport to determine if changes are present
  * @return 0 if there are no changes present, and non-zero otherwise
  */
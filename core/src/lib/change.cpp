@@ -14,12 +14,25 @@
 
 #include "../include/omega_edit/change.h"
 #include "impl_/change_def.hpp"
+#include "impl_/internal_fun.hpp"
 #include "impl_/macros.h"
+#include <atomic>
 #include <cassert>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 
 static_assert(sizeof(omega_change_t) == sizeof(omega_change_struct), "omega_change_t size mismatch");
 static_assert(sizeof(omega_change_t) == 40);
 
+namespace {
+    // Decoded copies of the payloads of compressed and fill changes, which live as long as their changes, so the bytes
+    // returned by omega_change_get_bytes stay valid and the shared payloads are never modified
+    std::mutex decoded_payloads_mutex_;
+    std::unordered_map<const omega_change_t *, std::unique_ptr<omega_byte_t[]>> decoded_payloads_;
+    std::atomic<int64_t> num_decoded_payloads_{};
+}// namespace
+
 int64_t omega_change_get_offset(const omega_change_t *change_ptr) {
     assert(change_ptr);
     return change_ptr->offset;
@@ -44,7 +57,32 @@ static inline const omega_byte_t *change_bytes_(const omega_change_t *change_ptr
 
 const omega_byte_t *omega_change_get_bytes(const omega_change_t *change_ptr) {
     assert(change_ptr);
-    return change_bytes_(change_ptr);
+    if (!omega_change_is_compressed_(change_ptr) && !omega_change_is_fill_(change_ptr)) {
+        return change_bytes_(change_ptr);
+    }
+    {
+        const std::lock_guard<std::mutex> lock(decoded_payloads_mutex_);
+        if (const auto iter = decoded_payloads_.find(change_ptr); iter != decoded_payloads_.end()) {
+            return iter->second.get();
+        }
+    }
+    // The payload itself is left alone, since snapshots on other threads can be reading it
+    auto bytes = std::make_unique<omega_byte_t[]>(change_ptr->length + 1);
+    if (!read_change_bytes_(change_ptr, 0, bytes.get(), change_ptr->length)) {
+        ABORT(LOG_ERROR("failed to read change payload"););
+    }
+    bytes[change_ptr->length] = '\0';
+    const std::lock_guard<std::mutex> lock(decoded_payloads_mutex_);
+    // Another thread may have decoded the payload in the meantime, in which case its copy is kept
+    const auto result = decoded_payloads_.emplace(change_ptr, std::move(bytes));
+    if (result.second) { num_decoded_payloads_.fetch_add(1, std::memory_order_relaxed); }
+    return result.first->second.get();
+}
+
+void release_decoded_payload_(const omega_change_t *change_ptr) noexcept {
+    if (0 == num_decoded_payloads_.load(std::memory_order_relaxed)) { return; }
+    const std::lock_guard<std::mutex> lock(decoded_payloads_mutex_);
+    if (0 < decoded_payloads_.erase(change_ptr)) { num_decoded_payloads_.fetch_sub(1, std::memory_order_relaxed); }
 }
 
 char omega_change_get_kind_as_char(const omega_change_t *change_ptr) {
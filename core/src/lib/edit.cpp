@@ -17,16 +17,23 @@
 #include "../include/omega_edit/search.h"
 #include "../include/omega_edit/segment.h"
 #include "../include/omega_edit/session.h"
+#include "../include/omega_edit/transform.h"
 #include "../include/omega_edit/viewport.h"
 #include "impl_/change_def.hpp"
+#include "impl_/compressed_data.hpp"
 #include "impl_/internal_fun.hpp"
 #include "impl_/macros.h"
 #include "impl_/model_def.hpp"
 #include "impl_/model_segment_def.hpp"
+#include "impl_/payload_store.hpp"
 #include "impl_/session_def.hpp"
+#include "impl_/shift_bits.hpp"
+#include "impl_/transform_def.hpp"
 #include "impl_/viewport_def.hpp"
 #include <algorithm>
 #include <cassert>
+#include <cstring>
+#include <limits>
 #include <memory>
 
 #ifdef OMEGA_BUILD_WINDOWS
@@ -66,6 +73,76 @@ namespace {
         }
     }
 
+    /*
+     * Decide whether a new payload of the given length is stored compressed.  Payloads at or above the compression
+     * threshold stay uncompressed while the uncompressed payloads the session holds in memory fit in the payload memory
+     * budget.
+     */
+    auto compress_payload_(const omega_session_t *session_ptr, int64_t length) -> bool {
+        const auto threshold = omega_session_get_payload_compression_threshold(session_ptr);
+        if (threshold <= 0 || length < std::max(threshold, static_cast<int64_t>(DATA_T_SIZE))) { return false; }
+        return omega_session_get_payload_memory_budget(session_ptr) <
+               omega_session_get_resident_payload_bytes_(session_ptr) + length;
+    }
+
+    /*
+     * Allocate the given number of bytes in the payload store of the session for a new payload of the given length, if
+     * payloads of that length are spilled, or return nullptr if the payload is kept in memory.  The payload store is
+     * created when the first payload is spilled.
+     */
+    auto allocate_spilled_payload_(omega_session_t *session_ptr, int64_t length, int64_t size) -> omega_byte_t * {
+        const auto threshold = omega_session_get_payload_spill_threshold(session_ptr);
+        if (threshold <= 0 || length < std::max(threshold, static_cast<int64_t>(DATA_T_SIZE))) { return nullptr; }
+        if (!session_ptr->payload_store_) {
+            session_ptr->payload_store_ =
+                    payload_store_t::create(omega_session_get_checkpoint_directory(session_ptr));
+            if (!session_ptr->payload_store_) { return nullptr; }
+        }
+        return session_ptr->payload_store_->allocate(size);
+    }
+
+    // Give the change the given compressed data (allocated with new[]), moving it to the payload store if it is spilled
+    void set_compressed_payload_(omega_session_t *session_ptr, omega_change_t *change_ptr, omega_byte_t *data) {
+        const auto size = compressed_data_size_(data);
+        if (auto *const spilled = allocate_spilled_payload_(session_ptr, change_ptr->length, size)) {
+            memcpy(spilled, data, size);
+            delete[] data;
+            change_ptr->data.bytes_ptr = spilled;
+            change_ptr->kind |= OMEGA_CHANGE_SPILLED_BIT;
+        } else {
+            change_ptr->data.bytes_ptr = data;
+        }
+        change_ptr->kind |= OMEGA_CHANGE_COMPRESSED_BIT;
+    }
+
+    // Give the change a copy of the given bytes as its payload
+    void set_payload_(omega_session_t *session_ptr, omega_change_t *change_ptr, const omega_byte_t *bytes) {
+        const auto length = change_ptr->length;
+        if (length < DATA_T_SIZE) {
+            // small bytes optimization
+            memcpy(change_ptr->data.sm_bytes, bytes, length);
+            change_ptr->data.sm_bytes[length] = '\0';
+        } else if (compress_payload_(session_ptr, length)) {
+            set_compressed_payload_(session_ptr, change_ptr, compress_data_(bytes, length));
+        } else {
+            // allocate its capacity plus one, so we can null-terminate it
+            auto *payload = allocate_spilled_payload_(session_ptr, length, length + 1);
+            if (payload) {
+                change_ptr->kind |= OMEGA_CHANGE_SPILLED_BIT;
+            } else if (OMEGA_INTERN_MIN_LENGTH <= length) {
+                // Identical payloads (repeated pastes, for example) share their bytes
+                change_ptr->data.bytes_ptr = session_ptr->payload_intern_table_.intern(bytes, length);
+                change_ptr->kind |= OMEGA_CHANGE_INTERNED_BIT;
+                return;
+            } else {
+                payload = new omega_byte_t[length + 1];
+            }
+            memcpy(payload, bytes, length);
+            payload[length] = '\0';
+            change_ptr->data.bytes_ptr = payload;
+        }
+    }
+
     inline auto del_(int64_t serial, int64_t offset, int64_t length, bool transaction_bit) -> const_omega_change_ptr_t {
         const auto change_ptr = std::make_shared<omega_change_t>();
         change_ptr->serial = serial;
@@ -77,48 +154,50 @@ namespace {
         return change_ptr;
     }
 
-    inline auto ins_(int64_t serial, int64_t offset, const omega_byte_t *bytes, int64_t length,
-                     bool transaction_bit) -> const_omega_change_ptr_t {
+    inline auto ins_(omega_session_t *session_ptr, int64_t serial, int64_t offset, const omega_byte_t *bytes,
+                     int64_t length, bool transaction_bit) -> const_omega_change_ptr_t {
         auto change_ptr = std::make_shared<omega_change_t>();
         change_ptr->serial = serial;
         change_ptr->kind =
                 (transaction_bit ? OMEGA_CHANGE_TRANSACTION_BIT : 0x00) | (uint8_t) change_kind_t::CHANGE_INSERT;
         change_ptr->offset = offset;
         change_ptr->length = length ? length : static_cast<int64_t>(strlen((const char *) bytes));
-        if (change_ptr->length < DATA_T_SIZE) {
-            // small bytes optimization
-            memcpy(change_ptr->data.sm_bytes, bytes, change_ptr->length);
-            change_ptr->data.sm_bytes[change_ptr->length] = '\0';
-        } else {
-            // allocate its capacity plus one, so we can null-terminate it
-            change_ptr->data.bytes_ptr = new omega_byte_t[change_ptr->length + 1];
-            memcpy(change_ptr->data.bytes_ptr, bytes, change_ptr->length);
-            change_ptr->data.bytes_ptr[change_ptr->length] = '\0';
-        }
+        set_payload_(session_ptr, change_ptr.get(), bytes);
         return std::move(change_ptr);
     }
 
-    inline auto ovr_(int64_t serial, int64_t offset, const omega_byte_t *bytes, int64_t length,
-                     bool transaction_bit) -> const_omega_change_ptr_t {
+    inline auto ovr_(omega_session_t *session_ptr, int64_t serial, int64_t offset, const omega_byte_t *bytes,
+                     int64_t length, bool transaction_bit) -> const_omega_change_ptr_t {
         auto change_ptr = std::make_shared<omega_change_t>();
         change_ptr->serial = serial;
         change_ptr->kind =
                 (transaction_bit ? OMEGA_CHANGE_TRANSACTION_BIT : 0x00) | (uint8_t) change_kind_t::CHANGE_OVERWRITE;
         change_ptr->offset = offset;
         change_ptr->length = length ? length : static_cast<int64_t>(strlen((const char *) bytes));
-        if (change_ptr->length < DATA_T_SIZE) {
-            // small bytes optimization
-            memcpy(change_ptr->data.sm_bytes, bytes, change_ptr->length);
-            change_ptr->data.sm_bytes[change_ptr->length] = '\0';
-        } else {
-            // allocate its capacity plus one, so we can null-terminate it
-            change_ptr->data.bytes_ptr = new omega_byte_t[change_ptr->length + 1];
-            memcpy(change_ptr->data.bytes_ptr, bytes, change_ptr->length);
-            change_ptr->data.bytes_ptr[change_ptr->length] = '\0';
-        }
+        set_payload_(session_ptr, change_ptr.get(), bytes);
         return std::move(change_ptr);
     }
 
+    /*
+     * Make an INSERT or OVERWRITE change whose payload is the given pattern repeated for the given length, storing the
+     * pattern instead of the repeated bytes
+     */
+    inline auto fill_(int64_t serial, change_kind_t kind, int64_t offset, const omega_byte_t *pattern,
+                      int64_t pattern_length, int64_t length, bool transaction_bit) -> const_omega_change_ptr_t {
+        assert(DATA_T_SIZE <= length);
+        auto change_ptr = std::make_shared<omega_change_t>();
+        change_ptr->serial = serial;
+        change_ptr->kind = (transaction_bit ? OMEGA_CHANGE_TRANSACTION_BIT : 0x00) | OMEGA_CHANGE_FILL_BIT |
+                           static_cast<uint8_t>(kind);
+        change_ptr->offset = offset;
+        change_ptr->length = length;
+        auto *const payload = new omega_byte_t[sizeof(int64_t) + pattern_length];
+        memcpy(payload, &pattern_length, sizeof(int64_t));
+        memcpy(payload + sizeof(int64_t), pattern, pattern_length);
+        change_ptr->data.bytes_ptr = payload;
+        return change_ptr;
+    }
+
     inline void update_viewport_offset_adjustment_(omega_viewport_t *viewport_ptr,
                                                    const omega_change_t *change_ptr) {
         assert(0 < change_ptr->length);
@@ -154,54 +233,109 @@ namespace {
         }
     }
 
-    auto update_viewports_(const omega_session_t *session_ptr, const omega_change_t *change_ptr) -> int {
+    void invalidate_viewport_change_pages_(omega_viewport_t *viewport_ptr, const omega_change_t *change_ptr,
+                                           int64_t viewport_offset) {
+        if (viewport_ptr->pages_.empty()) { return; }
+        // Undone changes rebuild the model, so all pages are stale
+        if (omega_change_get_serial(change_ptr) < 0) {
+            invalidate_viewport_pages_(viewport_ptr, 0, -1);
+            return;
+        }
+        const auto relative_offset = change_ptr->offset - viewport_offset;
+        switch (omega_change_get_kind(change_ptr)) {
+            case change_kind_t::CHANGE_OVERWRITE:
+                // OVERWRITE changes only affect the pages they intersect
+                invalidate_viewport_pages_(viewport_ptr, relative_offset, change_ptr->length);
+                break;
+            case change_kind_t::CHANGE_INSERT:
+                // Floating viewports move along with inserts before or at their start, so their pages remain valid
+                if (omega_viewport_is_floating(viewport_ptr) != 0 && relative_offset <= 0) { break; }
+                invalidate_viewport_pages_(viewport_ptr, relative_offset, -1);
+                break;
+            case change_kind_t::CHANGE_DELETE:
+                // Floating viewports move along with deletes that end before their start, so their pages remain valid
+                if (omega_viewport_is_floating(viewport_ptr) != 0 && relative_offset + change_ptr->length <= 0) {
+                    break;
+                }
+                invalidate_viewport_pages_(viewport_ptr, relative_offset, -1);
+                break;
+            default:
+                ABORT(LOG_ERROR("Unhandled change kind"););
+        }
+    }
+
+    auto update_viewports_(const omega_session_t *session_ptr, const omega_change_t *change_ptr,
+                           omega_viewport_event_t viewport_event = VIEWPORT_EVT_EDIT) -> int {
         for (auto &&viewport_ptr: session_ptr->viewports_) {
+            const auto viewport_offset = omega_viewport_get_offset(viewport_ptr.get());
             // possibly adjust the viewport offset if it's floating and other criteria are met
             update_viewport_offset_adjustment_(viewport_ptr.get(), change_ptr);
             if (change_affects_viewport_(viewport_ptr.get(), change_ptr)) {
                 viewport_ptr->data_segment.capacity =
                         -1 * std::abs(viewport_ptr->data_segment.capacity);// indicate dirty read
+                invalidate_viewport_change_pages_(viewport_ptr.get(), change_ptr, viewport_offset);
                 omega_viewport_notify(viewport_ptr.get(),
-                                      (0 < omega_change_get_serial(change_ptr)) ? VIEWPORT_EVT_EDIT : VIEWPORT_EVT_UNDO,
+                                      (0 < omega_change_get_serial(change_ptr)) ? viewport_event : VIEWPORT_EVT_UNDO,
                                       change_ptr);
             }
         }
         return 0;
     }
 
-    inline auto clone_model_segment_(const omega_model_segment_ptr_t &segment_ptr) -> omega_model_segment_ptr_t {
-        auto result = std::make_unique<omega_model_segment_t>();
-        result->computed_offset = segment_ptr->computed_offset;
-        result->computed_length = segment_ptr->computed_length;
-        result->change_offset = segment_ptr->change_offset;
-        result->change_ptr = segment_ptr->change_ptr;
-        return result;
-    }
-
-    inline void free_model_changes_(omega_model_struct *model_ptr) {
-        for (const auto &change_ptr: model_ptr->changes) {
-            if (omega_change_get_kind(change_ptr.get()) != change_kind_t::CHANGE_DELETE) {
-                omega_data_destroy(&const_cast<omega_change_t *>(change_ptr.get())->data, change_ptr->length);
+    auto reset_model_segments_(omega_model_t *model_ptr) -> int {
+        if (model_ptr->is_logical_checkpoint || model_ptr->is_compacted) {
+            // Logical checkpoints start from the segments that were frozen when the checkpoint was created, and
+            // compacted models start from the segments their squashed changes left
+            model_ptr->model_segments.clear();
+            model_ptr->model_segments.reserve(model_ptr->base_segments.size());
+            for (const auto &segment_ptr: model_ptr->base_segments) {
+                model_ptr->model_segments.push_back(clone_model_segment_(segment_ptr));
             }
+            return 0;
         }
-        model_ptr->changes.clear();
+        int64_t length = 0;
+        if (model_ptr->file_ptr != nullptr) {
+            if (0 != FSEEK(model_ptr->file_ptr, 0L, SEEK_END)) { return -1; }
+            length = FTELL(model_ptr->file_ptr);
+        }
+        initialize_model_segments_(model_ptr->model_segments, length);
+        return 0;
     }
 
-    inline void free_model_changes_undone_(omega_model_struct *model_ptr) {
-        for (const auto &change_ptr: model_ptr->changes_undone) {
-            if (omega_change_get_kind(change_ptr.get()) != change_kind_t::CHANGE_DELETE) {
-                omega_data_destroy(&const_cast<omega_change_t *>(change_ptr.get())->data, change_ptr->length);
+    // Join neighboring segments that are consecutive bytes of the same change
+    void flatten_model_segments_(omega_model_segments_t &model_segments) {
+        if (model_segments.empty()) { return; }
+        auto last = model_segments.begin();
+        for (auto iter = std::next(last); iter != model_segments.end(); ++iter) {
+            if ((*iter)->change_ptr == (*last)->change_ptr &&
+                (*iter)->change_offset == (*last)->change_offset + (*last)->computed_length) {
+                (*last)->computed_length += (*iter)->computed_length;
+            } else {
+                *++last = std::move(*iter);
             }
         }
-        model_ptr->changes_undone.clear();
+        model_segments.erase(std::next(last), model_segments.end());
     }
 
+    // The bytes of a change are freed along with the change, once no model segment refers to it
+    inline void free_model_changes_(omega_model_struct *model_ptr) { model_ptr->changes.clear(); }
+
+    inline void free_model_changes_undone_(omega_model_struct *model_ptr) { model_ptr->changes_undone.clear(); }
+
     inline void free_session_changes_(const omega_session_t *session_ptr) {
         for (auto &&model_ptr: session_ptr->models_) { free_model_changes_(model_ptr.get()); }
     }
 
-    inline void free_session_changes_undone_(const omega_session_t *session_ptr) {
-        for (auto &&model_ptr: session_ptr->models_) { free_model_changes_undone_(model_ptr.get()); }
+    inline void discard_model_changes_undone_(omega_session_t *session_ptr, omega_model_struct *model_ptr) {
+        for (const auto &change_ptr: model_ptr->changes_undone) {
+            session_ptr->history_memory_ -= change_history_memory_(change_ptr.get());
+            session_ptr->resident_payload_bytes_ -= change_resident_payload_bytes_(change_ptr.get());
+        }
+        free_model_changes_undone_(model_ptr);
+    }
+
+    inline void free_session_changes_undone_(omega_session_t *session_ptr) {
+        for (auto &&model_ptr: session_ptr->models_) { discard_model_changes_undone_(session_ptr, model_ptr.get()); }
     }
 
 /* --------------------------------------------------------------------------------------------------------------------
@@ -312,19 +446,154 @@ namespace {
         return update_model_helper_(model_ptr, change_ptr);
     }
 
-    auto update_(omega_session_t *session_ptr, const const_omega_change_ptr_t &change_ptr) -> int64_t {
+    inline auto change_removed_length_(const omega_change_t *change_ptr, int64_t computed_file_size) -> int64_t {
+        switch (omega_change_get_kind(change_ptr)) {
+            case change_kind_t::CHANGE_DELETE:
+                return change_ptr->length;
+            case change_kind_t::CHANGE_INSERT:
+                return 0;
+            case change_kind_t::CHANGE_OVERWRITE:
+                // OVERWRITE changes can extend past the end of the session
+                return std::min(change_ptr->length, computed_file_size - change_ptr->offset);
+            default:
+                ABORT(LOG_ERROR("Unhandled change kind"););
+        }
+    }
+
+    /*
+     * Get the last change of the session if the given new change can be coalesced into it, or nullptr otherwise.  The
+     * new change must be of the same kind and continue the last change, and be in the same transaction as the last
+     * change, or outside any transaction with the last change not part of a transaction either.  Whole changes
+     * (transforms and bit shifts) are never coalesced, in either direction.
+     */
+    auto coalescing_target_(const omega_session_t *session_ptr, const omega_change_t *change_ptr)
+            -> const_omega_change_ptr_t {
+        const auto &changes = session_ptr->models_.back()->changes;
+        if (0 == omega_session_get_change_coalescing(session_ptr) || changes.empty()) { return nullptr; }
+        const auto &last_change_ptr = changes.back();
+        if (omega_change_is_whole_(change_ptr) || omega_change_is_whole_(last_change_ptr.get())) { return nullptr; }
+        const auto kind = omega_change_get_kind(change_ptr);
+        if (kind != omega_change_get_kind(last_change_ptr.get())) { return nullptr; }
+        if (omega_change_get_transaction_bit_(change_ptr) != omega_change_get_transaction_bit_(last_change_ptr.get())) {
+            const auto last_change_in_transaction =
+                    1 < changes.size() && omega_change_get_transaction_bit_(last_change_ptr.get()) ==
+                                                  omega_change_get_transaction_bit_(changes[changes.size() - 2].get());
+            if (0 != omega_session_get_transaction_state(session_ptr) || last_change_in_transaction) { return nullptr; }
+        }
+        switch (kind) {
+            case change_kind_t::CHANGE_DELETE:
+                // Deleting forward from the same offset, or backward from just before it
+                return (change_ptr->offset == last_change_ptr->offset ||
+                        change_ptr->offset + change_ptr->length == last_change_ptr->offset)
+                       ? last_change_ptr
+                       : nullptr;
+            case change_kind_t::CHANGE_INSERT:// deliberate fall-through
+            case change_kind_t::CHANGE_OVERWRITE:
+                return (change_ptr->offset == last_change_ptr->offset + last_change_ptr->length &&
+                        last_change_ptr->length + change_ptr->length <= OMEGA_COALESCE_CHANGE_LENGTH_LIMIT)
+                       ? last_change_ptr
+                       : nullptr;
+            default:
+                ABORT(LOG_ERROR("Unhandled change kind"););
+        }
+    }
+
+    /*
+     * Model the given new change by merging it into the given last change of the session, which it continues.  The
+     * model is updated as if the new change were made, then the segment of the last change is handed to the merged
+     * change, so the model gains no segments.
+     */
+    auto coalesce_change_(omega_session_t *session_ptr, const const_omega_change_ptr_t &last_change_ptr,
+                          const const_omega_change_ptr_t &change_ptr) -> int {
+        auto *const model_ptr = session_ptr->models_.back().get();
+        const auto merged_change_ptr = std::make_shared<omega_change_t>();
+        merged_change_ptr->serial = last_change_ptr->serial;
+        merged_change_ptr->kind = last_change_ptr->kind & (OMEGA_CHANGE_KIND_MASK | OMEGA_CHANGE_TRANSACTION_BIT);
+        merged_change_ptr->offset = std::min(last_change_ptr->offset, change_ptr->offset);
+        merged_change_ptr->length = last_change_ptr->length + change_ptr->length;
+        if (change_kind_t::CHANGE_DELETE == omega_change_get_kind(change_ptr.get())) {
+            if (0 != update_model_helper_(model_ptr, change_ptr)) { return -1; }
+        } else {
+            const auto bytes = std::make_unique<omega_byte_t[]>(merged_change_ptr->length);
+            if (!read_change_bytes_(last_change_ptr.get(), 0, bytes.get(), last_change_ptr->length) ||
+                !read_change_bytes_(change_ptr.get(), 0, bytes.get() + last_change_ptr->length, change_ptr->length)) {
+                return -1;
+            }
+            set_payload_(session_ptr, merged_change_ptr.get(), bytes.get());
+            if (change_kind_t::CHANGE_OVERWRITE == omega_change_get_kind(change_ptr.get())) {
+                const_omega_change_ptr_t const_change_ptr = del_(0, change_ptr->offset, change_ptr->length,
+                                                                 !omega_session_get_transaction_bit_(session_ptr));
+                if (0 != update_model_helper_(model_ptr, const_change_ptr)) { return -1; }
+            }
+            // Nothing has changed the model since the last change, so its segment is whole and starts at its offset
+            auto &segments = model_ptr->model_segments;
+            auto iter = std::lower_bound(segments.begin(), segments.end(), last_change_ptr->offset,
+                                         [](const omega_model_segment_ptr_t &segment_ptr, int64_t offset) {
+                                             return segment_ptr->computed_offset < offset;
+                                         });
+            if (iter == segments.end() || (*iter)->change_ptr != last_change_ptr) { return -1; }
+            (*iter)->change_ptr = merged_change_ptr;
+            (*iter)->computed_length = merged_change_ptr->length;
+            for (++iter; iter != segments.end(); ++iter) { (*iter)->computed_offset += change_ptr->length; }
+        }
+        session_ptr->history_memory_ +=
+                change_history_memory_(merged_change_ptr.get()) - change_history_memory_(last_change_ptr.get());
+        session_ptr->resident_payload_bytes_ += change_resident_payload_bytes_(merged_change_ptr.get()) -
+                                                change_resident_payload_bytes_(last_change_ptr.get());
+        model_ptr->changes.back() = merged_change_ptr;
+        // Events carry the serial of the change the new change now belongs to
+        const_cast<omega_change_t *>(change_ptr.get())->serial = merged_change_ptr->serial;
+        return 0;
+    }
+
+    /*
+     * Make the given change and notify the session and its viewports with the given event (transforms that are made
+     * as changes keep notifying transform events).
+     */
+    auto update_(omega_session_t *session_ptr, const const_omega_change_ptr_t &change_ptr,
+                 omega_session_event_t session_event = SESSION_EVT_EDIT) -> int64_t {
         if (change_ptr->offset <= omega_session_get_computed_file_size(session_ptr)) {
-            if (omega_change_get_serial(change_ptr.get()) < 0) {
+            const_omega_change_ptr_t last_change_ptr;
+            const auto is_redo = omega_change_get_serial(change_ptr.get()) < 0;
+            if (is_redo) {
                 // This is a previously undone change that is being redone, so flip the serial number back to positive
                 const_cast<omega_change_t *>(change_ptr.get())->serial *= -1;
-            } else if (!session_ptr->models_.back()->changes_undone.empty()) {
-                // This is not a redo change, so any changes undone are now invalid and must be cleared
-                free_session_changes_undone_(session_ptr);
+            } else {
+                if (!session_ptr->models_.back()->changes_undone.empty()) {
+                    // This is not a redo change, so any changes undone are now invalid and must be cleared
+                    free_session_changes_undone_(session_ptr);
+                }
+                last_change_ptr = coalescing_target_(session_ptr, change_ptr.get());
+            }
+            // The bytes after the bytes removed by this change are not touched, so their profile remains the same
+            const auto computed_file_size = omega_session_get_computed_file_size(session_ptr);
+            const auto tail_length = computed_file_size - change_ptr->offset -
+                                     change_removed_length_(change_ptr.get(), computed_file_size);
+            omega_byte_frequency_profile_t window_profile;
+            const auto update_profile = omega_session_begin_tracked_profile_update_(session_ptr, change_ptr->offset,
+                                                                                   tail_length, &window_profile);
+            if (last_change_ptr) {
+                if (0 != coalesce_change_(session_ptr, last_change_ptr, change_ptr)) { return -1; }
+            } else {
+                session_ptr->models_.back()->changes.push_back(change_ptr);
+                // A redone change was already in the undo history
+                if (!is_redo) {
+                    session_ptr->history_memory_ += change_history_memory_(change_ptr.get());
+                    session_ptr->resident_payload_bytes_ += change_resident_payload_bytes_(change_ptr.get());
+                }
+                if (0 != update_model_(session_ptr, change_ptr)) { return -1; }
+            }
+            if (update_profile) {
+                omega_session_end_tracked_profile_update_(session_ptr, change_ptr->offset, tail_length,
+                                                          &window_profile);
+            }
+            if (SESSION_EVT_TRANSFORM == session_event) {
+                update_viewports_(session_ptr, change_ptr.get(), VIEWPORT_EVT_TRANSFORM);
+            } else {
+                update_viewports_(session_ptr, change_ptr.get());
             }
-            session_ptr->models_.back()->changes.push_back(change_ptr);
-            if (0 != update_model_(session_ptr, change_ptr)) { return -1; }
-            update_viewports_(session_ptr, change_ptr.get());
-            omega_session_notify(session_ptr, SESSION_EVT_EDIT, change_ptr.get());
+            omega_session_notify(session_ptr, session_event, change_ptr.get());
+            if (!is_redo && 0 != omega_session_enforce_history_limits_(session_ptr)) { return -1; }
             return omega_change_get_serial(change_ptr.get());
         }
         return -1;
@@ -349,6 +618,252 @@ namespace {
                 return false;
         }
     }
+
+    /*
+     * Insert or overwrite the given pattern repeated the given number of times.  Fills too short to be worth a fill
+     * change are made as ordinary changes.
+     */
+    int64_t edit_fill_(omega_session_t *session_ptr, change_kind_t kind, int64_t offset, const omega_byte_t *pattern,
+                       int64_t pattern_length, int64_t repeat_count) {
+        assert(session_ptr);
+        if (0 != omega_session_changes_paused(session_ptr) || !pattern || pattern_length <= 0 || repeat_count <= 0 ||
+            std::numeric_limits<int64_t>::max() / pattern_length < repeat_count ||
+            omega_session_get_computed_file_size(session_ptr) < offset) {
+            return 0;
+        }
+        const auto length = pattern_length * repeat_count;
+        const auto serial = 1 + omega_session_get_num_changes(session_ptr);
+        const auto transaction_bit = determine_change_transaction_bit_(session_ptr);
+        if (1 == repeat_count || length < DATA_T_SIZE) {
+            omega_byte_t bytes[DATA_T_SIZE];
+            if (1 < repeat_count) {
+                for (int64_t i = 0; i < length; ++i) { bytes[i] = pattern[i % pattern_length]; }
+                pattern = bytes;
+            }
+            return update_(session_ptr, change_kind_t::CHANGE_INSERT == kind
+                                                ? ins_(session_ptr, serial, offset, pattern, length, transaction_bit)
+                                                : ovr_(session_ptr, serial, offset, pattern, length, transaction_bit));
+        }
+        return update_(session_ptr, fill_(serial, kind, offset, pattern, pattern_length, length, transaction_bit));
+    }
+
+    auto create_checkpoint_(omega_session_t *session_ptr, bool materialize) -> int {
+        const auto *const last_model_ptr = session_ptr->models_.back().get();
+        auto model_ptr = std::make_unique<omega_model_t>();
+        if (materialize) {
+            // A materialized checkpoint saves the computed file and starts a new model on it
+            const auto *const checkpoint_directory = omega_session_get_checkpoint_directory(session_ptr);
+            // make sure the checkpoint directory exists
+            if (omega_util_directory_exists(checkpoint_directory) == 0) {
+                LOG_ERROR("checkpoint directory '" << checkpoint_directory << "' does not exist");
+            }
+            char checkpoint_filename[FILENAME_MAX];
+            if (FILENAME_MAX <= snprintf(checkpoint_filename, FILENAME_MAX, "%s%c.OmegaEdit-chk.%zu.XXXXXX",
+                                         checkpoint_directory, omega_util_directory_separator(),
+                                         session_ptr->models_.size())) {
+                LOG_ERROR("failed to create checkpoint filename template");
+                return -1;
+            }
+            const auto checkpoint_fd = omega_util_mkstemp(checkpoint_filename, 0600);// S_IRUSR | S_IWUSR
+            close(checkpoint_fd);
+            if (0 != omega_edit_save(session_ptr, checkpoint_filename, IO_FLG_OVERWRITE, nullptr)) {
+                LOG_ERROR("failed to save checkpoint to '" << checkpoint_filename << "'");
+                return -1;
+            }
+            if ((model_ptr->file_ptr = FOPEN(checkpoint_filename, "rb")) == nullptr) {
+                LOG_ERROR("failed to open checkpoint '" << checkpoint_filename << "'");
+                omega_util_remove_file(checkpoint_filename);
+                return -1;
+            }
+            model_ptr->file_path = checkpoint_filename;
+            initialize_model_segments_(model_ptr->model_segments, omega_session_get_computed_file_size(session_ptr));
+        } else {
+            // A logical checkpoint freezes the current model segments, sharing the file and the changes they refer to
+            model_ptr->is_logical_checkpoint = true;
+            model_ptr->file_ptr = last_model_ptr->file_ptr;
+            model_ptr->file_path = last_model_ptr->file_path;
+            model_ptr->base_segments.reserve(last_model_ptr->model_segments.size());
+            for (const auto &segment_ptr: last_model_ptr->model_segments) {
+                model_ptr->base_segments.push_back(clone_model_segment_(segment_ptr));
+            }
+            reset_model_segments_(model_ptr.get());
+        }
+        model_ptr->num_changes_adjustment = session_ptr->num_changes_adjustment_;
+        session_ptr->num_changes_adjustment_ = omega_session_get_num_changes(session_ptr);
+        session_ptr->models_.push_back(std::move(model_ptr));
+        omega_session_notify(session_ptr, SESSION_EVT_CREATE_CHECKPOINT, nullptr);
+        return 0;
+    }
+
+    /*
+     * Record an OVERWRITE change of the given range, whose payload is produced by fill(bytes, produced, count) writing
+     * the count payload bytes that follow the first produced payload bytes.  A compressed payload is produced and
+     * compressed a piece at a time, so the uncompressed payload is never held in memory.  The change is a whole change,
+     * so it is never coalesced with the changes around it.
+     */
+    template<typename FillFn>
+    auto record_streamed_overwrite_(omega_session_t *session_ptr, int64_t offset, int64_t length, bool compress,
+                                    FillFn &&fill, omega_session_event_t session_event = SESSION_EVT_EDIT)
+            -> int64_t {
+        const auto change_ptr = std::make_shared<omega_change_t>();
+        change_ptr->kind = OMEGA_CHANGE_WHOLE_BIT | (uint8_t) change_kind_t::CHANGE_OVERWRITE;
+        change_ptr->offset = offset;
+        change_ptr->length = length;
+        if (compress) {
+            compressed_data_builder_t builder(length);
+            const auto piece_capacity = std::min(length, OMEGA_COMPRESSION_STREAM_SIZE);
+            const auto piece = std::make_unique<omega_byte_t[]>(piece_capacity);
+            for (int64_t produced = 0; produced < length; produced += piece_capacity) {
+                const auto count = std::min(length - produced, piece_capacity);
+                if (!fill(piece.get(), produced, count)) { return 0; }
+                builder.append(piece.get(), count);
+            }
+            set_compressed_payload_(session_ptr, change_ptr.get(), builder.finish());
+        } else if (auto *const spilled = allocate_spilled_payload_(session_ptr, length, length + 1)) {
+            // The payload is produced straight into the payload store
+            spilled[length] = '\0';
+            change_ptr->data.bytes_ptr = spilled;
+            change_ptr->kind |= OMEGA_CHANGE_SPILLED_BIT;
+            if (!fill(spilled, 0, length)) { return 0; }
+        } else {
+            omega_data_create(&change_ptr->data, length);
+            if (!fill(omega_data_get_data(&change_ptr->data, length), 0, length)) { return 0; }
+        }
+        change_ptr->serial = 1 + omega_session_get_num_changes(session_ptr);
+        if (determine_change_transaction_bit_(session_ptr)) { change_ptr->kind |= OMEGA_CHANGE_TRANSACTION_BIT; }
+        const auto serial = update_(session_ptr, change_ptr, session_event);
+        return (0 < serial) ? serial : 0;
+    }
+
+    auto apply_transform_(omega_session_t *session_ptr, const omega_transform_t *transform_ptr, int64_t offset,
+                          int64_t length, int num_threads) -> int {
+        assert(session_ptr);
+        assert(transform_ptr);
+        if (omega_session_changes_paused(session_ptr) != 0) { return -1; }
+        const auto computed_file_size = omega_session_get_computed_file_size(session_ptr);
+        const auto transform_length = (0 == length) ? computed_file_size - offset : length;
+        if (offset < 0 || transform_length < 1 || computed_file_size < offset + transform_length) {
+            LOG_ERROR("transform out of range");
+            return -1;
+        }
+        // A range too large for a change is still recorded as a compressed change if rewriting the model file into a
+        // checkpoint would exceed the checkpoint disk budget
+        const auto checkpoint_disk_budget = omega_session_get_checkpoint_disk_budget(session_ptr);
+        const auto over_disk_budget =
+                OMEGA_TRANSFORM_CHANGE_LENGTH_LIMIT < transform_length && 0 <= checkpoint_disk_budget &&
+                checkpoint_disk_budget < omega_session_get_checkpoint_disk_usage(session_ptr) + computed_file_size;
+        if (transform_length <= OMEGA_TRANSFORM_CHANGE_LENGTH_LIMIT || over_disk_budget) {
+            // The transformed range becomes an OVERWRITE change, so the cost is proportional to the range and the
+            // transform can be undone like any other change
+            const auto compress = over_disk_budget || compress_payload_(session_ptr, transform_length);
+            const auto transform_bytes = [&](omega_byte_t *bytes, int64_t produced, int64_t count) {
+                if (populate_buffer_(session_ptr, offset + produced, bytes, count) != count) { return false; }
+                omega_transform_apply_parallel(transform_ptr, bytes, count, produced, num_threads);
+                return true;
+            };
+            return (0 < record_streamed_overwrite_(session_ptr, offset, transform_length, compress, transform_bytes,
+                                                   SESSION_EVT_TRANSFORM))
+                           ? 0
+                           : -1;
+        }
+        // The model file is transformed in place, so it must not be shared with a logical checkpoint
+        if (0 == create_checkpoint_(session_ptr, true)) {
+            const auto in_file = session_ptr->models_.back()->file_path;
+            const auto out_file = in_file + "_";
+            // The transformed bytes are replaced in place, so only their profile changes
+            const auto tail_length =
+                    (0 == length) ? 0 : std::max(computed_file_size - offset - length, static_cast<int64_t>(0));
+            omega_byte_frequency_profile_t window_profile;
+            const auto update_profile =
+                    omega_session_begin_tracked_profile_update_(session_ptr, offset, tail_length, &window_profile);
+            if (0 == omega_transform_apply_to_file(transform_ptr, in_file.c_str(), out_file.c_str(), offset, length,
+                                                   num_threads)) {
+                errno = 0;// reset errno
+                if (0 == FCLOSE(session_ptr->models_.back()->file_ptr) && 0 == omega_util_remove_file(in_file.c_str()) &&
+                    0 == rename(out_file.c_str(), in_file.c_str()) &&
+                    ((session_ptr->models_.back()->file_ptr = FOPEN(in_file.c_str(), "rb")) != nullptr)) {
+                    invalidate_block_summaries_(session_ptr->models_.back().get());
+                    if (update_profile) {
+                        omega_session_end_tracked_profile_update_(session_ptr, offset, tail_length, &window_profile);
+                    }
+                    for (const auto &viewport_ptr: session_ptr->viewports_) {
+                        viewport_ptr->data_segment.capacity =
+                                -1 * std::abs(viewport_ptr->data_segment.capacity);// indicate dirty read
+                        invalidate_viewport_pages_(viewport_ptr.get(),
+                                                   offset - omega_viewport_get_offset(viewport_ptr.get()),
+                                                   (0 == length) ? -1 : length);
+                        omega_viewport_notify(viewport_ptr.get(), VIEWPORT_EVT_TRANSFORM, nullptr);
+                    }
+                    omega_session_notify(session_ptr, SESSION_EVT_TRANSFORM, nullptr);
+                    return 0;
+                }
+
+                // In a bad state (I/O failure), so abort
+                ABORT(LOG_ERRNO(););
+            }
+            // The transform failed, but we can recover from this
+            if (omega_util_file_exists(out_file.c_str()) != 0) { omega_util_remove_file(out_file.c_str()); }
+        }
+        return -1;
+    }
+
+    /*
+     * Read the bytes of the shift source at [start, start + count), relative to the start of the range being shifted.
+     * Bytes outside of the range are the fill byte.
+     */
+    auto read_shift_source_(const omega_session_t *session_ptr, int64_t offset, int64_t length, int64_t start,
+                            omega_byte_t *buffer, int64_t count, omega_byte_t fill_byte) -> bool {
+        const auto begin = std::max(start, static_cast<int64_t>(0));
+        const auto end = std::min(start + count, length);
+        if (end <= begin) {
+            memset(buffer, fill_byte, count);
+            return true;
+        }
+        memset(buffer, fill_byte, begin - start);
+        memset(buffer + (end - start), fill_byte, start + count - end);
+        return populate_buffer_(session_ptr, offset + begin, buffer + (begin - start), end - begin) == end - begin;
+    }
+
+    auto shift_bits_(omega_session_t *session_ptr, int64_t offset, int64_t length, int64_t shift, int fill_bit,
+                     bool left) -> int64_t {
+        assert(session_ptr);
+        if (omega_session_changes_paused(session_ptr) != 0) { return 0; }
+        const auto computed_file_size = omega_session_get_computed_file_size(session_ptr);
+        const auto shift_length = (0 == length) ? computed_file_size - offset : length;
+        if (offset < 0 || shift_length < 1 || computed_file_size < offset + shift_length) {
+            LOG_ERROR("shift out of range");
+            return 0;
+        }
+        if (shift < 1 || (fill_bit != 0 && fill_bit != 1)) {
+            LOG_ERROR("invalid shift");
+            return 0;
+        }
+        const auto fill_byte = static_cast<omega_byte_t>(fill_bit ? 0xFF : 0x00);
+        // Whole bytes of the shift move the source window, the remaining bits are shifted by the kernels
+        const auto byte_shift = std::min(shift / 8, shift_length);
+        const auto bit_shift = static_cast<int>(shift % 8);
+        const auto block_capacity = std::min(shift_length, static_cast<int64_t>(OMEGA_SHIFT_BITS_BLOCK_SIZE));
+        // Each block of shifted bytes needs one more source byte to carry bits in from
+        const auto source = std::make_unique<omega_byte_t[]>(block_capacity + 1);
+        return record_streamed_overwrite_(
+                session_ptr, offset, shift_length, compress_payload_(session_ptr, shift_length),
+                [&](omega_byte_t *bytes, int64_t produced, int64_t count) {
+                    for (int64_t shifted = 0; shifted < count; shifted += block_capacity) {
+                        const auto block_length = std::min(count - shifted, block_capacity);
+                        const auto start = left ? produced + shifted + byte_shift : produced + shifted - byte_shift - 1;
+                        if (!read_shift_source_(session_ptr, offset, shift_length, start, source.get(),
+                                                block_length + 1, fill_byte)) {
+                            return false;
+                        }
+                        if (left) {
+                            shift_bits_left_(source.get(), bytes + shifted, block_length, bit_shift);
+                        } else {
+                            shift_bits_right_(source.get(), bytes + shifted, block_length, bit_shift);
+                        }
+                    }
+                    return true;
+                });
+    }
 }
 
 omega_session_t *omega_edit_create_session(const char *file_path, omega_session_event_cbk_t cbk, void *user_data_ptr,
@@ -434,7 +949,7 @@ void omega_edit_destroy_session(omega_session_t *session_ptr) {
     assert(session_ptr);
     // Close all open files in the models
     for (const auto &model_ptr: session_ptr->models_) {
-        if (model_ptr->file_ptr) { FCLOSE(model_ptr->file_ptr); }
+        if (model_ptr->file_ptr && !model_ptr->is_logical_checkpoint) { FCLOSE(model_ptr->file_ptr); }
     }
     // Destroy all search contexts
     while (!session_ptr->search_contexts_.empty()) {
@@ -448,7 +963,10 @@ void omega_edit_destroy_session(omega_session_t *session_ptr) {
     free_session_changes_undone_(session_ptr);
     // Remove all checkpoint files
     while (omega_session_get_num_checkpoints(session_ptr) != 0) {
-        if (0 != omega_util_remove_file(session_ptr->models_.back()->file_path.c_str())) { LOG_ERRNO(); }
+        if (!session_ptr->models_.back()->is_logical_checkpoint &&
+            0 != omega_util_remove_file(session_ptr->models_.back()->file_path.c_str())) {
+            LOG_ERRNO();
+        }
         session_ptr->models_.pop_back();
     }
     // Remove the session checkpoint file if it exists
@@ -484,6 +1002,33 @@ omega_viewport_t *omega_edit_create_viewport(omega_session_t *session_ptr, int64
     return nullptr;
 }
 
+omega_viewport_t *omega_edit_create_paged_viewport(omega_session_t *session_ptr, int64_t offset, int64_t capacity,
+                                                   int64_t page_size, int is_floating, omega_viewport_event_cbk_t cbk,
+                                                   void *user_data_ptr, int32_t event_interest) {
+    if (0 == page_size) { page_size = OMEGA_VIEWPORT_PAGE_SIZE; }
+    if (capacity > 0 && capacity <= OMEGA_PAGED_VIEWPORT_CAPACITY_LIMIT && page_size > 0 &&
+        page_size <= OMEGA_VIEWPORT_CAPACITY_LIMIT) {
+        const auto viewport_ptr = std::make_shared<omega_viewport_t>();
+        viewport_ptr->session_ptr = session_ptr;
+        viewport_ptr->data_segment.offset = offset;
+        viewport_ptr->data_segment.offset_adjustment = 0;
+        viewport_ptr->data_segment.is_floating = (bool) is_floating;
+        viewport_ptr->data_segment.capacity = -1 * capacity;// Negative capacity indicates dirty read
+        viewport_ptr->data_segment.length = 0;
+        // Paged viewports do not allocate a contiguous data buffer, pages are allocated as they are populated
+        viewport_ptr->page_size_ = page_size;
+        viewport_ptr->pages_.resize((capacity + page_size - 1) / page_size);
+        viewport_ptr->event_handler = cbk;
+        viewport_ptr->user_data_ptr = user_data_ptr;
+        viewport_ptr->event_interest_ = event_interest;
+        session_ptr->viewports_.push_back(viewport_ptr);
+        omega_viewport_notify(viewport_ptr.get(), VIEWPORT_EVT_CREATE, session_ptr->viewports_.back().get());
+        omega_session_notify(session_ptr, SESSION_EVT_CREATE_VIEWPORT, session_ptr->viewports_.back().get());
+        return session_ptr->viewports_.back().get();
+    }
+    return nullptr;
+}
+
 void omega_edit_destroy_viewport(omega_viewport_t *viewport_ptr) {
     for (auto iter = viewport_ptr->session_ptr->viewports_.rbegin();
          iter != viewport_ptr->session_ptr->viewports_.rend(); ++iter) {
@@ -510,8 +1055,8 @@ int64_t omega_edit_insert_bytes(omega_session_t *session_ptr, int64_t offset, co
                                 int64_t length) {
     return (omega_session_changes_paused(session_ptr) == 0) && 0 <= length &&
            offset <= omega_session_get_computed_file_size(session_ptr)
-           ? update_(session_ptr, ins_(1 + omega_session_get_num_changes(session_ptr), offset, bytes, length,
-                                       determine_change_transaction_bit_(session_ptr)))
+           ? update_(session_ptr, ins_(session_ptr, 1 + omega_session_get_num_changes(session_ptr), offset, bytes,
+                                       length, determine_change_transaction_bit_(session_ptr)))
            : 0;
 }
 
@@ -523,8 +1068,8 @@ int64_t omega_edit_overwrite_bytes(omega_session_t *session_ptr, int64_t offset,
                                    int64_t length) {
     return (omega_session_changes_paused(session_ptr) == 0) && 0 <= length &&
            offset <= omega_session_get_computed_file_size(session_ptr)
-           ? update_(session_ptr, ovr_(1 + omega_session_get_num_changes(session_ptr), offset, bytes, length,
-                                       determine_change_transaction_bit_(session_ptr)))
+           ? update_(session_ptr, ovr_(session_ptr, 1 + omega_session_get_num_changes(session_ptr), offset, bytes,
+                                       length, determine_change_transaction_bit_(session_ptr)))
            : 0;
 }
 
@@ -532,33 +1077,39 @@ int64_t omega_edit_overwrite(omega_session_t *session_ptr, int64_t offset, const
     return omega_edit_overwrite_bytes(session_ptr, offset, (const omega_byte_t *) cstr, length);
 }
 
+int64_t omega_edit_insert_fill(omega_session_t *session_ptr, int64_t offset, const omega_byte_t *pattern,
+                               int64_t pattern_length, int64_t repeat_count) {
+    return edit_fill_(session_ptr, change_kind_t::CHANGE_INSERT, offset, pattern, pattern_length, repeat_count);
+}
+
+int64_t omega_edit_overwrite_fill(omega_session_t *session_ptr, int64_t offset, const omega_byte_t *pattern,
+                                  int64_t pattern_length, int64_t repeat_count) {
+    return edit_fill_(session_ptr, change_kind_t::CHANGE_OVERWRITE, offset, pattern, pattern_length, repeat_count);
+}
+
 int omega_edit_apply_transform(omega_session_t *session_ptr, omega_util_byte_transform_t transform, void *user_data_ptr,
                                int64_t offset, int64_t length) {
-    if ((omega_session_changes_paused(session_ptr) == 0) && 0 == omega_edit_create_checkpoint(session_ptr)) {
-        const auto in_file = session_ptr->models_.back()->file_path;
-        const auto out_file = in_file + "_";
-        if (0 == omega_util_apply_byte_transform_to_file(in_file.c_str(), out_file.c_str(), transform, user_data_ptr,
-                                                         offset, length)) {
-            errno = 0;// reset errno
-            if (0 == FCLOSE(session_ptr->models_.back()->file_ptr) && 0 == omega_util_remove_file(in_file.c_str()) &&
-                0 == rename(out_file.c_str(), in_file.c_str()) &&
-                ((session_ptr->models_.back()->file_ptr = FOPEN(in_file.c_str(), "rb")) != nullptr)) {
-                for (const auto &viewport_ptr: session_ptr->viewports_) {
-                    viewport_ptr->data_segment.capacity =
-                            -1 * std::abs(viewport_ptr->data_segment.capacity);// indicate dirty read
-                    omega_viewport_notify(viewport_ptr.get(), VIEWPORT_EVT_TRANSFORM, nullptr);
-                }
-                omega_session_notify(session_ptr, SESSION_EVT_TRANSFORM, nullptr);
-                return 0;
-            }
+    assert(transform);
+    omega_transform_t callback_transform;
+    callback_transform.kind = transform_kind_t::TRANSFORM_CALLBACK;
+    callback_transform.callback = transform;
+    callback_transform.user_data_ptr = user_data_ptr;
+    return apply_transform_(session_ptr, &callback_transform, offset, length, 1);
+}
 
-            // In a bad state (I/O failure), so abort
-            ABORT(LOG_ERRNO(););
-        }
-        // The transform failed, but we can recover from this
-        if (omega_util_file_exists(out_file.c_str()) != 0) { omega_util_remove_file(out_file.c_str()); }
-    }
-    return -1;
+int omega_edit_apply_transform_parallel(omega_session_t *session_ptr, const omega_transform_t *transform_ptr,
+                                        int64_t offset, int64_t length, int num_threads) {
+    return apply_transform_(session_ptr, transform_ptr, offset, length, num_threads);
+}
+
+int64_t omega_edit_left_shift_bits(omega_session_t *session_ptr, int64_t offset, int64_t length, int64_t shift_left,
+                                   int fill_bit) {
+    return shift_bits_(session_ptr, offset, length, shift_left, fill_bit, true);
+}
+
+int64_t omega_edit_right_shift_bits(omega_session_t *session_ptr, int64_t offset, int64_t length, int64_t shift_right,
+                                    int fill_bit) {
+    return shift_bits_(session_ptr, offset, length, shift_right, fill_bit, false);
 }
 
 int omega_edit_save_segment(omega_session_t *session_ptr, const char *file_path, int io_flags, char *saved_file_path,
@@ -663,9 +1214,11 @@ int omega_edit_save_segment(omega_session_t *session_ptr, const char *file_path,
                 break;
             }
             case model_segment_kind_t::SEGMENT_INSERT: {
-                if (static_cast<int64_t>(fwrite(omega_change_get_bytes(segment->change_ptr.get()) +
-                                                segment->change_offset + segment_start,
-                                                1, segment_length, temp_fptr)) != segment_length) {
+                if (!visit_change_bytes_(segment->change_ptr.get(), segment->change_offset + segment_start,
+                                         segment_length, [temp_fptr](const omega_byte_t *data, int64_t data_length) {
+                                             return static_cast<int64_t>(fwrite(data, 1, data_length, temp_fptr)) ==
+                                                    data_length;
+                                         })) {
                     FCLOSE(temp_fptr);
                     omega_util_remove_file(temp_filename);
                     LOG_ERROR("fwrite failed");
@@ -729,16 +1282,16 @@ int omega_edit_save(omega_session_t *session_ptr, const char *file_path, int io_
 }
 
 int omega_edit_clear_changes(omega_session_t *session_ptr) {
-    int64_t length = 0;
-    if (session_ptr->models_.front()->file_ptr != nullptr) {
-        if (0 != FSEEK(session_ptr->models_.front()->file_ptr, 0L, SEEK_END)) { return -1; }
-        length = FTELL(session_ptr->models_.front()->file_ptr);
-    }
-    initialize_model_segments_(session_ptr->models_.front()->model_segments, length);
+    if (0 != reset_model_segments_(session_ptr->models_.front().get())) { return -1; }
     free_session_changes_(session_ptr);
     free_session_changes_undone_(session_ptr);
+    session_ptr->history_memory_ = 0;
+    session_ptr->resident_payload_bytes_ = 0;
+    session_ptr->payload_intern_table_.purge();
+    omega_session_invalidate_tracked_profile_(session_ptr);
     for (const auto &viewport_ptr: session_ptr->viewports_) {
         viewport_ptr->data_segment.capacity = -1 * std::abs(viewport_ptr->data_segment.capacity);// indicate dirty read
+        invalidate_viewport_pages_(viewport_ptr.get(), 0, -1);
         omega_viewport_notify(viewport_ptr.get(), VIEWPORT_EVT_CLEAR, nullptr);
     }
     omega_session_notify(session_ptr, SESSION_EVT_CLEAR, nullptr);
@@ -749,15 +1302,21 @@ int64_t omega_edit_undo_last_change(omega_session_t *session_ptr) {
     if ((omega_session_changes_paused(session_ptr) == 0) && !session_ptr->models_.back()->changes.empty()) {
         const auto change_ptr = session_ptr->models_.back()->changes.back();
         session_ptr->models_.back()->changes.pop_back();
-        int64_t length = 0;
-        if (session_ptr->models_.back()->file_ptr != nullptr) {
-            if (0 != FSEEK(session_ptr->models_.back()->file_ptr, 0L, SEEK_END)) { return -1; }
-            length = FTELL(session_ptr->models_.back()->file_ptr);
-        }
-        initialize_model_segments_(session_ptr->models_.back()->model_segments, length);
+        // The bytes after the bytes added by this change are not touched, so their profile remains the same
+        const auto tail_length = omega_session_get_computed_file_size(session_ptr) - change_ptr->offset -
+                                 ((change_kind_t::CHANGE_DELETE == omega_change_get_kind(change_ptr.get()))
+                                          ? 0
+                                          : change_ptr->length);
+        omega_byte_frequency_profile_t window_profile;
+        const auto update_profile = omega_session_begin_tracked_profile_update_(session_ptr, change_ptr->offset,
+                                                                               tail_length, &window_profile);
+        if (0 != reset_model_segments_(session_ptr->models_.back().get())) { return -1; }
         for (const auto &change: session_ptr->models_.back()->changes) {
             if (0 > update_model_(session_ptr, change)) { return -1; }
         }
+        if (update_profile) {
+            omega_session_end_tracked_profile_update_(session_ptr, change_ptr->offset, tail_length, &window_profile);
+        }
 
         // Negate the undone change's serial number to indicate that the change has been undone
         auto *const undone_change_ptr = const_cast<omega_change_t *>(change_ptr.get());
@@ -795,43 +1354,78 @@ int64_t omega_edit_redo_last_undo(omega_session_t *session_ptr) {
     return rc;
 }
 
-int omega_edit_create_checkpoint(omega_session_t *session_ptr) {
-    const auto *const checkpoint_directory = omega_session_get_checkpoint_directory(session_ptr);
-    // make sure the checkpoint directory exists
-    if (omega_util_directory_exists(checkpoint_directory) == 0) {
-        LOG_ERROR("checkpoint directory '" << checkpoint_directory << "' does not exist");
-    }
-    char checkpoint_filename[FILENAME_MAX];
-    if (FILENAME_MAX <= snprintf(checkpoint_filename, FILENAME_MAX, "%s%c.OmegaEdit-chk.%zu.XXXXXX",
-                                 checkpoint_directory, omega_util_directory_separator(), session_ptr->models_.size())) {
-        LOG_ERROR("failed to create checkpoint filename template");
+int64_t omega_edit_discard_undone_changes(omega_session_t *session_ptr) {
+    assert(session_ptr);
+    if (omega_session_changes_paused(session_ptr) != 0) { return -1; }
+    auto *const model_ptr = session_ptr->models_.back().get();
+    const auto num_discarded = static_cast<int64_t>(model_ptr->changes_undone.size());
+    discard_model_changes_undone_(session_ptr, model_ptr);
+    return num_discarded;
+}
+
+int omega_session_compact(omega_session_t *session_ptr, int64_t serial) {
+    assert(session_ptr);
+    if (0 != omega_session_changes_paused(session_ptr) || 0 != omega_session_get_transaction_state(session_ptr) ||
+        serial < 0 || omega_session_get_num_changes(session_ptr) < serial) {
         return -1;
     }
-    const auto checkpoint_fd = omega_util_mkstemp(checkpoint_filename, 0600);// S_IRUSR | S_IWUSR
-    close(checkpoint_fd);
-    if (0 != omega_edit_save(session_ptr, checkpoint_filename, IO_FLG_OVERWRITE, nullptr)) {
-        LOG_ERROR("failed to save checkpoint to '" << checkpoint_filename << "'");
-        return -1;
+    auto *const model_ptr = session_ptr->models_.back().get();
+    auto &changes = model_ptr->changes;
+    const auto num_squashed = serial - session_ptr->num_changes_adjustment_;
+    if (num_squashed <= 0) { return 0; }
+    // Model the squashed changes, and start the model from the flattened result
+    if (0 != reset_model_segments_(model_ptr)) { return -1; }
+    for (int64_t i = 0; i < num_squashed; ++i) {
+        if (0 != update_model_(session_ptr, changes[i])) { return -1; }
+    }
+    flatten_model_segments_(model_ptr->model_segments);
+    model_ptr->base_segments = std::move(model_ptr->model_segments);
+    model_ptr->is_compacted = true;
+    for (int64_t i = 0; i < num_squashed; ++i) {
+        session_ptr->resident_payload_bytes_ -= change_resident_payload_bytes_(changes[i].get());
+    }
+    changes.erase(changes.begin(), changes.begin() + num_squashed);
+    session_ptr->num_changes_adjustment_ += num_squashed;
+    session_ptr->num_folded_changes_ += num_squashed;
+    // Release the payloads of the squashed changes that nothing refers to anymore
+    session_ptr->payload_intern_table_.purge();
+    omega_session_recompute_history_memory_(session_ptr);
+    // Model the changes that remain on top of it
+    if (0 != reset_model_segments_(model_ptr)) { return -1; }
+    for (const auto &change_ptr: changes) {
+        if (0 != update_model_(session_ptr, change_ptr)) { return -1; }
     }
-    const auto file_size = omega_session_get_computed_file_size(session_ptr);
-    session_ptr->num_changes_adjustment_ = omega_session_get_num_changes(session_ptr);
-    session_ptr->models_.push_back(std::make_unique<omega_model_t>());
-    session_ptr->models_.back()->file_ptr = FOPEN(checkpoint_filename, "rb");
-    session_ptr->models_.back()->file_path = checkpoint_filename;
-    initialize_model_segments_(session_ptr->models_.back()->model_segments, file_size);
-    omega_session_notify(session_ptr, SESSION_EVT_CREATE_CHECKPOINT, nullptr);
     return 0;
 }
 
+int omega_edit_create_checkpoint(omega_session_t *session_ptr) { return create_checkpoint_(session_ptr, false); }
+
 int omega_edit_destroy_last_checkpoint(omega_session_t *session_ptr) {
     if (omega_session_get_num_checkpoints(session_ptr) > 0) {
         auto *const last_checkpoint_ptr = session_ptr->models_.back().get();
-        FCLOSE(last_checkpoint_ptr->file_ptr);
-        if (0 != omega_util_remove_file(last_checkpoint_ptr->file_path.c_str())) { LOG_ERRNO(); }
+        // Logical checkpoints share the file of the model below them
+        if (!last_checkpoint_ptr->is_logical_checkpoint) {
+            FCLOSE(last_checkpoint_ptr->file_ptr);
+            if (0 != omega_util_remove_file(last_checkpoint_ptr->file_path.c_str())) { LOG_ERRNO(); }
+        }
+        for (const auto *changes: {&last_checkpoint_ptr->changes, &last_checkpoint_ptr->changes_undone}) {
+            for (const auto &change_ptr: *changes) {
+                session_ptr->resident_payload_bytes_ -= change_resident_payload_bytes_(change_ptr.get());
+            }
+        }
         free_model_changes_(last_checkpoint_ptr);
         free_model_changes_undone_(last_checkpoint_ptr);
-        session_ptr->num_changes_adjustment_ -= (int64_t) session_ptr->models_.back()->changes.size();
+        // The adjustment goes back to what it was when the checkpoint was created, which also covers the changes of the
+        // model that is now current that were squashed when it was compacted
+        session_ptr->num_changes_adjustment_ = last_checkpoint_ptr->num_changes_adjustment;
         session_ptr->models_.pop_back();
+        omega_session_recompute_history_memory_(session_ptr);
+        omega_session_invalidate_tracked_profile_(session_ptr);
+        for (const auto &viewport_ptr: session_ptr->viewports_) {
+            viewport_ptr->data_segment.capacity =
+                    -1 * std::abs(viewport_ptr->data_segment.capacity);// indicate dirty read
+            invalidate_viewport_pages_(viewport_ptr.get(), 0, -1);
+        }
         omega_session_notify(session_ptr, SESSION_EVT_DESTROY_CHECKPOINT, nullptr);
         return 0;
     }
@@ -0,0 +1,51 @@
+/**********************************************************************************************************************
+ * Copyright (c) 2021 Concurrent Technologies Corporation.                                                            *
+ *                                                                                                                    *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance     *
+ * with the License.  You may obtain a copy of the License at                                                         *
+ *                                                                                                                    *
+ *     http://www.apache.org/licenses/LICENSE-2.0                                                                     *
+ *                                                                                                                    *
+ * Unless required by applicable law or agreed to in writing, software is distributed under the License is            *
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or                   *
+ * implied.  See the License for the specific language governing permissions and limitations under the License.       *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+
+#ifndef OMEGA_EDIT_BLOCK_SUMMARY_DEF_HPP
+#define OMEGA_EDIT_BLOCK_SUMMARY_DEF_HPP
+
+#include "../../include/omega_edit/byte.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * Summary of a block of a model file.  Blocks are OMEGA_SUMMARY_BLOCK_SIZE bytes, except for the last block of the file.
+ */
+struct omega_block_summary_struct {
+    uint32_t byte_counts[256]{};  ///< Frequency of each byte value in the block
+    uint32_t dos_eol_count{};     ///< Number of DOS end-of-line (CR LF) pairs entirely within the block
+    omega_byte_t first_bytes[4]{};///< First bytes of the block (fewer if the block is shorter)
+    omega_byte_t last_byte{};     ///< Last byte of the block
+    bool has_utf8_counts{};       ///< True if the UTF-8 counts are available for this block
+    uint8_t utf8_start{};         ///< Number of UTF-8 continuation bytes at the start of the block
+    uint8_t next_utf8_start{};    ///< Number of UTF-8 continuation bytes at the start of the next block
+    uint32_t utf8_counts[5]{};    ///< Single, double, triple, quad byte character and invalid byte counts
+                                  ///< from utf8_start to the end of the block plus next_utf8_start
+};
+
+using omega_block_summary_t = struct omega_block_summary_struct;
+using omega_block_summary_ptr_t = std::unique_ptr<omega_block_summary_t>;
+
+/**
+ * Lazily built block summaries of a model file
+ */
+struct omega_block_summaries_struct {
+    int64_t file_length{-1};                        ///< Length of the summarized file, negative if not yet known
+    std::vector<omega_block_summary_ptr_t> blocks{};///< Block summaries, null until the block is summarized
+};
+
+using omega_block_summaries_t = struct omega_block_summaries_struct;
+
+#endif//OMEGA_EDIT_BLOCK_SUMMARY_DEF_HPP
@@ -17,20 +17,52 @@
 
 #include "../../include/omega_edit/fwd_defs.h"
 #include "data_def.hpp"
+#include "payload_intern.hpp"
 #include <cstdint>
+#include <cstring>
 
 enum class change_kind_t {
     CHANGE_DELETE = 0, CHANGE_INSERT = 1, CHANGE_OVERWRITE = 2
 };
 #define OMEGA_CHANGE_KIND_MASK 0x03
 #define OMEGA_CHANGE_TRANSACTION_BIT 0x04
+#define OMEGA_CHANGE_COMPRESSED_BIT 0x08
+#define OMEGA_CHANGE_SPILLED_BIT 0x10
+#define OMEGA_CHANGE_INTERNED_BIT 0x20
+#define OMEGA_CHANGE_FILL_BIT 0x40
+#define OMEGA_CHANGE_WHOLE_BIT 0x80
+
+/**
+ * Release the decoded copy of the payload of the given compressed, spilled, or fill change, if it has one
+ * @param change_ptr change whose decoded payload to release
+ */
+void release_decoded_payload_(const omega_change_t *change_ptr) noexcept;
 
 struct omega_change_struct {
     int64_t serial{};   ///< Serial number of the change (increasing)
     uint8_t kind{};     ///< Change kind
     int64_t offset{};   ///< Offset at the time of the change
     int64_t length{};   ///< Number of bytes at the time of the change
-    omega_data_t data{};///< Bytes to insert or overwrite
+    omega_data_t data{};///< Bytes to insert or overwrite (see the compressed, spilled, interned, and fill bits)
+
+    // The bytes live as long as the change, so model segments that share the change (including the frozen segments of
+    // logical checkpoints) can outlive the model the change was made in.  Spilled bytes belong to the payload store,
+    // and interned bytes are shared with the other changes that have the same payload.
+    ~omega_change_struct() {
+        if (kind & (OMEGA_CHANGE_COMPRESSED_BIT | OMEGA_CHANGE_SPILLED_BIT | OMEGA_CHANGE_FILL_BIT)) {
+            release_decoded_payload_(this);
+        }
+        if (change_kind_t::CHANGE_DELETE == static_cast<change_kind_t>(kind & OMEGA_CHANGE_KIND_MASK) ||
+            (kind & OMEGA_CHANGE_SPILLED_BIT)) {
+            return;
+        }
+        if (kind & OMEGA_CHANGE_INTERNED_BIT) {
+            release_interned_payload_(data.bytes_ptr);
+            data.bytes_ptr = nullptr;
+        } else {
+            omega_data_destroy(&data, length);
+        }
+    }
 };
 
 /**
@@ -46,6 +78,36 @@ inline bool omega_change_get_transaction_bit_(const omega_change_t *change_ptr)
     return change_ptr->kind & OMEGA_CHANGE_TRANSACTION_BIT;
 }
 
+inline bool omega_change_is_compressed_(const omega_change_t *change_ptr) {
+    return change_ptr->kind & OMEGA_CHANGE_COMPRESSED_BIT;
+}
+
+inline bool omega_change_is_spilled_(const omega_change_t *change_ptr) {
+    return change_ptr->kind & OMEGA_CHANGE_SPILLED_BIT;
+}
+
+inline bool omega_change_is_interned_(const omega_change_t *change_ptr) {
+    return change_ptr->kind & OMEGA_CHANGE_INTERNED_BIT;
+}
+
+inline bool omega_change_is_fill_(const omega_change_t *change_ptr) { return change_ptr->kind & OMEGA_CHANGE_FILL_BIT; }
+
+// Whole changes (transforms and bit shifts) are undone on their own, so they are never coalesced with other changes
+inline bool omega_change_is_whole_(const omega_change_t *change_ptr) {
+    return change_ptr->kind & OMEGA_CHANGE_WHOLE_BIT;
+}
+
+// A fill payload is the length of its pattern followed by the pattern, which repeats for the length of the change
+inline int64_t omega_change_get_fill_pattern_length_(const omega_change_t *change_ptr) {
+    int64_t pattern_length;
+    memcpy(&pattern_length, change_ptr->data.bytes_ptr, sizeof(pattern_length));
+    return pattern_length;
+}
+
+inline const omega_byte_t *omega_change_get_fill_pattern_(const omega_change_t *change_ptr) {
+    return change_ptr->data.bytes_ptr + sizeof(int64_t);
+}
+
 inline void omega_change_toggle_transaction_bit(omega_change_t *change_ptr) {
     change_ptr->kind ^= OMEGA_CHANGE_TRANSACTION_BIT;// Toggle the transaction bit
 }
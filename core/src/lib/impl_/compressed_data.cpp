@@ -0,0 +1,136 @@
+/**********************************************************************************************************************
+ * Copyright (c) 2021 Concurrent Technologies Corporation.                                                            *
+ *                                                                                                                    *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance     *
+ * with the License.  You may obtain a copy of the License at                                                         *
+ *                                                                                                                    *
+ *     http://www.apache.org/licenses/LICENSE-2.0                                                                     *
+ *                                                                                                                    *
+ * Unless required by applicable law or agreed to in writing, software is distributed under the License is            *
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or                   *
+ * implied.  See the License for the specific language governing permissions and limitations under the License.       *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+
+#include "compressed_data.hpp"
+#include "../../include/omega_edit/config.h"
+#include "lz4_block.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace {
+    inline int64_t read_int64_(const omega_byte_t *ptr) {
+        int64_t value;
+        memcpy(&value, ptr, sizeof(value));
+        return value;
+    }
+
+    inline int64_t count_blocks_(int64_t length) {
+        return (length + OMEGA_COMPRESSION_BLOCK_SIZE - 1) / OMEGA_COMPRESSION_BLOCK_SIZE;
+    }
+
+    // The header is the uncompressed length followed by the block end offsets
+    inline int64_t header_size_(int64_t num_blocks) {
+        return static_cast<int64_t>(sizeof(int64_t)) * (1 + num_blocks);
+    }
+}// namespace
+
+compressed_data_builder_t::compressed_data_builder_t(int64_t length)
+    : length_(length), num_blocks_(count_blocks_(length)),
+      block_(std::make_unique<omega_byte_t[]>(OMEGA_COMPRESSION_BLOCK_SIZE)),
+      scratch_(std::make_unique<omega_byte_t[]>(lz4_compress_bound_(OMEGA_COMPRESSION_BLOCK_SIZE))) {
+    assert(0 <= length);
+    block_ends_.reserve(num_blocks_);
+}
+
+void compressed_data_builder_t::append(const omega_byte_t *bytes, int64_t count) {
+    assert(bytes || 0 == count);
+    while (0 < count) {
+        const auto amount = std::min(count, OMEGA_COMPRESSION_BLOCK_SIZE - block_length_);
+        memcpy(block_.get() + block_length_, bytes, amount);
+        block_length_ += amount;
+        bytes += amount;
+        count -= amount;
+        if (OMEGA_COMPRESSION_BLOCK_SIZE == block_length_) { flush_block_(); }
+    }
+}
+
+void compressed_data_builder_t::flush_block_() {
+    const auto compressed_length = lz4_compress_block_(block_.get(), block_length_, scratch_.get(),
+                                                       lz4_compress_bound_(OMEGA_COMPRESSION_BLOCK_SIZE));
+    // A block is only stored compressed if that makes it smaller, so blocks stored at full length are not compressed
+    if (0 < compressed_length && compressed_length < block_length_) {
+        blocks_.insert(blocks_.end(), scratch_.get(), scratch_.get() + compressed_length);
+    } else {
+        blocks_.insert(blocks_.end(), block_.get(), block_.get() + block_length_);
+    }
+    block_ends_.push_back(static_cast<int64_t>(blocks_.size()));
+    block_length_ = 0;
+}
+
+omega_byte_t *compressed_data_builder_t::finish() {
+    if (0 < block_length_) { flush_block_(); }
+    assert(static_cast<int64_t>(block_ends_.size()) == num_blocks_);
+    const auto header_size = header_size_(num_blocks_);
+    auto *const data = new omega_byte_t[header_size + blocks_.size()];
+    memcpy(data, &length_, sizeof(length_));
+    if (0 < num_blocks_) { memcpy(data + sizeof(length_), block_ends_.data(), sizeof(int64_t) * num_blocks_); }
+    if (!blocks_.empty()) { memcpy(data + header_size, blocks_.data(), blocks_.size()); }
+    return data;
+}
+
+omega_byte_t *compress_data_(const omega_byte_t *bytes, int64_t length) {
+    compressed_data_builder_t builder(length);
+    builder.append(bytes, length);
+    return builder.finish();
+}
+
+int64_t compressed_data_length_(const omega_byte_t *data) noexcept {
+    assert(data);
+    return read_int64_(data);
+}
+
+int64_t compressed_data_size_(const omega_byte_t *data) noexcept {
+    assert(data);
+    const auto num_blocks = count_blocks_(compressed_data_length_(data));
+    return header_size_(num_blocks) +
+           (0 < num_blocks ? read_int64_(data + sizeof(int64_t) * num_blocks) : static_cast<int64_t>(0));
+}
+
+bool read_compressed_data_(const omega_byte_t *data, int64_t offset, omega_byte_t *buffer, int64_t length) noexcept {
+    assert(data);
+    assert(buffer || 0 == length);
+    const auto data_length = compressed_data_length_(data);
+    if (offset < 0 || length < 0 || data_length - offset < length) { return false; }
+    const auto num_blocks = count_blocks_(data_length);
+    const auto *const blocks = data + header_size_(num_blocks);
+    std::unique_ptr<omega_byte_t[]> block;
+    while (0 < length) {
+        const auto block_index = offset / OMEGA_COMPRESSION_BLOCK_SIZE;
+        const auto block_offset = block_index * OMEGA_COMPRESSION_BLOCK_SIZE;
+        const auto block_length = std::min(data_length - block_offset, OMEGA_COMPRESSION_BLOCK_SIZE);
+        const auto block_begin = (0 < block_index) ? read_int64_(data + sizeof(int64_t) * block_index) : 0;
+        const auto block_end = read_int64_(data + sizeof(int64_t) * (1 + block_index));
+        const auto delta = offset - block_offset;
+        const auto amount = std::min(block_length - delta, length);
+        if (block_end - block_begin == block_length) {
+            memcpy(buffer, blocks + block_begin + delta, amount);
+        } else if (amount == block_length) {
+            // The whole block is wanted, so it is decompressed straight into the buffer
+            if (!lz4_decompress_block_(blocks + block_begin, block_end - block_begin, buffer, block_length)) {
+                return false;
+            }
+        } else {
+            if (!block) { block = std::make_unique<omega_byte_t[]>(OMEGA_COMPRESSION_BLOCK_SIZE); }
+            if (!lz4_decompress_block_(blocks + block_begin, block_end - block_begin, block.get(), block_length)) {
+                return false;
+            }
+            memcpy(buffer, block.get() + delta, amount);
+        }
+        buffer += amount;
+        offset += amount;
+        length -= amount;
+    }
+    return true;
+}
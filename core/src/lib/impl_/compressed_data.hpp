@@ -0,0 +1,98 @@
+/**********************************************************************************************************************
+ * Copyright (c) 2021 Concurrent Technologies Corporation.                                                            *
+ *                                                                                                                    *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance     *
+ * with the License.  You may obtain a copy of the License at                                                         *
+ *                                                                                                                    *
+ *     http://www.apache.org/licenses/LICENSE-2.0                                                                     *
+ *                                                                                                                    *
+ * Unless required by applicable law or agreed to in writing, software is distributed under the License is            *
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or                   *
+ * implied.  See the License for the specific language governing permissions and limitations under the License.       *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+
+#ifndef OMEGA_EDIT_COMPRESSED_DATA_HPP
+#define OMEGA_EDIT_COMPRESSED_DATA_HPP
+
+#include "../../include/omega_edit/byte.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/*
+ * Compressed data is a single allocation, so it can be held in place of the bytes it compresses.  It starts with the
+ * uncompressed length and the end offsets of the compressed blocks, followed by the blocks.  Every block but the last
+ * holds OMEGA_COMPRESSION_BLOCK_SIZE uncompressed bytes, so a range of the data is read by decompressing only the
+ * blocks that overlap it.  Blocks that do not compress are stored as is.
+ */
+
+/**
+ * Builds compressed data from bytes appended in order
+ */
+class compressed_data_builder_t {
+public:
+    /**
+     * Start building compressed data
+     * @param length total number of bytes that will be appended
+     */
+    explicit compressed_data_builder_t(int64_t length);
+
+    /**
+     * Append bytes to compress
+     * @param bytes bytes to append
+     * @param count number of bytes to append
+     */
+    void append(const omega_byte_t *bytes, int64_t count);
+
+    /**
+     * Finish building the compressed data, once all the bytes have been appended
+     * @return compressed data, allocated with new[]
+     */
+    omega_byte_t *finish();
+
+private:
+    void flush_block_();
+
+    int64_t length_;                         ///< Total number of bytes to compress
+    int64_t num_blocks_;                     ///< Number of blocks to compress
+    int64_t block_length_{};                 ///< Number of bytes in the block being appended to
+    std::unique_ptr<omega_byte_t[]> block_;  ///< Block being appended to
+    std::unique_ptr<omega_byte_t[]> scratch_;///< Compressed block being flushed
+    std::vector<int64_t> block_ends_{};      ///< End offsets of the flushed blocks
+    std::vector<omega_byte_t> blocks_{};     ///< Flushed blocks
+};
+
+/**
+ * Compress the given bytes
+ * @param bytes bytes to compress
+ * @param length number of bytes to compress
+ * @return compressed data, allocated with new[]
+ */
+omega_byte_t *compress_data_(const omega_byte_t *bytes, int64_t length);
+
+/**
+ * Get the uncompressed length of the given compressed data
+ * @param data compressed data
+ * @return uncompressed length
+ */
+int64_t compressed_data_length_(const omega_byte_t *data) noexcept;
+
+/**
+ * Get the number of bytes the given compressed data takes, including its block index
+ * @param data compressed data
+ * @return compressed size
+ */
+int64_t compressed_data_size_(const omega_byte_t *data) noexcept;
+
+/**
+ * Read a range of bytes out of the given compressed data, decompressing only the blocks that overlap the range
+ * @param data compressed data
+ * @param offset offset of the range in the uncompressed bytes
+ * @param buffer buffer to read into
+ * @param length number of bytes to read
+ * @return true on success, false if the compressed data is malformed
+ */
+bool read_compressed_data_(const omega_byte_t *data, int64_t offset, omega_byte_t *buffer, int64_t length) noexcept;
+
+#endif//OMEGA_EDIT_COMPRESSED_DATA_HPP
@@ -0,0 +1,274 @@
+/**********************************************************************************************************************
+ * Copyright (c) 2021 Concurrent Technologies Corporation.                                                            *
+ *                                                                                                                    *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance     *
+ * with the License.  You may obtain a copy of the License at                                                         *
+ *                                                                                                                    *
+ *     http://www.apache.org/licenses/LICENSE-2.0                                                                     *
+ *                                                                                                                    *
+ * Unless required by applicable law or agreed to in writing, software is distributed under the License is            *
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or                   *
+ * implied.  See the License for the specific language governing permissions and limitations under the License.       *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+
+#include "count_characters.h"
+#include "../../include/omega_edit/utility.h"
+#include "character_counts_def.h"
+#include "macros.h"
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define OMEGA_COUNT_CHARACTERS_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && 2 <= _M_IX86_FP)
+#include <emmintrin.h>
+#define OMEGA_COUNT_CHARACTERS_SSE2
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace {
+    /*
+     * Number of bytes in the UTF-8 sequence that starts with the given byte.  Bytes that can not start a sequence
+     * (continuation bytes and 0xF8-0xFF) are treated like 4-byte leads, matching the original state machine, so they
+     * are only counted as characters if followed by three continuation bytes.
+     */
+    constexpr std::array<uint8_t, 256> make_utf8_sequence_lengths_() {
+        std::array<uint8_t, 256> lengths{};
+        for (int byte = 0; byte < 256; ++byte) {
+            lengths[byte] = (byte < 0x80) ? 1 : ((byte & 0xE0) == 0xC0) ? 2 : ((byte & 0xF0) == 0xE0) ? 3 : 4;
+        }
+        return lengths;
+    }
+
+    constexpr auto utf8_sequence_lengths_ = make_utf8_sequence_lengths_();
+
+    inline size_t count_trailing_zeros_(uint32_t mask) {
+        assert(mask);
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return index;
+#else
+        return __builtin_ctz(mask);
+#endif
+    }
+
+    /*
+     * Length of the run of ASCII bytes at the start of the given data, testing whole vectors of bytes at a time
+     */
+    inline size_t ascii_run_length_(const unsigned char *data, size_t length) {
+        size_t i = 0;
+#if defined(OMEGA_COUNT_CHARACTERS_AVX2)
+        for (; i + 64 <= length; i += 64) {
+            const auto lo = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+            const auto hi = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i + 32));
+            if (0 != _mm256_movemask_epi8(_mm256_or_si256(lo, hi))) {
+                if (const auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(lo))) {
+                    return i + count_trailing_zeros_(mask);
+                }
+                return i + 32 + count_trailing_zeros_(static_cast<uint32_t>(_mm256_movemask_epi8(hi)));
+            }
+        }
+#elif defined(OMEGA_COUNT_CHARACTERS_SSE2)
+        for (; i + 32 <= length; i += 32) {
+            const auto lo = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+            const auto hi = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i + 16));
+            if (0 != _mm_movemask_epi8(_mm_or_si128(lo, hi))) {
+                if (const auto mask = static_cast<uint32_t>(_mm_movemask_epi8(lo))) {
+                    return i + count_trailing_zeros_(mask);
+                }
+                return i + 16 + count_trailing_zeros_(static_cast<uint32_t>(_mm_movemask_epi8(hi)));
+            }
+        }
+#endif
+        for (; i + 8 <= length; i += 8) {
+            uint64_t word;
+            memcpy(&word, data + i, sizeof(word));
+            if (0 != (word & UINT64_C(0x8080808080808080))) { break; }
+        }
+        while (i < length && data[i] < 0x80) { ++i; }
+        return i;
+    }
+
+    size_t count_utf8_(const unsigned char *data, size_t length, omega_character_counts_t *counts_ptr, int is_final) {
+        size_t i = 0;
+        while (i < length) {
+            if (data[i] < 0x80) {
+                const auto run_length = ascii_run_length_(data + i, length - i);
+                counts_ptr->singleByteChars += static_cast<int64_t>(run_length);
+                i += run_length;
+                continue;
+            }
+            const size_t sequence_length = utf8_sequence_lengths_[data[i]];
+            if (length < i + sequence_length) {
+                // The sequence is not complete in this data, so leave it for the next call if more data follows
+                if (!is_final) { return i; }
+                ++counts_ptr->invalidBytes;
+                ++i;
+                continue;
+            }
+            size_t continuation_bytes = 1;
+            while (continuation_bytes < sequence_length && (data[i + continuation_bytes] & 0xC0) == 0x80) {
+                ++continuation_bytes;
+            }
+            if (continuation_bytes != sequence_length) {
+                ++counts_ptr->invalidBytes;// invalid UTF-8 sequence
+                ++i;
+                continue;
+            }
+            switch (sequence_length) {
+                case 2:
+                    ++counts_ptr->doubleByteChars;// 2-byte UTF-8 character (e.g. é)
+                    break;
+                case 3:
+                    ++counts_ptr->tripleByteChars;// 3-byte UTF-8 character (e.g. €)
+                    break;
+                default:
+                    ++counts_ptr->quadByteChars;// 4-byte UTF-8 character (e.g. 🌍)
+                    break;
+            }
+            i += sequence_length;
+        }
+        return i;
+    }
+
+    inline int is_lead_surrogate_UTF16_(uint16_t word) {
+        // https://en.wikipedia.org/wiki/UTF-16#Code_points_from_U+010000_to_U+10FFFF
+        return word >= 0xD800 && word <= 0xDBFF ? 1 : 0;
+    }
+
+    inline int is_low_surrogate_UTF16_(uint16_t word) {
+        // https://en.wikipedia.org/wiki/UTF-16#Code_points_from_U+010000_to_U+10FFFF
+        return word >= 0xDC00 && word <= 0xDFFF ? 1 : 0;
+    }
+
+    size_t count_utf16_(const unsigned char *data, size_t length, omega_character_counts_t *counts_ptr, int is_final) {
+        const bool is_little_endian = counts_ptr->bom == BOM_UTF16LE;
+        size_t i = 0;
+        while (i + 1 < length) {
+            // Swap the bytes if the BOM is little endian
+            const uint16_t char16 = is_little_endian ? (uint16_t) (data[i]) | (uint16_t) (data[i + 1]) << 8
+                                                     : (uint16_t) (data[i]) << 8 | (uint16_t) (data[i + 1]);
+
+            if (is_lead_surrogate_UTF16_(char16)) {
+                if (i + 3 < length) {
+                    const uint16_t next_char16 = is_little_endian
+                                                         ? (uint16_t) (data[i + 2]) | (uint16_t) (data[i + 3]) << 8
+                                                         : (uint16_t) (data[i + 2]) << 8 | (uint16_t) (data[i + 3]);
+                    if (is_low_surrogate_UTF16_(next_char16)) {
+                        ++counts_ptr->doubleByteChars;
+                        i += 4;// skip the low surrogate as well
+                    } else {
+                        ++counts_ptr->invalidBytes;// incomplete surrogate pair
+                        ++i;
+                    }
+                } else {
+                    // The surrogate pair is not complete in this data, leave it for the next call if more data follows
+                    if (!is_final) { return i; }
+                    ++counts_ptr->invalidBytes;// incomplete surrogate pair at end of data
+                    break;                     // exit loop
+                }
+            } else if (is_low_surrogate_UTF16_(char16)) {
+                ++counts_ptr->invalidBytes;// low surrogate without preceding high surrogate
+                ++i;
+            } else if (char16 <= 0x7F) {
+                ++counts_ptr->singleByteChars;// ASCII characters
+                i += 2;
+            } else {
+                ++counts_ptr->doubleByteChars;// all other characters
+                i += 2;
+            }
+        }
+        return i;
+    }
+
+    size_t count_utf32_(const unsigned char *data, size_t length, omega_character_counts_t *counts_ptr) {
+        const bool is_little_endian = counts_ptr->bom == BOM_UTF32LE;
+        size_t i = 0;
+        while (i + 3 < length) {
+            // Swap the bytes if the BOM is little endian
+            const uint32_t char32 =
+                    is_little_endian
+                            ? (data[i] | (data[i + 1] << 8) | (data[i + 2] << 16) | ((uint32_t) data[i + 3] << 24))
+                            : (((uint32_t) data[i] << 24) | (data[i + 1] << 16) | (data[i + 2] << 8) | data[i + 3]);
+
+            if ((char32 >= 0xD800 && char32 <= 0xDFFF) || char32 > 0x10FFFF) {
+                ++counts_ptr->invalidBytes;// surrogate pairs and characters above 0x10FFFF are invalid in UTF-32
+                ++i;
+            } else if (char32 <= 0x7F) {
+                ++counts_ptr->singleByteChars;// ASCII characters
+                i += 4;
+            } else {
+                ++counts_ptr->quadByteChars;// all other characters
+                i += 4;
+            }
+        }
+        return i;
+    }
+}// namespace
+
+size_t omega_count_characters_skip_BOM(const unsigned char *data, size_t length, omega_character_counts_t *counts_ptr) {
+    assert(data);
+    assert(counts_ptr);
+    // Skip the BOM if present (the BOM is metadata, not part of the text)
+    const size_t bomSize = omega_util_BOM_size(counts_ptr->bom);
+    bool has_bom = false;
+    switch (counts_ptr->bom) {
+        case BOM_UTF8:
+            has_bom = length >= 3 && data[0] == 0xEF && data[1] == 0xBB && data[2] == 0xBF;
+            break;
+        case BOM_UTF16LE:
+            has_bom = length >= 2 && data[0] == 0xFF && data[1] == 0xFE;
+            break;
+        case BOM_UTF16BE:
+            has_bom = length >= 2 && data[0] == 0xFE && data[1] == 0xFF;
+            break;
+        case BOM_UTF32LE:
+            has_bom = length >= 4 && data[0] == 0xFF && data[1] == 0xFE && data[2] == 0x00 && data[3] == 0x00;
+            break;
+        case BOM_UTF32BE:
+            has_bom = length >= 4 && data[0] == 0x00 && data[1] == 0x00 && data[2] == 0xFE && data[3] == 0xFF;
+            break;
+        default:
+            // No actual BOM specified, do nothing
+            break;
+    }
+    if (!has_bom) { return 0; }
+    counts_ptr->bomBytes = static_cast<int64_t>(bomSize);
+    return bomSize;
+}
+
+size_t omega_count_characters(const unsigned char *data, size_t length, omega_character_counts_t *counts_ptr,
+                              int is_final) {
+    assert(data || 0 == length);
+    assert(counts_ptr);
+    size_t i = 0;
+    switch (counts_ptr->bom) {
+        case BOM_UNKNOWN:// fall through, assume UTF-8 if the BOM is unknown
+        case BOM_NONE:   // fall through, assume UTF-8 if the BOM is none
+        case BOM_UTF8:
+            i = count_utf8_(data, length, counts_ptr, is_final);
+            break;
+        case BOM_UTF16LE:// fall through
+        case BOM_UTF16BE:
+            i = count_utf16_(data, length, counts_ptr, is_final);
+            break;
+        case BOM_UTF32LE:// fall through
+        case BOM_UTF32BE:
+            i = count_utf32_(data, length, counts_ptr);
+            break;
+        default:
+            ABORT(LOG_ERROR("unhandled BOM"););
+    }
+    if (!is_final) { return i; }
+    // Handle trailing invalid bytes
+    counts_ptr->invalidBytes += static_cast<int64_t>(length - i);
+    return length;
+}
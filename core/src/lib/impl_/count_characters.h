@@ -0,0 +1,58 @@
+/**********************************************************************************************************************
+ * Copyright (c) 2021 Concurrent Technologies Corporation.                                                            *
+ *                                                                                                                    *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance     *
+ * with the License.  You may obtain a copy of the License at                                                         *
+ *                                                                                                                    *
+ *     http://www.apache.org/licenses/LICENSE-2.0                                                                     *
+ *                                                                                                                    *
+ * Unless required by applicable law or agreed to in writing, software is distributed under the License is            *
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or                   *
+ * implied.  See the License for the specific language governing permissions and limitations under the License.       *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+
+#ifndef OMEGA_EDIT_COUNT_CHARACTERS_H
+#define OMEGA_EDIT_COUNT_CHARACTERS_H
+
+#include "../../include/omega_edit/fwd_defs.h"
+
+#ifdef __cplusplus
+
+#include <cstddef>
+
+extern "C" {
+#else
+
+#include <stddef.h>
+
+#endif
+
+/**
+ * Skip the byte order marker (BOM) set in the given character counts if the given data begins with it, recording the
+ * BOM bytes in the character counts
+ * @param data data that may begin with the BOM
+ * @param length length of the data
+ * @param counts_ptr pointer to the character counts with the BOM set
+ * @return number of BOM bytes skipped
+ */
+size_t omega_count_characters_skip_BOM(const unsigned char *data, size_t length, omega_character_counts_t *counts_ptr);
+
+/**
+ * Count the number of single byte, and multi-byte characters in the given data (which does not contain a BOM)
+ * @param data data to count the characters in
+ * @param length length of the data
+ * @param counts_ptr pointer to the character counts to accumulate into
+ * @param is_final non-zero if this is the last of the data, zero if more data follows, in which case counting stops at
+ * the first character that is not complete in the given data
+ * @return number of bytes counted, which is less than the given length only when is_final is zero and the data ends
+ * with an incomplete character
+ */
+size_t omega_count_characters(const unsigned char *data, size_t length, omega_character_counts_t *counts_ptr,
+                              int is_final);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif//OMEGA_EDIT_COUNT_CHARACTERS_H
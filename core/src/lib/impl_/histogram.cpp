@@ -0,0 +1,148 @@
+/**********************************************************************************************************************
+ * Copyright (c) 2021 Concurrent Technologies Corporation.                                                            *
+ *                                                                                                                    *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance     *
+ * with the License.  You may obtain a copy of the License at                                                         *
+ *                                                                                                                    *
+ *     http://www.apache.org/licenses/LICENSE-2.0                                                                     *
+ *                                                                                                                    *
+ * Unless required by applicable law or agreed to in writing, software is distributed under the License is            *
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or                   *
+ * implied.  See the License for the specific language governing permissions and limitations under the License.       *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+
+#include "histogram.hpp"
+#include "worker_pool.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define OMEGA_HISTOGRAM_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && 2 <= _M_IX86_FP)
+#include <emmintrin.h>
+#define OMEGA_HISTOGRAM_SSE2
+#endif
+
+// Chunks are small enough that the 32-bit sub-histogram counters can not overflow
+#define HISTOGRAM_CHUNK_SIZE (INT64_C(1) << 30)
+
+// Parallel work is not split into pieces smaller than this
+#define HISTOGRAM_MIN_THREAD_LENGTH (INT64_C(64) * 1024)
+
+namespace {
+    struct partial_profile_t {
+        omega_byte_frequency_profile_t profile;
+    };
+
+    inline int popcount_(uint32_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_popcount(mask);
+#else
+        int count = 0;
+        for (; mask; mask &= mask - 1) { ++count; }
+        return count;
+#endif
+    }
+
+    /*
+     * Count the CR LF pairs that begin at offsets [0, length - 1) of the given bytes.  Comparing the bytes against CR
+     * and the bytes shifted by one against LF lets a whole vector of pairs be tested at once.
+     */
+    int64_t count_crlf_(const omega_byte_t *data, int64_t length) {
+        int64_t count = 0;
+        int64_t i = 0;
+#if defined(OMEGA_HISTOGRAM_AVX2)
+        const auto cr = _mm256_set1_epi8('\r');
+        const auto lf = _mm256_set1_epi8('\n');
+        for (; i + 32 < length; i += 32) {
+            const auto cur = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+            const auto next = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i + 1));
+            const auto pairs = _mm256_and_si256(_mm256_cmpeq_epi8(cur, cr), _mm256_cmpeq_epi8(next, lf));
+            count += popcount_(static_cast<uint32_t>(_mm256_movemask_epi8(pairs)));
+        }
+#elif defined(OMEGA_HISTOGRAM_SSE2)
+        const auto cr = _mm_set1_epi8('\r');
+        const auto lf = _mm_set1_epi8('\n');
+        for (; i + 16 < length; i += 16) {
+            const auto cur = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+            const auto next = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i + 1));
+            const auto pairs = _mm_and_si128(_mm_cmpeq_epi8(cur, cr), _mm_cmpeq_epi8(next, lf));
+            count += popcount_(static_cast<uint32_t>(_mm_movemask_epi8(pairs)));
+        }
+#endif
+        // Branch-free scalar tail (and fallback when no SIMD is available)
+        for (; i + 1 < length; ++i) { count += ('\r' == data[i]) & ('\n' == data[i + 1]); }
+        return count;
+    }
+
+    /*
+     * Count the byte frequencies using four sub-histograms so that runs of the same byte do not serialize on a single
+     * counter (store-to-load forwarding), then reduce the sub-histograms into the profile.
+     */
+    void count_bytes_(const omega_byte_t *data, int64_t length, omega_byte_frequency_profile_t *profile_ptr) {
+        uint32_t sub_histograms[4][256];
+        while (0 < length) {
+            const auto chunk_length = std::min(length, HISTOGRAM_CHUNK_SIZE);
+            memset(sub_histograms, 0, sizeof(sub_histograms));
+            int64_t i = 0;
+            for (; i + 8 <= chunk_length; i += 8) {
+                uint64_t word;
+                memcpy(&word, data + i, sizeof(word));
+                ++sub_histograms[0][word & 0xFF];
+                ++sub_histograms[1][(word >> 8) & 0xFF];
+                ++sub_histograms[2][(word >> 16) & 0xFF];
+                ++sub_histograms[3][(word >> 24) & 0xFF];
+                ++sub_histograms[0][(word >> 32) & 0xFF];
+                ++sub_histograms[1][(word >> 40) & 0xFF];
+                ++sub_histograms[2][(word >> 48) & 0xFF];
+                ++sub_histograms[3][word >> 56];
+            }
+            for (; i < chunk_length; ++i) { ++sub_histograms[i & 3][data[i]]; }
+            for (int byte = 0; byte < 256; ++byte) {
+                (*profile_ptr)[byte] += static_cast<int64_t>(sub_histograms[0][byte]) + sub_histograms[1][byte] +
+                                        sub_histograms[2][byte] + sub_histograms[3][byte];
+            }
+            data += chunk_length;
+            length -= chunk_length;
+        }
+    }
+}// namespace
+
+void byte_frequency_histogram_(const omega_byte_t *data, int64_t length, omega_byte_t previous_byte,
+                               omega_byte_frequency_profile_t *profile_ptr) noexcept {
+    assert(profile_ptr);
+    if (length <= 0) { return; }
+    assert(data);
+    count_bytes_(data, length, profile_ptr);
+    (*profile_ptr)[OMEGA_EDIT_PROFILE_DOS_EOL] +=
+            count_crlf_(data, length) + (('\r' == previous_byte && '\n' == data[0]) ? 1 : 0);
+}
+
+void byte_frequency_histogram_parallel_(const omega_byte_t *data, int64_t length, omega_byte_t previous_byte,
+                                        omega_byte_frequency_profile_t *profile_ptr, int num_threads) noexcept {
+    assert(profile_ptr);
+    const auto max_threads = std::max(static_cast<int64_t>(1), length / HISTOGRAM_MIN_THREAD_LENGTH);
+    const auto thread_count = static_cast<int>(std::min(static_cast<int64_t>(num_threads), max_threads));
+    if (thread_count <= 1) {
+        byte_frequency_histogram_(data, length, previous_byte, profile_ptr);
+        return;
+    }
+    std::vector<partial_profile_t> partial_profiles(thread_count);
+    const auto piece_length = length / thread_count;
+    parallel_for_(thread_count, [&](int t) {
+        const auto piece_offset = t * piece_length;
+        const auto piece_size = (t == thread_count - 1) ? length - piece_offset : piece_length;
+        // Each piece checks the byte before it, so CR LF pairs spanning pieces are counted once
+        const auto piece_previous_byte = (0 == t) ? previous_byte : data[piece_offset - 1];
+        byte_frequency_histogram_(data + piece_offset, piece_size, piece_previous_byte, &partial_profiles[t].profile);
+    });
+    for (const auto &partial_profile: partial_profiles) {
+        for (int i = 0; i < OMEGA_EDIT_BYTE_FREQUENCY_PROFILE_SIZE; ++i) {
+            (*profile_ptr)[i] += partial_profile.profile[i];
+        }
+    }
+}
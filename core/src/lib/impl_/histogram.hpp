@@ -0,0 +1,45 @@
+/**********************************************************************************************************************
+ * Copyright (c) 2021 Concurrent Technologies Corporation.                                                            *
+ *                                                                                                                    *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance     *
+ * with the License.  You may obtain a copy of the License at                                                         *
+ *                                                                                                                    *
+ *     http://www.apache.org/licenses/LICENSE-2.0                                                                     *
+ *                                                                                                                    *
+ * Unless required by applicable law or agreed to in writing, software is distributed under the License is            *
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or                   *
+ * implied.  See the License for the specific language governing permissions and limitations under the License.       *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+
+#ifndef OMEGA_EDIT_HISTOGRAM_HPP
+#define OMEGA_EDIT_HISTOGRAM_HPP
+
+#include "../../include/omega_edit/byte.h"
+#include "../../include/omega_edit/session.h"
+#include <cstdint>
+
+/**
+ * Accumulate the byte frequencies and DOS end-of-line (CR LF) pairs of the given bytes into the given profile
+ * @param data bytes to profile
+ * @param length number of bytes to profile
+ * @param previous_byte byte that immediately precedes the given bytes (used to detect CR LF pairs spanning calls), or
+ * zero if there is none
+ * @param profile_ptr byte frequency profile to accumulate into
+ */
+void byte_frequency_histogram_(const omega_byte_t *data, int64_t length, omega_byte_t previous_byte,
+                               omega_byte_frequency_profile_t *profile_ptr) noexcept;
+
+/**
+ * Accumulate the byte frequencies and DOS end-of-line (CR LF) pairs of the given bytes into the given profile, splitting
+ * the bytes across the given number of threads and reducing the partial profiles
+ * @param data bytes to profile
+ * @param length number of bytes to profile
+ * @param previous_byte byte that immediately precedes the given bytes, or zero if there is none
+ * @param profile_ptr byte frequency profile to accumulate into
+ * @param num_threads maximum number of threads to use
+ */
+void byte_frequency_histogram_parallel_(const omega_byte_t *data, int64_t length, omega_byte_t previous_byte,
+                                        omega_byte_frequency_profile_t *profile_ptr, int num_threads) noexcept;
+
+#endif//OMEGA_EDIT_HISTOGRAM_HPP
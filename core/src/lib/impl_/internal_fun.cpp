@@ -14,21 +14,30 @@
 
 #include "internal_fun.hpp"
 #include "../../include/omega_edit/change.h"
+#include "../../include/omega_edit/character_counts.h"
 #include "../../include/omega_edit/segment.h"
 #include "change_def.hpp"
+#include "character_counts_def.h"
+#include "compressed_data.hpp"
+#include "count_characters.h"
+#include "histogram.hpp"
 #include "macros.h"
 #include "model_def.hpp"
 #include "model_segment_def.hpp"
 #include "session_def.hpp"
 #include "viewport_def.hpp"
+#include "worker_pool.hpp"
+#include <algorithm>
 #include <cassert>
+#include <cstring>
+#include <memory>
+#include <vector>
 
 /**********************************************************************************************************************
  * Data segment functions
  **********************************************************************************************************************/
 
-static inline int64_t read_segment_from_file_(FILE *from_file_ptr, int64_t offset, omega_byte_t *buffer,
-                                              int64_t capacity) noexcept {
+int64_t read_segment_from_file_(FILE *from_file_ptr, int64_t offset, omega_byte_t *buffer, int64_t capacity) noexcept {
     assert(from_file_ptr);
     assert(buffer);
     int64_t rc = -1;
@@ -47,71 +56,427 @@ static inline int64_t read_segment_from_file_(FILE *from_file_ptr, int64_t offse
     return rc;
 }
 
-int populate_data_segment_(const omega_session_t *session_ptr, omega_segment_t *data_segment_ptr) noexcept {
-    assert(session_ptr);
-    assert(session_ptr->models_.back());
-    assert(data_segment_ptr);
-    const auto &model_ptr = session_ptr->models_.back();
-    data_segment_ptr->length = 0;
+int64_t populate_model_buffer_(const omega_model_t *model_ptr, int64_t offset, omega_byte_t *buffer,
+                               int64_t capacity) noexcept {
+    assert(model_ptr);
+    assert(buffer);
+    assert(0 <= capacity);
+    int64_t length = 0;
     if (model_ptr->model_segments.empty()) { return 0; }
-    assert(0 <= data_segment_ptr->capacity);
-    const auto data_segment_capacity = data_segment_ptr->capacity;
-    const auto data_segment_offset = data_segment_ptr->offset + data_segment_ptr->offset_adjustment;
     int64_t read_offset = 0;
 
     for (auto iter = model_ptr->model_segments.cbegin(); iter != model_ptr->model_segments.cend(); ++iter) {
         if (read_offset != (*iter)->computed_offset) {
-            ABORT(print_model_segments_(session_ptr->models_.back().get(), CLOG);
+            ABORT(print_model_segments_(model_ptr, CLOG);
                           LOG_ERROR("break in model continuity, expected: " << read_offset
                                                                             << ", got: " << (*iter)->computed_offset););
         }
-        if (read_offset <= data_segment_offset && data_segment_offset <= read_offset + (*iter)->computed_length) {
-            // We're at the first model segment that intersects with the data segment, but the model segment and the
-            // data segment offsets are likely not aligned, so we need to compute how much of the segment to move past
-            // (the delta).
-            auto delta = data_segment_offset - (*iter)->computed_offset;
-            const auto data_segment_buffer = omega_segment_get_data(data_segment_ptr);
+        if (read_offset <= offset && offset <= read_offset + (*iter)->computed_length) {
+            // We're at the first model segment that intersects with the buffer, but the model segment and the buffer
+            // offsets are likely not aligned, so we need to compute how much of the segment to move past (the delta).
+            auto delta = offset - (*iter)->computed_offset;
             do {
                 // This is how much data remains to be filled
-                const auto remaining_capacity = data_segment_capacity - data_segment_ptr->length;
+                const auto remaining_capacity = capacity - length;
                 auto amount = (*iter)->computed_length - delta;
                 amount = (amount > remaining_capacity) ? remaining_capacity : amount;
                 switch (omega_model_segment_get_kind(iter->get())) {
                     case model_segment_kind_t::SEGMENT_READ:
                         // For read segments, we're reading a segment, or portion thereof, from the input file and
-                        // writing it into the data segment
-                        if (read_segment_from_file_(session_ptr->models_.back()->file_ptr,
-                                                    (*iter)->change_offset + delta,
-                                                    data_segment_buffer + data_segment_ptr->length, amount) != amount) {
+                        // writing it into the buffer
+                        if (read_segment_from_file_(model_ptr->file_ptr,
+                                                    (*iter)->change_offset + delta, buffer + length,
+                                                    amount) != amount) {
                             return -1;
                         }
                         break;
                     case model_segment_kind_t::SEGMENT_INSERT:
-                        // For insert segments, we're writing the change byte buffer, or portion thereof, into the data
-                        // segment
-                        memcpy(data_segment_buffer + data_segment_ptr->length,
-                               omega_change_get_bytes((*iter)->change_ptr.get()) + (*iter)->change_offset + delta,
-                               amount);
+                        // For insert segments, we're writing the change byte buffer, or portion thereof, into the
+                        // buffer
+                        if (!read_change_bytes_((*iter)->change_ptr.get(), (*iter)->change_offset + delta,
+                                                buffer + length, amount)) {
+                            return -1;
+                        }
                         break;
                     default:
                         ABORT(LOG_ERROR("Unhandled model segment kind"););
                 }
-                // Add the amount written to the data segment length
-                data_segment_ptr->length += amount;
+                // Add the amount written to the buffer length
+                length += amount;
                 // After the first segment is written, the dela should be zero from that point on
                 delta = 0;
-                // Keep writing segments until we run out of viewport capacity or run out of segments
-            } while (data_segment_ptr->length < data_segment_capacity && ++iter != model_ptr->model_segments.end());
-            assert(data_segment_ptr->length <= data_segment_capacity);
-            // data segment buffer allocation is its capacity plus one, so we can null-terminate it
-            data_segment_buffer[data_segment_ptr->length] = '\0';
-            return 0;
+                // Keep writing segments until we run out of buffer capacity or run out of segments
+            } while (length < capacity && ++iter != model_ptr->model_segments.end());
+            assert(length <= capacity);
+            return length;
         }
         read_offset += (*iter)->computed_length;
     }
     return -1;
 }
 
+int64_t populate_buffer_(const omega_session_t *session_ptr, int64_t offset, omega_byte_t *buffer,
+                         int64_t capacity) noexcept {
+    assert(session_ptr);
+    assert(session_ptr->models_.back());
+    return populate_model_buffer_(session_ptr->models_.back().get(), offset, buffer, capacity);
+}
+
+int populate_model_data_segment_(const omega_model_t *model_ptr, omega_segment_t *data_segment_ptr) noexcept {
+    assert(model_ptr);
+    assert(data_segment_ptr);
+    assert(0 <= data_segment_ptr->capacity);
+    data_segment_ptr->length = 0;
+    const auto data_segment_buffer = omega_segment_get_data(data_segment_ptr);
+    const auto length =
+            populate_model_buffer_(model_ptr, data_segment_ptr->offset + data_segment_ptr->offset_adjustment,
+                                   data_segment_buffer, data_segment_ptr->capacity);
+    if (length < 0) { return -1; }
+    data_segment_ptr->length = length;
+    // data segment buffer allocation is its capacity plus one, so we can null-terminate it
+    data_segment_buffer[data_segment_ptr->length] = '\0';
+    return 0;
+}
+
+int populate_data_segment_(const omega_session_t *session_ptr, omega_segment_t *data_segment_ptr) noexcept {
+    assert(session_ptr);
+    assert(session_ptr->models_.back());
+    return populate_model_data_segment_(session_ptr->models_.back().get(), data_segment_ptr);
+}
+
+/**********************************************************************************************************************
+ * Change payload functions
+ **********************************************************************************************************************/
+
+bool read_change_bytes_(const omega_change_t *change_ptr, int64_t offset, omega_byte_t *buffer,
+                        int64_t length) noexcept {
+    assert(change_ptr);
+    assert(buffer);
+    if (omega_change_is_compressed_(change_ptr)) {
+        return read_compressed_data_(change_ptr->data.bytes_ptr, offset, buffer, length);
+    }
+    if (omega_change_is_fill_(change_ptr)) {
+        const auto pattern_length = omega_change_get_fill_pattern_length_(change_ptr);
+        const auto *const pattern = omega_change_get_fill_pattern_(change_ptr);
+        if (1 == pattern_length) {
+            memset(buffer, *pattern, length);
+            return true;
+        }
+        // Copy the pattern from the phase of the offset, then double the bytes already produced
+        const auto phase = offset % pattern_length;
+        const auto first = std::min(length, pattern_length - phase);
+        memcpy(buffer, pattern + phase, first);
+        if (first < length) {
+            const auto head = std::min(length - first, phase);
+            memcpy(buffer + first, pattern, head);
+            for (int64_t produced = first + head; produced < length;) {
+                const auto amount = std::min(length - produced, produced);
+                memcpy(buffer + produced, buffer, amount);
+                produced += amount;
+            }
+        }
+        return true;
+    }
+    memcpy(buffer, omega_change_get_bytes(change_ptr) + offset, length);
+    return true;
+}
+
+int64_t change_history_memory_(const omega_change_t *change_ptr) noexcept {
+    assert(change_ptr);
+    // Small payloads live in the change itself, and spilled payloads live in the payload store
+    auto memory = static_cast<int64_t>(sizeof(omega_change_t));
+    if (omega_change_get_kind(change_ptr) == change_kind_t::CHANGE_DELETE || change_ptr->length < DATA_T_SIZE ||
+        omega_change_is_spilled_(change_ptr)) {
+        return memory;
+    }
+    if (omega_change_is_compressed_(change_ptr)) { return memory + compressed_data_size_(change_ptr->data.bytes_ptr); }
+    if (omega_change_is_fill_(change_ptr)) {
+        return memory + static_cast<int64_t>(sizeof(int64_t)) + omega_change_get_fill_pattern_length_(change_ptr);
+    }
+    return memory + change_ptr->length + 1;
+}
+
+int64_t change_resident_payload_bytes_(const omega_change_t *change_ptr) noexcept {
+    assert(change_ptr);
+    // Compressed and fill payloads are smaller than their bytes, and spilled payloads live in the payload store
+    return (omega_change_get_kind(change_ptr) == change_kind_t::CHANGE_DELETE ||
+            omega_change_is_compressed_(change_ptr) || omega_change_is_spilled_(change_ptr) ||
+            omega_change_is_fill_(change_ptr))
+           ? 0
+           : change_ptr->length;
+}
+
+/**********************************************************************************************************************
+ * Block summary functions
+ **********************************************************************************************************************/
+
+int64_t get_summarized_file_length_(omega_model_t *model_ptr) noexcept {
+    assert(model_ptr);
+    auto &block_summaries = model_ptr->block_summaries;
+    if (block_summaries.file_length < 0) {
+        int64_t file_length = 0;
+        if (model_ptr->file_ptr) {
+            if (0 != FSEEK(model_ptr->file_ptr, 0, SEEK_END)) { return -1; }
+            file_length = FTELL(model_ptr->file_ptr);
+        }
+        block_summaries.file_length = file_length;
+        block_summaries.blocks.clear();
+        block_summaries.blocks.resize((file_length + OMEGA_SUMMARY_BLOCK_SIZE - 1) / OMEGA_SUMMARY_BLOCK_SIZE);
+    }
+    return block_summaries.file_length;
+}
+
+static inline uint8_t count_utf8_continuation_bytes_(const omega_byte_t *data, int64_t length) noexcept {
+    uint8_t count = 0;
+    while (count < length && count < 4 && (data[count] & 0xC0) == 0x80) { ++count; }
+    return count;
+}
+
+const omega_block_summary_t *get_block_summary_(omega_model_t *model_ptr, int64_t block_index) noexcept {
+    assert(model_ptr);
+    const auto file_length = get_summarized_file_length_(model_ptr);
+    auto &blocks = model_ptr->block_summaries.blocks;
+    if (file_length < 0 || block_index < 0 || static_cast<int64_t>(blocks.size()) <= block_index) { return nullptr; }
+    if (blocks[block_index]) { return blocks[block_index].get(); }
+
+    // Read the block along with the start of the next block, which is needed to find where the UTF-8 character that
+    // straddles the end of the block (if any) ends
+    const auto block_offset = block_index * OMEGA_SUMMARY_BLOCK_SIZE;
+    const auto block_length = std::min(static_cast<int64_t>(OMEGA_SUMMARY_BLOCK_SIZE), file_length - block_offset);
+    const auto read_length = std::min(block_length + 4, file_length - block_offset);
+    const auto buffer = std::make_unique<omega_byte_t[]>(read_length);
+    if (read_segment_from_file_(model_ptr->file_ptr, block_offset, buffer.get(), read_length) != read_length) {
+        return nullptr;
+    }
+    auto summary_ptr = std::make_unique<omega_block_summary_t>();
+    omega_byte_frequency_profile_t profile{};
+    byte_frequency_histogram_(buffer.get(), block_length, 0, &profile);
+    for (int byte = 0; byte < 256; ++byte) { summary_ptr->byte_counts[byte] = static_cast<uint32_t>(profile[byte]); }
+    summary_ptr->dos_eol_count = static_cast<uint32_t>(profile[OMEGA_EDIT_PROFILE_DOS_EOL]);
+    memcpy(summary_ptr->first_bytes, buffer.get(), std::min(block_length, static_cast<int64_t>(4)));
+    summary_ptr->last_byte = buffer[block_length - 1];
+
+    // Non-continuation bytes always begin a UTF-8 character, so the characters from the first non-continuation byte of
+    // this block up to the first non-continuation byte of the next block count the same no matter what precedes them
+    summary_ptr->utf8_start = count_utf8_continuation_bytes_(buffer.get(), block_length);
+    summary_ptr->next_utf8_start =
+            count_utf8_continuation_bytes_(buffer.get() + block_length, read_length - block_length);
+    summary_ptr->has_utf8_counts = summary_ptr->utf8_start < 4 && summary_ptr->next_utf8_start < 4 &&
+                                   summary_ptr->utf8_start < block_length;
+    if (summary_ptr->has_utf8_counts) {
+        omega_character_counts_t counts;
+        omega_character_counts_set_BOM(omega_character_counts_reset(&counts), BOM_NONE);
+        omega_count_characters(buffer.get() + summary_ptr->utf8_start,
+                               block_length + summary_ptr->next_utf8_start - summary_ptr->utf8_start, &counts, 1);
+        summary_ptr->utf8_counts[0] = static_cast<uint32_t>(counts.singleByteChars);
+        summary_ptr->utf8_counts[1] = static_cast<uint32_t>(counts.doubleByteChars);
+        summary_ptr->utf8_counts[2] = static_cast<uint32_t>(counts.tripleByteChars);
+        summary_ptr->utf8_counts[3] = static_cast<uint32_t>(counts.quadByteChars);
+        summary_ptr->utf8_counts[4] = static_cast<uint32_t>(counts.invalidBytes);
+    }
+    blocks[block_index] = std::move(summary_ptr);
+    return blocks[block_index].get();
+}
+
+void invalidate_block_summaries_(omega_model_t *model_ptr) noexcept {
+    assert(model_ptr);
+    model_ptr->block_summaries.file_length = -1;
+    model_ptr->block_summaries.blocks.clear();
+}
+
+/**********************************************************************************************************************
+ * Byte frequency profile functions
+ **********************************************************************************************************************/
+
+// Bytes are read from the model and profiled in blocks of this size
+#define PROFILE_BLOCK_SIZE (1024 * 1024)
+
+int byte_frequency_profile_(omega_model_t *model_ptr, omega_byte_frequency_profile_t *profile_ptr, int64_t offset,
+                            int64_t length, int num_threads) noexcept {
+    assert(model_ptr);
+    assert(profile_ptr);
+    memset(profile_ptr, 0, sizeof(omega_byte_frequency_profile_t));
+    if (length <= 0) { return 0; }
+    const auto block_capacity = std::min(length, static_cast<int64_t>(PROFILE_BLOCK_SIZE));
+    const auto block = std::make_unique<omega_byte_t[]>(block_capacity);
+    int64_t block_length = 0;
+    omega_byte_t previous_byte = 0;
+    const auto profile_bytes = [&](const omega_byte_t *data, int64_t data_length) {
+        byte_frequency_histogram_parallel_(data, data_length, previous_byte, profile_ptr, num_threads);
+        previous_byte = data[data_length - 1];
+    };
+    const auto flush = [&]() {
+        if (block_length) { profile_bytes(block.get(), block_length); }
+        block_length = 0;
+    };
+    const auto rc = visit_summarized_range_(
+            model_ptr, offset, length, true,
+            [&](const omega_byte_t *data, int64_t data_length) {
+                if (0 == block_length && block_capacity <= data_length) {
+                    profile_bytes(data, data_length);
+                    return;
+                }
+                while (data_length) {
+                    const auto amount = std::min(data_length, block_capacity - block_length);
+                    memcpy(block.get() + block_length, data, amount);
+                    block_length += amount;
+                    data += amount;
+                    data_length -= amount;
+                    if (block_length == block_capacity) { flush(); }
+                }
+            },
+            [&](const omega_block_summary_t &summary, int64_t) {
+                flush();
+                for (int byte = 0; byte < 256; ++byte) { (*profile_ptr)[byte] += summary.byte_counts[byte]; }
+                (*profile_ptr)[OMEGA_EDIT_PROFILE_DOS_EOL] +=
+                        summary.dos_eol_count + ('\r' == previous_byte && '\n' == summary.first_bytes[0] ? 1 : 0);
+                previous_byte = summary.last_byte;
+                return true;
+            });
+    if (0 != rc) { return rc; }
+    flush();
+    return 0;
+}
+
+/**********************************************************************************************************************
+ * Character counts functions
+ **********************************************************************************************************************/
+
+// Bytes are read from the model and counted in blocks of this size
+#define CHARACTER_COUNTS_BLOCK_SIZE (1024 * 1024)
+
+// Parallel character counting does not split blocks into pieces smaller than this
+#define CHARACTER_COUNTS_MIN_THREAD_LENGTH (64 * 1024)
+
+/*
+ * Count the characters in the given data using up to the given number of threads.  UTF-8 data is split into pieces
+ * that begin with non-continuation bytes, which always begin a character, so the pieces count exactly as if the
+ * data was counted in one piece.  Other encodings are counted on the calling thread.
+ */
+static size_t count_characters_parallel_(const omega_byte_t *data, size_t length, omega_character_counts_t *counts_ptr,
+                                        int is_final, int num_threads) {
+    const auto bom = omega_character_counts_get_BOM(counts_ptr);
+    const auto max_threads = std::max(static_cast<size_t>(1), length / CHARACTER_COUNTS_MIN_THREAD_LENGTH);
+    const auto thread_count = std::min(static_cast<size_t>(std::max(num_threads, 1)), max_threads);
+    if ((BOM_NONE != bom && BOM_UNKNOWN != bom && BOM_UTF8 != bom) || thread_count <= 1) {
+        return omega_count_characters(data, length, counts_ptr, is_final);
+    }
+    std::vector<size_t> bounds{0};
+    for (size_t t = 1; t < thread_count; ++t) {
+        auto bound = std::max(bounds.back(), length * t / thread_count);
+        while (bound < length && (data[bound] & 0xC0) == 0x80) { ++bound; }
+        if (bounds.back() < bound && bound < length) { bounds.push_back(bound); }
+    }
+    bounds.push_back(length);
+    const auto num_pieces = bounds.size() - 1;
+    std::vector<omega_character_counts_t> partial_counts(num_pieces);
+    std::vector<size_t> counted(num_pieces);
+    const auto count_piece = [&](size_t piece) {
+        omega_character_counts_set_BOM(omega_character_counts_reset(&partial_counts[piece]), bom);
+        // Only the last piece can end with a character that continues in the next block
+        counted[piece] = omega_count_characters(data + bounds[piece], bounds[piece + 1] - bounds[piece],
+                                                &partial_counts[piece], (piece + 1 == num_pieces) ? is_final : 1);
+    };
+    parallel_for_(static_cast<int>(num_pieces), [&](int piece) { count_piece(static_cast<size_t>(piece)); });
+    for (const auto &partial: partial_counts) {
+        counts_ptr->singleByteChars += partial.singleByteChars;
+        counts_ptr->doubleByteChars += partial.doubleByteChars;
+        counts_ptr->tripleByteChars += partial.tripleByteChars;
+        counts_ptr->quadByteChars += partial.quadByteChars;
+        counts_ptr->invalidBytes += partial.invalidBytes;
+    }
+    return bounds[num_pieces - 1] + counted[num_pieces - 1];
+}
+
+int character_counts_(omega_model_t *model_ptr, omega_character_counts_t *counts_ptr, int64_t offset, int64_t length,
+                      omega_bom_t bom, int num_threads) noexcept {
+    assert(model_ptr);
+    assert(counts_ptr);
+    omega_character_counts_set_BOM(omega_character_counts_reset(counts_ptr), bom);
+    if (length <= 0) { return 0; }
+
+    // The BOM can only be at the start of the range
+    omega_byte_t bom_probe[4];
+    const auto probe_length = populate_model_buffer_(model_ptr, offset, bom_probe, std::min(length, int64_t(4)));
+    if (probe_length <= 0) { return -1; }
+    const auto bom_bytes = static_cast<int64_t>(
+            omega_count_characters_skip_BOM(bom_probe, static_cast<size_t>(probe_length), counts_ptr));
+    offset += bom_bytes;
+    length -= bom_bytes;
+    if (length <= 0) { return 0; }
+
+    // Block summaries hold UTF-8 counts, so they are only used if the data is counted as UTF-8
+    const auto use_summaries = BOM_NONE == bom || BOM_UNKNOWN == bom || BOM_UTF8 == bom;
+    const auto block_capacity = std::min(length, static_cast<int64_t>(CHARACTER_COUNTS_BLOCK_SIZE));
+    const auto block = std::make_unique<omega_byte_t[]>(block_capacity);
+    int64_t block_length = 0;
+    // Number of bytes at the start of the next bytes visited that were already counted with a block summary
+    int64_t skip_length = 0;
+    const auto count_block = [&](int is_final) {
+        // A character that is incomplete at the end of the block is counted with the next bytes
+        const auto counted = static_cast<int64_t>(
+                count_characters_parallel_(block.get(), block_length, counts_ptr, is_final, num_threads));
+        block_length -= counted;
+        memmove(block.get(), block.get() + counted, block_length);
+    };
+    const auto append_bytes = [&](const omega_byte_t *data, int64_t data_length) {
+        while (data_length) {
+            const auto amount = std::min(data_length, block_capacity - block_length);
+            memcpy(block.get() + block_length, data, amount);
+            block_length += amount;
+            data += amount;
+            data_length -= amount;
+            if (block_length == block_capacity) { count_block(0); }
+        }
+    };
+    const auto rc = visit_summarized_range_(
+            model_ptr, offset, length, use_summaries,
+            [&](const omega_byte_t *data, int64_t data_length) {
+                const auto skip = std::min(skip_length, data_length);
+                skip_length -= skip;
+                append_bytes(data + skip, data_length - skip);
+            },
+            [&](const omega_block_summary_t &summary, int64_t remaining) {
+                // The summary counts through the continuation bytes at the start of the next block, so they must
+                // be in the range and come from the model file
+                if (!summary.has_utf8_counts || remaining < summary.next_utf8_start) { return false; }
+                // Continuation bytes at the start of the block belong to the characters before it, unless they
+                // were already counted with the summary of the previous block
+                if (0 == skip_length) { append_bytes(summary.first_bytes, summary.utf8_start); }
+                count_block(1);
+                assert(0 == block_length);
+                counts_ptr->singleByteChars += summary.utf8_counts[0];
+                counts_ptr->doubleByteChars += summary.utf8_counts[1];
+                counts_ptr->tripleByteChars += summary.utf8_counts[2];
+                counts_ptr->quadByteChars += summary.utf8_counts[3];
+                counts_ptr->invalidBytes += summary.utf8_counts[4];
+                skip_length = summary.next_utf8_start;
+                return true;
+            });
+    if (0 != rc) { return rc; }
+    count_block(1);
+    return 0;
+}
+
+/**********************************************************************************************************************
+ * Viewport page functions
+ **********************************************************************************************************************/
+
+void invalidate_viewport_pages_(omega_viewport_t *viewport_ptr, int64_t offset, int64_t length) noexcept {
+    assert(viewport_ptr);
+    if (viewport_ptr->pages_.empty() || (0 <= length && offset + length < 0)) { return; }
+    assert(0 < viewport_ptr->page_size_);
+    // Pages are relative to the viewport offset, so clamp the given range to the viewport and stale every page it
+    // touches.  A negative length invalidates all pages from the given offset to the end of the viewport.
+    const auto first_page = std::max(offset, static_cast<int64_t>(0)) / viewport_ptr->page_size_;
+    const auto num_pages = static_cast<int64_t>(viewport_ptr->pages_.size());
+    const auto last_page = (length < 0) ? num_pages - 1
+                                        : std::min((offset + std::max(length, static_cast<int64_t>(1)) - 1) /
+                                                           viewport_ptr->page_size_,
+                                                   num_pages - 1);
+    for (auto page = first_page; page <= last_page; ++page) { viewport_ptr->pages_[page].length = -1; }
+}
+
 /**********************************************************************************************************************
  * Model segment functions
  **********************************************************************************************************************/
@@ -121,7 +486,16 @@ static inline void print_change_(const omega_change_t *change_ptr, std::ostream
     out_stream << R"({"serial": )" << omega_change_get_serial(change_ptr) << R"(, "kind": ")"
                << omega_change_get_kind_as_char(change_ptr) << R"(", "offset": )" << omega_change_get_offset(change_ptr)
                << R"(, "length": )" << omega_change_get_length(change_ptr);
-    if (const auto bytes = omega_change_get_bytes(change_ptr); bytes) {
+    if (omega_change_is_compressed_(change_ptr)) {
+        // Printing does not decode the payload
+        out_stream << R"(, "compressed": true)";
+    } else if (omega_change_is_fill_(change_ptr)) {
+        // Nor does it materialize a fill
+        out_stream << R"(, "fill": ")"
+                   << std::string((char const *) omega_change_get_fill_pattern_(change_ptr),
+                                  omega_change_get_fill_pattern_length_(change_ptr))
+                   << R"(")";
+    } else if (const auto bytes = omega_change_get_bytes(change_ptr); bytes) {
         out_stream << R"(, "bytes": ")" << std::string((char const *) bytes, omega_change_get_length(change_ptr))
                    << R"(")";
     }
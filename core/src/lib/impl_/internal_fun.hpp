@@ -17,14 +17,174 @@
 
 #include "../../include/omega_edit/byte.h"
 #include "../../include/omega_edit/fwd_defs.h"
+#include "../../include/omega_edit/session.h"
+#include "block_summary_def.hpp"
+#include "change_def.hpp"
 #include "internal_fwd_defs.hpp"
+#include "model_def.hpp"
+#include "model_segment_def.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
 #include <iosfwd>
+#include <memory>
 
 // Data segment functions
+int64_t populate_model_buffer_(const omega_model_t *model_ptr, int64_t offset, omega_byte_t *buffer, int64_t capacity)
+
+noexcept;
+
+int64_t populate_buffer_(const omega_session_t *session_ptr, int64_t offset, omega_byte_t *buffer, int64_t capacity)
+
+noexcept;
+
+int populate_model_data_segment_(const omega_model_t *model_ptr, omega_segment_t *data_segment_ptr)
+
+noexcept;
+
 int populate_data_segment_(const omega_session_t *session_ptr, omega_segment_t *data_segment_ptr)
 
 noexcept;
 
+// File functions
+int64_t read_segment_from_file_(FILE *from_file_ptr, int64_t offset, omega_byte_t *buffer, int64_t capacity)
+
+noexcept;
+
+// Change payload functions
+bool read_change_bytes_(const omega_change_t *change_ptr, int64_t offset, omega_byte_t *buffer, int64_t length)
+
+noexcept;
+
+int64_t change_history_memory_(const omega_change_t *change_ptr)
+
+noexcept;
+
+int64_t change_resident_payload_bytes_(const omega_change_t *change_ptr)
+
+noexcept;
+
+/**
+ * Pass a range of the bytes of the given change payload to on_bytes(data, length), a block at a time if the payload is
+ * compressed or a fill, so the payload is never decoded whole
+ * @param change_ptr INSERT or OVERWRITE change whose payload to visit
+ * @param offset offset of the range in the payload
+ * @param length number of bytes in the range
+ * @param on_bytes function to pass the bytes to, returning false to stop the visit
+ * @return true if all the bytes were passed to on_bytes, false otherwise
+ */
+template<typename BytesFn>
+bool visit_change_bytes_(const omega_change_t *change_ptr, int64_t offset, int64_t length, BytesFn &&on_bytes) {
+    if (!omega_change_is_compressed_(change_ptr) && !omega_change_is_fill_(change_ptr)) {
+        return on_bytes(omega_data_get_data_const(&change_ptr->data, change_ptr->length) + offset, length);
+    }
+    const auto block = std::make_unique<omega_byte_t[]>(OMEGA_COMPRESSION_BLOCK_SIZE);
+    while (0 < length) {
+        // Reads aligned to the compressed blocks decompress straight into the block buffer
+        const auto amount = std::min(length, OMEGA_COMPRESSION_BLOCK_SIZE - offset % OMEGA_COMPRESSION_BLOCK_SIZE);
+        if (!read_change_bytes_(change_ptr, offset, block.get(), amount) || !on_bytes(block.get(), amount)) {
+            return false;
+        }
+        offset += amount;
+        length -= amount;
+    }
+    return true;
+}
+
+// Block summary functions
+int64_t get_summarized_file_length_(omega_model_t *model_ptr)
+
+noexcept;
+
+const omega_block_summary_t *get_block_summary_(omega_model_t *model_ptr, int64_t block_index)
+
+noexcept;
+
+void invalidate_block_summaries_(omega_model_t *model_ptr)
+
+noexcept;
+
+/**
+ * Visit the bytes of the given range of the given model in order.  Bytes that come from changes and from blocks of the
+ * model file that are only partially in the range are passed to on_bytes(data, length).  Blocks of the model file
+ * that are entirely in the range are first offered to on_block(summary, remaining), where remaining is the number
+ * of bytes of the model file that directly follow the block in the range, and are passed to on_bytes if on_block
+ * returns false.  Block summaries are only consulted if use_summaries is true.
+ */
+template<typename BytesFn, typename BlockFn>
+int visit_summarized_range_(omega_model_t *model_ptr, int64_t offset, int64_t length, bool use_summaries,
+                            BytesFn &&on_bytes, BlockFn &&on_block) {
+    const auto &segments = model_ptr->model_segments;
+    auto iter = std::upper_bound(segments.cbegin(), segments.cend(), offset,
+                                 [](int64_t value, const omega_model_segment_ptr_t &segment_ptr) {
+                                     return value < segment_ptr->computed_offset;
+                                 });
+    if (iter == segments.cbegin()) { return 0 < length ? -1 : 0; }
+    std::unique_ptr<omega_byte_t[]> buffer;
+    for (--iter; 0 < length && iter != segments.cend(); ++iter) {
+        const auto &segment_ptr = *iter;
+        const auto delta = offset - segment_ptr->computed_offset;
+        const auto amount = std::min(segment_ptr->computed_length - delta, length);
+        assert(0 < amount);
+        if (omega_model_segment_get_kind(segment_ptr.get()) == model_segment_kind_t::SEGMENT_INSERT) {
+            if (!visit_change_bytes_(segment_ptr->change_ptr.get(), segment_ptr->change_offset + delta, amount,
+                                     [&on_bytes](const omega_byte_t *data, int64_t data_length) {
+                                         on_bytes(data, data_length);
+                                         return true;
+                                     })) {
+                return -1;
+            }
+        } else {
+            auto file_offset = segment_ptr->change_offset + delta;
+            const auto file_end = file_offset + amount;
+            const auto file_length = use_summaries ? get_summarized_file_length_(model_ptr) : file_end;
+            if (file_length < file_end) { return -1; }
+            while (file_offset < file_end) {
+                const auto block_offset = file_offset - file_offset % OMEGA_SUMMARY_BLOCK_SIZE;
+                const auto block_end = std::min(block_offset + OMEGA_SUMMARY_BLOCK_SIZE, file_length);
+                if (use_summaries && file_offset == block_offset && block_end <= file_end) {
+                    const auto summary_ptr =
+                            get_block_summary_(model_ptr, block_offset / OMEGA_SUMMARY_BLOCK_SIZE);
+                    if (!summary_ptr) { return -1; }
+                    if (on_block(*summary_ptr, file_end - block_end)) {
+                        file_offset = block_end;
+                        continue;
+                    }
+                }
+                const auto read_length = std::min(block_end, file_end) - file_offset;
+                if (!buffer) { buffer = std::make_unique<omega_byte_t[]>(OMEGA_SUMMARY_BLOCK_SIZE); }
+                if (read_segment_from_file_(model_ptr->file_ptr, file_offset, buffer.get(), read_length) !=
+                    read_length) {
+                    return -1;
+                }
+                on_bytes(buffer.get(), read_length);
+                file_offset += read_length;
+            }
+        }
+        offset += amount;
+        length -= amount;
+    }
+    return 0 < length ? -1 : 0;
+}
+
+// Byte frequency profile functions
+int byte_frequency_profile_(omega_model_t *model_ptr, omega_byte_frequency_profile_t *profile_ptr, int64_t offset,
+                            int64_t length, int num_threads)
+
+noexcept;
+
+// Character counts functions
+int character_counts_(omega_model_t *model_ptr, omega_character_counts_t *counts_ptr, int64_t offset, int64_t length,
+                      omega_bom_t bom, int num_threads)
+
+noexcept;
+
+// Viewport page functions
+void invalidate_viewport_pages_(omega_viewport_t *viewport_ptr, int64_t offset, int64_t length)
+
+noexcept;
+
 // Model segment functions
 void print_model_segments_(const omega_model_t *model_ptr, std::ostream &out_stream)
 
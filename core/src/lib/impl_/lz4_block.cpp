@@ -0,0 +1,144 @@
+/**********************************************************************************************************************
+ * Copyright (c) 2021 Concurrent Technologies Corporation.                                                            *
+ *                                                                                                                    *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance     *
+ * with the License.  You may obtain a copy of the License at                                                         *
+ *                                                                                                                    *
+ *     http://www.apache.org/licenses/LICENSE-2.0                                                                     *
+ *                                                                                                                    *
+ * Unless required by applicable law or agreed to in writing, software is distributed under the License is            *
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or                   *
+ * implied.  See the License for the specific language governing permissions and limitations under the License.       *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+
+#include "lz4_block.hpp"
+#include <cassert>
+#include <cstring>
+
+// The minimum match length, and the format limits on where matches can start and end near the end of a block
+#define LZ4_MIN_MATCH (4)
+#define LZ4_LAST_LITERALS (5)
+#define LZ4_MATCH_FIND_LIMIT (12)
+#define LZ4_MAX_OFFSET (65535)
+#define LZ4_HASH_LOG (12)
+
+namespace {
+    inline uint32_t read32_(const omega_byte_t *ptr) {
+        uint32_t value;
+        memcpy(&value, ptr, sizeof(value));
+        return value;
+    }
+
+    inline uint32_t hash_(uint32_t sequence) { return (sequence * 2654435761U) >> (32 - LZ4_HASH_LOG); }
+
+    // Write the run length continuation bytes of a length whose 4-bit token field is saturated
+    inline omega_byte_t *write_length_(omega_byte_t *op, int64_t length) {
+        for (; 255 <= length; length -= 255) { *op++ = 255; }
+        *op++ = static_cast<omega_byte_t>(length);
+        return op;
+    }
+
+    inline omega_byte_t *write_sequence_(omega_byte_t *op, const omega_byte_t *literals, int64_t literal_length,
+                                         int64_t offset, int64_t match_length) {
+        auto *const token = op++;
+        *token = static_cast<omega_byte_t>((15 <= literal_length ? 15 : literal_length) << 4);
+        if (15 <= literal_length) { op = write_length_(op, literal_length - 15); }
+        memcpy(op, literals, literal_length);
+        op += literal_length;
+        if (0 < match_length) {
+            *op++ = static_cast<omega_byte_t>(offset);
+            *op++ = static_cast<omega_byte_t>(offset >> 8);
+            const auto match_code = match_length - LZ4_MIN_MATCH;
+            *token |= static_cast<omega_byte_t>(15 <= match_code ? 15 : match_code);
+            if (15 <= match_code) { op = write_length_(op, match_code - 15); }
+        }
+        return op;
+    }
+}// namespace
+
+int64_t lz4_compress_block_(const omega_byte_t *src, int64_t length, omega_byte_t *dst, int64_t capacity) noexcept {
+    assert(src);
+    assert(dst);
+    assert(0 <= length && length <= LZ4_MAX_OFFSET + 1);
+    if (capacity < lz4_compress_bound_(length)) { return 0; }
+    // Positions are stored plus one, so zero marks an empty slot
+    uint32_t table[1 << LZ4_HASH_LOG] = {};
+    auto *op = dst;
+    int64_t anchor = 0;
+    int64_t i = 0;
+    const auto match_find_limit = length - LZ4_MATCH_FIND_LIMIT;
+    const auto match_end_limit = length - LZ4_LAST_LITERALS;
+    while (i < match_find_limit) {
+        const auto sequence = read32_(src + i);
+        const auto hash = hash_(sequence);
+        int64_t ref = static_cast<int64_t>(table[hash]) - 1;
+        table[hash] = static_cast<uint32_t>(i + 1);
+        if (ref < 0 || LZ4_MAX_OFFSET < i - ref || read32_(src + ref) != sequence) {
+            // Skip ahead faster through bytes that are not matching
+            i += 1 + ((i - anchor) >> 6);
+            continue;
+        }
+        auto start = i;
+        while (anchor < start && 0 < ref && src[start - 1] == src[ref - 1]) {
+            --start;
+            --ref;
+        }
+        auto match_length = static_cast<int64_t>(LZ4_MIN_MATCH) + (i - start);
+        while (start + match_length < match_end_limit && src[start + match_length] == src[ref + match_length]) {
+            ++match_length;
+        }
+        op = write_sequence_(op, src + anchor, start - anchor, start - ref, match_length);
+        i = anchor = start + match_length;
+        if (i - 2 < match_find_limit) { table[hash_(read32_(src + i - 2))] = static_cast<uint32_t>(i - 2 + 1); }
+    }
+    op = write_sequence_(op, src + anchor, length - anchor, 0, 0);
+    return op - dst;
+}
+
+bool lz4_decompress_block_(const omega_byte_t *src, int64_t src_length, omega_byte_t *dst,
+                           int64_t dst_length) noexcept {
+    assert(src);
+    assert(dst);
+    const auto *ip = src;
+    const auto *const src_end = src + src_length;
+    auto *op = dst;
+    auto *const dst_end = dst + dst_length;
+    const auto read_length = [&](int64_t length) -> int64_t {
+        if (15 == length) {
+            omega_byte_t byte;
+            do {
+                if (ip == src_end) { return -1; }
+                byte = *ip++;
+                length += byte;
+            } while (255 == byte);
+        }
+        return length;
+    };
+    while (ip < src_end) {
+        const auto token = *ip++;
+        const auto literal_length = read_length(token >> 4);
+        if (literal_length < 0 || src_end - ip < literal_length || dst_end - op < literal_length) { return false; }
+        memcpy(op, ip, literal_length);
+        ip += literal_length;
+        op += literal_length;
+        // The last sequence has only literals
+        if (ip == src_end) { break; }
+        if (src_end - ip < 2) { return false; }
+        const auto offset = static_cast<int64_t>(ip[0]) | (static_cast<int64_t>(ip[1]) << 8);
+        ip += 2;
+        const auto match_code = read_length(token & 15);
+        if (match_code < 0 || 0 == offset || op - dst < offset) { return false; }
+        const auto match_length = match_code + LZ4_MIN_MATCH;
+        if (dst_end - op < match_length) { return false; }
+        const auto *match = op - offset;
+        if (match_length <= offset) {
+            memcpy(op, match, match_length);
+            op += match_length;
+        } else {
+            // Overlapping matches repeat the bytes being written
+            for (int64_t j = 0; j < match_length; ++j) { *op++ = *match++; }
+        }
+    }
+    return op == dst_end;
+}
@@ -0,0 +1,49 @@
+/**********************************************************************************************************************
+ * Copyright (c) 2021 Concurrent Technologies Corporation.                                                            *
+ *                                                                                                                    *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance     *
+ * with the License.  You may obtain a copy of the License at                                                         *
+ *                                                                                                                    *
+ *     http://www.apache.org/licenses/LICENSE-2.0                                                                     *
+ *                                                                                                                    *
+ * Unless required by applicable law or agreed to in writing, software is distributed under the License is            *
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or                   *
+ * implied.  See the License for the specific language governing permissions and limitations under the License.       *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+
+#ifndef OMEGA_EDIT_LZ4_BLOCK_HPP
+#define OMEGA_EDIT_LZ4_BLOCK_HPP
+
+#include "../../include/omega_edit/byte.h"
+#include <cstdint>
+
+/**
+ * Get the largest number of bytes the compression of the given number of bytes can take
+ * @param length number of bytes to compress
+ * @return compression bound
+ */
+inline int64_t lz4_compress_bound_(int64_t length) { return length + length / 255 + 16; }
+
+/**
+ * Compress the given bytes into the LZ4 block format
+ * @param src bytes to compress
+ * @param length number of bytes to compress (up to 64 KiB, so the hash table positions fit the match window)
+ * @param dst buffer to compress into
+ * @param capacity capacity of the destination buffer
+ * @return number of compressed bytes, or zero if the compressed bytes would not fit in the destination buffer
+ */
+int64_t lz4_compress_block_(const omega_byte_t *src, int64_t length, omega_byte_t *dst, int64_t capacity) noexcept;
+
+/**
+ * Decompress the given LZ4 block
+ * @param src compressed bytes
+ * @param src_length number of compressed bytes
+ * @param dst buffer to decompress into
+ * @param dst_length exact number of bytes the block decompresses into
+ * @return true if the block decompressed into exactly dst_length bytes, false if the block is malformed
+ */
+bool lz4_decompress_block_(const omega_byte_t *src, int64_t src_length, omega_byte_t *dst,
+                           int64_t dst_length) noexcept;
+
+#endif//OMEGA_EDIT_LZ4_BLOCK_HPP
@@ -15,8 +15,10 @@
 #ifndef OMEGA_EDIT_MODEL_DEF_HPP
 #define OMEGA_EDIT_MODEL_DEF_HPP
 
+#include "block_summary_def.hpp"
 #include "internal_fwd_defs.hpp"
 #include "model_segment_def.hpp"
+#include <cstdint>
 #include <cstdio>
 #include <memory>
 #include <string>
@@ -26,12 +28,31 @@ using omega_model_segment_ptr_t = std::unique_ptr<omega_model_segment_t>;
 using omega_model_segments_t = std::vector<omega_model_segment_ptr_t>;
 using omega_changes_t = std::vector<const_omega_change_ptr_t>;
 
+/**
+ * Clone the given model segment, sharing the change it refers to
+ * @param segment_ptr model segment to clone
+ * @return cloned model segment
+ */
+inline omega_model_segment_ptr_t clone_model_segment_(const omega_model_segment_ptr_t &segment_ptr) {
+    auto result = std::make_unique<omega_model_segment_t>();
+    result->computed_offset = segment_ptr->computed_offset;
+    result->computed_length = segment_ptr->computed_length;
+    result->change_offset = segment_ptr->change_offset;
+    result->change_ptr = segment_ptr->change_ptr;
+    return result;
+}
+
 struct omega_model_struct {
-    FILE *file_ptr{};                       ///< File being edited (open for read)
-    std::string file_path{};                ///< File path being edited
-    omega_changes_t changes{};              ///< Collection of changes for this session, ordered by time
-    omega_changes_t changes_undone{};       ///< Undone changes that are eligible for being redone
-    omega_model_segments_t model_segments{};///< Model segment vector
+    FILE *file_ptr{};                         ///< File being edited (open for read)
+    std::string file_path{};                  ///< File path being edited
+    omega_changes_t changes{};                ///< Collection of changes for this session, ordered by time
+    omega_changes_t changes_undone{};         ///< Undone changes that are eligible for being redone
+    omega_model_segments_t model_segments{};  ///< Model segment vector
+    omega_block_summaries_t block_summaries{};///< Lazily built summaries of the file blocks
+    bool is_logical_checkpoint{};             ///< True if the model shares the file of the model below it
+    omega_model_segments_t base_segments{};   ///< Frozen segments a logical checkpoint or compacted model starts from
+    bool is_compacted{};                      ///< True if the model starts from segments squashed from its changes
+    int64_t num_changes_adjustment{};         ///< Session changes adjustment to restore when the model is destroyed
 };
 
 #endif//OMEGA_EDIT_MODEL_DEF_HPP
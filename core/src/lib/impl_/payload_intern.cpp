@@ -0,0 +1,90 @@
+/**********************************************************************************************************************
+ * Copyright (c) 2021 Concurrent Technologies Corporation.                                                            *
+ *                                                                                                                    *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance     *
+ * with the License.  You may obtain a copy of the License at                                                         *
+ *                                                                                                                    *
+ *     http://www.apache.org/licenses/LICENSE-2.0                                                                     *
+ *                                                                                                                    *
+ * Unless required by applicable law or agreed to in writing, software is distributed under the License is            *
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or                   *
+ * implied.  See the License for the specific language governing permissions and limitations under the License.       *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+
+#include "payload_intern.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <iterator>
+#include <new>
+
+namespace {
+    inline uint64_t read64_(const omega_byte_t *ptr) {
+        uint64_t value;
+        memcpy(&value, ptr, sizeof(value));
+        return value;
+    }
+
+    // Hash whole words at a time, so hashing a payload costs much less than copying it
+    uint64_t hash_bytes_(const omega_byte_t *bytes, int64_t length) {
+        const uint64_t multiplier = 0x9E3779B97F4A7C15ULL;
+        uint64_t hash = static_cast<uint64_t>(length) * multiplier;
+        int64_t i = 0;
+        for (; i + 8 <= length; i += 8) {
+            hash = (hash ^ read64_(bytes + i)) * multiplier;
+            hash ^= hash >> 29;
+        }
+        for (; i < length; ++i) { hash = (hash ^ bytes[i]) * multiplier; }
+        return hash ^ (hash >> 32);
+    }
+}// namespace
+
+payload_intern_table_t::~payload_intern_table_t() {
+    for (const auto &bucket: entries_) {
+        for (const auto &entry: bucket.second) { release_interned_payload_(entry.bytes); }
+    }
+}
+
+omega_byte_t *payload_intern_table_t::intern(const omega_byte_t *bytes, int64_t length) {
+    assert(bytes);
+    assert(0 < length);
+    auto &bucket = entries_[hash_bytes_(bytes, length)];
+    for (const auto &entry: bucket) {
+        if (entry.length == length && 0 == memcmp(entry.bytes, bytes, length)) {
+            interned_payload_ref_count_(entry.bytes)->fetch_add(1, std::memory_order_relaxed);
+            return entry.bytes;
+        }
+    }
+    // The payload starts with one reference for the table and one for the caller
+    auto *const base = new omega_byte_t[sizeof(payload_ref_count_t) + length + 1];
+    new (base) payload_ref_count_t(2);
+    auto *const interned = base + sizeof(payload_ref_count_t);
+    memcpy(interned, bytes, length);
+    interned[length] = '\0';
+    bucket.push_back({interned, length});
+    // Purging whenever the table doubles keeps the cost of purging constant per interned payload
+    if (purge_size_ <= ++size_) {
+        purge();
+        purge_size_ = std::max(purge_size_, 2 * size_);
+    }
+    return interned;
+}
+
+void payload_intern_table_t::purge() {
+    for (auto iter = entries_.begin(); iter != entries_.end();) {
+        auto &bucket = iter->second;
+        for (size_t i = 0; i < bucket.size();) {
+            // Only the session thread takes references, so a payload only the table refers to stays that way
+            if (1 == interned_payload_ref_count_(bucket[i].bytes)->load(std::memory_order_acquire)) {
+                release_interned_payload_(bucket[i].bytes);
+                bucket[i] = bucket.back();
+                bucket.pop_back();
+                --size_;
+            } else {
+                ++i;
+            }
+        }
+        iter = bucket.empty() ? entries_.erase(iter) : std::next(iter);
+    }
+}
@@ -0,0 +1,102 @@
+/**********************************************************************************************************************
+ * Copyright (c) 2021 Concurrent Technologies Corporation.                                                            *
+ *                                                                                                                    *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance     *
+ * with the License.  You may obtain a copy of the License at                                                         *
+ *                                                                                                                    *
+ *     http://www.apache.org/licenses/LICENSE-2.0                                                                     *
+ *                                                                                                                    *
+ * Unless required by applicable law or agreed to in writing, software is distributed under the License is            *
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or                   *
+ * implied.  See the License for the specific language governing permissions and limitations under the License.       *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+
+#ifndef OMEGA_EDIT_PAYLOAD_INTERN_HPP
+#define OMEGA_EDIT_PAYLOAD_INTERN_HPP
+
+#include "../../include/omega_edit/byte.h"
+#include <atomic>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * Interned payloads are shared by every change that has the same bytes.  Each one is allocated with a reference count
+ * in front of the bytes, so the changes that share it can release it without going through the session.  The count is
+ * atomic because changes can be released by the threads reading session snapshots that share them.
+ */
+
+using payload_ref_count_t = std::atomic<int64_t>;
+
+static_assert(sizeof(payload_ref_count_t) == sizeof(int64_t), "interned payload reference count must be 8 bytes");
+
+/**
+ * Get the reference count in front of the given interned payload
+ * @param bytes interned payload bytes
+ * @return reference count of the payload
+ */
+inline payload_ref_count_t *interned_payload_ref_count_(omega_byte_t *bytes) noexcept {
+    return reinterpret_cast<payload_ref_count_t *>(bytes - sizeof(payload_ref_count_t));
+}
+
+/**
+ * Release a reference to the given interned payload, freeing it if it was the last reference
+ * @param bytes interned payload bytes
+ */
+inline void release_interned_payload_(omega_byte_t *bytes) noexcept {
+    auto *const ref_count_ptr = interned_payload_ref_count_(bytes);
+    if (1 == ref_count_ptr->fetch_sub(1, std::memory_order_acq_rel)) {
+        ref_count_ptr->~payload_ref_count_t();
+        delete[] reinterpret_cast<omega_byte_t *>(ref_count_ptr);
+    }
+}
+
+/**
+ * Content-addressed table of the interned payloads of a session.  The table holds a reference to each of its payloads,
+ * so they can be found again while they are in use, and lets go of the payloads nothing else refers to when purged.
+ */
+class payload_intern_table_t {
+public:
+    payload_intern_table_t() = default;
+
+    /**
+     * Release the references the table holds
+     */
+    ~payload_intern_table_t();
+
+    payload_intern_table_t(const payload_intern_table_t &) = delete;
+
+    payload_intern_table_t &operator=(const payload_intern_table_t &) = delete;
+
+    /**
+     * Get a reference to the interned payload with the given bytes, interning a copy of the bytes if there is none
+     * @param bytes payload bytes
+     * @param length number of payload bytes
+     * @return interned payload bytes (null-terminated), to be released with release_interned_payload_
+     */
+    omega_byte_t *intern(const omega_byte_t *bytes, int64_t length);
+
+    /**
+     * Release the payloads that only the table refers to
+     */
+    void purge();
+
+    /**
+     * Get the number of payloads in the table
+     * @return number of interned payloads
+     */
+    int64_t get_size() const { return size_; }
+
+private:
+    struct entry_t {
+        omega_byte_t *bytes{};///< Interned payload bytes
+        int64_t length{};     ///< Number of interned payload bytes
+    };
+
+    std::unordered_map<uint64_t, std::vector<entry_t>> entries_{};///< Interned payloads by the hash of their bytes
+    int64_t size_{};                                              ///< Number of interned payloads
+    int64_t purge_size_{64};                                      ///< Number of interned payloads that triggers a purge
+};
+
+#endif//OMEGA_EDIT_PAYLOAD_INTERN_HPP
@@ -0,0 +1,119 @@
+/**********************************************************************************************************************
+ * Copyright (c) 2021 Concurrent Technologies Corporation.                                                            *
+ *                                                                                                                    *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance     *
+ * with the License.  You may obtain a copy of the License at                                                         *
+ *                                                                                                                    *
+ *     http://www.apache.org/licenses/LICENSE-2.0                                                                     *
+ *                                                                                                                    *
+ * Unless required by applicable law or agreed to in writing, software is distributed under the License is            *
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or                   *
+ * implied.  See the License for the specific language governing permissions and limitations under the License.       *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+
+#include "payload_store.hpp"
+#include "../../include/omega_edit/config.h"
+#include "../../include/omega_edit/filesystem.h"
+#include "macros.h"
+#include <cassert>
+#include <cstdio>
+
+#ifdef OMEGA_BUILD_WINDOWS
+#include <io.h>
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#define close _close
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// Extents start at multiples of this, which satisfies the mapping offset alignment of all supported platforms
+#define PAYLOAD_STORE_ALIGNMENT (INT64_C(64) * 1024)
+
+std::unique_ptr<payload_store_t> payload_store_t::create(const char *directory) {
+    assert(directory);
+    char file_path[FILENAME_MAX];
+    if (FILENAME_MAX <= snprintf(file_path, FILENAME_MAX, "%s%c.OmegaEdit-payloads.XXXXXX", directory,
+                                 omega_util_directory_separator())) {
+        LOG_ERROR("failed to create payload store filename template");
+        return nullptr;
+    }
+    const auto fd = omega_util_mkstemp(file_path, 0600);// S_IRUSR | S_IWUSR
+    if (fd < 0) {
+        LOG_ERROR("failed to create payload store '" << file_path << "'");
+        return nullptr;
+    }
+    return std::unique_ptr<payload_store_t>(new payload_store_t(fd, file_path));
+}
+
+payload_store_t::~payload_store_t() {
+    for (const auto &extent: extents_) {
+#ifdef OMEGA_BUILD_WINDOWS
+        UnmapViewOfFile(extent.base);
+#else
+        munmap(extent.base, static_cast<size_t>(extent.length));
+#endif
+    }
+    close(fd_);
+    if (0 != omega_util_remove_file(file_path_.c_str())) { LOG_ERRNO(); }
+}
+
+omega_byte_t *payload_store_t::map_extent_(int64_t length) {
+    const auto offset = file_length_;
+    const auto new_file_length = offset + length;
+#ifdef OMEGA_BUILD_WINDOWS
+    if (0 != _chsize_s(fd_, new_file_length)) { return nullptr; }
+    const auto file_handle = reinterpret_cast<HANDLE>(_get_osfhandle(fd_));
+    const auto mapping_handle =
+            CreateFileMappingA(file_handle, nullptr, PAGE_READWRITE, static_cast<DWORD>(new_file_length >> 32),
+                               static_cast<DWORD>(new_file_length), nullptr);
+    if (!mapping_handle) { return nullptr; }
+    // The view keeps the mapping alive
+    auto *const base = static_cast<omega_byte_t *>(MapViewOfFile(mapping_handle, FILE_MAP_WRITE,
+                                                                 static_cast<DWORD>(offset >> 32),
+                                                                 static_cast<DWORD>(offset),
+                                                                 static_cast<SIZE_T>(length)));
+    CloseHandle(mapping_handle);
+    if (!base) { return nullptr; }
+#else
+    // Growing the file leaves a hole, so disk space is only used as payloads are written
+    if (0 != ftruncate(fd_, new_file_length)) { return nullptr; }
+    auto *const mapped = mmap(nullptr, static_cast<size_t>(length), PROT_READ | PROT_WRITE, MAP_SHARED, fd_, offset);
+    if (MAP_FAILED == mapped) { return nullptr; }
+    auto *const base = static_cast<omega_byte_t *>(mapped);
+#endif
+    file_length_ = new_file_length;
+    extents_.push_back({base, length});
+    return base;
+}
+
+omega_byte_t *payload_store_t::allocate(int64_t size) {
+    assert(0 < size);
+    if (available_ < size) {
+        // Payloads larger than an extent get an extent of their own, and the current extent keeps taking smaller ones
+        const auto own_extent = OMEGA_PAYLOAD_STORE_EXTENT_SIZE < size;
+        const auto length = own_extent ? (size + PAYLOAD_STORE_ALIGNMENT - 1) / PAYLOAD_STORE_ALIGNMENT *
+                                                 PAYLOAD_STORE_ALIGNMENT
+                                       : OMEGA_PAYLOAD_STORE_EXTENT_SIZE;
+        auto *const base = map_extent_(length);
+        if (!base) {
+            LOG_ERRNO();
+            return nullptr;
+        }
+        if (own_extent) {
+            size_ += size;
+            return base;
+        }
+        next_ = base;
+        available_ = length;
+    }
+    size_ += size;
+    auto *const bytes = next_;
+    next_ += size;
+    available_ -= size;
+    return bytes;
+}
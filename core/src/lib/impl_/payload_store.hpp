@@ -0,0 +1,85 @@
+/**********************************************************************************************************************
+ * Copyright (c) 2021 Concurrent Technologies Corporation.                                                            *
+ *                                                                                                                    *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance     *
+ * with the License.  You may obtain a copy of the License at                                                         *
+ *                                                                                                                    *
+ *     http://www.apache.org/licenses/LICENSE-2.0                                                                     *
+ *                                                                                                                    *
+ * Unless required by applicable law or agreed to in writing, software is distributed under the License is            *
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or                   *
+ * implied.  See the License for the specific language governing permissions and limitations under the License.       *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+
+#ifndef OMEGA_EDIT_PAYLOAD_STORE_HPP
+#define OMEGA_EDIT_PAYLOAD_STORE_HPP
+
+#include "../../include/omega_edit/byte.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * Session-local, append-only store of change payloads, backed by a memory-mapped file.  The file is mapped in extents
+ * that are never remapped, so pointers to payloads in the store stay valid for the life of the store, and the operating
+ * system can page the payloads out to the file instead of holding them in memory.
+ */
+class payload_store_t {
+public:
+    /**
+     * Create a payload store backed by a new file in the given directory
+     * @param directory directory to create the payload file in
+     * @return payload store, or nullptr on failure
+     */
+    static std::unique_ptr<payload_store_t> create(const char *directory);
+
+    /**
+     * Unmap, close, and remove the payload file
+     */
+    ~payload_store_t();
+
+    payload_store_t(const payload_store_t &) = delete;
+
+    payload_store_t &operator=(const payload_store_t &) = delete;
+
+    /**
+     * Allocate space for a payload at the end of the store
+     * @param size number of bytes to allocate
+     * @return writable pointer to the allocated bytes, or nullptr on failure
+     */
+    omega_byte_t *allocate(int64_t size);
+
+    /**
+     * Get the number of bytes of payloads in the store
+     * @return number of bytes allocated from the store
+     */
+    int64_t get_size() const { return size_; }
+
+    /**
+     * Get the path of the payload file
+     * @return payload file path
+     */
+    const std::string &get_file_path() const { return file_path_; }
+
+private:
+    struct extent_t {
+        omega_byte_t *base{};///< Start of the mapped extent
+        int64_t length{};    ///< Number of bytes mapped
+    };
+
+    payload_store_t(int fd, std::string file_path) : fd_(fd), file_path_(std::move(file_path)) {}
+
+    omega_byte_t *map_extent_(int64_t length);
+
+    int fd_;                         ///< Payload file descriptor
+    std::string file_path_;          ///< Payload file path
+    int64_t file_length_{};          ///< Length of the payload file (the end of the last mapped extent)
+    int64_t size_{};                 ///< Number of bytes allocated from the store
+    std::vector<extent_t> extents_{};///< Mapped extents of the payload file
+    omega_byte_t *next_{};           ///< Next free byte of the current extent
+    int64_t available_{};            ///< Number of free bytes in the current extent
+};
+
+#endif//OMEGA_EDIT_PAYLOAD_STORE_HPP
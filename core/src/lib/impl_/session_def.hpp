@@ -17,8 +17,11 @@
 
 #include "../../include/omega_edit/edit.h"
 #include "../../include/omega_edit/fwd_defs.h"
+#include "../../include/omega_edit/session.h"
 #include "internal_fwd_defs.hpp"
 #include "model_def.hpp"
+#include "payload_intern.hpp"
+#include "payload_store.hpp"
 #include <vector>
 
 using omega_model_ptr_t = std::unique_ptr<omega_model_t>;
@@ -33,20 +36,89 @@ using omega_viewports_t = std::vector<omega_viewport_ptr_t>;
 #define SESSION_FLAGS_SESSION_CHANGES_PAUSED ((uint8_t) (1 << 1))
 #define SESSION_FLAGS_SESSION_TRANSACTION_OPENED ((uint8_t) (1 << 2))
 #define SESSION_FLAGS_SESSION_TRANSACTION_IN_PROGRESS ((uint8_t) (1 << 3))
+#define SESSION_FLAGS_PROFILE_TRACKING ((uint8_t) (1 << 4))
+#define SESSION_FLAGS_COALESCE_CHANGES ((uint8_t) (1 << 5))
 
 struct omega_session_struct {
-    omega_session_event_cbk_t event_handler{}; ///< User callback when the session changes
-    void *user_data_ptr{};                     ///< Pointer to associated user-provided data
-    int32_t event_interest_;                   ///< Events of interest
-    omega_viewports_t viewports_{};            ///< Collection of viewports in this session
-    omega_search_contexts_t search_contexts_{};///< Collection of active search contexts
-    omega_models_t models_{};                  ///< Edit models (internal)
-    int64_t num_changes_adjustment_{};         ///< Number of changes in checkpoints
-    int8_t session_flags_{};                   ///< Internal state flags
-    std::string checkpoint_directory_{};       ///< Path to checkpoint directory
-    std::string checkpoint_file_name_{};       ///< Name of session checkpoint file
+    omega_session_event_cbk_t event_handler{};        ///< User callback when the session changes
+    void *user_data_ptr{};                            ///< Pointer to associated user-provided data
+    int32_t event_interest_;                          ///< Events of interest
+    omega_viewports_t viewports_{};                   ///< Collection of viewports in this session
+    omega_search_contexts_t search_contexts_{};       ///< Collection of active search contexts
+    std::shared_ptr<payload_store_t> payload_store_{};///< Store of spilled payloads (outlives the models)
+    payload_intern_table_t payload_intern_table_{};   ///< Interned payloads shared by identical changes
+    omega_models_t models_{};                         ///< Edit models (internal)
+    int64_t num_changes_adjustment_{};                ///< Number of changes in checkpoints
+    int8_t session_flags_{};                          ///< Internal state flags
+    std::string checkpoint_directory_{};              ///< Path to checkpoint directory
+    std::string checkpoint_file_name_{};              ///< Name of session checkpoint file
+    omega_byte_frequency_profile_t tracked_profile_{};///< Byte frequency profile maintained as the session is edited
+    bool tracked_profile_valid_{};                    ///< True if the tracked byte frequency profile is up-to-date
+    int64_t payload_compression_threshold_{};         ///< Payload length at or above which payloads are compressed
+    int64_t payload_memory_budget_{};                 ///< Uncompressed payload bytes before compressing
+    int64_t payload_spill_threshold_{};               ///< Payload length at or above which payloads are spilled
+    int64_t checkpoint_disk_budget_{-1};              ///< Checkpoint file bytes allowed (negative for none)
+    int64_t undo_depth_limit_{-1};                    ///< Changes kept for undo (negative for no limit)
+    int64_t history_memory_budget_{-1};               ///< Undo history memory allowed (negative for none)
+    int64_t history_memory_{};                        ///< Memory held by the undo history
+    int64_t resident_payload_bytes_{};                ///< Uncompressed payload bytes held in memory
+    int64_t num_folded_changes_{};                    ///< Number of changes squashed by compacting the session
 };
 
 bool omega_session_get_transaction_bit_(const omega_session_t *session_ptr);
 
+/**
+ * Get the number of bytes of uncompressed change payloads (done and undone) the session holds in memory
+ * @param session_ptr session to get the resident payload bytes for
+ * @return number of bytes of uncompressed payloads that are not spilled to the payload store
+ */
+int64_t omega_session_get_resident_payload_bytes_(const omega_session_t *session_ptr);
+
+/**
+ * Bring the running count of the memory held by the undo history of the session back in step with its changes, after
+ * changes were dropped or squashed without being accounted for one at a time
+ * @param session_ptr session whose undo history memory to recompute
+ */
+void omega_session_recompute_history_memory_(omega_session_t *session_ptr);
+
+/**
+ * Fold the oldest changes of the session into the model it starts from while its undo history exceeds the undo depth
+ * limit or the history memory budget.  Whole transactions are folded, and not while a transaction is open.
+ * @param session_ptr session whose undo history to bound
+ * @return zero on success and non-zero otherwise
+ */
+int omega_session_enforce_history_limits_(omega_session_t *session_ptr);
+
+/**
+ * Begin updating the tracked byte frequency profile (if tracking and up-to-date) for a change, by profiling the window
+ * that spans the byte before the given offset up to and including the first byte of the given unchanged tail.  The
+ * tracked profile is only updated by omega_session_end_tracked_profile_update_, once the change has succeeded, so a
+ * change that fails leaves it as it was.
+ * @param session_ptr session whose tracked profile to update
+ * @param offset offset where the change begins
+ * @param tail_length number of bytes at the end of the session that the change does not touch
+ * @param window_profile_ptr set to the profile of the window before the change
+ * @return true if the tracked profile must be updated once the change succeeds, false otherwise
+ */
+bool omega_session_begin_tracked_profile_update_(omega_session_t *session_ptr, int64_t offset, int64_t tail_length,
+                                                 omega_byte_frequency_profile_t *window_profile_ptr);
+
+/**
+ * End updating the tracked byte frequency profile after a change succeeded, by replacing the profile of the window
+ * before the change with the profile of the window after it.  Doing so keeps the profile, including DOS EOL pairs,
+ * up-to-date.
+ * @param session_ptr session whose tracked profile to update
+ * @param offset offset where the change begins
+ * @param tail_length number of bytes at the end of the session that the change does not touch
+ * @param window_profile_ptr profile of the window before the change, from omega_session_begin_tracked_profile_update_
+ */
+void omega_session_end_tracked_profile_update_(omega_session_t *session_ptr, int64_t offset, int64_t tail_length,
+                                               const omega_byte_frequency_profile_t *window_profile_ptr);
+
+/**
+ * Invalidate the tracked byte frequency profile, so it will be recomputed the next time it is needed
+ * @param session_ptr session whose tracked profile to invalidate
+ */
+void omega_session_invalidate_tracked_profile_(omega_session_t *session_ptr);
+
 #endif//OMEGA_EDIT_SESSION_DEF_HPP
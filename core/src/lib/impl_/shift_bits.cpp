@@ -0,0 +1,129 @@
+/**********************************************************************************************************************
+ * Copyright (c) 2021 Concurrent Technologies Corporation.                                                            *
+ *                                                                                                                    *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance     *
+ * with the License.  You may obtain a copy of the License at                                                         *
+ *                                                                                                                    *
+ *     http://www.apache.org/licenses/LICENSE-2.0                                                                     *
+ *                                                                                                                    *
+ * Unless required by applicable law or agreed to in writing, software is distributed under the License is            *
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or                   *
+ * implied.  See the License for the specific language governing permissions and limitations under the License.       *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+
+#include "shift_bits.hpp"
+#include <cassert>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define OMEGA_SHIFT_BITS_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && 2 <= _M_IX86_FP)
+#include <emmintrin.h>
+#define OMEGA_SHIFT_BITS_SSE2
+#endif
+
+namespace {
+    /*
+     * Bytes are big-endian within the shifted bit stream, so words are assembled most significant byte first.
+     * Compilers recognize these loops as a load or store and a byte swap.
+     */
+    inline uint64_t load_be64_(const omega_byte_t *src) {
+        uint64_t word = 0;
+        for (int i = 0; i < 8; ++i) { word = (word << 8) | src[i]; }
+        return word;
+    }
+
+    inline void store_be64_(omega_byte_t *dst, uint64_t word) {
+        for (int i = 7; 0 <= i; --i) {
+            dst[i] = static_cast<omega_byte_t>(word);
+            word >>= 8;
+        }
+    }
+}// namespace
+
+void shift_bits_left_(const omega_byte_t *src, omega_byte_t *dst, int64_t count, int bits) noexcept {
+    assert(src);
+    assert(dst);
+    assert(0 <= bits && bits < 8);
+    if (0 == bits) {
+        memcpy(dst, src, count);
+        return;
+    }
+    int64_t i = 0;
+    // Vector lanes shift 16-bit words, then mask off the bits that crossed into the neighbouring byte
+#if defined(OMEGA_SHIFT_BITS_AVX2)
+    const auto left_count = _mm_cvtsi32_si128(bits);
+    const auto right_count = _mm_cvtsi32_si128(8 - bits);
+    const auto left_mask = _mm256_set1_epi8(static_cast<char>(0xFF << bits));
+    const auto right_mask = _mm256_set1_epi8(static_cast<char>(0xFF >> (8 - bits)));
+    for (; i + 32 <= count; i += 32) {
+        const auto current = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+        const auto next = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i + 1));
+        const auto shifted = _mm256_or_si256(_mm256_and_si256(_mm256_sll_epi16(current, left_count), left_mask),
+                                             _mm256_and_si256(_mm256_srl_epi16(next, right_count), right_mask));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), shifted);
+    }
+#elif defined(OMEGA_SHIFT_BITS_SSE2)
+    const auto left_count = _mm_cvtsi32_si128(bits);
+    const auto right_count = _mm_cvtsi32_si128(8 - bits);
+    const auto left_mask = _mm_set1_epi8(static_cast<char>(0xFF << bits));
+    const auto right_mask = _mm_set1_epi8(static_cast<char>(0xFF >> (8 - bits)));
+    for (; i + 16 <= count; i += 16) {
+        const auto current = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        const auto next = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i + 1));
+        const auto shifted = _mm_or_si128(_mm_and_si128(_mm_sll_epi16(current, left_count), left_mask),
+                                          _mm_and_si128(_mm_srl_epi16(next, right_count), right_mask));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), shifted);
+    }
+#endif
+    for (; i + 8 <= count; i += 8) {
+        store_be64_(dst + i, (load_be64_(src + i) << bits) | (src[i + 8] >> (8 - bits)));
+    }
+    for (; i < count; ++i) {
+        dst[i] = static_cast<omega_byte_t>((src[i] << bits) | (src[i + 1] >> (8 - bits)));
+    }
+}
+
+void shift_bits_right_(const omega_byte_t *src, omega_byte_t *dst, int64_t count, int bits) noexcept {
+    assert(src);
+    assert(dst);
+    assert(0 <= bits && bits < 8);
+    if (0 == bits) {
+        memcpy(dst, src + 1, count);
+        return;
+    }
+    int64_t i = 0;
+#if defined(OMEGA_SHIFT_BITS_AVX2)
+    const auto right_count = _mm_cvtsi32_si128(bits);
+    const auto left_count = _mm_cvtsi32_si128(8 - bits);
+    const auto right_mask = _mm256_set1_epi8(static_cast<char>(0xFF >> bits));
+    const auto left_mask = _mm256_set1_epi8(static_cast<char>(0xFF << (8 - bits)));
+    for (; i + 32 <= count; i += 32) {
+        const auto previous = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+        const auto current = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i + 1));
+        const auto shifted = _mm256_or_si256(_mm256_and_si256(_mm256_srl_epi16(current, right_count), right_mask),
+                                             _mm256_and_si256(_mm256_sll_epi16(previous, left_count), left_mask));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), shifted);
+    }
+#elif defined(OMEGA_SHIFT_BITS_SSE2)
+    const auto right_count = _mm_cvtsi32_si128(bits);
+    const auto left_count = _mm_cvtsi32_si128(8 - bits);
+    const auto right_mask = _mm_set1_epi8(static_cast<char>(0xFF >> bits));
+    const auto left_mask = _mm_set1_epi8(static_cast<char>(0xFF << (8 - bits)));
+    for (; i + 16 <= count; i += 16) {
+        const auto previous = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        const auto current = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i + 1));
+        const auto shifted = _mm_or_si128(_mm_and_si128(_mm_srl_epi16(current, right_count), right_mask),
+                                          _mm_and_si128(_mm_sll_epi16(previous, left_count), left_mask));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), shifted);
+    }
+#endif
+    for (; i + 8 <= count; i += 8) {
+        store_be64_(dst + i, (load_be64_(src + i + 1) >> bits) | (static_cast<uint64_t>(src[i]) << (64 - bits)));
+    }
+    for (; i < count; ++i) {
+        dst[i] = static_cast<omega_byte_t>((src[i + 1] >> bits) | (src[i] << (8 - bits)));
+    }
+}
@@ -0,0 +1,43 @@
+/**********************************************************************************************************************
+ * Copyright (c) 2021 Concurrent Technologies Corporation.                                                            *
+ *                                                                                                                    *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance     *
+ * with the License.  You may obtain a copy of the License at                                                         *
+ *                                                                                                                    *
+ *     http://www.apache.org/licenses/LICENSE-2.0                                                                     *
+ *                                                                                                                    *
+ * Unless required by applicable law or agreed to in writing, software is distributed under the License is            *
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or                   *
+ * implied.  See the License for the specific language governing permissions and limitations under the License.       *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+
+#ifndef OMEGA_EDIT_SHIFT_BITS_HPP
+#define OMEGA_EDIT_SHIFT_BITS_HPP
+
+#include "../../include/omega_edit/byte.h"
+#include <cstdint>
+
+/**
+ * Shift bits towards the start of the bytes, so each destination byte is its source byte shifted left by the given
+ * number of bits, filled from the top bits of the next source byte
+ * @param src source bytes, count + 1 of them (the last one only supplies the bits shifted into the last destination
+ * byte)
+ * @param dst destination bytes, count of them (may not overlap the source bytes)
+ * @param count number of destination bytes
+ * @param bits number of bits to shift (0 to 7)
+ */
+void shift_bits_left_(const omega_byte_t *src, omega_byte_t *dst, int64_t count, int bits) noexcept;
+
+/**
+ * Shift bits towards the end of the bytes, so each destination byte is its source byte shifted right by the given
+ * number of bits, filled from the bottom bits of the previous source byte
+ * @param src source bytes, count + 1 of them (the first one only supplies the bits shifted into the first destination
+ * byte)
+ * @param dst destination bytes, count of them (may not overlap the source bytes)
+ * @param count number of destination bytes
+ * @param bits number of bits to shift (0 to 7)
+ */
+void shift_bits_right_(const omega_byte_t *src, omega_byte_t *dst, int64_t count, int bits) noexcept;
+
+#endif//OMEGA_EDIT_SHIFT_BITS_HPP
@@ -0,0 +1,61 @@
+/**********************************************************************************************************************
+ * Copyright (c) 2021 Concurrent Technologies Corporation.                                                            *
+ *                                                                                                                    *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance     *
+ * with the License.  You may obtain a copy of the License at                                                         *
+ *                                                                                                                    *
+ *     http://www.apache.org/licenses/LICENSE-2.0                                                                     *
+ *                                                                                                                    *
+ * Unless required by applicable law or agreed to in writing, software is distributed under the License is            *
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or                   *
+ * implied.  See the License for the specific language governing permissions and limitations under the License.       *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+
+#ifndef OMEGA_EDIT_SNAPSHOT_DEF_HPP
+#define OMEGA_EDIT_SNAPSHOT_DEF_HPP
+
+#include "../../include/omega_edit/fwd_defs.h"
+#include "find.h"
+#include "model_def.hpp"
+#include "payload_store.hpp"
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * Immutable snapshot of a session.  The model holds clones of the model segments of the session, which share the
+ * changes of the session, and its own handle to the file the segments read from, so it can be read on another thread.
+ */
+struct omega_snapshot_struct {
+    std::shared_ptr<payload_store_t> payload_store_{};///< Store of spilled payloads (outlives the model)
+    omega_model_t model_{};                           ///< Model of the session when the snapshot was taken
+    int64_t num_changes_{};                           ///< Number of active changes when the snapshot was taken
+    std::mutex mutex_{};                              ///< Serializes reads of the model file and block summaries
+
+    ~omega_snapshot_struct() {
+        if (model_.file_ptr) { FCLOSE(model_.file_ptr); }
+    }
+};
+
+/**
+ * Search of a range of a snapshot for the successive matches of a pattern.  The window of the snapshot being searched is
+ * kept between matches, and the next window overlaps it by one less than the pattern length.
+ */
+struct omega_snapshot_search_context_struct {
+    omega_snapshot_t *snapshot_ptr{};               ///< Snapshot being searched
+    std::vector<omega_byte_t> pattern{};            ///< Pattern to find
+    const omega_find_skip_table_t *skip_table_ptr{};///< Skip table of the pattern
+    std::unique_ptr<omega_byte_t[]> window{};       ///< Bytes of the snapshot being searched
+    int64_t window_capacity{};                      ///< Capacity of the window
+    int64_t window_offset{};                        ///< Snapshot offset of the window
+    int64_t window_length{};                        ///< Number of bytes in the window
+    int64_t next_offset{};                          ///< Snapshot offset to resume the search from
+    int64_t end{};                                  ///< Snapshot offset where the search range ends
+
+    ~omega_snapshot_search_context_struct() {
+        if (skip_table_ptr) { omega_find_destroy_skip_table(skip_table_ptr); }
+    }
+};
+
+#endif//OMEGA_EDIT_SNAPSHOT_DEF_HPP
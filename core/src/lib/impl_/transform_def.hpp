@@ -0,0 +1,36 @@
+/**********************************************************************************************************************
+ * Copyright (c) 2021 Concurrent Technologies Corporation.                                                            *
+ *                                                                                                                    *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance     *
+ * with the License.  You may obtain a copy of the License at                                                         *
+ *                                                                                                                    *
+ *     http://www.apache.org/licenses/LICENSE-2.0                                                                     *
+ *                                                                                                                    *
+ * Unless required by applicable law or agreed to in writing, software is distributed under the License is            *
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or                   *
+ * implied.  See the License for the specific language governing permissions and limitations under the License.       *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+
+#ifndef OMEGA_EDIT_TRANSFORM_DEF_HPP
+#define OMEGA_EDIT_TRANSFORM_DEF_HPP
+
+#include "../../include/omega_edit/byte.h"
+#include "../../include/omega_edit/utility.h"
+#include <cstdint>
+#include <vector>
+
+enum class transform_kind_t {
+    TRANSFORM_XOR, TRANSFORM_AND, TRANSFORM_OR, TRANSFORM_ADD, TRANSFORM_SUB, TRANSFORM_LOOKUP, TRANSFORM_CALLBACK
+};
+
+struct omega_transform_struct {
+    transform_kind_t kind{};               ///< Transform kind
+    int64_t key_length{};                  ///< Length of the repeating key
+    std::vector<omega_byte_t> pattern{};   ///< Key repeated to a length that is a multiple of the key length
+    omega_byte_t table[256]{};             ///< Lookup table for TRANSFORM_LOOKUP
+    omega_util_byte_transform_t callback{};///< Byte transform function for TRANSFORM_CALLBACK
+    void *user_data_ptr{};                 ///< User data for the byte transform function
+};
+
+#endif//OMEGA_EDIT_TRANSFORM_DEF_HPP
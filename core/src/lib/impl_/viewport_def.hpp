@@ -18,6 +18,19 @@
 #include "../../include/omega_edit/fwd_defs.h"
 #include "internal_fwd_defs.hpp"
 #include "segment_def.hpp"
+#include <memory>
+#include <vector>
+
+/**
+ * A page of viewport data, populated on demand for paged viewports
+ */
+struct omega_viewport_page_struct {
+    int64_t length{-1};                    ///< Populated page length (in bytes), negative if the page is stale
+    std::unique_ptr<omega_byte_t[]> data{};///< Page data, allocated when the page is first populated
+};
+
+using omega_viewport_page_t = struct omega_viewport_page_struct;
+using omega_viewport_pages_t = std::vector<omega_viewport_page_t>;
 
 struct omega_viewport_struct {
     omega_session_t *session_ptr{};            ///< Session that owns this viewport instance
@@ -25,6 +38,8 @@ struct omega_viewport_struct {
     omega_viewport_event_cbk_t event_handler{};///< User callback when the viewport changes
     void *user_data_ptr{};                     ///< Pointer to associated user-provided data
     int32_t event_interest_{};                 ///< Events of interest
+    int64_t page_size_{};                      ///< Page size for paged viewports, zero for contiguous viewports
+    omega_viewport_pages_t pages_{};           ///< Viewport data pages (paged viewports only)
 };
 
 #endif//OMEGA_EDIT_VIEWPORT_DEF_HPP
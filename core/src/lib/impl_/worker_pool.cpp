@@ -0,0 +1,123 @@
+/**********************************************************************************************************************
+ * Copyright (c) 2021 Concurrent Technologies Corporation.                                                            *
+ *                                                                                                                    *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance     *
+ * with the License.  You may obtain a copy of the License at                                                         *
+ *                                                                                                                    *
+ *     http://www.apache.org/licenses/LICENSE-2.0                                                                     *
+ *                                                                                                                    *
+ * Unless required by applicable law or agreed to in writing, software is distributed under the License is            *
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or                   *
+ * implied.  See the License for the specific language governing permissions and limitations under the License.       *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+
+#include "worker_pool.hpp"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace {
+    /*
+     * Pieces of one parallel_for_ call, claimed one at a time by the calling thread and the pool threads
+     */
+    struct batch_t {
+        const std::function<void(int)> *task_ptr{};
+        int num_pieces{};
+        int next_piece{};    // guarded by the pool mutex
+        int pieces_running{};// guarded by the pool mutex
+    };
+
+    class worker_pool_t {
+    public:
+        worker_pool_t() {
+            const auto num_threads = std::max(1U, std::thread::hardware_concurrency()) - 1;
+            for (unsigned i = 0; i < num_threads; ++i) {
+                try {
+                    threads_.emplace_back(&worker_pool_t::work_, this);
+                } catch (const std::system_error &) {
+                    // Unable to start a thread, so make do with the threads started so far
+                    break;
+                }
+            }
+        }
+
+        ~worker_pool_t() {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stopping_ = true;
+            }
+            work_available_.notify_all();
+            for (auto &thread: threads_) { thread.join(); }
+        }
+
+        worker_pool_t(const worker_pool_t &) = delete;
+
+        worker_pool_t &operator=(const worker_pool_t &) = delete;
+
+        void run(int num_pieces, const std::function<void(int)> &task) {
+            const auto batch_ptr = std::make_shared<batch_t>();
+            batch_ptr->task_ptr = &task;
+            batch_ptr->num_pieces = num_pieces;
+            std::unique_lock<std::mutex> lock(mutex_);
+            batches_.push_back(batch_ptr);
+            lock.unlock();
+            work_available_.notify_all();
+            lock.lock();
+            while (run_piece_(lock, *batch_ptr)) {}
+            // Wait for the pieces the pool threads are still running
+            piece_done_.wait(lock, [&] { return 0 == batch_ptr->pieces_running; });
+        }
+
+    private:
+        // Claim and run the next piece of the given batch, returning false if it has no pieces left to claim
+        bool run_piece_(std::unique_lock<std::mutex> &lock, batch_t &batch) {
+            if (batch.num_pieces <= batch.next_piece) {
+                batches_.erase(std::remove_if(batches_.begin(), batches_.end(),
+                                              [&](const std::shared_ptr<batch_t> &b) { return b.get() == &batch; }),
+                               batches_.end());
+                return false;
+            }
+            const auto piece = batch.next_piece++;
+            ++batch.pieces_running;
+            lock.unlock();
+            (*batch.task_ptr)(piece);
+            lock.lock();
+            --batch.pieces_running;
+            piece_done_.notify_all();
+            return true;
+        }
+
+        void work_() {
+            std::unique_lock<std::mutex> lock(mutex_);
+            for (;;) {
+                work_available_.wait(lock, [this] { return stopping_ || !batches_.empty(); });
+                if (stopping_) { return; }
+                // Keep the batch alive while running its piece, even if the calling thread finishes the others
+                const auto batch_ptr = batches_.front();
+                run_piece_(lock, *batch_ptr);
+            }
+        }
+
+        std::mutex mutex_;
+        std::condition_variable work_available_;
+        std::condition_variable piece_done_;
+        std::deque<std::shared_ptr<batch_t>> batches_;
+        std::vector<std::thread> threads_;
+        bool stopping_{};
+    };
+}// namespace
+
+void parallel_for_(int num_pieces, const std::function<void(int)> &task) noexcept {
+    if (num_pieces <= 1) {
+        if (1 == num_pieces) { task(0); }
+        return;
+    }
+    static worker_pool_t pool;
+    pool.run(num_pieces, task);
+}
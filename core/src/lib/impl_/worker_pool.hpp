@@ -0,0 +1,30 @@
+/**********************************************************************************************************************
+ * Copyright (c) 2021 Concurrent Technologies Corporation.                                                            *
+ *                                                                                                                    *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance     *
+ * with the License.  You may obtain a copy of the License at                                                         *
+ *                                                                                                                    *
+ *     http://www.apache.org/licenses/LICENSE-2.0                                                                     *
+ *                                                                                                                    *
+ * Unless required by applicable law or agreed to in writing, software is distributed under the License is            *
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or                   *
+ * implied.  See the License for the specific language governing permissions and limitations under the License.       *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+
+#ifndef OMEGA_EDIT_WORKER_POOL_HPP
+#define OMEGA_EDIT_WORKER_POOL_HPP
+
+#include <functional>
+
+/**
+ * Run the given task for each piece in [0, num_pieces), on the calling thread and the threads of a small worker pool
+ * that is shared by the whole library.  The pool has one thread less than the hardware has, and is started the first
+ * time it is needed, so parallel work that is done block by block does not start and join threads for every block.
+ * The calling thread also runs pieces, so the call completes even when every pool thread is busy with other calls.
+ * @param num_pieces number of pieces to run the task for
+ * @param task task to run, given the index of the piece to work on
+ */
+void parallel_for_(int num_pieces, const std::function<void(int)> &task) noexcept;
+
+#endif//OMEGA_EDIT_WORKER_POOL_HPP
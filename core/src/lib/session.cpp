@@ -15,16 +15,26 @@
 #include "omega_edit/session.h"
 #include "impl_/change_def.hpp"
 #include "impl_/character_counts_def.h"
+#include "impl_/compressed_data.hpp"
+#include "impl_/count_characters.h"
+#include "impl_/histogram.hpp"
 #include "impl_/internal_fun.hpp"
 #include "impl_/model_def.hpp"
+#include "impl_/model_segment_def.hpp"
 #include "impl_/segment_def.hpp"
 #include "impl_/session_def.hpp"
 #include "omega_edit/character_counts.h"
 #include "omega_edit/fwd_defs.h"
 #include "omega_edit/segment.h"
 #include "omega_edit/viewport.h"
+#include <algorithm>
 #include <cassert>
 #include <cstring>
+#include <memory>
+#include <system_error>
+#include <thread>
+#include <unordered_set>
+#include <vector>
 
 
 int omega_session_byte_frequency_profile_size() { return OMEGA_EDIT_BYTE_FREQUENCY_PROFILE_SIZE; }
@@ -117,8 +127,10 @@ const omega_change_t *omega_session_get_change(const omega_session_t *session_pt
     assert(session_ptr->models_.back());
     if (0 < change_serial) {
         // Positive serials are active changes
-        if (change_serial <= omega_session_get_num_changes(session_ptr)) {
-            return session_ptr->models_.back()->changes[change_serial - 1].get();
+        // Changes squashed by compacting the session are no longer in the model
+        const auto index = change_serial - 1 - session_ptr->num_changes_adjustment_;
+        if (0 <= index && change_serial <= omega_session_get_num_changes(session_ptr)) {
+            return session_ptr->models_.back()->changes[index].get();
         }
     } else if (change_serial < 0) {
         // Negative serials are undone changes
@@ -283,56 +295,241 @@ omega_bom_t omega_session_detect_BOM(const omega_session_t *session_ptr, int64_t
     return bom;
 }
 
+namespace {
+    int session_byte_frequency_profile_(const omega_session_t *session_ptr,
+                                        omega_byte_frequency_profile_t *profile_ptr, int64_t offset, int64_t length,
+                                        int num_threads) {
+        assert(session_ptr);
+        assert(profile_ptr);
+        assert(0 <= offset);
+        const auto computed_file_size = omega_session_get_computed_file_size(session_ptr);
+        length = 0 == length ? computed_file_size - offset : length;
+        assert(0 <= length);
+        assert(offset + length <= computed_file_size);
+        if (0 != omega_session_byte_frequency_profile_tracking(session_ptr) && 0 == offset &&
+            length == computed_file_size) {
+            const auto mut_session_ptr = const_cast<omega_session_t *>(session_ptr);
+            if (!session_ptr->tracked_profile_valid_) {
+                if (const auto rc = byte_frequency_profile_(session_ptr->models_.back().get(),
+                                                            &mut_session_ptr->tracked_profile_, 0, length, num_threads);
+                    rc != 0) {
+                    return rc;
+                }
+                mut_session_ptr->tracked_profile_valid_ = true;
+            }
+            memcpy(profile_ptr, session_ptr->tracked_profile_, sizeof(omega_byte_frequency_profile_t));
+            return 0;
+        }
+        return byte_frequency_profile_(session_ptr->models_.back().get(), profile_ptr, offset, length, num_threads);
+    }
+}// namespace
+
 int omega_session_byte_frequency_profile(const omega_session_t *session_ptr,
                                          omega_byte_frequency_profile_t *profile_ptr, int64_t offset, int64_t length) {
+    return session_byte_frequency_profile_(session_ptr, profile_ptr, offset, length, 1);
+}
+
+int omega_session_byte_frequency_profile_parallel(const omega_session_t *session_ptr,
+                                                  omega_byte_frequency_profile_t *profile_ptr, int64_t offset,
+                                                  int64_t length, int num_threads) {
+    if (num_threads <= 0) { num_threads = static_cast<int>(std::max(1U, std::thread::hardware_concurrency())); }
+    return session_byte_frequency_profile_(session_ptr, profile_ptr, offset, length, num_threads);
+}
+
+void omega_session_set_change_coalescing(omega_session_t *session_ptr, int coalesce) {
     assert(session_ptr);
-    assert(profile_ptr);
-    assert(0 <= offset);
-    length = 0 == length ? omega_session_get_computed_file_size(session_ptr) - offset : length;
-    assert(0 <= length);
-    assert(offset + length <= omega_session_get_computed_file_size(session_ptr));
-    memset(profile_ptr, 0, sizeof(omega_byte_frequency_profile_t));
-    if (0 < length) {
-        const auto segment_ptr = omega_segment_create(std::min(length, static_cast<int64_t>(BUFSIZ)));
-        omega_byte_t last_profiled_byte = 0;
-        int64_t dos_eol_count = 0;
-        while (length) {
-            if (const auto rc = omega_session_get_segment(session_ptr, segment_ptr, offset) != 0) { return rc; }
-            const auto profile_length = std::min(length, omega_segment_get_length(segment_ptr));
-            const auto segment_data = omega_segment_get_data(segment_ptr);
-            for (auto i = 0; i < profile_length; ++i) {
-                if (last_profiled_byte == '\r' && segment_data[i] == '\n') { ++dos_eol_count; }
-                ++(*profile_ptr)[last_profiled_byte = segment_data[i]];
+    if (coalesce) {
+        session_ptr->session_flags_ |= SESSION_FLAGS_COALESCE_CHANGES;
+    } else {
+        session_ptr->session_flags_ &= ~SESSION_FLAGS_COALESCE_CHANGES;
+    }
+}
+
+int omega_session_get_change_coalescing(const omega_session_t *session_ptr) {
+    assert(session_ptr);
+    return session_ptr->session_flags_ & SESSION_FLAGS_COALESCE_CHANGES ? 1 : 0;
+}
+
+void omega_session_set_undo_depth_limit(omega_session_t *session_ptr, int64_t limit) {
+    assert(session_ptr);
+    session_ptr->undo_depth_limit_ = limit;
+    omega_session_enforce_history_limits_(session_ptr);
+}
+
+int64_t omega_session_get_undo_depth_limit(const omega_session_t *session_ptr) {
+    assert(session_ptr);
+    return session_ptr->undo_depth_limit_;
+}
+
+void omega_session_set_history_memory_budget(omega_session_t *session_ptr, int64_t budget) {
+    assert(session_ptr);
+    session_ptr->history_memory_budget_ = budget;
+    omega_session_enforce_history_limits_(session_ptr);
+}
+
+int64_t omega_session_get_history_memory_budget(const omega_session_t *session_ptr) {
+    assert(session_ptr);
+    return session_ptr->history_memory_budget_;
+}
+
+int64_t omega_session_get_history_memory(const omega_session_t *session_ptr) {
+    assert(session_ptr);
+    int64_t memory = 0;
+    for (const auto &model_ptr: session_ptr->models_) {
+        for (const auto *changes: {&model_ptr->changes, &model_ptr->changes_undone}) {
+            for (const auto &change_ptr: *changes) { memory += change_history_memory_(change_ptr.get()); }
+        }
+    }
+    return memory;
+}
+
+void omega_session_recompute_history_memory_(omega_session_t *session_ptr) {
+    assert(session_ptr);
+    session_ptr->history_memory_ = omega_session_get_history_memory(session_ptr);
+}
+
+int64_t omega_session_get_num_folded_changes(const omega_session_t *session_ptr) {
+    assert(session_ptr);
+    return session_ptr->num_folded_changes_;
+}
+
+int omega_session_enforce_history_limits_(omega_session_t *session_ptr) {
+    assert(session_ptr);
+    const auto depth_limit = session_ptr->undo_depth_limit_;
+    const auto budget = session_ptr->history_memory_budget_;
+    const auto &changes = session_ptr->models_.back()->changes;
+    const auto num_changes = static_cast<int64_t>(changes.size());
+    const auto over_depth = 0 <= depth_limit && depth_limit < num_changes;
+    const auto over_budget = 0 <= budget && budget < session_ptr->history_memory_;
+    if ((!over_depth && !over_budget) || 0 != omega_session_changes_paused(session_ptr) ||
+        0 != omega_session_get_transaction_state(session_ptr)) {
+        return 0;
+    }
+    // Fold an eighth of the limits more than needed, so the cost of folding is spread over many changes
+    int64_t num_folded = over_depth ? num_changes - (depth_limit - depth_limit / 8) : 0;
+    if (0 <= budget) {
+        auto memory = session_ptr->history_memory_;
+        for (int64_t i = 0; i < num_folded; ++i) { memory -= change_history_memory_(changes[i].get()); }
+        if (budget < memory) {
+            const auto target = budget - budget / 8;
+            while (target < memory && num_folded < num_changes) {
+                memory -= change_history_memory_(changes[num_folded++].get());
             }
-            offset += profile_length;
-            length -= profile_length;
         }
-        omega_segment_destroy(segment_ptr);
-        (*profile_ptr)[OMEGA_EDIT_PROFILE_DOS_EOL] = dos_eol_count;
     }
-    return 0;
+    // Transactions are folded whole
+    while (0 < num_folded && num_folded < num_changes &&
+           omega_change_get_transaction_bit_(changes[num_folded - 1].get()) ==
+           omega_change_get_transaction_bit_(changes[num_folded].get())) {
+        ++num_folded;
+    }
+    return 0 < num_folded ? omega_session_compact(session_ptr, changes[num_folded - 1]->serial) : 0;
 }
 
+int omega_session_byte_frequency_profile_tracking(const omega_session_t *session_ptr) {
+    assert(session_ptr);
+    return session_ptr->session_flags_ & SESSION_FLAGS_PROFILE_TRACKING ? 1 : 0;
+}
+
+void omega_session_start_byte_frequency_profile_tracking(omega_session_t *session_ptr) {
+    assert(session_ptr);
+    if (!omega_session_byte_frequency_profile_tracking(session_ptr)) {
+        session_ptr->session_flags_ |= SESSION_FLAGS_PROFILE_TRACKING;
+        omega_session_invalidate_tracked_profile_(session_ptr);
+    }
+}
+
+void omega_session_stop_byte_frequency_profile_tracking(omega_session_t *session_ptr) {
+    assert(session_ptr);
+    session_ptr->session_flags_ &= ~SESSION_FLAGS_PROFILE_TRACKING;
+    omega_session_invalidate_tracked_profile_(session_ptr);
+}
+
+namespace {
+    int session_character_counts_(const omega_session_t *session_ptr, omega_character_counts_t *counts_ptr,
+                                  int64_t offset, int64_t length, omega_bom_t bom, int num_threads) {
+        assert(session_ptr);
+        assert(counts_ptr);
+        assert(0 <= offset);
+        length = length ? length : omega_session_get_computed_file_size(session_ptr) - offset;
+        assert(0 <= length);
+        assert(offset + length <= omega_session_get_computed_file_size(session_ptr));
+        return character_counts_(session_ptr->models_.back().get(), counts_ptr, offset, length, bom, num_threads);
+    }
+
+    /*
+     * Get the number of bytes at the end of the given range that start a UTF-8 sequence the end of the range cuts off,
+     * which happens when the range is a prefix of longer content
+     */
+    int64_t truncated_utf8_tail_length_(const omega_session_t *session_ptr, int64_t offset, int64_t length) {
+        const auto tail_length = std::min(length, static_cast<int64_t>(3));
+        const auto segment_ptr = omega_segment_create(tail_length);
+        omega_session_get_segment(session_ptr, segment_ptr, offset + length - tail_length);
+        const auto *const tail = omega_segment_get_data(segment_ptr);
+        int64_t truncated = 0;
+        for (auto i = omega_segment_get_length(segment_ptr) - 1; 0 <= i; --i) {
+            if (0x80 == (tail[i] & 0xC0)) { continue; }// continuation byte
+            const auto sequence_length = (0xF0 == (tail[i] & 0xF8))   ? 4
+                                         : (0xE0 == (tail[i] & 0xF0)) ? 3
+                                         : (0xC0 == (tail[i] & 0xE0)) ? 2
+                                                                      : 1;
+            const auto available = omega_segment_get_length(segment_ptr) - i;
+            if (available < sequence_length) { truncated = available; }
+            break;
+        }
+        omega_segment_destroy(segment_ptr);
+        return truncated;
+    }
+}// namespace
+
 int omega_session_character_counts(const omega_session_t *session_ptr, omega_character_counts_t *counts_ptr,
                                    int64_t offset, int64_t length, omega_bom_t bom) {
+    return session_character_counts_(session_ptr, counts_ptr, offset, length, bom, 1);
+}
+
+int omega_session_character_counts_parallel(const omega_session_t *session_ptr, omega_character_counts_t *counts_ptr,
+                                            int64_t offset, int64_t length, omega_bom_t bom, int num_threads) {
+    if (num_threads <= 0) { num_threads = static_cast<int>(std::max(1U, std::thread::hardware_concurrency())); }
+    return session_character_counts_(session_ptr, counts_ptr, offset, length, bom, num_threads);
+}
+
+omega_content_class_t omega_session_classify_content(const omega_session_t *session_ptr, int64_t offset,
+                                                     int64_t length) {
     assert(session_ptr);
-    assert(counts_ptr);
     assert(0 <= offset);
     length = length ? length : omega_session_get_computed_file_size(session_ptr) - offset;
-    assert(0 <= length);
-    assert(offset + length <= omega_session_get_computed_file_size(session_ptr));
-    omega_character_counts_set_BOM(omega_character_counts_reset(counts_ptr), bom);
-    const auto segment_ptr = omega_segment_create(std::min(length, static_cast<int64_t>(BUFSIZ)));
-    while (length) {
-        if (const auto rc = omega_session_get_segment(session_ptr, segment_ptr, offset) != 0) { return rc; }
-        const auto segment_data = omega_segment_get_data(segment_ptr);
-        const auto count_length = std::min(length, omega_segment_get_length(segment_ptr));
-        omega_util_count_characters(segment_data, count_length, counts_ptr);
-        offset += count_length;
-        length -= count_length;
+    if (length <= 0) { return CONTENT_CLASS_EMPTY; }
+    switch (omega_session_detect_BOM(session_ptr, offset)) {
+        case BOM_UTF16LE:// deliberate fall-through
+        case BOM_UTF16BE:
+            return CONTENT_CLASS_TEXT_UTF16;
+        case BOM_UTF32LE:// deliberate fall-through
+        case BOM_UTF32BE:
+            return CONTENT_CLASS_TEXT_UTF32;
+        default:
+            break;
     }
-    omega_segment_destroy(segment_ptr);
-    return 0;
+    omega_byte_frequency_profile_t profile;
+    if (0 != omega_session_byte_frequency_profile(session_ptr, &profile, offset, length)) {
+        return CONTENT_CLASS_UNKNOWN;
+    }
+    if (0 < profile[0]) { return CONTENT_CLASS_BINARY; }
+    int64_t control_bytes = profile[0x7F];
+    for (int byte = 1; byte < 0x20; ++byte) {
+        // tab, line feed, vertical tab, form feed, carriage return, and escape are common in text
+        if (byte == '\t' || byte == '\n' || byte == '\v' || byte == '\f' || byte == '\r' || byte == 0x1B) { continue; }
+        control_bytes += profile[byte];
+    }
+    if (OMEGA_BINARY_CONTROL_BYTE_PERCENT * length <= 100 * control_bytes) { return CONTENT_CLASS_BINARY; }
+    // A character cut off by the end of the range is not a sign of another encoding
+    const auto utf8_length = length - truncated_utf8_tail_length_(session_ptr, offset, length);
+    if (0 == utf8_length) { return CONTENT_CLASS_TEXT_UTF8; }
+    const auto counts_ptr = omega_character_counts_create();
+    const auto rc = omega_session_character_counts(session_ptr, counts_ptr, offset, utf8_length, BOM_UTF8);
+    const auto invalid_bytes = omega_character_counts_invalid_bytes(counts_ptr);
+    omega_character_counts_destroy(counts_ptr);
+    if (0 != rc) { return CONTENT_CLASS_UNKNOWN; }
+    return 0 == invalid_bytes ? CONTENT_CLASS_TEXT_UTF8 : CONTENT_CLASS_TEXT_OTHER;
 }
 
 const char *omega_session_get_checkpoint_directory(const omega_session_t *session_ptr) {
@@ -345,7 +542,193 @@ int64_t omega_session_get_checkpoint_directory_length(const omega_session_t *ses
     return session_ptr->checkpoint_directory_.length();
 }
 
+void omega_session_set_payload_compression_threshold(omega_session_t *session_ptr, int64_t threshold) {
+    assert(session_ptr);
+    session_ptr->payload_compression_threshold_ = std::max(threshold, static_cast<int64_t>(0));
+}
+
+int64_t omega_session_get_payload_compression_threshold(const omega_session_t *session_ptr) {
+    assert(session_ptr);
+    return session_ptr->payload_compression_threshold_;
+}
+
+void omega_session_set_payload_memory_budget(omega_session_t *session_ptr, int64_t budget) {
+    assert(session_ptr);
+    session_ptr->payload_memory_budget_ = std::max(budget, static_cast<int64_t>(0));
+}
+
+int64_t omega_session_get_payload_memory_budget(const omega_session_t *session_ptr) {
+    assert(session_ptr);
+    return session_ptr->payload_memory_budget_;
+}
+
+void omega_session_set_checkpoint_disk_budget(omega_session_t *session_ptr, int64_t budget) {
+    assert(session_ptr);
+    session_ptr->checkpoint_disk_budget_ = budget;
+}
+
+int64_t omega_session_get_checkpoint_disk_budget(const omega_session_t *session_ptr) {
+    assert(session_ptr);
+    return session_ptr->checkpoint_disk_budget_;
+}
+
+int64_t omega_session_get_checkpoint_disk_usage(const omega_session_t *session_ptr) {
+    assert(session_ptr);
+    int64_t usage = 0;
+    // The first model is the file being edited, and logical checkpoints share the file of the model below them
+    for (size_t i = 1; i < session_ptr->models_.size(); ++i) {
+        const auto model_ptr = session_ptr->models_[i].get();
+        if (!model_ptr->is_logical_checkpoint) { usage += get_summarized_file_length_(model_ptr); }
+    }
+    return usage;
+}
+
+namespace {
+    /*
+     * Visit the INSERT and OVERWRITE changes (done and undone) of the session.  Every change belongs to exactly one
+     * model, even when the frozen segments of logical checkpoints refer to it.
+     */
+    template<typename ChangeFn>
+    void visit_payload_changes_(const omega_session_t *session_ptr, ChangeFn &&on_change) {
+        for (const auto &model_ptr: session_ptr->models_) {
+            for (const auto *changes: {&model_ptr->changes, &model_ptr->changes_undone}) {
+                for (const auto &change_ptr: *changes) {
+                    if (omega_change_get_kind(change_ptr.get()) != change_kind_t::CHANGE_DELETE) {
+                        on_change(change_ptr.get());
+                    }
+                }
+            }
+        }
+    }
+}// namespace
+
+void omega_session_set_payload_spill_threshold(omega_session_t *session_ptr, int64_t threshold) {
+    assert(session_ptr);
+    session_ptr->payload_spill_threshold_ = std::max(threshold, static_cast<int64_t>(0));
+}
+
+int64_t omega_session_get_payload_spill_threshold(const omega_session_t *session_ptr) {
+    assert(session_ptr);
+    return session_ptr->payload_spill_threshold_;
+}
+
+int64_t omega_session_get_num_spilled_payloads(const omega_session_t *session_ptr) {
+    assert(session_ptr);
+    int64_t count = 0;
+    visit_payload_changes_(session_ptr, [&count](const omega_change_t *change_ptr) {
+        if (omega_change_is_spilled_(change_ptr)) { ++count; }
+    });
+    return count;
+}
+
+int64_t omega_session_get_payload_store_size(const omega_session_t *session_ptr) {
+    assert(session_ptr);
+    return session_ptr->payload_store_ ? session_ptr->payload_store_->get_size() : 0;
+}
+
+int64_t omega_session_get_num_compressed_payloads(const omega_session_t *session_ptr) {
+    assert(session_ptr);
+    int64_t count = 0;
+    visit_payload_changes_(session_ptr, [&count](const omega_change_t *change_ptr) {
+        if (omega_change_is_compressed_(change_ptr)) { ++count; }
+    });
+    return count;
+}
+
+int64_t omega_session_get_payload_bytes(const omega_session_t *session_ptr) {
+    assert(session_ptr);
+    int64_t bytes = 0;
+    visit_payload_changes_(session_ptr, [&bytes](const omega_change_t *change_ptr) { bytes += change_ptr->length; });
+    return bytes;
+}
+
+int64_t omega_session_get_compressed_payload_bytes(const omega_session_t *session_ptr) {
+    assert(session_ptr);
+    int64_t bytes = 0;
+    visit_payload_changes_(session_ptr, [&bytes](const omega_change_t *change_ptr) {
+        if (omega_change_is_compressed_(change_ptr)) { bytes += change_ptr->length; }
+    });
+    return bytes;
+}
+
+int64_t omega_session_get_stored_compressed_payload_bytes(const omega_session_t *session_ptr) {
+    assert(session_ptr);
+    int64_t bytes = 0;
+    visit_payload_changes_(session_ptr, [&bytes](const omega_change_t *change_ptr) {
+        if (omega_change_is_compressed_(change_ptr)) { bytes += compressed_data_size_(change_ptr->data.bytes_ptr); }
+    });
+    return bytes;
+}
+
+int64_t omega_session_get_num_interned_payloads(const omega_session_t *session_ptr) {
+    assert(session_ptr);
+    // Count the payloads the changes refer to, as the intern table may still hold payloads no change refers to
+    std::unordered_set<const omega_byte_t *> payloads;
+    visit_payload_changes_(session_ptr, [&payloads](const omega_change_t *change_ptr) {
+        if (omega_change_is_interned_(change_ptr)) { payloads.insert(change_ptr->data.bytes_ptr); }
+    });
+    return static_cast<int64_t>(payloads.size());
+}
+
+int64_t omega_session_get_resident_payload_bytes_(const omega_session_t *session_ptr) {
+    assert(session_ptr);
+    return session_ptr->resident_payload_bytes_;
+}
+
 bool omega_session_get_transaction_bit_(const omega_session_t *session_ptr) {
     return (session_ptr->models_.back()->changes.empty()) ||
            omega_change_get_transaction_bit_(session_ptr->models_.back()->changes.back().get());
 }
+
+namespace {
+    int tracked_profile_window_(const omega_session_t *session_ptr, int64_t offset, int64_t tail_length,
+                                omega_byte_frequency_profile_t *window_profile_ptr) {
+        assert(0 <= offset);
+        assert(0 <= tail_length);
+        // The window includes the byte before the change and the first byte of the tail so that DOS EOL pairs that
+        // straddle the edges of the change are accounted for
+        const auto computed_file_size = omega_session_get_computed_file_size(session_ptr);
+        const auto window_offset = std::max(offset - 1, static_cast<int64_t>(0));
+        const auto window_end = std::min(computed_file_size - tail_length + 1, computed_file_size);
+        if (window_end <= window_offset) {
+            std::fill(std::begin(*window_profile_ptr), std::end(*window_profile_ptr), 0);
+            return 0;
+        }
+        return byte_frequency_profile_(session_ptr->models_.back().get(), window_profile_ptr, window_offset,
+                                       window_end - window_offset, 1);
+    }
+}// namespace
+
+bool omega_session_begin_tracked_profile_update_(omega_session_t *session_ptr, int64_t offset, int64_t tail_length,
+                                                 omega_byte_frequency_profile_t *window_profile_ptr) {
+    assert(session_ptr);
+    assert(window_profile_ptr);
+    if (0 == omega_session_byte_frequency_profile_tracking(session_ptr) || !session_ptr->tracked_profile_valid_) {
+        return false;
+    }
+    if (0 != tracked_profile_window_(session_ptr, offset, tail_length, window_profile_ptr)) {
+        omega_session_invalidate_tracked_profile_(session_ptr);
+        return false;
+    }
+    return true;
+}
+
+void omega_session_end_tracked_profile_update_(omega_session_t *session_ptr, int64_t offset, int64_t tail_length,
+                                               const omega_byte_frequency_profile_t *window_profile_ptr) {
+    assert(session_ptr);
+    assert(window_profile_ptr);
+    if (!session_ptr->tracked_profile_valid_) { return; }
+    omega_byte_frequency_profile_t window_profile;
+    if (0 != tracked_profile_window_(session_ptr, offset, tail_length, &window_profile)) {
+        omega_session_invalidate_tracked_profile_(session_ptr);
+        return;
+    }
+    for (auto i = 0; i < OMEGA_EDIT_BYTE_FREQUENCY_PROFILE_SIZE; ++i) {
+        session_ptr->tracked_profile_[i] += window_profile[i] - (*window_profile_ptr)[i];
+    }
+}
+
+void omega_session_invalidate_tracked_profile_(omega_session_t *session_ptr) {
+    assert(session_ptr);
+    session_ptr->tracked_profile_valid_ = false;
+}
@@ -0,0 +1,194 @@
+/**********************************************************************************************************************
+ * Copyright (c) 2021 Concurrent Technologies Corporation.                                                            *
+ *                                                                                                                    *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance     *
+ * with the License.  You may obtain a copy of the License at                                                         *
+ *                                                                                                                    *
+ *     http://www.apache.org/licenses/LICENSE-2.0                                                                     *
+ *                                                                                                                    *
+ * Unless required by applicable law or agreed to in writing, software is distributed under the License is            *
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or                   *
+ * implied.  See the License for the specific language governing permissions and limitations under the License.       *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+
+#include "../include/omega_edit/snapshot.h"
+#include "../include/omega_edit/segment.h"
+#include "impl_/find.h"
+#include "impl_/internal_fun.hpp"
+#include "impl_/macros.h"
+#include "impl_/segment_def.hpp"
+#include "impl_/session_def.hpp"
+#include "impl_/snapshot_def.hpp"
+#include <algorithm>
+#include <cassert>
+#include <memory>
+#include <mutex>
+
+// Snapshots are searched in windows of this many bytes, which overlap by one less than the pattern length
+constexpr auto SNAPSHOT_SEARCH_WINDOW_LENGTH = static_cast<int64_t>(OMEGA_SEARCH_PATTERN_LENGTH_LIMIT) << 1;
+
+namespace {
+    /*
+     * Get the path of the file the model segments of the session read from.  Logical checkpoints share the file of the
+     * model below them, and the first model reads from the copy of the original file made when the session was created.
+     */
+    auto session_file_path_(const omega_session_t *session_ptr) -> const std::string & {
+        auto index = session_ptr->models_.size() - 1;
+        while (0 < index && session_ptr->models_[index]->is_logical_checkpoint) { --index; }
+        return 0 == index ? session_ptr->checkpoint_file_name_ : session_ptr->models_[index]->file_path;
+    }
+
+    auto model_computed_file_size_(const omega_model_t *model_ptr) -> int64_t {
+        return model_ptr->model_segments.empty() ? 0
+                                                 : model_ptr->model_segments.back()->computed_offset +
+                                                           model_ptr->model_segments.back()->computed_length;
+    }
+}// namespace
+
+omega_snapshot_t *omega_session_snapshot(const omega_session_t *session_ptr) {
+    assert(session_ptr);
+    assert(session_ptr->models_.back());
+    const auto &model_ptr = session_ptr->models_.back();
+    auto snapshot_ptr = std::make_unique<omega_snapshot_t>();
+    if (model_ptr->file_ptr) {
+        // The snapshot reads the file through its own handle, which also keeps a checkpoint file readable after the
+        // session removes it
+        const auto &file_path = session_file_path_(session_ptr);
+        if ((snapshot_ptr->model_.file_ptr = FOPEN(file_path.c_str(), "rb")) == nullptr) {
+            LOG_ERROR("failed to open '" << file_path << "' for the snapshot");
+            return nullptr;
+        }
+        snapshot_ptr->model_.file_path = file_path;
+    }
+    snapshot_ptr->model_.model_segments.reserve(model_ptr->model_segments.size());
+    for (const auto &segment_ptr: model_ptr->model_segments) {
+        snapshot_ptr->model_.model_segments.push_back(clone_model_segment_(segment_ptr));
+    }
+    snapshot_ptr->payload_store_ = session_ptr->payload_store_;
+    snapshot_ptr->num_changes_ = omega_session_get_num_changes(session_ptr);
+    return snapshot_ptr.release();
+}
+
+void omega_snapshot_destroy(omega_snapshot_t *snapshot_ptr) {
+    assert(snapshot_ptr);
+    delete snapshot_ptr;
+}
+
+int64_t omega_snapshot_get_computed_file_size(const omega_snapshot_t *snapshot_ptr) {
+    assert(snapshot_ptr);
+    return model_computed_file_size_(&snapshot_ptr->model_);
+}
+
+int64_t omega_snapshot_get_num_changes(const omega_snapshot_t *snapshot_ptr) {
+    assert(snapshot_ptr);
+    return snapshot_ptr->num_changes_;
+}
+
+int omega_snapshot_get_segment(omega_snapshot_t *snapshot_ptr, omega_segment_t *data_segment_ptr, int64_t offset) {
+    assert(snapshot_ptr);
+    assert(data_segment_ptr);
+    const std::lock_guard<std::mutex> lock(snapshot_ptr->mutex_);
+    data_segment_ptr->offset = offset;
+    return populate_model_data_segment_(&snapshot_ptr->model_, data_segment_ptr);
+}
+
+int omega_snapshot_byte_frequency_profile(omega_snapshot_t *snapshot_ptr, omega_byte_frequency_profile_t *profile_ptr,
+                                          int64_t offset, int64_t length) {
+    assert(snapshot_ptr);
+    assert(profile_ptr);
+    assert(0 <= offset);
+    const auto computed_file_size = model_computed_file_size_(&snapshot_ptr->model_);
+    length = 0 == length ? computed_file_size - offset : length;
+    assert(0 <= length);
+    assert(offset + length <= computed_file_size);
+    const std::lock_guard<std::mutex> lock(snapshot_ptr->mutex_);
+    return byte_frequency_profile_(&snapshot_ptr->model_, profile_ptr, offset, length, 1);
+}
+
+int omega_snapshot_character_counts(omega_snapshot_t *snapshot_ptr, omega_character_counts_t *counts_ptr,
+                                    int64_t offset, int64_t length, omega_bom_t bom) {
+    assert(snapshot_ptr);
+    assert(counts_ptr);
+    assert(0 <= offset);
+    const auto computed_file_size = model_computed_file_size_(&snapshot_ptr->model_);
+    length = 0 == length ? computed_file_size - offset : length;
+    assert(0 <= length);
+    assert(offset + length <= computed_file_size);
+    const std::lock_guard<std::mutex> lock(snapshot_ptr->mutex_);
+    return character_counts_(&snapshot_ptr->model_, counts_ptr, offset, length, bom, 1);
+}
+
+int64_t omega_snapshot_search(omega_snapshot_t *snapshot_ptr, const omega_byte_t *pattern, int64_t pattern_length,
+                              int64_t offset, int64_t length) {
+    auto *const search_context_ptr =
+            omega_snapshot_search_create_context(snapshot_ptr, pattern, pattern_length, offset, length);
+    if (!search_context_ptr) { return -2; }
+    const auto result = omega_snapshot_search_next_match(search_context_ptr);
+    omega_snapshot_search_destroy_context(search_context_ptr);
+    return result;
+}
+
+omega_snapshot_search_context_t *omega_snapshot_search_create_context(omega_snapshot_t *snapshot_ptr,
+                                                                      const omega_byte_t *pattern,
+                                                                      int64_t pattern_length, int64_t offset,
+                                                                      int64_t length) {
+    assert(snapshot_ptr);
+    assert(pattern);
+    const auto computed_file_size = model_computed_file_size_(&snapshot_ptr->model_);
+    length = 0 == length ? computed_file_size - offset : length;
+    if (pattern_length <= 0 || OMEGA_SEARCH_PATTERN_LENGTH_LIMIT <= pattern_length || offset < 0 || length < 0 ||
+        computed_file_size < offset + length) {
+        LOG_ERROR("invalid snapshot search");
+        return nullptr;
+    }
+    auto search_context_ptr = std::make_unique<omega_snapshot_search_context_t>();
+    search_context_ptr->snapshot_ptr = snapshot_ptr;
+    search_context_ptr->pattern.assign(pattern, pattern + pattern_length);
+    search_context_ptr->skip_table_ptr = omega_find_create_skip_table(pattern, pattern_length, 0);
+    search_context_ptr->window_capacity = std::min(length, SNAPSHOT_SEARCH_WINDOW_LENGTH);
+    search_context_ptr->window = std::make_unique<omega_byte_t[]>(search_context_ptr->window_capacity);
+    search_context_ptr->window_offset = offset;
+    search_context_ptr->next_offset = offset;
+    search_context_ptr->end = offset + length;
+    return search_context_ptr.release();
+}
+
+int64_t omega_snapshot_search_next_match(omega_snapshot_search_context_t *search_context_ptr) {
+    assert(search_context_ptr);
+    const auto *const pattern = search_context_ptr->pattern.data();
+    const auto pattern_length = static_cast<int64_t>(search_context_ptr->pattern.size());
+    auto *const window = search_context_ptr->window.get();
+    const std::lock_guard<std::mutex> lock(search_context_ptr->snapshot_ptr->mutex_);
+    while (search_context_ptr->next_offset + pattern_length <= search_context_ptr->end) {
+        // The window is read again only once the rest of it is too short to hold a match
+        if (search_context_ptr->window_offset + search_context_ptr->window_length <
+            search_context_ptr->next_offset + pattern_length) {
+            search_context_ptr->window_offset = search_context_ptr->next_offset;
+            search_context_ptr->window_length = std::min(search_context_ptr->window_capacity,
+                                                         search_context_ptr->end - search_context_ptr->window_offset);
+            if (populate_model_buffer_(&search_context_ptr->snapshot_ptr->model_, search_context_ptr->window_offset,
+                                       window, search_context_ptr->window_length) !=
+                search_context_ptr->window_length) {
+                search_context_ptr->window_length = 0;
+                return -2;
+            }
+        }
+        const auto start = search_context_ptr->next_offset - search_context_ptr->window_offset;
+        if (const auto *found = omega_find(window + start, search_context_ptr->window_length - start,
+                                           search_context_ptr->skip_table_ptr, pattern, pattern_length)) {
+            const auto match_offset = search_context_ptr->window_offset + (found - window);
+            search_context_ptr->next_offset = match_offset + 1;
+            return match_offset;
+        }
+        // Matches that start in the last pattern length - 1 bytes of the window are found in the next window
+        search_context_ptr->next_offset =
+                search_context_ptr->window_offset + search_context_ptr->window_length - pattern_length + 1;
+    }
+    return -1;
+}
+
+void omega_snapshot_search_destroy_context(omega_snapshot_search_context_t *search_context_ptr) {
+    assert(search_context_ptr);
+    delete search_context_ptr;
+}
@@ -23,6 +23,19 @@ std::string omega_change_get_string(const omega_change_t *change_ptr) noexcept {
 }
 
 std::string omega_viewport_get_string(const omega_viewport_t *viewport_ptr) noexcept {
+    if (omega_viewport_is_paged(viewport_ptr)) {
+        // Paged viewports are gathered page by page
+        std::string result;
+        result.reserve(static_cast<size_t>(omega_viewport_get_length(viewport_ptr)));
+        const auto num_pages = omega_viewport_get_num_pages(viewport_ptr);
+        for (int64_t page_index = 0; page_index < num_pages; ++page_index) {
+            int64_t page_length = 0;
+            const auto page_data = omega_viewport_get_page_data(viewport_ptr, page_index, &page_length);
+            if (!page_data) { break; }
+            result.append(reinterpret_cast<const char *>(page_data), static_cast<size_t>(page_length));
+        }
+        return result;
+    }
     return {reinterpret_cast<const char *>(omega_viewport_get_data(viewport_ptr)),
             static_cast<size_t>(omega_viewport_get_length(viewport_ptr))};
 }
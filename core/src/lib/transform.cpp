@@ -0,0 +1,328 @@
+/**********************************************************************************************************************
+ * Copyright (c) 2021 Concurrent Technologies Corporation.                                                            *
+ *                                                                                                                    *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance     *
+ * with the License.  You may obtain a copy of the License at                                                         *
+ *                                                                                                                    *
+ *     http://www.apache.org/licenses/LICENSE-2.0                                                                     *
+ *                                                                                                                    *
+ * Unless required by applicable law or agreed to in writing, software is distributed under the License is            *
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or                   *
+ * implied.  See the License for the specific language governing permissions and limitations under the License.       *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+
+#include "../include/omega_edit/transform.h"
+#include "../include/omega_edit/filesystem.h"
+#include "impl_/macros.h"
+#include "impl_/transform_def.hpp"
+#include "impl_/worker_pool.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define OMEGA_TRANSFORM_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && 2 <= _M_IX86_FP)
+#include <emmintrin.h>
+#define OMEGA_TRANSFORM_SSE2
+#endif
+
+// Keys are repeated into a pattern at least this long, so short keys are still combined in long vector runs
+#define TRANSFORM_MIN_PATTERN_LENGTH (1024)
+
+// Parallel work is not split into pieces smaller than this
+#define TRANSFORM_MIN_THREAD_LENGTH (INT64_C(256) * 1024)
+
+// Files are transformed in blocks of this size
+#define TRANSFORM_FILE_BLOCK_SIZE (INT64_C(8) * 1024 * 1024)
+
+namespace {
+    struct xor_op_ {
+#if defined(OMEGA_TRANSFORM_AVX2)
+        static __m256i apply(__m256i a, __m256i b) { return _mm256_xor_si256(a, b); }
+#elif defined(OMEGA_TRANSFORM_SSE2)
+        static __m128i apply(__m128i a, __m128i b) { return _mm_xor_si128(a, b); }
+#endif
+        static omega_byte_t apply(omega_byte_t a, omega_byte_t b) { return static_cast<omega_byte_t>(a ^ b); }
+    };
+
+    struct and_op_ {
+#if defined(OMEGA_TRANSFORM_AVX2)
+        static __m256i apply(__m256i a, __m256i b) { return _mm256_and_si256(a, b); }
+#elif defined(OMEGA_TRANSFORM_SSE2)
+        static __m128i apply(__m128i a, __m128i b) { return _mm_and_si128(a, b); }
+#endif
+        static omega_byte_t apply(omega_byte_t a, omega_byte_t b) { return static_cast<omega_byte_t>(a & b); }
+    };
+
+    struct or_op_ {
+#if defined(OMEGA_TRANSFORM_AVX2)
+        static __m256i apply(__m256i a, __m256i b) { return _mm256_or_si256(a, b); }
+#elif defined(OMEGA_TRANSFORM_SSE2)
+        static __m128i apply(__m128i a, __m128i b) { return _mm_or_si128(a, b); }
+#endif
+        static omega_byte_t apply(omega_byte_t a, omega_byte_t b) { return static_cast<omega_byte_t>(a | b); }
+    };
+
+    struct add_op_ {
+#if defined(OMEGA_TRANSFORM_AVX2)
+        static __m256i apply(__m256i a, __m256i b) { return _mm256_add_epi8(a, b); }
+#elif defined(OMEGA_TRANSFORM_SSE2)
+        static __m128i apply(__m128i a, __m128i b) { return _mm_add_epi8(a, b); }
+#endif
+        static omega_byte_t apply(omega_byte_t a, omega_byte_t b) { return static_cast<omega_byte_t>(a + b); }
+    };
+
+    struct sub_op_ {
+#if defined(OMEGA_TRANSFORM_AVX2)
+        static __m256i apply(__m256i a, __m256i b) { return _mm256_sub_epi8(a, b); }
+#elif defined(OMEGA_TRANSFORM_SSE2)
+        static __m128i apply(__m128i a, __m128i b) { return _mm_sub_epi8(a, b); }
+#endif
+        static omega_byte_t apply(omega_byte_t a, omega_byte_t b) { return static_cast<omega_byte_t>(a - b); }
+    };
+
+    /*
+     * Combine each byte of the data with the key byte at the same position, a whole vector of bytes at a time
+     */
+    template<typename Op>
+    void combine_(omega_byte_t *data, const omega_byte_t *key, int64_t length) {
+        int64_t i = 0;
+#if defined(OMEGA_TRANSFORM_AVX2)
+        for (; i + 32 <= length; i += 32) {
+            const auto a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+            const auto b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(key + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(data + i), Op::apply(a, b));
+        }
+#elif defined(OMEGA_TRANSFORM_SSE2)
+        for (; i + 16 <= length; i += 16) {
+            const auto a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+            const auto b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(key + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(data + i), Op::apply(a, b));
+        }
+#endif
+        for (; i < length; ++i) { data[i] = Op::apply(data[i], key[i]); }
+    }
+
+    void combine_kind_(transform_kind_t kind, omega_byte_t *data, const omega_byte_t *key, int64_t length) {
+        switch (kind) {
+            case transform_kind_t::TRANSFORM_XOR:
+                combine_<xor_op_>(data, key, length);
+                break;
+            case transform_kind_t::TRANSFORM_AND:
+                combine_<and_op_>(data, key, length);
+                break;
+            case transform_kind_t::TRANSFORM_OR:
+                combine_<or_op_>(data, key, length);
+                break;
+            case transform_kind_t::TRANSFORM_ADD:
+                combine_<add_op_>(data, key, length);
+                break;
+            case transform_kind_t::TRANSFORM_SUB:
+                combine_<sub_op_>(data, key, length);
+                break;
+            default:
+                ABORT(LOG_ERROR("Unhandled transform kind"););
+        }
+    }
+
+    omega_transform_t *create_keyed_(transform_kind_t kind, const omega_byte_t *key, int64_t key_length) {
+        if (!key || key_length <= 0) { return nullptr; }
+        auto *const transform_ptr = new omega_transform_t;
+        transform_ptr->kind = kind;
+        transform_ptr->key_length = key_length;
+        // The pattern length is a multiple of the key length, so every run of the pattern starts at the first key byte
+        const auto repeats = (TRANSFORM_MIN_PATTERN_LENGTH + key_length - 1) / key_length;
+        transform_ptr->pattern.reserve(repeats * key_length);
+        for (int64_t i = 0; i < repeats; ++i) {
+            transform_ptr->pattern.insert(transform_ptr->pattern.end(), key, key + key_length);
+        }
+        return transform_ptr;
+    }
+
+    void apply_keyed_(const omega_transform_t *transform_ptr, omega_byte_t *buffer, int64_t length, int64_t key_offset) {
+        const auto pattern_length = static_cast<int64_t>(transform_ptr->pattern.size());
+        auto phase = key_offset % transform_ptr->key_length;
+        while (length) {
+            const auto run_length = std::min(length, pattern_length - phase);
+            combine_kind_(transform_ptr->kind, buffer, transform_ptr->pattern.data() + phase, run_length);
+            buffer += run_length;
+            length -= run_length;
+            phase = 0;
+        }
+    }
+
+    void apply_lookup_(const omega_byte_t *table, omega_byte_t *buffer, int64_t length) {
+        int64_t i = 0;
+        // Unrolled so the independent lookups can be in flight together
+        for (; i + 4 <= length; i += 4) {
+            const auto b0 = table[buffer[i]];
+            const auto b1 = table[buffer[i + 1]];
+            const auto b2 = table[buffer[i + 2]];
+            const auto b3 = table[buffer[i + 3]];
+            buffer[i] = b0;
+            buffer[i + 1] = b1;
+            buffer[i + 2] = b2;
+            buffer[i + 3] = b3;
+        }
+        for (; i < length; ++i) { buffer[i] = table[buffer[i]]; }
+    }
+
+    template<typename Fn>
+    omega_transform_t *create_lookup_table_from_(Fn &&fn) {
+        omega_byte_t table[256];
+        for (int byte = 0; byte < 256; ++byte) { table[byte] = static_cast<omega_byte_t>(fn(byte)); }
+        return omega_transform_create_lookup_table(table);
+    }
+}// namespace
+
+omega_transform_t *omega_transform_create_mask(omega_mask_kind_t mask_kind, const omega_byte_t *key,
+                                               int64_t key_length) {
+    switch (mask_kind) {
+        case MASK_AND:
+            return create_keyed_(transform_kind_t::TRANSFORM_AND, key, key_length);
+        case MASK_OR:
+            return create_keyed_(transform_kind_t::TRANSFORM_OR, key, key_length);
+        case MASK_XOR:
+            return create_keyed_(transform_kind_t::TRANSFORM_XOR, key, key_length);
+        default:
+            ABORT(LOG_ERROR("unhandled mask kind"););
+    }
+}
+
+omega_transform_t *omega_transform_create_add(const omega_byte_t *key, int64_t key_length) {
+    return create_keyed_(transform_kind_t::TRANSFORM_ADD, key, key_length);
+}
+
+omega_transform_t *omega_transform_create_subtract(const omega_byte_t *key, int64_t key_length) {
+    return create_keyed_(transform_kind_t::TRANSFORM_SUB, key, key_length);
+}
+
+omega_transform_t *omega_transform_create_lookup_table(const omega_byte_t *table) {
+    assert(table);
+    auto *const transform_ptr = new omega_transform_t;
+    transform_ptr->kind = transform_kind_t::TRANSFORM_LOOKUP;
+    memcpy(transform_ptr->table, table, sizeof(transform_ptr->table));
+    return transform_ptr;
+}
+
+omega_transform_t *omega_transform_create_to_upper() {
+    // std::toupper depends on the locale, and would also map letters above 0x7F in single-byte locales
+    return create_lookup_table_from_([](int byte) { return 'a' <= byte && byte <= 'z' ? byte - 'a' + 'A' : byte; });
+}
+
+omega_transform_t *omega_transform_create_to_lower() {
+    return create_lookup_table_from_([](int byte) { return 'A' <= byte && byte <= 'Z' ? byte - 'A' + 'a' : byte; });
+}
+
+omega_transform_t *omega_transform_create_callback(omega_util_byte_transform_t transform, void *user_data_ptr) {
+    assert(transform);
+    auto *const transform_ptr = new omega_transform_t;
+    transform_ptr->kind = transform_kind_t::TRANSFORM_CALLBACK;
+    transform_ptr->callback = transform;
+    transform_ptr->user_data_ptr = user_data_ptr;
+    return transform_ptr;
+}
+
+void omega_transform_destroy(omega_transform_t *transform_ptr) {
+    assert(transform_ptr);
+    delete transform_ptr;
+}
+
+void omega_transform_apply(const omega_transform_t *transform_ptr, omega_byte_t *buffer, int64_t length,
+                           int64_t key_offset) {
+    assert(transform_ptr);
+    assert(buffer || length == 0);
+    assert(0 <= key_offset);
+    switch (transform_ptr->kind) {
+        case transform_kind_t::TRANSFORM_LOOKUP:
+            apply_lookup_(transform_ptr->table, buffer, length);
+            break;
+        case transform_kind_t::TRANSFORM_CALLBACK:
+            omega_util_apply_byte_transform(buffer, length, transform_ptr->callback, transform_ptr->user_data_ptr);
+            break;
+        default:
+            apply_keyed_(transform_ptr, buffer, length, key_offset);
+            break;
+    }
+}
+
+void omega_transform_apply_parallel(const omega_transform_t *transform_ptr, omega_byte_t *buffer, int64_t length,
+                                    int64_t key_offset, int num_threads) {
+    assert(transform_ptr);
+    if (num_threads <= 0) { num_threads = static_cast<int>(std::max(1U, std::thread::hardware_concurrency())); }
+    const auto max_threads = std::max(static_cast<int64_t>(1), length / TRANSFORM_MIN_THREAD_LENGTH);
+    const auto thread_count = static_cast<int>(std::min(static_cast<int64_t>(num_threads), max_threads));
+    // Byte transform functions are not known to be thread safe, so they are always called on this thread
+    if (thread_count <= 1 || transform_kind_t::TRANSFORM_CALLBACK == transform_ptr->kind) {
+        omega_transform_apply(transform_ptr, buffer, length, key_offset);
+        return;
+    }
+    const auto piece_length = length / thread_count;
+    parallel_for_(thread_count, [&](int t) {
+        const auto piece_offset = t * piece_length;
+        const auto piece_size = (t == thread_count - 1) ? length - piece_offset : piece_length;
+        omega_transform_apply(transform_ptr, buffer + piece_offset, piece_size, key_offset + piece_offset);
+    });
+}
+
+int omega_transform_apply_to_file(const omega_transform_t *transform_ptr, char const *in_path, char const *out_path,
+                                  int64_t offset, int64_t length, int num_threads) {
+    assert(transform_ptr);
+    assert(in_path);
+    assert(out_path);
+    assert(0 <= offset);
+    assert(0 <= length);
+    FILE *in_fp = FOPEN(in_path, "rb");
+    if (!in_fp) {
+        LOG_ERROR("failed to open '" << in_path << "'");
+        return -1;
+    }
+    if (0 != FSEEK(in_fp, 0, SEEK_END)) {
+        FCLOSE(in_fp);
+        return -1;
+    }
+    const int64_t in_file_length = FTELL(in_fp);
+    if (0 == length) { length = in_file_length - offset; }
+    if (length < 1 || in_file_length <= offset || in_file_length < offset + length) {
+        LOG_ERROR("transform out of range");
+        FCLOSE(in_fp);
+        return -1;
+    }
+    FILE *out_fp = FOPEN(out_path, "wb");
+    if (!out_fp) {
+        LOG_ERROR("failed to open '" << out_path << "'");
+        FCLOSE(in_fp);
+        return -1;
+    }
+    int rc = -1;
+    if (omega_util_write_segment_to_file(in_fp, 0, offset, out_fp) == offset && 0 == FSEEK(in_fp, offset, SEEK_SET)) {
+        const auto block_capacity = std::min(length, TRANSFORM_FILE_BLOCK_SIZE);
+        const auto block = std::make_unique<omega_byte_t[]>(block_capacity);
+        int64_t transformed = 0;
+        while (transformed < length) {
+            const auto count = std::min(length - transformed, block_capacity);
+            if (count != static_cast<int64_t>(fread(block.get(), sizeof(omega_byte_t), count, in_fp))) { break; }
+            omega_transform_apply_parallel(transform_ptr, block.get(), count, transformed, num_threads);
+            if (count != static_cast<int64_t>(fwrite(block.get(), sizeof(omega_byte_t), count, out_fp))) { break; }
+            transformed += count;
+        }
+        const auto tail_length = in_file_length - offset - length;
+        if (transformed == length &&
+            omega_util_write_segment_to_file(in_fp, offset + length, tail_length, out_fp) == tail_length) {
+            rc = 0;
+        }
+    }
+    FCLOSE(out_fp);
+    FCLOSE(in_fp);
+    if (0 != rc) {
+        LOG_ERROR("failed to transform '" << in_path << "' to '" << out_path << "'");
+        omega_util_remove_file(out_path);
+    }
+    return rc;
+}
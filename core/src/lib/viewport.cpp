@@ -18,6 +18,7 @@
 #include "impl_/internal_fun.hpp"
 #include "impl_/session_def.hpp"
 #include "impl_/viewport_def.hpp"
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
 
@@ -83,16 +84,24 @@ int64_t omega_viewport_get_following_byte_count(const omega_viewport_t *viewport
 
 int omega_viewport_modify(omega_viewport_t *viewport_ptr, int64_t offset, int64_t capacity, int is_floating) {
     assert(viewport_ptr);
-    if (capacity > 0 && capacity <= OMEGA_VIEWPORT_CAPACITY_LIMIT) {
+    const auto capacity_limit = (0 != omega_viewport_is_paged(viewport_ptr)) ? OMEGA_PAGED_VIEWPORT_CAPACITY_LIMIT
+                                                                             : OMEGA_VIEWPORT_CAPACITY_LIMIT;
+    if (capacity > 0 && capacity <= capacity_limit) {
         // only change settings if they are different
         if (viewport_ptr->data_segment.offset != offset || omega_viewport_get_capacity(viewport_ptr) != capacity ||
             viewport_ptr->data_segment.is_floating != (bool) is_floating) {
-            omega_data_destroy(&viewport_ptr->data_segment.data, omega_viewport_get_capacity(viewport_ptr));
+            if (0 != omega_viewport_is_paged(viewport_ptr)) {
+                // drop all the pages, they will be allocated again as they are populated
+                viewport_ptr->pages_.clear();
+                viewport_ptr->pages_.resize((capacity + viewport_ptr->page_size_ - 1) / viewport_ptr->page_size_);
+            } else {
+                omega_data_destroy(&viewport_ptr->data_segment.data, omega_viewport_get_capacity(viewport_ptr));
+                omega_data_create(&viewport_ptr->data_segment.data, capacity);
+            }
             viewport_ptr->data_segment.offset = offset;
             viewport_ptr->data_segment.is_floating = (bool) is_floating;
             viewport_ptr->data_segment.offset_adjustment = 0;
             viewport_ptr->data_segment.capacity = -1 * capacity;// Negative capacity indicates dirty read
-            omega_data_create(&viewport_ptr->data_segment.data, capacity);
             omega_viewport_notify(viewport_ptr, VIEWPORT_EVT_MODIFY, nullptr);
         }
         return 0;
@@ -102,6 +111,8 @@ int omega_viewport_modify(omega_viewport_t *viewport_ptr, int64_t offset, int64_
 
 const omega_byte_t *omega_viewport_get_data(const omega_viewport_t *viewport_ptr) {
     assert(viewport_ptr);
+    // Paged viewports do not have a contiguous data buffer
+    if (0 != omega_viewport_is_paged(viewport_ptr)) { return nullptr; }
     const auto mut_viewport_ptr = const_cast<omega_viewport_t *>(viewport_ptr);
     if (0 != omega_viewport_has_changes(viewport_ptr)) {
         // Clean the dirty read with a fresh data segment population
@@ -112,6 +123,65 @@ const omega_byte_t *omega_viewport_get_data(const omega_viewport_t *viewport_ptr
     return omega_segment_get_data(&mut_viewport_ptr->data_segment);
 }
 
+int omega_viewport_is_paged(const omega_viewport_t *viewport_ptr) {
+    assert(viewport_ptr);
+    return 0 < viewport_ptr->page_size_ ? 1 : 0;
+}
+
+int64_t omega_viewport_get_page_size(const omega_viewport_t *viewport_ptr) {
+    assert(viewport_ptr);
+    return (0 != omega_viewport_is_paged(viewport_ptr)) ? viewport_ptr->page_size_
+                                                        : omega_viewport_get_capacity(viewport_ptr);
+}
+
+int64_t omega_viewport_get_num_pages(const omega_viewport_t *viewport_ptr) {
+    assert(viewport_ptr);
+    const auto page_size = omega_viewport_get_page_size(viewport_ptr);
+    return (omega_viewport_get_length(viewport_ptr) + page_size - 1) / page_size;
+}
+
+int64_t omega_viewport_get_num_populated_pages(const omega_viewport_t *viewport_ptr) {
+    assert(viewport_ptr);
+    if (0 == omega_viewport_is_paged(viewport_ptr)) { return omega_viewport_has_changes(viewport_ptr) ? 0 : 1; }
+    return std::count_if(viewport_ptr->pages_.cbegin(), viewport_ptr->pages_.cend(),
+                         [](const omega_viewport_page_t &page) { return 0 <= page.length; });
+}
+
+const omega_byte_t *omega_viewport_get_page_data(const omega_viewport_t *viewport_ptr, int64_t page_index,
+                                                 int64_t *page_length_ptr) {
+    assert(viewport_ptr);
+    if (page_index < 0 || omega_viewport_get_num_pages(viewport_ptr) <= page_index) { return nullptr; }
+    if (0 == omega_viewport_is_paged(viewport_ptr)) {
+        // Contiguous viewports have a single page, which is the viewport data
+        const auto data_ptr = omega_viewport_get_data(viewport_ptr);
+        if (data_ptr && page_length_ptr) { *page_length_ptr = viewport_ptr->data_segment.length; }
+        return data_ptr;
+    }
+    const auto mut_viewport_ptr = const_cast<omega_viewport_t *>(viewport_ptr);
+    if (0 != omega_viewport_has_changes(viewport_ptr)) {
+        // Clean the dirty read by computing the new length, stale pages are populated as they are requested
+        mut_viewport_ptr->data_segment.length = omega_viewport_get_length(viewport_ptr);
+        mut_viewport_ptr->data_segment.capacity = std::abs(viewport_ptr->data_segment.capacity);
+    }
+    const auto page_size = viewport_ptr->page_size_;
+    const auto page_offset = page_index * page_size;
+    const auto expected_length = std::min(page_size, viewport_ptr->data_segment.length - page_offset);
+    auto &page = mut_viewport_ptr->pages_[page_index];
+    if (page.length != expected_length) {
+        // page data allocation is the page size plus one, so we can null-terminate it
+        if (!page.data) { page.data = std::make_unique<omega_byte_t[]>(page_size + 1); }
+        if (populate_buffer_(viewport_ptr->session_ptr, omega_viewport_get_offset(viewport_ptr) + page_offset,
+                             page.data.get(), expected_length) != expected_length) {
+            page.length = -1;
+            return nullptr;
+        }
+        page.length = expected_length;
+        page.data[page.length] = '\0';
+    }
+    if (page_length_ptr) { *page_length_ptr = page.length; }
+    return page.data.get();
+}
+
 int omega_viewport_has_changes(const omega_viewport_t *viewport_ptr) {
     assert(viewport_ptr);
     // If the data segment capacity is negative, the viewport has changes.  When the data gets fetched from this
@@ -998,3 +998,88 @@ TEST_CASE("Viewports", "[ViewportTests]") {
     omega_edit_destroy_session(session_ptr);
 }
 
+TEST_CASE("Paged Viewports", "[ViewportTests]") {
+    const auto session_ptr = omega_edit_create_session(nullptr, nullptr, nullptr, NO_EVENTS, nullptr);
+    REQUIRE(session_ptr);
+    omega_edit_insert_string(session_ptr, 0, "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ");
+    REQUIRE(nullptr == omega_edit_create_paged_viewport(session_ptr, 0, 0, 8, 0, nullptr, nullptr, NO_EVENTS));
+    REQUIRE(nullptr == omega_edit_create_paged_viewport(session_ptr, 0, OMEGA_PAGED_VIEWPORT_CAPACITY_LIMIT + 1, 0, 0,
+                                                        nullptr, nullptr, NO_EVENTS));
+    const auto viewport_ptr = omega_edit_create_paged_viewport(session_ptr, 2, 20, 8, 0, vpt_change_cbk, nullptr,
+                                                               ALL_EVENTS);
+    REQUIRE(viewport_ptr);
+    const auto floating_viewport_ptr = omega_edit_create_paged_viewport(session_ptr, 20, 16, 8, 1, nullptr, nullptr,
+                                                                        NO_EVENTS);
+    REQUIRE(floating_viewport_ptr);
+    REQUIRE(0 != omega_viewport_is_paged(viewport_ptr));
+    REQUIRE(8 == omega_viewport_get_page_size(viewport_ptr));
+    REQUIRE(20 == omega_viewport_get_capacity(viewport_ptr));
+    REQUIRE(20 == omega_viewport_get_length(viewport_ptr));
+    REQUIRE(3 == omega_viewport_get_num_pages(viewport_ptr));
+    REQUIRE(nullptr == omega_viewport_get_data(viewport_ptr));
+    REQUIRE(0 == omega_viewport_get_num_populated_pages(viewport_ptr));
+    REQUIRE(0 != omega_viewport_has_changes(viewport_ptr));
+
+    // Only the pages that are read get populated
+    int64_t page_length = 0;
+    auto page_data = omega_viewport_get_page_data(viewport_ptr, 1, &page_length);
+    REQUIRE(page_data);
+    REQUIRE(8 == page_length);
+    REQUIRE(std::string(reinterpret_cast<const char *>(page_data)) == "ABCDEFGH");
+    REQUIRE(0 == omega_viewport_has_changes(viewport_ptr));
+    REQUIRE(1 == omega_viewport_get_num_populated_pages(viewport_ptr));
+    page_data = omega_viewport_get_page_data(viewport_ptr, 2, &page_length);
+    REQUIRE(page_data);
+    REQUIRE(4 == page_length);
+    REQUIRE(std::string(reinterpret_cast<const char *>(page_data)) == "IJKL");
+    REQUIRE(nullptr == omega_viewport_get_page_data(viewport_ptr, 3, &page_length));
+    REQUIRE(nullptr == omega_viewport_get_page_data(viewport_ptr, -1, &page_length));
+    REQUIRE(omega_viewport_get_string(viewport_ptr) == "23456789ABCDEFGHIJKL");
+    REQUIRE(3 == omega_viewport_get_num_populated_pages(viewport_ptr));
+    REQUIRE(omega_viewport_get_string(floating_viewport_ptr) == "KLMNOPQRSTUVWXYZ");
+    REQUIRE(2 == omega_viewport_get_num_populated_pages(floating_viewport_ptr));
+
+    // Overwrites only stale the pages they intersect
+    omega_edit_overwrite_string(session_ptr, 12, "cd");
+    REQUIRE(0 != omega_viewport_has_changes(viewport_ptr));
+    REQUIRE(2 == omega_viewport_get_num_populated_pages(viewport_ptr));
+    REQUIRE(omega_viewport_get_string(viewport_ptr) == "23456789ABcdEFGHIJKL");
+
+    // Inserts stale the pages from the insert to the end of the viewport, but floating viewports move along
+    omega_edit_insert_string(session_ptr, 18, "**");
+    REQUIRE(2 == omega_viewport_get_num_populated_pages(viewport_ptr));
+    REQUIRE(2 == omega_viewport_get_num_populated_pages(floating_viewport_ptr));
+    REQUIRE(22 == omega_viewport_get_offset(floating_viewport_ptr));
+    REQUIRE(omega_viewport_get_string(viewport_ptr) == "23456789ABcdEFGH**IJ");
+    REQUIRE(omega_viewport_get_string(floating_viewport_ptr) == "KLMNOPQRSTUVWXYZ");
+
+    // Deletes that reach into the viewport stale the pages from the start of the viewport
+    omega_edit_delete(session_ptr, 20, 4);
+    REQUIRE(0 == omega_viewport_get_num_populated_pages(floating_viewport_ptr));
+    REQUIRE(omega_viewport_get_string(floating_viewport_ptr) == "**MNOPQRSTUVWXYZ");
+    REQUIRE(2 == omega_viewport_get_num_pages(floating_viewport_ptr));
+
+    // Undo stales all the pages
+    omega_edit_undo_last_change(session_ptr);
+    REQUIRE(0 == omega_viewport_get_num_populated_pages(viewport_ptr));
+    REQUIRE(omega_viewport_get_string(viewport_ptr) == "23456789ABcdEFGH**IJ");
+
+    // Modifying the viewport keeps it paged
+    REQUIRE(0 == omega_viewport_modify(viewport_ptr, 0, 10, 0));
+    REQUIRE(0 != omega_viewport_is_paged(viewport_ptr));
+    REQUIRE(2 == omega_viewport_get_num_pages(viewport_ptr));
+    REQUIRE(omega_viewport_get_string(viewport_ptr) == "0123456789");
+    REQUIRE(0 != omega_viewport_modify(viewport_ptr, 0, OMEGA_PAGED_VIEWPORT_CAPACITY_LIMIT + 1, 0));
+
+    // Contiguous viewports present their data as a single page
+    const auto contiguous_viewport_ptr = omega_edit_create_viewport(session_ptr, 0, 10, 0, nullptr, nullptr, NO_EVENTS);
+    REQUIRE(contiguous_viewport_ptr);
+    REQUIRE(0 == omega_viewport_is_paged(contiguous_viewport_ptr));
+    REQUIRE(10 == omega_viewport_get_page_size(contiguous_viewport_ptr));
+    REQUIRE(1 == omega_viewport_get_num_pages(contiguous_viewport_ptr));
+    page_data = omega_viewport_get_page_data(contiguous_viewport_ptr, 0, &page_length);
+    REQUIRE(page_data == omega_viewport_get_data(contiguous_viewport_ptr));
+    REQUIRE(10 == page_length);
+    omega_edit_destroy_session(session_ptr);
+}
+
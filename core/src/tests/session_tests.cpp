@@ -13,6 +13,7 @@
  **********************************************************************************************************************/
 
 #include "omega_edit.h"
+#include "omega_edit/character_counts.h"
 #include "omega_edit/stl_string_adaptor.hpp"
 
 #include <test_util.hpp>
@@ -21,6 +22,10 @@
 #include <catch2/matchers/catch_matchers_contains.hpp>
 #include <catch2/matchers/catch_matchers_string.hpp>
 
+#include <filesystem>
+#include <thread>
+#include <vector>
+
 using Catch::Matchers::Contains;
 using Catch::Matchers::EndsWith;
 using Catch::Matchers::Equals;
@@ -63,13 +68,15 @@ TEST_CASE("Session Checkpoint Tests", "[SessionCheckpointTests]") {
     REQUIRE(1 == omega_session_get_num_changes(session_ptr));
     REQUIRE(0 == omega_session_get_num_checkpoints(session_ptr));
     REQUIRE(-1 == omega_edit_destroy_last_checkpoint(session_ptr));
+    // Transforms are changes, so they are checkpointed explicitly here
+    REQUIRE(0 == omega_edit_create_checkpoint(session_ptr));
     REQUIRE(0 == omega_edit_apply_transform(session_ptr, to_lower, nullptr, 0, 0));
     REQUIRE(1 == omega_session_get_num_checkpoints(session_ptr));
-    REQUIRE(1 == omega_session_get_num_changes(session_ptr));
-    REQUIRE(1 == omega_session_get_num_change_transactions(session_ptr));
-    REQUIRE(2 == omega_edit_overwrite_string(session_ptr, 37, "BCDEFGHIJKLMNOPQRSTUVWXY"));
     REQUIRE(2 == omega_session_get_num_changes(session_ptr));
     REQUIRE(2 == omega_session_get_num_change_transactions(session_ptr));
+    REQUIRE(3 == omega_edit_overwrite_string(session_ptr, 37, "BCDEFGHIJKLMNOPQRSTUVWXY"));
+    REQUIRE(3 == omega_session_get_num_changes(session_ptr));
+    REQUIRE(3 == omega_session_get_num_change_transactions(session_ptr));
     REQUIRE(0 == omega_edit_save(session_ptr, MAKE_PATH("test1.actual.checkpoint.1.dat"),
         omega_io_flags_t::IO_FLG_OVERWRITE, nullptr));
     REQUIRE(0 == omega_util_compare_files(MAKE_PATH("test1.expected.checkpoint.1.dat"),
@@ -77,10 +84,12 @@ TEST_CASE("Session Checkpoint Tests", "[SessionCheckpointTests]") {
     mask_info_t mask_info;
     mask_info.mask_kind = MASK_XOR;
     mask_info.mask = 0xFF;
+    REQUIRE(0 == omega_edit_create_checkpoint(session_ptr));
     REQUIRE(0 == omega_edit_apply_transform(session_ptr, byte_mask_transform, &mask_info, 10, 26));
     REQUIRE(2 == omega_session_get_num_checkpoints(session_ptr));
     REQUIRE(0 == omega_edit_save(session_ptr, MAKE_PATH("test1.actual.checkpoint.2.dat"),
         omega_io_flags_t::IO_FLG_OVERWRITE, nullptr));
+    REQUIRE(0 == omega_edit_create_checkpoint(session_ptr));
     REQUIRE(0 == omega_edit_apply_transform(session_ptr, byte_mask_transform, &mask_info, 10, 26));
     REQUIRE(3 == omega_session_get_num_checkpoints(session_ptr));
     REQUIRE(0 == omega_edit_save(session_ptr, MAKE_PATH("test1.actual.checkpoint.3.dat"),
@@ -88,6 +97,7 @@ TEST_CASE("Session Checkpoint Tests", "[SessionCheckpointTests]") {
     REQUIRE(0 == omega_util_compare_files(MAKE_PATH("test1.expected.checkpoint.1.dat"),
         MAKE_PATH("test1.actual.checkpoint.3.dat")));
     mask_info.mask_kind = MASK_AND;
+    REQUIRE(0 == omega_edit_create_checkpoint(session_ptr));
     REQUIRE(0 == omega_edit_apply_transform(session_ptr, byte_mask_transform, &mask_info, 10, 0));
     REQUIRE(4 == omega_session_get_num_checkpoints(session_ptr));
     REQUIRE(0 == omega_edit_save(session_ptr, MAKE_PATH("test1.actual.checkpoint.4.dat"),
@@ -96,6 +106,7 @@ TEST_CASE("Session Checkpoint Tests", "[SessionCheckpointTests]") {
         MAKE_PATH("test1.actual.checkpoint.4.dat")));
     mask_info.mask_kind = MASK_OR;
     mask_info.mask = 0x00;
+    REQUIRE(0 == omega_edit_create_checkpoint(session_ptr));
     REQUIRE(0 == omega_edit_apply_transform(session_ptr, byte_mask_transform, &mask_info, 10, 0));
     REQUIRE(5 == omega_session_get_num_checkpoints(session_ptr));
     REQUIRE(0 == omega_edit_save(session_ptr, MAKE_PATH("test1.actual.checkpoint.5.dat"),
@@ -103,30 +114,32 @@ TEST_CASE("Session Checkpoint Tests", "[SessionCheckpointTests]") {
     REQUIRE(0 == omega_util_compare_files(MAKE_PATH("test1.expected.checkpoint.1.dat"),
         MAKE_PATH("test1.actual.checkpoint.5.dat")));
     mask_info.mask_kind = MASK_AND;
+    REQUIRE(0 == omega_edit_create_checkpoint(session_ptr));
     REQUIRE(0 == omega_edit_apply_transform(session_ptr, byte_mask_transform, &mask_info, 10, 0));
     REQUIRE(6 == omega_session_get_num_checkpoints(session_ptr));
-    REQUIRE(3 == omega_edit_overwrite_string(session_ptr, 0,
+    REQUIRE(9 == omega_edit_overwrite_string(session_ptr, 0,
         "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz"));
-    REQUIRE(3 == omega_session_get_num_changes(session_ptr));
-    REQUIRE(3 == omega_session_get_num_change_transactions(session_ptr));
+    REQUIRE(9 == omega_session_get_num_changes(session_ptr));
+    REQUIRE(9 == omega_session_get_num_change_transactions(session_ptr));
     REQUIRE(0 == omega_edit_save(session_ptr, MAKE_PATH("test1.actual.checkpoint.6.dat"),
         omega_io_flags_t::IO_FLG_OVERWRITE, nullptr));
     REQUIRE(0 == omega_util_compare_files(MAKE_PATH("test1.expected.checkpoint.6.dat"),
         MAKE_PATH("test1.actual.checkpoint.6.dat")));
     auto change_ptr = omega_session_get_last_change(session_ptr);
     REQUIRE(change_ptr);
-    REQUIRE(3 == omega_change_get_serial(change_ptr));
-    REQUIRE(4 == omega_edit_insert_string(session_ptr, 0, "12345"));
-    REQUIRE(5 == omega_edit_delete(session_ptr, 0, 5));
-    REQUIRE(5 == omega_session_get_num_changes(session_ptr));
-    REQUIRE(5 == omega_session_get_num_change_transactions(session_ptr));
+    REQUIRE(9 == omega_change_get_serial(change_ptr));
+    REQUIRE(10 == omega_edit_insert_string(session_ptr, 0, "12345"));
+    REQUIRE(11 == omega_edit_delete(session_ptr, 0, 5));
+    REQUIRE(11 == omega_session_get_num_changes(session_ptr));
+    REQUIRE(11 == omega_session_get_num_change_transactions(session_ptr));
     change_ptr = omega_session_get_last_change(session_ptr);
-    REQUIRE(5 == omega_change_get_serial(change_ptr));
+    REQUIRE(11 == omega_change_get_serial(change_ptr));
     REQUIRE(0 == omega_edit_destroy_last_checkpoint(session_ptr));
     REQUIRE(5 == omega_session_get_num_checkpoints(session_ptr));
-    REQUIRE(2 == omega_session_get_num_changes(session_ptr));
-    REQUIRE(2 == omega_session_get_num_change_transactions(session_ptr));
-    REQUIRE(nullptr == omega_session_get_last_change(session_ptr));
+    REQUIRE(7 == omega_session_get_num_changes(session_ptr));
+    REQUIRE(7 == omega_session_get_num_change_transactions(session_ptr));
+    change_ptr = omega_session_get_last_change(session_ptr);
+    REQUIRE(7 == omega_change_get_serial(change_ptr));
     REQUIRE(0 == omega_edit_save(session_ptr, MAKE_PATH("test1.actual.checkpoint.7.dat"),
         omega_io_flags_t::IO_FLG_OVERWRITE, nullptr));
     REQUIRE(0 == omega_util_compare_files(MAKE_PATH("test1.expected.checkpoint.1.dat"),
@@ -378,6 +391,18 @@ TEST_CASE("Transactions", "[TransactionTests]") {
     REQUIRE(7 == omega_session_get_num_changes(session_ptr));
     REQUIRE(0 == omega_session_get_num_undone_changes(session_ptr));
     REQUIRE(4 == omega_session_get_num_change_transactions(session_ptr));
+    // Discarded undone changes can no longer be redone, and no longer count toward the history memory
+    const auto history_memory = omega_session_get_history_memory(session_ptr);
+    REQUIRE(0 == omega_edit_discard_undone_changes(session_ptr));
+    REQUIRE(-5 == omega_edit_undo_last_change(session_ptr));
+    REQUIRE(history_memory == omega_session_get_history_memory(session_ptr));
+    REQUIRE(3 == omega_edit_discard_undone_changes(session_ptr));
+    REQUIRE(0 == omega_session_get_num_undone_changes(session_ptr));
+    REQUIRE(0 == omega_session_get_num_undone_change_transactions(session_ptr));
+    REQUIRE(history_memory > omega_session_get_history_memory(session_ptr));
+    REQUIRE(0 == omega_edit_redo_last_undo(session_ptr));
+    REQUIRE(4 == omega_session_get_num_changes(session_ptr));
+    REQUIRE(3 == omega_session_get_num_change_transactions(session_ptr));
 
     // Negative testing
     REQUIRE(0 == omega_session_get_transaction_state(session_ptr));
@@ -388,3 +413,1054 @@ TEST_CASE("Transactions", "[TransactionTests]") {
     REQUIRE(0 == omega_session_end_transaction(session_ptr));
     REQUIRE(0 == omega_session_get_transaction_state(session_ptr));
 }
+
+static void require_tracked_profile_matches(const omega_session_t *session_ptr) {
+    omega_byte_frequency_profile_t expected{};
+    const auto contents = omega_session_get_segment_string(session_ptr, 0,
+                                                           omega_session_get_computed_file_size(session_ptr));
+    for (size_t i = 0; i < contents.size(); ++i) {
+        ++expected[static_cast<omega_byte_t>(contents[i])];
+        if (0 < i && '\r' == contents[i - 1] && '\n' == contents[i]) { ++expected[OMEGA_EDIT_PROFILE_DOS_EOL]; }
+    }
+    omega_byte_frequency_profile_t profile;
+    REQUIRE(0 == omega_session_byte_frequency_profile(session_ptr, &profile, 0, 0));
+    for (int i = 0; i < OMEGA_EDIT_BYTE_FREQUENCY_PROFILE_SIZE; ++i) { REQUIRE(expected[i] == profile[i]); }
+}
+
+TEST_CASE("Byte Frequency Profile Tracking", "[SessionProfileTests]") {
+    const auto session_ptr = omega_edit_create_session(nullptr, nullptr, nullptr, NO_EVENTS, nullptr);
+    REQUIRE(session_ptr);
+    REQUIRE(0 == omega_session_byte_frequency_profile_tracking(session_ptr));
+    omega_session_start_byte_frequency_profile_tracking(session_ptr);
+    REQUIRE(0 != omega_session_byte_frequency_profile_tracking(session_ptr));
+    require_tracked_profile_matches(session_ptr);
+    omega_edit_insert_string(session_ptr, 0, "line one\r\nline two\r\nline three\r\n");
+    require_tracked_profile_matches(session_ptr);
+    // Split a DOS EOL pair with an insert
+    omega_edit_insert_string(session_ptr, 9, "**");
+    require_tracked_profile_matches(session_ptr);
+    // Join a DOS EOL pair with a delete
+    omega_edit_delete(session_ptr, 9, 2);
+    require_tracked_profile_matches(session_ptr);
+    // Create a DOS EOL pair with an overwrite that extends past the end of the session
+    const auto computed_file_size = omega_session_get_computed_file_size(session_ptr);
+    omega_edit_overwrite_string(session_ptr, computed_file_size - 2, "\r\r\nx");
+    require_tracked_profile_matches(session_ptr);
+    omega_edit_delete(session_ptr, 0, 5);
+    require_tracked_profile_matches(session_ptr);
+    while (omega_session_get_num_changes(session_ptr)) {
+        omega_edit_undo_last_change(session_ptr);
+        require_tracked_profile_matches(session_ptr);
+    }
+    while (omega_session_get_num_undone_changes(session_ptr)) {
+        omega_edit_redo_last_undo(session_ptr);
+        require_tracked_profile_matches(session_ptr);
+    }
+    mask_info_t mask_info;
+    mask_info.mask_kind = MASK_XOR;
+    mask_info.mask = 0xFF;
+    REQUIRE(0 == omega_edit_create_checkpoint(session_ptr));
+    REQUIRE(0 == omega_edit_apply_transform(session_ptr, byte_mask_transform, &mask_info, 4, 8));
+    require_tracked_profile_matches(session_ptr);
+    REQUIRE(0 > omega_edit_undo_last_change(session_ptr));
+    require_tracked_profile_matches(session_ptr);
+    REQUIRE(0 < omega_edit_redo_last_undo(session_ptr));
+    require_tracked_profile_matches(session_ptr);
+    REQUIRE(0 == omega_edit_destroy_last_checkpoint(session_ptr));
+    require_tracked_profile_matches(session_ptr);
+    REQUIRE(0 == omega_edit_clear_changes(session_ptr));
+    require_tracked_profile_matches(session_ptr);
+    omega_session_stop_byte_frequency_profile_tracking(session_ptr);
+    REQUIRE(0 == omega_session_byte_frequency_profile_tracking(session_ptr));
+    omega_edit_insert_string(session_ptr, 0, "\r\n");
+    require_tracked_profile_matches(session_ptr);
+    omega_edit_destroy_session(session_ptr);
+}
+
+TEST_CASE("Byte Frequency Profile Parallel", "[SessionProfileTests]") {
+    const auto session_ptr = omega_edit_create_session(nullptr, nullptr, nullptr, NO_EVENTS, nullptr);
+    REQUIRE(session_ptr);
+    // Build content large enough to be split across threads, with CR LF pairs landing on every alignment
+    std::string contents;
+    uint32_t state = 12345;
+    while (contents.size() < 3 * 1024 * 1024) {
+        state = state * 1103515245 + 12345;
+        const auto byte = static_cast<char>(state >> 24);
+        contents.push_back(byte);
+        if (0 == (state & 0x1F0000)) { contents.append("\r\n"); }
+    }
+    omega_edit_insert_string(session_ptr, 0, contents);
+    omega_byte_frequency_profile_t expected{};
+    for (size_t i = 0; i < contents.size(); ++i) {
+        ++expected[static_cast<omega_byte_t>(contents[i])];
+        if (0 < i && '\r' == contents[i - 1] && '\n' == contents[i]) { ++expected[OMEGA_EDIT_PROFILE_DOS_EOL]; }
+    }
+    omega_byte_frequency_profile_t profile;
+    REQUIRE(0 == omega_session_byte_frequency_profile(session_ptr, &profile, 0, 0));
+    for (int i = 0; i < OMEGA_EDIT_BYTE_FREQUENCY_PROFILE_SIZE; ++i) { REQUIRE(expected[i] == profile[i]); }
+    for (const auto num_threads: {0, 1, 2, 3, 8}) {
+        REQUIRE(0 == omega_session_byte_frequency_profile_parallel(session_ptr, &profile, 0, 0, num_threads));
+        for (int i = 0; i < OMEGA_EDIT_BYTE_FREQUENCY_PROFILE_SIZE; ++i) { REQUIRE(expected[i] == profile[i]); }
+    }
+    // Profile a range that does not start or end on a block boundary
+    omega_byte_frequency_profile_t expected_range{};
+    const int64_t range_offset = 1001;
+    const int64_t range_length = 2 * 1024 * 1024 + 17;
+    for (auto i = range_offset; i < range_offset + range_length; ++i) {
+        ++expected_range[static_cast<omega_byte_t>(contents[i])];
+        if (range_offset < i && '\r' == contents[i - 1] && '\n' == contents[i]) {
+            ++expected_range[OMEGA_EDIT_PROFILE_DOS_EOL];
+        }
+    }
+    REQUIRE(0 == omega_session_byte_frequency_profile_parallel(session_ptr, &profile, range_offset, range_length, 4));
+    for (int i = 0; i < OMEGA_EDIT_BYTE_FREQUENCY_PROFILE_SIZE; ++i) { REQUIRE(expected_range[i] == profile[i]); }
+    omega_edit_destroy_session(session_ptr);
+}
+
+TEST_CASE("Character Counts Across Blocks", "[SessionCharCountsTests]") {
+    const auto session_ptr = omega_edit_create_session(nullptr, nullptr, nullptr, NO_EVENTS, nullptr);
+    REQUIRE(session_ptr);
+    const auto counts_ptr = omega_character_counts_create();
+    // Multi-byte characters will straddle the blocks the session is read in
+    const int64_t num_units = 200000;
+    std::string utf8_contents = "\xEF\xBB\xBF";
+    for (int64_t i = 0; i < num_units; ++i) { utf8_contents.append("a\xC3\xA9\xE2\x82\xAC\xF0\x9F\x8C\x8D\xFF"); }
+    omega_edit_insert_string(session_ptr, 0, utf8_contents);
+    for (const auto num_threads: {1, 2, 3, 0}) {
+        REQUIRE(0 == omega_session_character_counts_parallel(session_ptr, counts_ptr, 0, 0, BOM_UTF8, num_threads));
+        REQUIRE(3 == omega_character_counts_bom_bytes(counts_ptr));
+        REQUIRE(num_units == omega_character_counts_single_byte_chars(counts_ptr));
+        REQUIRE(num_units == omega_character_counts_double_byte_chars(counts_ptr));
+        REQUIRE(num_units == omega_character_counts_triple_byte_chars(counts_ptr));
+        REQUIRE(num_units == omega_character_counts_quad_byte_chars(counts_ptr));
+        REQUIRE(num_units == omega_character_counts_invalid_bytes(counts_ptr));
+    }
+    // A range that starts in the middle of a character
+    REQUIRE(0 == omega_session_character_counts(session_ptr, counts_ptr, 5, 0, BOM_NONE));
+    REQUIRE(0 == omega_character_counts_bom_bytes(counts_ptr));
+    REQUIRE(num_units - 1 == omega_character_counts_single_byte_chars(counts_ptr));
+    REQUIRE(num_units - 1 == omega_character_counts_double_byte_chars(counts_ptr));
+    REQUIRE(num_units + 1 == omega_character_counts_invalid_bytes(counts_ptr));
+
+    omega_edit_clear_changes(session_ptr);
+    std::string utf16_contents("\xFF\xFE" "B\x00", 4);
+    for (int64_t i = 0; i < num_units; ++i) { utf16_contents.append("A\x00\xE9\x00\x3C\xD8\x0D\xDF", 8); }
+    omega_edit_insert_string(session_ptr, 0, utf16_contents);
+    REQUIRE(0 == omega_session_character_counts(session_ptr, counts_ptr, 0, 0, BOM_UTF16LE));
+    REQUIRE(2 == omega_character_counts_bom_bytes(counts_ptr));
+    REQUIRE(num_units + 1 == omega_character_counts_single_byte_chars(counts_ptr));
+    REQUIRE(2 * num_units == omega_character_counts_double_byte_chars(counts_ptr));
+    REQUIRE(0 == omega_character_counts_invalid_bytes(counts_ptr));
+    omega_character_counts_destroy(counts_ptr);
+    omega_edit_destroy_session(session_ptr);
+}
+
+TEST_CASE("Content Classification", "[SessionCharCountsTests]") {
+    const auto session_ptr = omega_edit_create_session(nullptr, nullptr, nullptr, NO_EVENTS, nullptr);
+    REQUIRE(session_ptr);
+    REQUIRE(CONTENT_CLASS_EMPTY == omega_session_classify_content(session_ptr, 0, 0));
+    omega_edit_insert_string(session_ptr, 0, "Hello,\tworld!\r\n");
+    REQUIRE(CONTENT_CLASS_TEXT_UTF8 == omega_session_classify_content(session_ptr, 0, 0));
+    omega_edit_insert_string(session_ptr, 0, "caf\xC3\xA9 ");
+    REQUIRE(CONTENT_CLASS_TEXT_UTF8 == omega_session_classify_content(session_ptr, 0, 0));
+    // Latin-1 encoded text is not valid UTF-8
+    omega_edit_insert_string(session_ptr, 0, "caf\xE9 ");
+    REQUIRE(CONTENT_CLASS_TEXT_OTHER == omega_session_classify_content(session_ptr, 0, 0));
+    REQUIRE(CONTENT_CLASS_TEXT_UTF8 == omega_session_classify_content(session_ptr, 5, 0));
+    omega_edit_insert_bytes(session_ptr, 0, reinterpret_cast<const omega_byte_t *>("\x00"), 1);
+    REQUIRE(CONTENT_CLASS_BINARY == omega_session_classify_content(session_ptr, 0, 0));
+    REQUIRE(CONTENT_CLASS_TEXT_OTHER == omega_session_classify_content(session_ptr, 1, 0));
+    omega_edit_clear_changes(session_ptr);
+    omega_edit_insert_string(session_ptr, 0, "ab\x01\x02\x03\x04\x05" "cdefghijklmnopqrstuvwxyz");
+    REQUIRE(CONTENT_CLASS_BINARY == omega_session_classify_content(session_ptr, 0, 0));
+    REQUIRE(CONTENT_CLASS_TEXT_UTF8 == omega_session_classify_content(session_ptr, 7, 0));
+    omega_edit_clear_changes(session_ptr);
+    omega_edit_insert_bytes(session_ptr, 0, reinterpret_cast<const omega_byte_t *>("\xFF\xFEh\x00i\x00"), 6);
+    REQUIRE(CONTENT_CLASS_TEXT_UTF16 == omega_session_classify_content(session_ptr, 0, 0));
+
+    // Characters cut off by the end of the range, as by a 64 KiB detection limit, are still UTF-8
+    omega_edit_clear_changes(session_ptr);
+    std::string text = "a";
+    while (text.size() < 70000) { text.append("\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80"); }
+    omega_edit_insert_string(session_ptr, 0, text);
+    for (int64_t limit = 64 * 1024; limit < 64 * 1024 + 9; ++limit) {
+        REQUIRE(CONTENT_CLASS_TEXT_UTF8 == omega_session_classify_content(session_ptr, 0, limit));
+    }
+    REQUIRE(CONTENT_CLASS_TEXT_UTF8 == omega_session_classify_content(session_ptr, 1, 2));
+    REQUIRE(CONTENT_CLASS_TEXT_UTF8 == omega_session_classify_content(session_ptr, 6, 3));
+    // Continuation bytes that start the range, or that follow a complete character, are invalid
+    REQUIRE(CONTENT_CLASS_TEXT_OTHER == omega_session_classify_content(session_ptr, 2, 64 * 1024));
+    omega_edit_insert_string(session_ptr, 3, "\xA9");
+    REQUIRE(CONTENT_CLASS_TEXT_OTHER == omega_session_classify_content(session_ptr, 0, 4));
+    omega_edit_destroy_session(session_ptr);
+}
+
+static void require_character_counts_match(const omega_session_t *session_ptr, int64_t offset, int64_t length) {
+    const auto contents = omega_session_get_segment_string(session_ptr, offset, length);
+    const auto expected_ptr = omega_character_counts_create();
+    omega_character_counts_set_BOM(expected_ptr, BOM_UTF8);
+    omega_util_count_characters(reinterpret_cast<const omega_byte_t *>(contents.data()), contents.size(), expected_ptr);
+    const auto counts_ptr = omega_character_counts_create();
+    REQUIRE(0 == omega_session_character_counts(session_ptr, counts_ptr, offset, length, BOM_UTF8));
+    REQUIRE(omega_character_counts_bom_bytes(expected_ptr) == omega_character_counts_bom_bytes(counts_ptr));
+    REQUIRE(omega_character_counts_single_byte_chars(expected_ptr) ==
+            omega_character_counts_single_byte_chars(counts_ptr));
+    REQUIRE(omega_character_counts_double_byte_chars(expected_ptr) ==
+            omega_character_counts_double_byte_chars(counts_ptr));
+    REQUIRE(omega_character_counts_triple_byte_chars(expected_ptr) ==
+            omega_character_counts_triple_byte_chars(counts_ptr));
+    REQUIRE(omega_character_counts_quad_byte_chars(expected_ptr) ==
+            omega_character_counts_quad_byte_chars(counts_ptr));
+    REQUIRE(omega_character_counts_invalid_bytes(expected_ptr) == omega_character_counts_invalid_bytes(counts_ptr));
+    omega_character_counts_destroy(counts_ptr);
+    omega_character_counts_destroy(expected_ptr);
+}
+
+TEST_CASE("Block Summaries", "[SessionProfileTests]") {
+    // Multi-byte characters and DOS EOL pairs will straddle the summarized blocks of the file
+    auto session_ptr = omega_edit_create_session(nullptr, nullptr, nullptr, NO_EVENTS, nullptr);
+    REQUIRE(session_ptr);
+    std::string contents = "\xEF\xBB\xBF";
+    for (int i = 0; i < 30000; ++i) { contents.append("a\xC3\xA9\r\n\xE2\x82\xAC\xF0\x9F\x8C\x8D\xFF\x80"); }
+    omega_edit_insert_string(session_ptr, 0, contents);
+    REQUIRE(0 == omega_edit_save(session_ptr, MAKE_PATH("block_summaries.actual.dat"),
+                                 omega_io_flags_t::IO_FLG_OVERWRITE, nullptr));
+    omega_edit_destroy_session(session_ptr);
+    session_ptr = omega_edit_create_session(MAKE_PATH("block_summaries.actual.dat"), nullptr, nullptr, NO_EVENTS,
+                                            nullptr);
+    REQUIRE(session_ptr);
+    const auto file_size = omega_session_get_computed_file_size(session_ptr);
+    REQUIRE(static_cast<int64_t>(contents.size()) == file_size);
+    // The second pass uses the summaries built by the first
+    for (int pass = 0; pass < 2; ++pass) {
+        require_tracked_profile_matches(session_ptr);
+        require_character_counts_match(session_ptr, 0, file_size);
+        require_character_counts_match(session_ptr, 7, file_size - 7);
+        require_character_counts_match(session_ptr, 65535, 3 * 65536 + 2);
+    }
+    // Edits are visited between the summarized blocks
+    REQUIRE(0 < omega_edit_insert_string(session_ptr, 65536 + 10, "\x8C\x8D\r"));
+    REQUIRE(0 < omega_edit_delete(session_ptr, 3 * 65536 - 1, 2));
+    REQUIRE(0 < omega_edit_overwrite_string(session_ptr, 5 * 65536, "\n\xF0\x9F"));
+    for (int pass = 0; pass < 2; ++pass) {
+        require_tracked_profile_matches(session_ptr);
+        require_character_counts_match(session_ptr, 0, omega_session_get_computed_file_size(session_ptr));
+        require_character_counts_match(session_ptr, 65536 + 5, 4 * 65536);
+    }
+    // Transforms are visited between the summarized blocks
+    mask_info_t mask_info;
+    mask_info.mask_kind = MASK_XOR;
+    mask_info.mask = 0x40;
+    REQUIRE(0 == omega_edit_create_checkpoint(session_ptr));
+    REQUIRE(0 == omega_edit_apply_transform(session_ptr, byte_mask_transform, &mask_info, 2 * 65536, 65536));
+    require_tracked_profile_matches(session_ptr);
+    require_character_counts_match(session_ptr, 0, omega_session_get_computed_file_size(session_ptr));
+    REQUIRE(0 == omega_edit_destroy_last_checkpoint(session_ptr));
+    require_tracked_profile_matches(session_ptr);
+    require_character_counts_match(session_ptr, 0, omega_session_get_computed_file_size(session_ptr));
+    omega_edit_destroy_session(session_ptr);
+    omega_util_remove_file(MAKE_PATH("block_summaries.actual.dat"));
+}
+
+static size_t count_checkpoint_files(const char *checkpoint_directory, const char *prefix = ".OmegaEdit-chk.") {
+    size_t count = 0;
+    for (const auto &entry: std::filesystem::directory_iterator(checkpoint_directory)) {
+        if (entry.path().filename().string().rfind(prefix, 0) == 0) { ++count; }
+    }
+    return count;
+}
+
+TEST_CASE("Logical Checkpoints", "[SessionCheckpointTests]") {
+    const auto checkpoint_directory_str = std::string(MAKE_PATH("logical_checkpoints"));
+    const auto checkpoint_directory = checkpoint_directory_str.c_str();
+    const auto in_filename_str = std::string(MAKE_PATH("test1.dat"));
+    std::filesystem::remove_all(checkpoint_directory);
+    auto session_ptr = omega_edit_create_session(in_filename_str.c_str(), nullptr, nullptr, NO_EVENTS,
+                                                 checkpoint_directory);
+    REQUIRE(session_ptr);
+    const auto session_contents = [&session_ptr]() {
+        return omega_session_get_segment_string(session_ptr, 0, omega_session_get_computed_file_size(session_ptr));
+    };
+    const auto original = session_contents();
+    REQUIRE(0 < omega_edit_insert_string(session_ptr, 0, "0123456789"));
+    REQUIRE(0 < omega_edit_delete(session_ptr, 20, 5));
+    const auto checkpointed = session_contents();
+
+    // Creating a checkpoint does not write the session out
+    REQUIRE(0 == omega_edit_create_checkpoint(session_ptr));
+    REQUIRE(1 == omega_session_get_num_checkpoints(session_ptr));
+    REQUIRE(0 == count_checkpoint_files(checkpoint_directory));
+    REQUIRE_THAT(omega_session_get_file_path(session_ptr), Equals(in_filename_str));
+    REQUIRE(checkpointed == session_contents());
+    REQUIRE(0 == omega_edit_undo_last_change(session_ptr));
+
+    // Changes after the checkpoint are undone back to the checkpoint
+    REQUIRE(0 < omega_edit_overwrite_string(session_ptr, 5, "ABCDEFGHIJKLMNOPQRSTUVWXYZ"));
+    REQUIRE(0 < omega_edit_insert_string(session_ptr, 0, "abc"));
+    REQUIRE(0 == omega_edit_create_checkpoint(session_ptr));
+    REQUIRE(0 < omega_edit_delete(session_ptr, 0, 8));
+    REQUIRE(0 > omega_edit_undo_last_change(session_ptr));
+    REQUIRE(0 == omega_edit_undo_last_change(session_ptr));
+    REQUIRE(0 == omega_edit_destroy_last_checkpoint(session_ptr));
+    REQUIRE(0 > omega_edit_undo_last_change(session_ptr));
+    REQUIRE(0 > omega_edit_undo_last_change(session_ptr));
+    REQUIRE(checkpointed == session_contents());
+
+    // Transforms of ranges that fit in a change do not write a checkpoint either
+    REQUIRE(0 < omega_edit_insert_string(session_ptr, 0, "abc"));
+    REQUIRE(0 == omega_edit_create_checkpoint(session_ptr));
+    REQUIRE(0 == omega_edit_apply_transform(session_ptr, to_upper, nullptr, 0, 0));
+    REQUIRE(2 == omega_session_get_num_checkpoints(session_ptr));
+    REQUIRE(0 == count_checkpoint_files(checkpoint_directory));
+    REQUIRE(0 > omega_edit_undo_last_change(session_ptr));
+    REQUIRE("abc" + checkpointed == session_contents());
+    REQUIRE(0 == omega_edit_destroy_last_checkpoint(session_ptr));
+    REQUIRE(0 == omega_edit_destroy_last_checkpoint(session_ptr));
+    REQUIRE(0 == omega_session_get_num_checkpoints(session_ptr));
+    REQUIRE(0 > omega_edit_undo_last_change(session_ptr));
+    REQUIRE(0 > omega_edit_undo_last_change(session_ptr));
+    REQUIRE(0 == omega_edit_undo_last_change(session_ptr));
+    REQUIRE(original == session_contents());
+
+    // Checkpoints left on the session are cleaned up with it
+    REQUIRE(0 < omega_edit_insert_string(session_ptr, 0, "abc"));
+    REQUIRE(0 == omega_edit_create_checkpoint(session_ptr));
+    REQUIRE(0 == omega_edit_apply_transform(session_ptr, to_lower, nullptr, 0, 0));
+    REQUIRE(0 == omega_edit_create_checkpoint(session_ptr));
+    omega_edit_destroy_session(session_ptr);
+    REQUIRE(0 == count_checkpoint_files(checkpoint_directory));
+    std::filesystem::remove_all(checkpoint_directory);
+}
+
+TEST_CASE("Parallel Range Transforms", "[SessionTransformTests]") {
+    auto session_ptr = omega_edit_create_session(nullptr, nullptr, nullptr, NO_EVENTS, nullptr);
+    REQUIRE(session_ptr);
+    std::string contents;
+    for (int i = 0; i < 100000; ++i) { contents.append("Hello World! "); }
+    omega_edit_insert_string(session_ptr, 0, contents);
+    const auto file_size = omega_session_get_computed_file_size(session_ptr);
+    const omega_byte_t key[] = {0x01, 0x20, 0x7F};
+    const auto xor_ptr = omega_transform_create_mask(MASK_XOR, key, sizeof(key));
+    REQUIRE(xor_ptr);
+    REQUIRE(0 == omega_edit_apply_transform_parallel(session_ptr, xor_ptr, 3, file_size - 6, 4));
+    REQUIRE(2 == omega_session_get_num_changes(session_ptr));
+    auto transformed = omega_session_get_segment_string(session_ptr, 0, file_size);
+    REQUIRE(contents.substr(0, 3) == transformed.substr(0, 3));
+    REQUIRE(static_cast<char>(contents[3] ^ key[0]) == transformed[3]);
+    REQUIRE(static_cast<char>(contents[4] ^ key[1]) == transformed[4]);
+    REQUIRE(static_cast<char>(contents[5] ^ key[2]) == transformed[5]);
+    REQUIRE(contents.substr(file_size - 3) == transformed.substr(file_size - 3));
+    require_tracked_profile_matches(session_ptr);
+    // The keyed transform is its own inverse when applied over the same range
+    REQUIRE(0 == omega_edit_apply_transform_parallel(session_ptr, xor_ptr, 3, file_size - 6, 0));
+    REQUIRE(contents == omega_session_get_segment_string(session_ptr, 0, file_size));
+    REQUIRE(0 > omega_edit_undo_last_change(session_ptr));
+    REQUIRE(transformed == omega_session_get_segment_string(session_ptr, 0, file_size));
+    REQUIRE(0 != omega_edit_apply_transform_parallel(session_ptr, xor_ptr, file_size, 1, 0));
+    omega_transform_destroy(xor_ptr);
+    omega_edit_destroy_session(session_ptr);
+}
+
+TEST_CASE("Range Transform Events", "[SessionTransformTests]") {
+    std::vector<int32_t> session_events;
+    std::vector<int32_t> viewport_events;
+    auto session_ptr = omega_edit_create_session(
+            nullptr,
+            [](const omega_session_t *session_ptr, omega_session_event_t session_event, const void *) {
+                static_cast<std::vector<int32_t> *>(omega_session_get_user_data_ptr(session_ptr))
+                        ->push_back(session_event);
+            },
+            &session_events, SESSION_EVT_EDIT | SESSION_EVT_UNDO | SESSION_EVT_TRANSFORM, nullptr);
+    REQUIRE(session_ptr);
+    const auto viewport_ptr = omega_edit_create_viewport(
+            session_ptr, 0, 16, 0,
+            [](const omega_viewport_t *viewport_ptr, omega_viewport_event_t viewport_event, const void *) {
+                static_cast<std::vector<int32_t> *>(omega_viewport_get_user_data_ptr(viewport_ptr))
+                        ->push_back(viewport_event);
+            },
+            &viewport_events, VIEWPORT_EVT_EDIT | VIEWPORT_EVT_UNDO | VIEWPORT_EVT_TRANSFORM);
+    REQUIRE(viewport_ptr);
+    omega_session_set_change_coalescing(session_ptr, 1);
+    REQUIRE(0 < omega_edit_overwrite_string(session_ptr, 0, "hello "));
+    session_events.clear();
+    viewport_events.clear();
+    REQUIRE(0 < omega_edit_overwrite_string(session_ptr, 6, "world"));
+    REQUIRE(0 == omega_edit_apply_transform(session_ptr, to_upper, nullptr, 0, 0));
+    // Transforms made as changes notify transform events, and are not coalesced with the edit before them
+    REQUIRE(std::vector<int32_t>{SESSION_EVT_EDIT, SESSION_EVT_TRANSFORM} == session_events);
+    REQUIRE(std::vector<int32_t>{VIEWPORT_EVT_EDIT, VIEWPORT_EVT_TRANSFORM} == viewport_events);
+    REQUIRE("HELLO WORLD" == omega_session_get_segment_string(session_ptr, 0, 11));
+    REQUIRE(0 > omega_edit_undo_last_change(session_ptr));
+    REQUIRE(SESSION_EVT_UNDO == session_events.back());
+    REQUIRE(VIEWPORT_EVT_UNDO == viewport_events.back());
+    REQUIRE("hello world" == omega_session_get_segment_string(session_ptr, 0, 11));
+    // Edits that continue a transformed or shifted range are not coalesced into it either
+    const auto num_changes = omega_session_get_num_changes(session_ptr);
+    REQUIRE(0 == omega_edit_apply_transform(session_ptr, to_upper, nullptr, 0, 5));
+    REQUIRE(0 < omega_edit_overwrite_string(session_ptr, 5, "_"));
+    REQUIRE(num_changes + 2 == omega_session_get_num_changes(session_ptr));
+    REQUIRE("HELLO_world" == omega_session_get_segment_string(session_ptr, 0, 11));
+    REQUIRE(0 > omega_edit_undo_last_change(session_ptr));
+    REQUIRE("HELLO world" == omega_session_get_segment_string(session_ptr, 0, 11));
+    REQUIRE(0 < omega_edit_left_shift_bits(session_ptr, 0, 5, 8, 0));
+    REQUIRE(0 < omega_edit_overwrite_string(session_ptr, 5, "_"));
+    REQUIRE(num_changes + 3 == omega_session_get_num_changes(session_ptr));
+    REQUIRE(0 > omega_edit_undo_last_change(session_ptr));
+    REQUIRE(0 > omega_edit_undo_last_change(session_ptr));
+    REQUIRE("HELLO world" == omega_session_get_segment_string(session_ptr, 0, 11));
+    // A shift that continues an edit is not coalesced into the edit
+    REQUIRE(0 < omega_edit_overwrite_string(session_ptr, 0, "j"));
+    REQUIRE(0 < omega_edit_right_shift_bits(session_ptr, 1, 4, 8, 0));
+    REQUIRE(num_changes + 3 == omega_session_get_num_changes(session_ptr));
+    REQUIRE(0 > omega_edit_undo_last_change(session_ptr));
+    REQUIRE("jELLO world" == omega_session_get_segment_string(session_ptr, 0, 11));
+    omega_edit_destroy_session(session_ptr);
+}
+
+static std::string shift_bits_reference(const std::string &bytes, int64_t shift, int fill_bit, bool left) {
+    const auto bit_count = static_cast<int64_t>(bytes.size()) * 8;
+    std::string shifted(bytes.size(), '\0');
+    for (int64_t bit = 0; bit < bit_count; ++bit) {
+        const auto source_bit = left ? bit + shift : bit - shift;
+        const auto value = (source_bit < 0 || bit_count <= source_bit)
+                                   ? fill_bit
+                                   : (static_cast<unsigned char>(bytes[source_bit / 8]) >> (7 - source_bit % 8)) & 1;
+        if (value) { shifted[bit / 8] = static_cast<char>(shifted[bit / 8] | (0x80 >> (bit % 8))); }
+    }
+    return shifted;
+}
+
+TEST_CASE("Session Bit Shifts", "[SessionTransformTests]") {
+    auto session_ptr = omega_edit_create_session(nullptr, nullptr, nullptr, NO_EVENTS, nullptr);
+    REQUIRE(session_ptr);
+    // The range spans several streaming blocks, and is made of several model segments
+    std::string contents;
+    for (int i = 0; i < 300000; ++i) { contents.append("\x5A\xC3\x0F\x81\xFF\x00\x42", 7); }
+    omega_edit_insert_string(session_ptr, 0, contents.substr(0, 1000000));
+    omega_edit_insert_string(session_ptr, 1000000, contents.substr(1000000));
+    const auto file_size = omega_session_get_computed_file_size(session_ptr);
+    const int64_t offset = 3;
+    const auto length = file_size - 10;
+    const auto range = contents.substr(offset, length);
+    for (const int64_t shift: {1, 3, 7, 8, 13, 8 * 1024 * 1024 + 5}) {
+        for (const int fill_bit: {0, 1}) {
+            for (const bool left: {true, false}) {
+                const auto serial = left ? omega_edit_left_shift_bits(session_ptr, offset, length, shift, fill_bit)
+                                         : omega_edit_right_shift_bits(session_ptr, offset, length, shift, fill_bit);
+                REQUIRE(0 < serial);
+                const auto shifted = omega_session_get_segment_string(session_ptr, 0, file_size);
+                REQUIRE(contents.substr(0, offset) == shifted.substr(0, offset));
+                REQUIRE(shift_bits_reference(range, shift, fill_bit, left) == shifted.substr(offset, length));
+                REQUIRE(contents.substr(offset + length) == shifted.substr(offset + length));
+                REQUIRE(0 > omega_edit_undo_last_change(session_ptr));
+                REQUIRE(contents == omega_session_get_segment_string(session_ptr, 0, file_size));
+            }
+        }
+    }
+    // Sub-byte shifts of a short range match the buffer utilities
+    for (const bool left: {true, false}) {
+        auto buffer = contents.substr(1, 5);
+        auto *const buffer_bytes = reinterpret_cast<omega_byte_t *>(&buffer[0]);
+        if (left) {
+            REQUIRE(0 < omega_edit_left_shift_bits(session_ptr, 1, 5, 5, 1));
+            REQUIRE(0 == omega_util_left_shift_buffer(buffer_bytes, 5, 5, 1));
+        } else {
+            REQUIRE(0 < omega_edit_right_shift_bits(session_ptr, 1, 5, 5, 1));
+            REQUIRE(0 == omega_util_right_shift_buffer(buffer_bytes, 5, 5, 1));
+        }
+        REQUIRE(buffer == omega_session_get_segment_string(session_ptr, 1, 5));
+        REQUIRE(0 > omega_edit_undo_last_change(session_ptr));
+    }
+    REQUIRE(0 == omega_edit_left_shift_bits(session_ptr, 0, 0, 0, 0));
+    REQUIRE(0 == omega_edit_left_shift_bits(session_ptr, 0, 0, 1, 2));
+    REQUIRE(0 == omega_edit_right_shift_bits(session_ptr, file_size, 1, 1, 0));
+    REQUIRE(0 < omega_edit_right_shift_bits(session_ptr, file_size - 1, 0, 1, 0));
+    omega_edit_destroy_session(session_ptr);
+}
+
+TEST_CASE("Payload Compression", "[SessionCompressionTests]") {
+    auto session_ptr = omega_edit_create_session(nullptr, nullptr, nullptr, NO_EVENTS, nullptr);
+    REQUIRE(session_ptr);
+    REQUIRE(0 == omega_session_get_payload_compression_threshold(session_ptr));
+    REQUIRE(0 > omega_session_get_checkpoint_disk_budget(session_ptr));
+    omega_session_set_payload_compression_threshold(session_ptr, 4096);
+    std::string log_lines;
+    for (int i = 0; log_lines.size() < 1000000; ++i) {
+        log_lines.append("2024-01-01T00:00:" + std::to_string(i % 60) + " INFO request " + std::to_string(i) +
+                         " served in " + std::to_string(i % 97) + "ms\r\n");
+    }
+    std::string noise(300000, '\0');
+    uint32_t state = 12345;
+    for (auto &byte: noise) {
+        state = state * 1103515245 + 12345;
+        byte = static_cast<char>(state >> 24);
+    }
+    const std::string runs = std::string(70000, 'A') + std::string(5, 'B') + std::string(70000, 'A');
+    REQUIRE(0 < omega_edit_insert_string(session_ptr, 0, log_lines));
+    REQUIRE(0 < omega_edit_insert_string(session_ptr, 500000, noise));
+    REQUIRE(0 < omega_edit_insert_string(session_ptr, 123, runs));
+    REQUIRE(0 < omega_edit_insert_string(session_ptr, 7, "short payloads are left alone"));
+    auto expected = log_lines;
+    expected.insert(500000, noise);
+    expected.insert(123, runs);
+    expected.insert(7, "short payloads are left alone");
+    REQUIRE(3 == omega_session_get_num_compressed_payloads(session_ptr));
+    REQUIRE(static_cast<int64_t>(expected.size()) == omega_session_get_payload_bytes(session_ptr));
+    REQUIRE(static_cast<int64_t>(log_lines.size() + noise.size() + runs.size()) ==
+            omega_session_get_compressed_payload_bytes(session_ptr));
+    // Log lines and runs compress well, and noise is stored as is
+    REQUIRE(omega_session_get_stored_compressed_payload_bytes(session_ptr) <
+            static_cast<int64_t>(noise.size() + log_lines.size() / 4));
+    const auto file_size = omega_session_get_computed_file_size(session_ptr);
+    REQUIRE(static_cast<int64_t>(expected.size()) == file_size);
+    REQUIRE(expected == omega_session_get_segment_string(session_ptr, 0, file_size));
+    for (const int64_t offset: {0, 1, 65535, 65536, 65537, 499999, 777777}) {
+        REQUIRE(expected.substr(offset, 70000) == omega_session_get_segment_string(session_ptr, offset, 70000));
+    }
+    require_tracked_profile_matches(session_ptr);
+    require_character_counts_match(session_ptr, 0, file_size);
+    const auto search_context_ptr =
+            omega_search_create_context(session_ptr, "request 12345 ", 0, 0, 0, 0, 0);
+    REQUIRE(search_context_ptr);
+    REQUIRE(0 < omega_search_next_match(search_context_ptr, 1));
+    REQUIRE(static_cast<int64_t>(expected.find("request 12345 ")) ==
+            omega_search_context_get_match_offset(search_context_ptr));
+    omega_search_destroy_context(search_context_ptr);
+
+    // Edits split the compressed payloads, and saving reads them a block at a time
+    REQUIRE(0 < omega_edit_delete(session_ptr, 300000, 1000));
+    REQUIRE(0 < omega_edit_overwrite_string(session_ptr, 100, "overwritten"));
+    expected.erase(300000, 1000);
+    expected.replace(100, 11, "overwritten");
+    REQUIRE(0 == omega_edit_save(session_ptr, MAKE_PATH("payload_compression.actual.dat"),
+                                 omega_io_flags_t::IO_FLG_OVERWRITE, nullptr));
+    const auto saved_session_ptr = omega_edit_create_session(MAKE_PATH("payload_compression.actual.dat"), nullptr,
+                                                             nullptr, NO_EVENTS, nullptr);
+    REQUIRE(saved_session_ptr);
+    REQUIRE(expected == omega_session_get_segment_string(saved_session_ptr, 0,
+                                                         omega_session_get_computed_file_size(saved_session_ptr)));
+    omega_edit_destroy_session(saved_session_ptr);
+    omega_util_remove_file(MAKE_PATH("payload_compression.actual.dat"));
+
+    // Transforms and shifts of large ranges produce compressed payloads directly
+    const auto xor_ptr = omega_transform_create_mask(MASK_XOR, reinterpret_cast<const omega_byte_t *>("key"), 3);
+    REQUIRE(0 == omega_edit_apply_transform_parallel(session_ptr, xor_ptr, 1000, 1400000, 0));
+    REQUIRE(4 == omega_session_get_num_compressed_payloads(session_ptr));
+    REQUIRE(0 == omega_edit_apply_transform_parallel(session_ptr, xor_ptr, 1000, 1400000, 0));
+    REQUIRE(expected ==
+            omega_session_get_segment_string(session_ptr, 0, omega_session_get_computed_file_size(session_ptr)));
+    omega_transform_destroy(xor_ptr);
+    REQUIRE(0 < omega_edit_left_shift_bits(session_ptr, 10, 1200000, 4, 0));
+    REQUIRE(6 == omega_session_get_num_compressed_payloads(session_ptr));
+    REQUIRE(0 < omega_edit_right_shift_bits(session_ptr, 10, 1200000, 4, 0));
+    const auto shifted =
+            omega_session_get_segment_string(session_ptr, 0, omega_session_get_computed_file_size(session_ptr));
+    REQUIRE(expected.substr(0, 10) == shifted.substr(0, 10));
+    REQUIRE(static_cast<char>(expected[10] & 0x0F) == shifted[10]);
+    // Only the bits shifted out of the start of the range are lost
+    REQUIRE(expected.substr(11) == shifted.substr(11));
+    while (0 > omega_edit_undo_last_change(session_ptr)) {}
+    REQUIRE(0 == omega_session_get_computed_file_size(session_ptr));
+    REQUIRE(0 < omega_edit_redo_last_undo(session_ptr));
+    REQUIRE(log_lines ==
+            omega_session_get_segment_string(session_ptr, 0, omega_session_get_computed_file_size(session_ptr)));
+
+    // Asking a change for its bytes decodes a copy of its payload, and leaves the payload compressed
+    const auto num_compressed_payloads = omega_session_get_num_compressed_payloads(session_ptr);
+    const auto change_ptr = omega_session_get_last_change(session_ptr);
+    const auto bytes = omega_change_get_bytes(change_ptr);
+    REQUIRE(log_lines == std::string(reinterpret_cast<const char *>(bytes), omega_change_get_length(change_ptr)));
+    REQUIRE(bytes == omega_change_get_bytes(change_ptr));
+    REQUIRE(num_compressed_payloads == omega_session_get_num_compressed_payloads(session_ptr));
+    omega_edit_destroy_session(session_ptr);
+
+    // Payloads stay uncompressed while they fit in the memory budget
+    session_ptr = omega_edit_create_session(nullptr, nullptr, nullptr, NO_EVENTS, nullptr);
+    REQUIRE(session_ptr);
+    omega_session_set_payload_compression_threshold(session_ptr, 4096);
+    omega_session_set_payload_memory_budget(session_ptr, 2 * static_cast<int64_t>(log_lines.size()));
+    REQUIRE(0 < omega_edit_insert_string(session_ptr, 0, log_lines));
+    REQUIRE(0 < omega_edit_insert_string(session_ptr, 0, log_lines));
+    REQUIRE(0 == omega_session_get_num_compressed_payloads(session_ptr));
+    REQUIRE(0 < omega_edit_insert_string(session_ptr, 0, log_lines));
+    REQUIRE(1 == omega_session_get_num_compressed_payloads(session_ptr));
+    REQUIRE(log_lines + log_lines + log_lines ==
+            omega_session_get_segment_string(session_ptr, 0, omega_session_get_computed_file_size(session_ptr)));
+    REQUIRE(0 == omega_edit_create_checkpoint(session_ptr));
+    REQUIRE(0 == omega_session_get_checkpoint_disk_usage(session_ptr));
+    omega_edit_destroy_session(session_ptr);
+}
+
+TEST_CASE("Payload Spilling", "[SessionCompressionTests]") {
+    const auto checkpoint_directory_str = std::string(MAKE_PATH("payload_spilling"));
+    const auto checkpoint_directory = checkpoint_directory_str.c_str();
+    std::filesystem::remove_all(checkpoint_directory);
+    auto session_ptr = omega_edit_create_session(nullptr, nullptr, nullptr, NO_EVENTS, checkpoint_directory);
+    REQUIRE(session_ptr);
+    REQUIRE(0 == omega_session_get_payload_spill_threshold(session_ptr));
+    omega_session_set_payload_spill_threshold(session_ptr, 100000);
+    std::string pasted;
+    for (int i = 0; pasted.size() < 300000; ++i) { pasted.append("pasted line " + std::to_string(i) + "\n"); }
+    std::string expected;
+    REQUIRE(0 < omega_edit_insert_string(session_ptr, 0, pasted));
+    REQUIRE(0 < omega_edit_insert_string(session_ptr, 1000, pasted));
+    REQUIRE(0 < omega_edit_overwrite_string(session_ptr, 10, "small payloads stay in memory"));
+    expected = pasted;
+    expected.insert(1000, pasted);
+    expected.replace(10, 29, "small payloads stay in memory");
+    REQUIRE(2 == omega_session_get_num_spilled_payloads(session_ptr));
+    REQUIRE(2 * static_cast<int64_t>(pasted.size() + 1) == omega_session_get_payload_store_size(session_ptr));
+    REQUIRE(1 == count_checkpoint_files(checkpoint_directory, ".OmegaEdit-payloads."));
+    REQUIRE(expected ==
+            omega_session_get_segment_string(session_ptr, 0, omega_session_get_computed_file_size(session_ptr)));
+    require_tracked_profile_matches(session_ptr);
+
+    // Spilled payloads can be read in place
+    const auto change_ptr = omega_session_get_change(session_ptr, 2);
+    REQUIRE(pasted == std::string(reinterpret_cast<const char *>(omega_change_get_bytes(change_ptr)),
+                                  omega_change_get_length(change_ptr)));
+    REQUIRE(2 == omega_session_get_num_spilled_payloads(session_ptr));
+
+    // Produced and compressed payloads are spilled too
+    const auto xor_ptr = omega_transform_create_mask(MASK_XOR, reinterpret_cast<const omega_byte_t *>("\x20"), 1);
+    REQUIRE(0 == omega_edit_apply_transform_parallel(session_ptr, xor_ptr, 0, 0, 0));
+    omega_transform_destroy(xor_ptr);
+    REQUIRE(0 < omega_edit_right_shift_bits(session_ptr, 0, 0, 8, 0));
+    REQUIRE(4 == omega_session_get_num_spilled_payloads(session_ptr));
+    omega_session_set_payload_compression_threshold(session_ptr, 4096);
+    const auto payload_store_size = omega_session_get_payload_store_size(session_ptr);
+    REQUIRE(0 < omega_edit_insert_string(session_ptr, 0, pasted));
+    REQUIRE(5 == omega_session_get_num_spilled_payloads(session_ptr));
+    REQUIRE(1 == omega_session_get_num_compressed_payloads(session_ptr));
+    REQUIRE(omega_session_get_payload_store_size(session_ptr) - payload_store_size <
+            static_cast<int64_t>(pasted.size()) / 2);
+    const auto file_size = omega_session_get_computed_file_size(session_ptr);
+    const auto contents = omega_session_get_segment_string(session_ptr, 0, file_size);
+    REQUIRE(pasted == contents.substr(0, pasted.size()));
+    REQUIRE('\0' == contents[pasted.size()]);
+    REQUIRE(static_cast<char>(expected[0] ^ 0x20) == contents[pasted.size() + 1]);
+    REQUIRE(0 > omega_edit_undo_last_change(session_ptr));
+    REQUIRE(0 > omega_edit_undo_last_change(session_ptr));
+    REQUIRE(0 > omega_edit_undo_last_change(session_ptr));
+    REQUIRE(expected ==
+            omega_session_get_segment_string(session_ptr, 0, omega_session_get_computed_file_size(session_ptr)));
+    REQUIRE(0 < omega_edit_redo_last_undo(session_ptr));
+    REQUIRE(0 == omega_edit_clear_changes(session_ptr));
+    REQUIRE(0 == omega_session_get_num_spilled_payloads(session_ptr));
+
+    // The payload store is removed with the session
+    omega_edit_destroy_session(session_ptr);
+    REQUIRE(0 == count_checkpoint_files(checkpoint_directory, ".OmegaEdit-payloads."));
+    std::filesystem::remove_all(checkpoint_directory);
+}
+
+TEST_CASE("Payload Interning and Fills", "[SessionCompressionTests]") {
+    auto session_ptr = omega_edit_create_session(nullptr, nullptr, nullptr, NO_EVENTS, nullptr);
+    REQUIRE(session_ptr);
+
+    // Identical payloads share their bytes
+    const std::string pasted = "the same clipboard contents pasted over and over again, and again, and again\n";
+    std::string expected;
+    for (int i = 0; i < 100; ++i) {
+        REQUIRE(0 < omega_edit_insert_string(session_ptr, i * 3, pasted));
+        expected.insert(i * 3, pasted);
+    }
+    REQUIRE(0 < omega_edit_insert_string(session_ptr, 0, "short payloads are not interned"));
+    expected.insert(0, "short payloads are not interned");
+    REQUIRE(1 == omega_session_get_num_interned_payloads(session_ptr));
+    REQUIRE(omega_change_get_bytes(omega_session_get_change(session_ptr, 1)) ==
+            omega_change_get_bytes(omega_session_get_change(session_ptr, 100)));
+    REQUIRE(expected ==
+            omega_session_get_segment_string(session_ptr, 0, omega_session_get_computed_file_size(session_ptr)));
+    while (0 > omega_edit_undo_last_change(session_ptr)) {}
+    REQUIRE(0 < omega_edit_redo_last_undo(session_ptr));
+    REQUIRE(pasted ==
+            omega_session_get_segment_string(session_ptr, 0, omega_session_get_computed_file_size(session_ptr)));
+    REQUIRE(0 == omega_edit_clear_changes(session_ptr));
+    REQUIRE(0 == omega_session_get_num_interned_payloads(session_ptr));
+
+    // Filling a gigabyte stores only the pattern
+    const auto zero = omega_byte_t{0x00};
+    const int64_t gigabyte = INT64_C(1024) * 1024 * 1024;
+    REQUIRE(0 < omega_edit_insert_fill(session_ptr, 0, &zero, 1, gigabyte));
+    REQUIRE(gigabyte == omega_session_get_computed_file_size(session_ptr));
+    REQUIRE(0 < omega_edit_overwrite_string(session_ptr, gigabyte / 2, "middle"));
+    REQUIRE(std::string(3, '\0') + "middle" + std::string(3, '\0') ==
+            omega_session_get_segment_string(session_ptr, gigabyte / 2 - 3, 12));
+    REQUIRE(std::string(100, '\0') == omega_session_get_segment_string(session_ptr, gigabyte - 100, 100));
+    REQUIRE(0 > omega_edit_undo_last_change(session_ptr));
+    REQUIRE(0 > omega_edit_undo_last_change(session_ptr));
+    REQUIRE(0 == omega_session_get_computed_file_size(session_ptr));
+    REQUIRE(0 == omega_edit_clear_changes(session_ptr));
+
+    // Patterns repeat from the phase of the offset read
+    omega_session_start_byte_frequency_profile_tracking(session_ptr);
+    const auto *const pattern = reinterpret_cast<const omega_byte_t *>("0123456789");
+    REQUIRE(0 == omega_edit_insert_fill(session_ptr, 0, pattern, 0, 10));
+    REQUIRE(0 == omega_edit_insert_fill(session_ptr, 0, pattern, 10, 0));
+    REQUIRE(0 == omega_edit_insert_fill(session_ptr, 0, pattern, 10, std::numeric_limits<int64_t>::max() / 5));
+    REQUIRE(0 == omega_edit_insert_fill(session_ptr, 1, pattern, 10, 1));
+    REQUIRE(0 < omega_edit_insert_string(session_ptr, 0, "[]"));
+    REQUIRE(0 < omega_edit_insert_fill(session_ptr, 1, pattern, 10, 1000));
+    REQUIRE(0 < omega_edit_overwrite_fill(session_ptr, 5, pattern + 7, 3, 3));
+    REQUIRE(0 < omega_edit_insert_fill(session_ptr, 0, pattern, 3, 2));
+    expected = "[]";
+    for (int i = 0; i < 1000; ++i) { expected.insert(1 + i * 10, "0123456789"); }
+    expected.replace(5, 9, "789789789");
+    expected.insert(0, "012012");
+    const auto file_size = omega_session_get_computed_file_size(session_ptr);
+    REQUIRE(static_cast<int64_t>(expected.size()) == file_size);
+    REQUIRE(expected == omega_session_get_segment_string(session_ptr, 0, file_size));
+    for (const int64_t offset: {0, 5, 6, 7, 11, 13, 999, 9990}) {
+        REQUIRE(expected.substr(offset, 23) == omega_session_get_segment_string(session_ptr, offset, 23));
+    }
+    require_tracked_profile_matches(session_ptr);
+
+    // Asking a fill change for its bytes materializes them
+    const auto change_ptr = omega_session_get_change(session_ptr, 2);
+    REQUIRE(10000 == omega_change_get_length(change_ptr));
+    std::string filled;
+    for (int i = 0; i < 1000; ++i) { filled.append("0123456789"); }
+    REQUIRE(filled == std::string(reinterpret_cast<const char *>(omega_change_get_bytes(change_ptr)),
+                                  omega_change_get_length(change_ptr)));
+    REQUIRE(expected == omega_session_get_segment_string(session_ptr, 0, file_size));
+    REQUIRE(0 == omega_edit_save(session_ptr, MAKE_PATH("payload_fill.actual.dat"),
+                                 omega_io_flags_t::IO_FLG_OVERWRITE, nullptr));
+    const auto saved_session_ptr =
+            omega_edit_create_session(MAKE_PATH("payload_fill.actual.dat"), nullptr, nullptr, NO_EVENTS, nullptr);
+    REQUIRE(saved_session_ptr);
+    REQUIRE(expected == omega_session_get_segment_string(saved_session_ptr, 0, file_size));
+    omega_edit_destroy_session(saved_session_ptr);
+    omega_util_remove_file(MAKE_PATH("payload_fill.actual.dat"));
+    omega_edit_destroy_session(session_ptr);
+}
+
+TEST_CASE("Change Coalescing and Compaction", "[SessionChangeTests]") {
+    auto session_ptr = omega_edit_create_session(nullptr, nullptr, nullptr, NO_EVENTS, nullptr);
+    REQUIRE(session_ptr);
+    omega_session_start_byte_frequency_profile_tracking(session_ptr);
+    REQUIRE(0 == omega_session_get_change_coalescing(session_ptr));
+    omega_session_set_change_coalescing(session_ptr, 1);
+    REQUIRE(0 != omega_session_get_change_coalescing(session_ptr));
+
+    // Typing one byte at a time makes a single change and a single model segment
+    const std::string typed = "Typing one byte at a time makes a single change.";
+    for (size_t i = 0; i < typed.size(); ++i) {
+        REQUIRE(1 == omega_edit_insert_bytes(session_ptr, static_cast<int64_t>(i),
+                                             reinterpret_cast<const omega_byte_t *>(&typed[i]), 1));
+    }
+    REQUIRE(1 == omega_session_get_num_changes(session_ptr));
+    REQUIRE(1 == omega_session_get_num_change_transactions(session_ptr));
+    REQUIRE(typed ==
+            omega_session_get_segment_string(session_ptr, 0, omega_session_get_computed_file_size(session_ptr)));
+    const auto change_ptr = omega_session_get_change(session_ptr, 1);
+    REQUIRE(static_cast<int64_t>(typed.size()) == omega_change_get_length(change_ptr));
+    REQUIRE(typed == std::string(reinterpret_cast<const char *>(omega_change_get_bytes(change_ptr)),
+                                 omega_change_get_length(change_ptr)));
+
+    // Patching byte by byte, and deleting forward and backward, coalesce too
+    std::string expected = typed;
+    for (int64_t i = 7; i < 10; ++i) { REQUIRE(2 == omega_edit_overwrite_string(session_ptr, i, "#")); }
+    expected.replace(7, 3, "###");
+    REQUIRE(3 == omega_edit_delete(session_ptr, 20, 1));
+    REQUIRE(3 == omega_edit_delete(session_ptr, 20, 2));
+    REQUIRE(3 == omega_edit_delete(session_ptr, 19, 1));
+    REQUIRE(3 == omega_edit_delete(session_ptr, 17, 2));
+    expected.erase(17, 6);
+    REQUIRE(3 == omega_session_get_num_changes(session_ptr));
+    REQUIRE(expected ==
+            omega_session_get_segment_string(session_ptr, 0, omega_session_get_computed_file_size(session_ptr)));
+    require_tracked_profile_matches(session_ptr);
+
+    // Changes that do not continue the last change, or are of another kind, are not coalesced
+    REQUIRE(4 == omega_edit_insert_string(session_ptr, 0, ">"));
+    REQUIRE(5 == omega_edit_insert_string(session_ptr, 0, ">"));
+    REQUIRE(6 == omega_edit_overwrite_string(session_ptr, 2, "t"));
+    expected.insert(0, ">>");
+    expected[2] = 't';
+    REQUIRE(expected ==
+            omega_session_get_segment_string(session_ptr, 0, omega_session_get_computed_file_size(session_ptr)));
+
+    // Undo undoes the whole coalesced change
+    REQUIRE(0 > omega_edit_undo_last_change(session_ptr));
+    REQUIRE(0 > omega_edit_undo_last_change(session_ptr));
+    REQUIRE(0 > omega_edit_undo_last_change(session_ptr));
+    REQUIRE(0 > omega_edit_undo_last_change(session_ptr));
+    expected = typed;
+    expected.replace(7, 3, "###");
+    REQUIRE(expected ==
+            omega_session_get_segment_string(session_ptr, 0, omega_session_get_computed_file_size(session_ptr)));
+    REQUIRE(0 < omega_edit_redo_last_undo(session_ptr));
+    REQUIRE(3 == omega_session_get_num_changes(session_ptr));
+    REQUIRE(4 == omega_edit_delete(session_ptr, 0, 1));
+    REQUIRE(4 == omega_session_get_num_changes(session_ptr));
+
+    // Changes in a transaction coalesce with each other but not with changes outside it
+    REQUIRE(0 == omega_session_begin_transaction(session_ptr));
+    REQUIRE(5 == omega_edit_insert_string(session_ptr, 0, "a"));
+    REQUIRE(5 == omega_edit_insert_string(session_ptr, 1, "b"));
+    REQUIRE(6 == omega_edit_overwrite_string(session_ptr, 0, "c"));
+    REQUIRE(0 == omega_session_end_transaction(session_ptr));
+    REQUIRE(7 == omega_edit_overwrite_string(session_ptr, 1, "d"));
+    REQUIRE(7 == omega_session_get_num_changes(session_ptr));
+    REQUIRE(0 > omega_edit_undo_last_change(session_ptr));
+    REQUIRE(0 > omega_edit_undo_last_change(session_ptr));
+    REQUIRE(4 == omega_session_get_num_changes(session_ptr));
+    omega_session_set_change_coalescing(session_ptr, 0);
+    REQUIRE(5 == omega_edit_insert_string(session_ptr, 0, "x"));
+    REQUIRE(6 == omega_edit_insert_string(session_ptr, 1, "y"));
+    expected.erase(17, 6);
+    expected = "xy" + expected.substr(1);
+    REQUIRE(expected ==
+            omega_session_get_segment_string(session_ptr, 0, omega_session_get_computed_file_size(session_ptr)));
+    require_tracked_profile_matches(session_ptr);
+
+    // Compaction squashes the oldest changes, which can no longer be undone
+    REQUIRE(0 != omega_session_compact(session_ptr, 7));
+    REQUIRE(0 == omega_session_compact(session_ptr, 4));
+    REQUIRE(6 == omega_session_get_num_changes(session_ptr));
+    REQUIRE(nullptr == omega_session_get_change(session_ptr, 4));
+    REQUIRE(5 == omega_change_get_serial(omega_session_get_change(session_ptr, 5)));
+    REQUIRE(expected ==
+            omega_session_get_segment_string(session_ptr, 0, omega_session_get_computed_file_size(session_ptr)));
+    REQUIRE(0 == omega_session_compact(session_ptr, 3));
+    REQUIRE(0 > omega_edit_undo_last_change(session_ptr));
+    REQUIRE(0 > omega_edit_undo_last_change(session_ptr));
+    REQUIRE(0 == omega_edit_undo_last_change(session_ptr));
+    REQUIRE(expected.substr(2) ==
+            omega_session_get_segment_string(session_ptr, 0, omega_session_get_computed_file_size(session_ptr)));
+    REQUIRE(0 < omega_edit_redo_last_undo(session_ptr));
+    REQUIRE(0 < omega_edit_redo_last_undo(session_ptr));
+    REQUIRE(0 == omega_session_compact(session_ptr, omega_session_get_num_changes(session_ptr)));
+    REQUIRE(6 == omega_session_get_num_changes(session_ptr));
+    REQUIRE(expected ==
+            omega_session_get_segment_string(session_ptr, 0, omega_session_get_computed_file_size(session_ptr)));
+    REQUIRE(0 == omega_edit_undo_last_change(session_ptr));
+    REQUIRE(7 == omega_edit_insert_string(session_ptr, 0, "z"));
+    REQUIRE("z" + expected ==
+            omega_session_get_segment_string(session_ptr, 0, omega_session_get_computed_file_size(session_ptr)));
+    require_tracked_profile_matches(session_ptr);
+    omega_edit_destroy_session(session_ptr);
+}
+
+TEST_CASE("Bounded Undo History", "[SessionChangeTests]") {
+    auto session_ptr = omega_edit_create_session(nullptr, nullptr, nullptr, NO_EVENTS, nullptr);
+    REQUIRE(session_ptr);
+    REQUIRE(0 > omega_session_get_undo_depth_limit(session_ptr));
+    REQUIRE(0 > omega_session_get_history_memory_budget(session_ptr));
+    REQUIRE(0 == omega_session_get_history_memory(session_ptr));
+
+    // The undo depth limit folds the oldest changes, an eighth of the limit at a time
+    omega_session_set_undo_depth_limit(session_ptr, 16);
+    REQUIRE(16 == omega_session_get_undo_depth_limit(session_ptr));
+    std::string expected;
+    for (int i = 0; i < 100; ++i) {
+        const auto text = std::to_string(i) + ",";
+        REQUIRE(i + 1 == omega_edit_insert_string(session_ptr, 0, text));
+        expected.insert(0, text);
+        REQUIRE(omega_session_get_num_changes(session_ptr) - omega_session_get_num_folded_changes(session_ptr) <= 16);
+    }
+    REQUIRE(100 == omega_session_get_num_changes(session_ptr));
+    REQUIRE(84 <= omega_session_get_num_folded_changes(session_ptr));
+    REQUIRE(expected ==
+            omega_session_get_segment_string(session_ptr, 0, omega_session_get_computed_file_size(session_ptr)));
+    int64_t num_undone = 0;
+    while (0 != omega_edit_undo_last_change(session_ptr)) { ++num_undone; }
+    REQUIRE(100 - omega_session_get_num_folded_changes(session_ptr) == num_undone);
+    REQUIRE(expected.substr(expected.find(std::to_string(99 - num_undone) + ",")) ==
+            omega_session_get_segment_string(session_ptr, 0, omega_session_get_computed_file_size(session_ptr)));
+    while (0 != omega_edit_redo_last_undo(session_ptr)) {}
+    REQUIRE(expected ==
+            omega_session_get_segment_string(session_ptr, 0, omega_session_get_computed_file_size(session_ptr)));
+
+    // Transactions are folded whole
+    omega_session_set_undo_depth_limit(session_ptr, -1);
+    const auto num_folded_changes = omega_session_get_num_folded_changes(session_ptr);
+    REQUIRE(0 == omega_session_begin_transaction(session_ptr));
+    for (int i = 0; i < 10; ++i) { REQUIRE(0 < omega_edit_insert_string(session_ptr, 0, "t")); }
+    REQUIRE(0 == omega_session_end_transaction(session_ptr));
+    REQUIRE(0 < omega_edit_insert_string(session_ptr, 0, "u"));
+    omega_session_set_undo_depth_limit(session_ptr, 5);
+    REQUIRE(omega_session_get_num_changes(session_ptr) - 1 == omega_session_get_num_folded_changes(session_ptr));
+    REQUIRE(num_folded_changes < omega_session_get_num_folded_changes(session_ptr));
+    REQUIRE(0 > omega_edit_undo_last_change(session_ptr));
+    REQUIRE(0 == omega_edit_undo_last_change(session_ptr));
+    REQUIRE(std::string(10, 't') + expected ==
+            omega_session_get_segment_string(session_ptr, 0, omega_session_get_computed_file_size(session_ptr)));
+    REQUIRE(0 < omega_edit_redo_last_undo(session_ptr));
+    omega_session_set_undo_depth_limit(session_ptr, -1);
+
+    // The history memory budget releases the payloads of overwritten bytes
+    REQUIRE(0 == omega_edit_clear_changes(session_ptr));
+    REQUIRE(0 == omega_session_get_history_memory(session_ptr));
+    const std::string block(1000, 'x');
+    REQUIRE(0 < omega_edit_insert_string(session_ptr, 0, block));
+    const auto block_memory = omega_session_get_history_memory(session_ptr);
+    REQUIRE(static_cast<int64_t>(block.size()) < block_memory);
+    omega_session_set_history_memory_budget(session_ptr, 10 * block_memory);
+    REQUIRE(10 * block_memory == omega_session_get_history_memory_budget(session_ptr));
+    for (int i = 0; i < 100; ++i) {
+        const std::string overwrite(block.size(), static_cast<char>('a' + i % 26));
+        REQUIRE(0 < omega_edit_overwrite_string(session_ptr, 0, overwrite));
+        REQUIRE(omega_session_get_history_memory(session_ptr) <= 10 * block_memory);
+        REQUIRE(overwrite == omega_session_get_segment_string(session_ptr, 0, static_cast<int64_t>(block.size())));
+    }
+    REQUIRE(omega_session_get_payload_bytes(session_ptr) <= 10 * static_cast<int64_t>(block.size()));
+    REQUIRE(0 > omega_edit_undo_last_change(session_ptr));
+    REQUIRE(std::string(block.size(), static_cast<char>('a' + 98 % 26)) ==
+            omega_session_get_segment_string(session_ptr, 0, static_cast<int64_t>(block.size())));
+    omega_edit_destroy_session(session_ptr);
+}
+
+TEST_CASE("Compaction Within Checkpoints", "[SessionChangeTests]") {
+    auto session_ptr = omega_edit_create_session(nullptr, nullptr, nullptr, NO_EVENTS, nullptr);
+    REQUIRE(session_ptr);
+    std::string expected;
+    for (int i = 0; i < 10; ++i) {
+        const auto text = std::to_string(i) + ",";
+        REQUIRE(i + 1 == omega_edit_insert_string(session_ptr, 0, text));
+        expected.insert(0, text);
+    }
+
+    // Destroying a checkpoint whose changes were compacted goes back to the changes made before it
+    REQUIRE(0 == omega_edit_create_checkpoint(session_ptr));
+    for (int i = 0; i < 5; ++i) { REQUIRE(11 + i == omega_edit_insert_string(session_ptr, 0, "c")); }
+    REQUIRE(0 == omega_session_compact(session_ptr, omega_session_get_num_changes(session_ptr)));
+    REQUIRE(15 == omega_session_get_num_changes(session_ptr));
+    REQUIRE(0 == omega_edit_destroy_last_checkpoint(session_ptr));
+    REQUIRE(10 == omega_session_get_num_changes(session_ptr));
+    REQUIRE(10 == omega_change_get_serial(omega_session_get_last_change(session_ptr)));
+    REQUIRE(expected ==
+            omega_session_get_segment_string(session_ptr, 0, omega_session_get_computed_file_size(session_ptr)));
+    REQUIRE(-10 == omega_edit_undo_last_change(session_ptr));
+    REQUIRE(9 == omega_session_get_num_changes(session_ptr));
+    REQUIRE(0 < omega_edit_redo_last_undo(session_ptr));
+    REQUIRE(10 == omega_session_get_num_changes(session_ptr));
+
+    // So does destroying a checkpoint whose changes were folded to bound the undo history
+    REQUIRE(0 == omega_edit_create_checkpoint(session_ptr));
+    omega_session_set_undo_depth_limit(session_ptr, 4);
+    for (int i = 0; i < 20; ++i) { REQUIRE(11 + i == omega_edit_insert_string(session_ptr, 0, "f")); }
+    REQUIRE(0 < omega_session_get_num_folded_changes(session_ptr));
+    REQUIRE(30 == omega_session_get_num_changes(session_ptr));
+    omega_session_set_undo_depth_limit(session_ptr, -1);
+    REQUIRE(0 == omega_edit_destroy_last_checkpoint(session_ptr));
+    REQUIRE(10 == omega_session_get_num_changes(session_ptr));
+    REQUIRE(expected ==
+            omega_session_get_segment_string(session_ptr, 0, omega_session_get_computed_file_size(session_ptr)));
+    REQUIRE(-10 == omega_edit_undo_last_change(session_ptr));
+    REQUIRE(expected.substr(2) ==
+            omega_session_get_segment_string(session_ptr, 0, omega_session_get_computed_file_size(session_ptr)));
+    REQUIRE(0 < omega_edit_redo_last_undo(session_ptr));
+    REQUIRE(11 == omega_edit_insert_string(session_ptr, 0, "z"));
+    REQUIRE(11 == omega_session_get_num_changes(session_ptr));
+    REQUIRE(11 == omega_change_get_serial(omega_session_get_change(session_ptr, 11)));
+    REQUIRE("z" + expected ==
+            omega_session_get_segment_string(session_ptr, 0, omega_session_get_computed_file_size(session_ptr)));
+    omega_edit_destroy_session(session_ptr);
+}
+
+TEST_CASE("Session Snapshots", "[SessionSnapshotTests]") {
+    auto session_ptr = omega_edit_create_session(nullptr, nullptr, nullptr, NO_EVENTS, nullptr);
+    REQUIRE(session_ptr);
+    std::string contents;
+    for (int i = 0; i < 20000; ++i) { contents.append("line " + std::to_string(i) + "\r\n"); }
+    REQUIRE(0 < omega_edit_insert_string(session_ptr, 0, contents));
+    REQUIRE(0 == omega_edit_save(session_ptr, MAKE_PATH("session_snapshot.actual.dat"),
+                                 omega_io_flags_t::IO_FLG_OVERWRITE, nullptr));
+    omega_edit_destroy_session(session_ptr);
+    session_ptr = omega_edit_create_session(MAKE_PATH("session_snapshot.actual.dat"), nullptr, nullptr, NO_EVENTS,
+                                            nullptr);
+    REQUIRE(session_ptr);
+    REQUIRE(0 < omega_edit_insert_string(session_ptr, 10, "<first>"));
+    contents.insert(10, "<first>");
+    auto snapshot_ptr = omega_session_snapshot(session_ptr);
+    REQUIRE(snapshot_ptr);
+    REQUIRE(1 == omega_snapshot_get_num_changes(snapshot_ptr));
+    REQUIRE(static_cast<int64_t>(contents.size()) == omega_snapshot_get_computed_file_size(snapshot_ptr));
+    omega_byte_frequency_profile_t expected_profile;
+    REQUIRE(0 == omega_session_byte_frequency_profile(session_ptr, &expected_profile, 0, 0));
+
+    // The session keeps being edited, checkpointed, and undone while another thread reads the snapshot
+    std::string snapshot_contents;
+    omega_byte_frequency_profile_t profile;
+    int64_t match_offset = -2;
+    int profile_rc = -1;
+    std::thread reader([&]() {
+        const auto segment_ptr = omega_segment_create(4096);
+        for (int64_t offset = 0; offset < omega_snapshot_get_computed_file_size(snapshot_ptr);
+             offset += omega_segment_get_length(segment_ptr)) {
+            if (0 != omega_snapshot_get_segment(snapshot_ptr, segment_ptr, offset) ||
+                0 == omega_segment_get_length(segment_ptr)) {
+                break;
+            }
+            snapshot_contents.append(reinterpret_cast<const char *>(omega_segment_get_data(segment_ptr)),
+                                     omega_segment_get_length(segment_ptr));
+        }
+        omega_segment_destroy(segment_ptr);
+        profile_rc = omega_snapshot_byte_frequency_profile(snapshot_ptr, &profile, 0, 0);
+        match_offset = omega_snapshot_search(snapshot_ptr, reinterpret_cast<const omega_byte_t *>("line 19999"), 10,
+                                             0, 0);
+    });
+    for (int i = 0; i < 200; ++i) { REQUIRE(0 < omega_edit_insert_string(session_ptr, 100 * i, "<edit>")); }
+    REQUIRE(0 < omega_edit_delete(session_ptr, 0, 1000));
+    REQUIRE(0 == omega_edit_create_checkpoint(session_ptr));
+    REQUIRE(0 < omega_edit_overwrite_string(session_ptr, 0, "<checkpointed>"));
+    reader.join();
+    REQUIRE(contents == snapshot_contents);
+    REQUIRE(0 == profile_rc);
+    for (int byte = 0; byte < OMEGA_EDIT_BYTE_FREQUENCY_PROFILE_SIZE; ++byte) {
+        REQUIRE(expected_profile[byte] == profile[byte]);
+    }
+    REQUIRE(static_cast<int64_t>(contents.find("line 19999")) == match_offset);
+    REQUIRE(-1 == omega_snapshot_search(snapshot_ptr, reinterpret_cast<const omega_byte_t *>("<edit>"), 6, 0, 0));
+    REQUIRE(10 == omega_snapshot_search(snapshot_ptr, reinterpret_cast<const omega_byte_t *>("<first>"), 7, 5, 100));
+    // A search context finds every match, overlapping ones included, across the windows of the snapshot
+    for (const std::string pattern: {"11", "line 1", "\r\nline 1999"}) {
+        const auto search_context_ptr = omega_snapshot_search_create_context(
+                snapshot_ptr, reinterpret_cast<const omega_byte_t *>(pattern.data()),
+                static_cast<int64_t>(pattern.size()), 0, 0);
+        REQUIRE(search_context_ptr);
+        for (auto pos = contents.find(pattern); pos != std::string::npos; pos = contents.find(pattern, pos + 1)) {
+            REQUIRE(static_cast<int64_t>(pos) == omega_snapshot_search_next_match(search_context_ptr));
+        }
+        REQUIRE(-1 == omega_snapshot_search_next_match(search_context_ptr));
+        REQUIRE(-1 == omega_snapshot_search_next_match(search_context_ptr));
+        omega_snapshot_search_destroy_context(search_context_ptr);
+    }
+    const auto search_context_ptr =
+            omega_snapshot_search_create_context(snapshot_ptr, reinterpret_cast<const omega_byte_t *>("line"), 4, 1, 40);
+    REQUIRE(search_context_ptr);
+    const auto range = contents.substr(1, 40);
+    for (auto pos = range.find("line"); pos != std::string::npos; pos = range.find("line", pos + 1)) {
+        REQUIRE(static_cast<int64_t>(1 + pos) == omega_snapshot_search_next_match(search_context_ptr));
+    }
+    REQUIRE(-1 == omega_snapshot_search_next_match(search_context_ptr));
+    omega_snapshot_search_destroy_context(search_context_ptr);
+    REQUIRE(nullptr == omega_snapshot_search_create_context(snapshot_ptr, reinterpret_cast<const omega_byte_t *>("x"),
+                                                            0, 0, 0));
+    const auto counts_ptr = omega_character_counts_create();
+    REQUIRE(0 == omega_snapshot_character_counts(snapshot_ptr, counts_ptr, 0, 0, BOM_UTF8));
+    REQUIRE(static_cast<int64_t>(contents.size()) == omega_character_counts_single_byte_chars(counts_ptr));
+    REQUIRE(0 == omega_character_counts_invalid_bytes(counts_ptr));
+    omega_character_counts_destroy(counts_ptr);
+
+    // The snapshot outlives the checkpoint and the session it was taken from
+    const auto later_snapshot_ptr = omega_session_snapshot(session_ptr);
+    REQUIRE(later_snapshot_ptr);
+    REQUIRE(omega_session_get_computed_file_size(session_ptr) ==
+            omega_snapshot_get_computed_file_size(later_snapshot_ptr));
+    const auto expected = omega_session_get_segment_string(session_ptr, 0, 100);
+    REQUIRE(0 == omega_edit_destroy_last_checkpoint(session_ptr));
+    omega_edit_destroy_session(session_ptr);
+    const auto segment_ptr = omega_segment_create(100);
+    REQUIRE(0 == omega_snapshot_get_segment(later_snapshot_ptr, segment_ptr, 0));
+    REQUIRE(expected == std::string(reinterpret_cast<const char *>(omega_segment_get_data(segment_ptr)),
+                                    omega_segment_get_length(segment_ptr)));
+    REQUIRE(0 == omega_snapshot_get_segment(snapshot_ptr, segment_ptr, 0));
+    REQUIRE(contents.substr(0, 100) == std::string(reinterpret_cast<const char *>(omega_segment_get_data(segment_ptr)),
+                                                   omega_segment_get_length(segment_ptr)));
+    omega_segment_destroy(segment_ptr);
+    omega_snapshot_destroy(later_snapshot_ptr);
+    omega_snapshot_destroy(snapshot_ptr);
+}
@@ -13,6 +13,7 @@
  **********************************************************************************************************************/
 
 #include "omega_edit/filesystem.h"
+#include "omega_edit/transform.h"
 #include "omega_edit/utility.h"
 #include <test_util.hpp>
 #include <catch2/catch_test_macros.hpp>
@@ -128,4 +129,95 @@ TEST_CASE("File Transformer", "[TransformerTest]") {
         MAKE_PATH("test1.actual.transformed.3.dat"), to_lower, nullptr,
         37, 100));
     REQUIRE(0 == omega_util_file_exists(MAKE_PATH("test1.actual.transformed.3.dat")));
-}
\ No newline at end of file
+}
+
+TEST_CASE("Built-in Transforms", "[TransformerTest]") {
+    std::vector<omega_byte_t> data(3 * 1024 * 1024 + 7);
+    for (size_t i = 0; i < data.size(); ++i) { data[i] = static_cast<omega_byte_t>(i * 131 + (i >> 9)); }
+    const omega_byte_t key[] = "The quick brown fox jumps over the lazy dog";
+    for (const int64_t key_length: {1, 3, 16, 43}) {
+        for (const auto mask_kind: {MASK_AND, MASK_OR, MASK_XOR}) {
+            const auto transform_ptr = omega_transform_create_mask(mask_kind, key, key_length);
+            REQUIRE(transform_ptr);
+            const int64_t key_offset = 5;
+            auto expected = data;
+            for (size_t i = 0; i < expected.size(); ++i) {
+                expected[i] = omega_util_mask_byte(expected[i], key[(key_offset + i) % key_length], mask_kind);
+            }
+            auto actual = data;
+            omega_transform_apply(transform_ptr, actual.data(), static_cast<int64_t>(actual.size()), key_offset);
+            REQUIRE(expected == actual);
+            // Pieces applied on other threads pick up the key where the previous piece left off
+            for (const auto num_threads: {2, 3, 0}) {
+                actual = data;
+                omega_transform_apply_parallel(transform_ptr, actual.data(), static_cast<int64_t>(actual.size()),
+                                               key_offset, num_threads);
+                REQUIRE(expected == actual);
+            }
+            omega_transform_destroy(transform_ptr);
+        }
+        const auto add_ptr = omega_transform_create_add(key, key_length);
+        const auto subtract_ptr = omega_transform_create_subtract(key, key_length);
+        auto actual = data;
+        omega_transform_apply_parallel(add_ptr, actual.data(), static_cast<int64_t>(actual.size()), 0, 0);
+        REQUIRE(static_cast<omega_byte_t>(data[key_length + 1] + key[1 % key_length]) == actual[key_length + 1]);
+        REQUIRE(data != actual);
+        omega_transform_apply(subtract_ptr, actual.data(), static_cast<int64_t>(actual.size()), 0);
+        REQUIRE(data == actual);
+        omega_transform_destroy(subtract_ptr);
+        omega_transform_destroy(add_ptr);
+    }
+    REQUIRE(nullptr == omega_transform_create_mask(MASK_XOR, key, 0));
+    REQUIRE(nullptr == omega_transform_create_add(nullptr, 1));
+
+    omega_byte_t bytes[32];
+    strcpy(reinterpret_cast<char *>(bytes), "Hello World!");
+    const auto bytes_length = static_cast<int64_t>(strlen(reinterpret_cast<const char *>(bytes)));
+    const auto upper_ptr = omega_transform_create_to_upper();
+    const auto lower_ptr = omega_transform_create_to_lower();
+    const auto callback_ptr = omega_transform_create_callback(to_upper, nullptr);
+    omega_transform_apply(upper_ptr, bytes, bytes_length, 0);
+    REQUIRE_THAT(string(reinterpret_cast<const char *>(bytes)), Equals("HELLO WORLD!"));
+    omega_transform_apply(lower_ptr, bytes, bytes_length, 0);
+    REQUIRE_THAT(string(reinterpret_cast<const char *>(bytes)), Equals("hello world!"));
+    omega_transform_apply_parallel(callback_ptr, bytes, 1, 0, 0);
+    REQUIRE_THAT(string(reinterpret_cast<const char *>(bytes)), Equals("Hello world!"));
+    // Only ASCII letters change case, whatever the locale
+    omega_byte_t all_bytes[256];
+    for (int byte = 0; byte < 256; ++byte) { all_bytes[byte] = static_cast<omega_byte_t>(byte); }
+    omega_transform_apply(upper_ptr, all_bytes, sizeof(all_bytes), 0);
+    for (int byte = 0; byte < 256; ++byte) {
+        REQUIRE(('a' <= byte && byte <= 'z' ? byte - 'a' + 'A' : byte) == all_bytes[byte]);
+    }
+    for (int byte = 0; byte < 256; ++byte) { all_bytes[byte] = static_cast<omega_byte_t>(byte); }
+    omega_transform_apply(lower_ptr, all_bytes, sizeof(all_bytes), 0);
+    for (int byte = 0; byte < 256; ++byte) {
+        REQUIRE(('A' <= byte && byte <= 'Z' ? byte - 'A' + 'a' : byte) == all_bytes[byte]);
+    }
+    omega_byte_t table[256];
+    for (int byte = 0; byte < 256; ++byte) { table[byte] = static_cast<omega_byte_t>(255 - byte); }
+    const auto table_ptr = omega_transform_create_lookup_table(table);
+    omega_transform_apply(table_ptr, bytes, bytes_length, 0);
+    REQUIRE(static_cast<omega_byte_t>(255 - 'H') == bytes[0]);
+    omega_transform_apply(table_ptr, bytes, bytes_length, 0);
+    REQUIRE_THAT(string(reinterpret_cast<const char *>(bytes)), Equals("Hello world!"));
+
+    REQUIRE(0 == omega_transform_apply_to_file(upper_ptr, MAKE_PATH("test1.dat"),
+                                               MAKE_PATH("test1.actual.transformed.4.dat"), 0, 0, 0));
+    REQUIRE(0 == omega_util_compare_files(MAKE_PATH("test1.expected.transformed.1.dat"),
+                                          MAKE_PATH("test1.actual.transformed.4.dat")));
+    REQUIRE(0 == omega_transform_apply_to_file(callback_ptr, MAKE_PATH("test1.dat"),
+                                               MAKE_PATH("test1.actual.transformed.5.dat"), 37, 10, 1));
+    REQUIRE(0 == omega_util_apply_byte_transform_to_file(MAKE_PATH("test1.dat"),
+                                                         MAKE_PATH("test1.actual.transformed.6.dat"), to_upper, nullptr,
+                                                         37, 10));
+    REQUIRE(0 == omega_util_compare_files(MAKE_PATH("test1.actual.transformed.5.dat"),
+                                          MAKE_PATH("test1.actual.transformed.6.dat")));
+    REQUIRE(0 != omega_transform_apply_to_file(lower_ptr, MAKE_PATH("test1.dat"),
+                                               MAKE_PATH("test1.actual.transformed.7.dat"), 37, 100, 0));
+    REQUIRE(0 == omega_util_file_exists(MAKE_PATH("test1.actual.transformed.7.dat")));
+    omega_transform_destroy(table_ptr);
+    omega_transform_destroy(callback_ptr);
+    omega_transform_destroy(lower_ptr);
+    omega_transform_destroy(upper_ptr);
+}
@@ -40,9 +40,11 @@ import {
   SegmentResponse,
   SessionCountResponse,
   SingleCount,
+  StreamSegmentRequest,
   TextRequest,
 } from './omega_edit_pb'
 import { Empty } from 'google-protobuf/google/protobuf/empty_pb'
+import { ServiceError } from '@grpc/grpc-js'
 import { getClient } from './client'
 import { getLogger } from './logger'
 import { editSimple, IEditStats, overwrite } from './change'
@@ -453,6 +455,55 @@ export async function getSegment(
   })
 }
 
+/**
+ * Streams a range of the session in chunks, read from a snapshot of the session taken when the stream starts, so ranges
+ * too large for a single getSegment call can be read with bounded memory.  Chunks are pulled from the server as the
+ * caller consumes them.
+ * @param session_id session to stream from
+ * @param offset start offset of the range
+ * @param length number of bytes to stream, or zero to stream to the end of the session
+ * @param chunk_size maximum number of bytes per chunk, or undefined to use the server default
+ * @return chunks of the range, in order
+ */
+export async function* streamSegment(
+  session_id: string,
+  offset: number,
+  length: number,
+  chunk_size?: number
+): AsyncGenerator<SegmentResponse> {
+  const log = getLogger()
+  const request = new StreamSegmentRequest()
+    .setSessionId(session_id)
+    .setOffset(offset)
+    .setLength(length)
+  if (chunk_size !== undefined) {
+    request.setChunkSize(chunk_size)
+  }
+  log.debug({ fn: 'streamSegment', rqst: request.toObject() })
+  const client = await getClient()
+  const stream = client.streamSegment(request)
+  try {
+    for await (const chunk of stream) {
+      yield chunk as SegmentResponse
+    }
+  } catch (e) {
+    const err = e as ServiceError
+    log.error({
+      fn: 'streamSegment',
+      rqst: request.toObject(),
+      err: {
+        msg: err.message,
+        details: err.details,
+        code: err.code,
+        stack: err.stack,
+      },
+    })
+    throw new Error('streamSegment error: ' + err.message)
+  } finally {
+    stream.cancel()
+  }
+}
+
 /**
  * Gets the number of active editing sessions on the server
  * @return number of active sessions on the server, on success
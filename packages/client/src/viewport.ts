@@ -25,6 +25,7 @@ import {
   ObjectId,
   ViewportDataRequest,
   ViewportDataResponse,
+  ViewportEvent,
 } from './omega_edit_pb'
 import { getLogger } from './logger'
 import { getClient } from './client'
@@ -359,3 +360,88 @@ export async function unsubscribeViewport(
       })
   })
 }
+
+/**
+ * Viewport data kept up to date on the client by applying viewport events
+ */
+export interface ViewportState {
+  // byte-offset start of the viewport
+  offset: number
+  // viewport data
+  data: Uint8Array
+  // sequence of the last viewport event reflected in the data
+  sequence: number
+}
+
+/**
+ * Create a viewport state from viewport data
+ * @param response viewport data from createViewport, modifyViewport, or getViewportData
+ * @return viewport state with the given data
+ */
+export function viewportStateFromData(
+  response: ViewportDataResponse
+): ViewportState {
+  return {
+    offset: response.getOffset(),
+    data: response.getData_asU8(),
+    sequence: response.hasSequence() ? response.getSequence() : 0,
+  }
+}
+
+/**
+ * Apply a viewport event to a viewport state.  Events carry the full viewport data, unless the subscription asked for
+ * viewport deltas, in which case edits and undos usually carry a delta that rebuilds the viewport data from the data of
+ * the previous event.
+ * @param state viewport state to apply the event to, undefined if there is none yet
+ * @param event viewport event to apply
+ * @return updated viewport state, the given state if it already reflects the event, or undefined if the event cannot be
+ * applied to the given state, in which case the viewport state must be resynchronized using getViewportData
+ */
+export function applyViewportEvent(
+  state: ViewportState | undefined,
+  event: ViewportEvent
+): ViewportState | undefined {
+  const sequence = event.hasSequence() ? event.getSequence() : undefined
+  if (
+    state !== undefined &&
+    sequence !== undefined &&
+    sequence <= state.sequence
+  ) {
+    return state
+  }
+  const delta = event.getDelta()
+  if (delta === undefined) {
+    if (!event.hasData()) return undefined
+    return {
+      offset: event.getOffset(),
+      data: event.getData_asU8(),
+      sequence: sequence ?? (state === undefined ? 0 : state.sequence),
+    }
+  }
+  if (
+    state === undefined ||
+    sequence === undefined ||
+    delta.getBaseSequence() !== state.sequence ||
+    delta.getBaseLength() !== state.data.length
+  ) {
+    return undefined
+  }
+  const data = new Uint8Array(event.getLength())
+  let length = 0
+  for (const piece of delta.getPiecesList()) {
+    const copy = piece.getCopy()
+    const bytes =
+      copy === undefined
+        ? piece.getData_asU8()
+        : state.data.subarray(
+            copy.getOffset(),
+            copy.getOffset() + copy.getLength()
+          )
+    if (data.length < length + bytes.length) return undefined
+    data.set(bytes, length)
+    length += bytes.length
+  }
+  return length === data.length
+    ? { offset: event.getOffset(), data: data, sequence: sequence }
+    : undefined
+}
@@ -37,6 +37,8 @@ import {
   overwrite,
   removeCommonSuffix,
   SessionEventKind,
+  streamSegment,
+  submitEditOperations,
   unsubscribeSession,
 } from '@omega-edit/client'
 import {
@@ -96,6 +98,48 @@ describe('Editing', () => {
     })
   })
 
+  describe('Bulk', () => {
+    it('Should submit many changes in one stream', async () => {
+      await subscribeSession(session_id, SessionEventKind.SESSION_EVT_EDIT)
+      const operations: EditOperation[] = []
+      for (let i = 0; i < 100; ++i) {
+        operations.push({
+          type: EditOperationType.Insert,
+          start: i,
+          data: Buffer.from([0x30 + (i % 10)]),
+        })
+      }
+      operations.push({ type: EditOperationType.Delete, start: 0, length: 10 })
+      const stats = new EditStats()
+      const r = await submitEditOperations(session_id, operations, stats)
+      expect(r.getChangeCount()).to.equal(101)
+      expect(r.getLastSerial()).to.equal(await getChangeCount(session_id))
+      expect(stats.insert_count).to.equal(100)
+      expect(stats.delete_count).to.equal(1)
+      expect(await getComputedFileSize(session_id)).to.equal(90)
+      expect(await getSegment(session_id, 0, 10)).deep.equals(
+        Buffer.from('0123456789')
+      )
+      // one edit event per batch rather than one per change
+      await checkCallbackCount(session_callbacks, session_id, r.getBatchCount())
+    })
+  })
+
+  describe('Stream', () => {
+    it('Should stream a range in chunks', async () => {
+      const data: Uint8Array = Buffer.from('abcdefghijklmnopqrstuvwxyz')
+      await insert(session_id, 0, data)
+      const offsets: number[] = []
+      const chunks: Uint8Array[] = []
+      for await (const chunk of streamSegment(session_id, 2, 0, 10)) {
+        offsets.push(chunk.getOffset())
+        chunks.push(chunk.getData_asU8())
+      }
+      expect(offsets).deep.equals([2, 12, 22])
+      expect(Buffer.concat(chunks)).deep.equals(data.subarray(2))
+    })
+  })
+
   describe('Delete', () => {
     it('Should delete some data', async () => {
       expect(0).to.equal(await getComputedFileSize(session_id))
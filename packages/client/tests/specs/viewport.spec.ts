@@ -20,10 +20,14 @@
 import { expect } from 'chai'
 import {
   ALL_EVENTS,
+  applyViewportEvent,
   createViewport,
   del,
   destroyViewport,
+  EventOverflowPolicy,
+  EventSubscriptionRequest,
   getChangeCount,
+  getClient,
   getComputedFileSize,
   getSegment,
   getViewportCount,
@@ -34,9 +38,13 @@ import {
   overwrite,
   pauseViewportEvents,
   resumeViewportEvents,
+  undo,
   unsubscribeViewport,
+  ViewportEvent,
   ViewportEventKind,
   viewportHasChanges,
+  ViewportState,
+  viewportStateFromData,
 } from '@omega-edit/client'
 import {
   checkCallbackCount,
@@ -426,4 +434,112 @@ describe('Viewports', () => {
     await destroyViewport(viewport_id)
     expect(await getViewportCount(session_id)).to.equal(0)
   }).timeout(8000)
+
+  it('Should rebuild viewport data from viewport event deltas', async () => {
+    const viewport_response = await createViewport(
+      'test_vpt_delta',
+      session_id,
+      2,
+      10,
+      false
+    )
+    const viewport_id = viewport_response.getViewportId()
+    const events: ViewportEvent[] = []
+    const client = await getClient()
+    client
+      .subscribeToViewportEvents(
+        new EventSubscriptionRequest()
+          .setId(viewport_id)
+          .setViewportDeltas(true)
+      )
+      .on('data', (event: ViewportEvent) => {
+        events.push(event)
+      })
+      .on('error', (err: Error) => {
+        log_info('viewport delta subscription error: ' + err.message)
+      })
+
+    await insert(session_id, 0, Buffer.from('0123456789ABCDEF'))
+    await del(session_id, 3, 2)
+    await overwrite(session_id, 5, Buffer.from('xy'))
+    await insert(session_id, 11, Buffer.from('++'))
+    await undo(session_id)
+    const changeEvents = () =>
+      events.filter((event) =>
+        [
+          ViewportEventKind.VIEWPORT_EVT_EDIT,
+          ViewportEventKind.VIEWPORT_EVT_UNDO,
+        ].includes(event.getViewportEventKind())
+      )
+    for (let i = 0; i < 50 && changeEvents().length < 5; ++i) {
+      await new Promise((resolve) => setTimeout(resolve, 100))
+    }
+    expect(changeEvents().length).to.equal(5)
+
+    // Only the first edit, which fills the empty viewport, needs the full data
+    expect(events.filter((event) => event.hasDelta()).length).to.equal(4)
+    let state: ViewportState | undefined =
+      viewportStateFromData(viewport_response)
+    for (const event of events) {
+      state = applyViewportEvent(state, event)
+      expect(state).to.not.be.undefined
+    }
+    const viewport_data = await getViewportData(viewport_id)
+    expect(state!.offset).to.equal(viewport_data.getOffset())
+    expect(state!.data).to.deep.equal(viewport_data.getData_asU8())
+    expect(Buffer.from(state!.data)).to.deep.equal(Buffer.from('256xy9ABCD'))
+
+    // Events that the viewport data already reflects are skipped
+    expect(
+      applyViewportEvent(viewportStateFromData(viewport_data), events[1])
+    ).to.deep.equal(viewportStateFromData(viewport_data))
+    await unsubscribeViewport(viewport_id)
+    await destroyViewport(viewport_id)
+  }).timeout(8000)
+
+  it('Should send full viewport data to conflated subscribers', async () => {
+    const viewport_response = await createViewport(
+      'test_vpt_conflate',
+      session_id,
+      0,
+      10,
+      false
+    )
+    const viewport_id = viewport_response.getViewportId()
+    const events: ViewportEvent[] = []
+    const client = await getClient()
+    client
+      .subscribeToViewportEvents(
+        new EventSubscriptionRequest()
+          .setId(viewport_id)
+          .setOverflowPolicy(EventOverflowPolicy.EVENT_OVERFLOW_CONFLATE)
+      )
+      .on('data', (event: ViewportEvent) => {
+        events.push(event)
+      })
+      .on('error', (err: Error) => {
+        log_info('viewport conflate subscription error: ' + err.message)
+      })
+
+    await insert(session_id, 0, Buffer.from('0123456789'))
+    await overwrite(session_id, 2, Buffer.from('xy'))
+    await del(session_id, 0, 1)
+    const viewport_data = await getViewportData(viewport_id)
+    const caughtUp = () =>
+      events.length > 0 &&
+      Buffer.from(events[events.length - 1].getData_asU8()).equals(
+        Buffer.from(viewport_data.getData_asU8())
+      )
+    for (let i = 0; i < 50 && !caughtUp(); ++i) {
+      await new Promise((resolve) => setTimeout(resolve, 100))
+    }
+    expect(caughtUp()).to.be.true
+
+    // Conflated events can be missed, so none of them depends on the ones before it
+    expect(events.filter((event) => event.hasDelta()).length).to.equal(0)
+    const last = events[events.length - 1]
+    expect(applyViewportEvent(undefined, last)).to.not.be.undefined
+    await unsubscribeViewport(viewport_id)
+    await destroyViewport(viewport_id)
+  }).timeout(8000)
 })
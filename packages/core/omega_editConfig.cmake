@@ -32,6 +32,10 @@ if (omega_edit_comp_static AND omega_edit_comp_shared)
     return()
 endif ()
 
+# The static library links against the platform threads library
+include(CMakeFindDependencyMacro)
+find_dependency(Threads)
+
 set(omega_edit_static_targets "${CMAKE_CURRENT_LIST_DIR}/omega_edit-static-targets.cmake")
 set(omega_edit_shared_targets "${CMAKE_CURRENT_LIST_DIR}/omega_edit-shared-targets.cmake")
 
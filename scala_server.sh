@@ -33,6 +33,11 @@ function serv_build {
     serv
 }
 
+# run against a server started with serv or serv_build, e.g. ./scala_server.sh load_test --clients 8 --viewports 4
+function load_test {
+    sbt "bench/run $*"
+}
+
 cd server/scala
 $@
 cd ../../
@@ -0,0 +1,1082 @@
+/**********************************************************************************************************************
+ * Copyright (c) 2021 Concurrent Technologies Corporation.                                                            *
+ *                                                                                                                    *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance     *
+ * with the License.  You may obtain a copy of the License at                                                         *
+ *                                                                                                                    *
+ *     http://www.apache.org/licenses/LICENSE-2.0                                                                     *
+ *                                                                                                                    *
+ * Unless required by applicable law or agreed to in writing, software is distributed under the License is            *
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or                   *
+ * implied.  See the License for the specific language governing permissions and limitations under the License.       *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+
+#include "editor_service.hpp"
+#include <omega_edit.h>
+#include <omega_edit/character_counts.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+    constexpr size_t change_batch_size = 1024;
+    constexpr int64_t default_stream_chunk_size = 1024 * 1024;
+    // stay below the default gRPC maximum message size of 4 MiB
+    constexpr int64_t max_stream_chunk_size = 3 * 1024 * 1024;
+    constexpr auto subscription_poll_interval = std::chrono::milliseconds(100);
+
+    int32_t get_pid_() {
+#ifdef _WIN32
+        return static_cast<int32_t>(_getpid());
+#else
+        return static_cast<int32_t>(getpid());
+#endif
+    }
+
+    std::string get_hostname_() {
+#ifdef _WIN32
+        const auto *hostname = std::getenv("COMPUTERNAME");
+        return hostname ? hostname : "";
+#else
+        char hostname[256] = {};
+        return 0 == gethostname(hostname, sizeof(hostname) - 1) ? hostname : "";
+#endif
+    }
+
+    std::string get_version_() {
+        return std::to_string(omega_version_major()) + "." + std::to_string(omega_version_minor()) + "." +
+               std::to_string(omega_version_patch());
+    }
+
+    int32_t get_cpu_count_() { return static_cast<int32_t>(std::max(1U, std::thread::hardware_concurrency())); }
+
+    /**
+     * Encode the given string as URL-safe base64, as session ids for files are
+     */
+    std::string base64url_(const std::string &in) {
+        static constexpr char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+        std::string out;
+        out.reserve((in.size() + 2) / 3 * 4);
+        for (size_t i = 0; i < in.size(); i += 3) {
+            const auto remaining = in.size() - i;
+            uint32_t bits = static_cast<uint8_t>(in[i]) << 16;
+            if (1 < remaining) { bits |= static_cast<uint8_t>(in[i + 1]) << 8; }
+            if (2 < remaining) { bits |= static_cast<uint8_t>(in[i + 2]); }
+            out += alphabet[(bits >> 18) & 0x3F];
+            out += alphabet[(bits >> 12) & 0x3F];
+            out += 1 < remaining ? alphabet[(bits >> 6) & 0x3F] : '=';
+            out += 2 < remaining ? alphabet[bits & 0x3F] : '=';
+        }
+        return out;
+    }
+
+    /**
+     * Generate a random (version 4) UUID string
+     */
+    std::string uuid_() {
+        thread_local std::mt19937_64 generator{std::random_device{}()};
+        auto high = generator();
+        auto low = generator();
+        high = (high & ~UINT64_C(0xF000)) | UINT64_C(0x4000);
+        low = (low & ~(UINT64_C(0xC) << 60)) | (UINT64_C(0x8) << 60);
+        char uuid[37];
+        std::snprintf(uuid, sizeof(uuid), "%08x-%04x-%04x-%04x-%012llx", static_cast<uint32_t>(high >> 32),
+                      static_cast<uint32_t>((high >> 16) & 0xFFFF), static_cast<uint32_t>(high & 0xFFFF),
+                      static_cast<uint32_t>(low >> 48),
+                      static_cast<unsigned long long>(low & UINT64_C(0xFFFFFFFFFFFF)));
+        return uuid;
+    }
+
+    grpc::Status session_not_found_() { return {grpc::StatusCode::NOT_FOUND, "session not found"}; }
+
+    grpc::Status undefined_change_kind_() { return {grpc::StatusCode::INVALID_ARGUMENT, "undefined change kind"}; }
+
+    void session_event_cbk_(const omega_session_t *session_ptr, omega_session_event_t session_event,
+                            const void *event_ptr) {
+        auto *session = static_cast<server_session_t *>(omega_session_get_user_data_ptr(session_ptr));
+        std::shared_ptr<event_queue_t<omega_edit::SessionEvent>> events;
+        {
+            std::lock_guard<std::mutex> lock(session->subscriptions_mutex);
+            events = session->events;
+        }
+        if (!events) { return; }
+        omega_edit::SessionEvent event;
+        event.set_session_id(session->id);
+        event.set_session_event_kind(static_cast<omega_edit::SessionEventKind>(session_event));
+        event.set_computed_file_size(omega_session_get_computed_file_size(session_ptr));
+        event.set_change_count(omega_session_get_num_changes(session_ptr));
+        event.set_undo_count(omega_session_get_num_undone_changes(session_ptr));
+        if (event_ptr && (SESSION_EVT_EDIT == session_event || SESSION_EVT_UNDO == session_event)) {
+            event.set_serial(omega_change_get_serial(static_cast<const omega_change_t *>(event_ptr)));
+        }
+        events->offer(std::move(event));
+    }
+
+    /* Viewport events always carry the full viewport data, which is what subscribers get by default, so the viewport
+     * deltas option of a subscription is not supported.  Viewports served from shared memory get every event, to keep
+     * the region current, and only tell their subscriber which generation of the region is ready. */
+    void viewport_event_cbk_(const omega_viewport_t *viewport_ptr, omega_viewport_event_t viewport_event,
+                             const void *event_ptr) {
+        auto *viewport = static_cast<server_viewport_t *>(omega_viewport_get_user_data_ptr(viewport_ptr));
+        auto *session = static_cast<server_session_t *>(
+                omega_session_get_user_data_ptr(omega_viewport_get_session(viewport_ptr)));
+        std::shared_ptr<event_queue_t<omega_edit::ViewportEvent>> events;
+        {
+            std::lock_guard<std::mutex> lock(session->subscriptions_mutex);
+            events = viewport->events;
+        }
+        if (!events && !viewport->shared) { return; }
+        const auto *data = reinterpret_cast<const char *>(omega_viewport_get_data(viewport_ptr));
+        const auto offset = omega_viewport_get_offset(viewport_ptr);
+        const auto length = omega_viewport_get_length(viewport_ptr);
+        omega_edit::ViewportEvent event;
+        event.set_session_id(viewport->session_id);
+        event.set_viewport_id(viewport->viewport_id);
+        event.set_viewport_event_kind(static_cast<omega_edit::ViewportEventKind>(viewport_event));
+        if (event_ptr && (VIEWPORT_EVT_EDIT == viewport_event || VIEWPORT_EVT_UNDO == viewport_event)) {
+            event.set_serial(omega_change_get_serial(static_cast<const omega_change_t *>(event_ptr)));
+        }
+        event.set_offset(offset);
+        event.set_length(length);
+        event.set_sequence(++viewport->sequence);
+        if (viewport->shared) {
+            const auto following_byte_count = omega_viewport_get_following_byte_count(viewport_ptr);
+            *event.mutable_shared_update() =
+                    viewport->shared->update(offset, data, length, following_byte_count, event.sequence());
+        } else {
+            event.set_data(data, static_cast<size_t>(length));
+        }
+        if (events && (viewport_event & viewport->interest)) { events->offer(std::move(event)); }
+    }
+
+    void fill_viewport_data_(const server_viewport_t &viewport, omega_edit::ViewportDataResponse &response) {
+        const auto *data = omega_viewport_get_data(viewport.viewport_ptr);
+        const auto length = omega_viewport_get_length(viewport.viewport_ptr);
+        response.set_viewport_id(viewport.viewport_id);
+        response.set_offset(omega_viewport_get_offset(viewport.viewport_ptr));
+        response.set_length(length);
+        response.set_data(reinterpret_cast<const char *>(data), static_cast<size_t>(length));
+        response.set_following_byte_count(omega_viewport_get_following_byte_count(viewport.viewport_ptr));
+        response.set_sequence(viewport.sequence);
+        if (viewport.shared) { viewport.shared->describe(*response.mutable_shared_viewport()); }
+    }
+
+    void fill_change_details_(const std::string &session_id, const omega_change_t *change_ptr,
+                              omega_edit::ChangeDetailsResponse &response) {
+        response.set_session_id(session_id);
+        response.set_serial(omega_change_get_serial(change_ptr));
+        switch (omega_change_get_kind_as_char(change_ptr)) {
+            case 'D':
+                response.set_kind(omega_edit::CHANGE_DELETE);
+                break;
+            case 'I':
+                response.set_kind(omega_edit::CHANGE_INSERT);
+                break;
+            case 'O':
+                response.set_kind(omega_edit::CHANGE_OVERWRITE);
+                break;
+            default:
+                response.set_kind(omega_edit::UNDEFINED_CHANGE);
+                break;
+        }
+        response.set_offset(omega_change_get_offset(change_ptr));
+        response.set_length(omega_change_get_length(change_ptr));
+        const auto *bytes = omega_change_get_bytes(change_ptr);
+        response.set_data(bytes ? std::string(reinterpret_cast<const char *>(bytes),
+                                              static_cast<size_t>(omega_change_get_length(change_ptr)))
+                                : std::string());
+    }
+
+    bool is_defined_change_(const omega_edit::ChangeRequest &change) {
+        switch (change.kind()) {
+            case omega_edit::CHANGE_DELETE:
+                return true;
+            case omega_edit::CHANGE_INSERT:
+            case omega_edit::CHANGE_OVERWRITE:
+                return change.has_data();
+            default:
+                return false;
+        }
+    }
+
+    /**
+     * Apply a single change, returning its serial, or a non-positive value if it could not be applied
+     */
+    int64_t apply_change_(omega_session_t *session_ptr, const omega_edit::ChangeRequest &change) {
+        const auto *bytes = reinterpret_cast<const omega_byte_t *>(change.data().data());
+        const auto length = static_cast<int64_t>(change.data().size());
+        switch (change.kind()) {
+            case omega_edit::CHANGE_DELETE:
+                return omega_edit_delete(session_ptr, change.offset(), change.length());
+            case omega_edit::CHANGE_INSERT:
+                return omega_edit_insert_bytes(session_ptr, change.offset(), bytes, length);
+            case omega_edit::CHANGE_OVERWRITE:
+                return omega_edit_overwrite_bytes(session_ptr, change.offset(), bytes, length);
+            default:
+                return 0;
+        }
+    }
+
+    /**
+     * Apply a batch of changes as one change transaction.  Per-change edit events and viewport events are held back
+     * while the batch is applied, then a single edit event is emitted for the batch and changed viewports are notified
+     * once.  If any change fails, the changes already applied from the batch are rolled back, and cannot be redone.
+     * A batch is rejected while the client has a transaction of its own open, because rolling back the batch would
+     * undo the whole client transaction.
+     */
+    grpc::Status apply_batch_(omega_session_t *session_ptr, const std::vector<omega_edit::ChangeRequest> &changes,
+                              omega_edit::ChangesResponse &response) {
+        if (0 != omega_session_get_transaction_state(session_ptr)) {
+            return {grpc::StatusCode::FAILED_PRECONDITION, "a batch cannot be submitted inside a change transaction"};
+        }
+        const auto interest = omega_session_get_event_interest(session_ptr);
+        const auto viewport_events_paused = omega_session_viewport_event_callbacks_paused(session_ptr);
+        omega_session_set_event_interest(session_ptr, interest & ~(SESSION_EVT_EDIT | SESSION_EVT_UNDO));
+        if (!viewport_events_paused) { omega_session_pause_viewport_event_callbacks(session_ptr); }
+        omega_session_begin_transaction(session_ptr);
+        int64_t first_serial = 0;
+        int64_t last_serial = 0;
+        int64_t applied = 0;
+        auto failed_at = changes.size();
+        for (size_t i = 0; i < changes.size(); ++i) {
+            const auto serial = apply_change_(session_ptr, changes[i]);
+            if (serial <= 0) {
+                failed_at = i;
+                break;
+            }
+            if (0 == applied++) { first_serial = serial; }
+            last_serial = serial;
+        }
+        omega_session_end_transaction(session_ptr);
+        const auto failed = failed_at < changes.size();
+        if (failed && 0 < applied) {
+            omega_edit_undo_last_change(session_ptr);
+            omega_edit_discard_undone_changes(session_ptr);
+        }
+        omega_session_set_event_interest(session_ptr, interest);
+        if (!viewport_events_paused) {
+            omega_session_resume_viewport_event_callbacks(session_ptr);
+            omega_session_notify_changed_viewports(session_ptr);
+        }
+        if (failed) {
+            return {grpc::StatusCode::INVALID_ARGUMENT,
+                    "change " + std::to_string(failed_at) + " of the batch could not be applied"};
+        }
+        if (0 < applied) {
+            omega_session_notify(session_ptr, SESSION_EVT_EDIT, omega_session_get_last_change(session_ptr));
+        }
+        if (0 == response.batch_count()) { response.set_first_serial(first_serial); }
+        if (0 < applied) { response.set_last_serial(last_serial); }
+        response.set_change_count(response.change_count() + applied);
+        response.set_batch_count(response.batch_count() + 1);
+        return grpc::Status::OK;
+    }
+
+    /**
+     * Split a fully qualified viewport id (session:viewport) into its session id and the id within the session
+     */
+    bool split_viewport_id_(const std::string &viewport_id, std::string &session_id, std::string &local_id) {
+        const auto colon = viewport_id.find(':');
+        if (colon == std::string::npos || viewport_id.find(':', colon + 1) != std::string::npos) { return false; }
+        session_id = viewport_id.substr(0, colon);
+        local_id = viewport_id.substr(colon + 1);
+        return true;
+    }
+
+    /**
+     * Close the queues of the subscribers of the given session and its viewports
+     */
+    void close_subscriptions_(server_session_t &session) {
+        std::lock_guard<std::mutex> lock(session.subscriptions_mutex);
+        if (session.events) { session.events->close(); }
+        for (const auto &entry: session.viewports) {
+            if (entry.second->events) { entry.second->events->close(); }
+        }
+    }
+
+    /**
+     * Stream the events of the given queue to the subscriber until it goes away or the queue is closed
+     */
+    template<typename T>
+    grpc::Status stream_events_(grpc::ServerContext &context, event_queue_t<T> &events,
+                                grpc::ServerWriter<T> &writer) {
+        T event;
+        while (!context.IsCancelled()) {
+            if (events.pop(event, subscription_poll_interval)) {
+                if (!writer.Write(event)) { break; }
+            } else if (events.is_closed()) {
+                break;
+            }
+        }
+        // release an editing thread held back by this subscriber
+        events.close();
+        return grpc::Status::OK;
+    }
+
+    int64_t get_count_(const omega_session_t *session_ptr, omega_edit::CountKind kind) {
+        switch (kind) {
+            case omega_edit::COUNT_COMPUTED_FILE_SIZE:
+                return omega_session_get_computed_file_size(session_ptr);
+            case omega_edit::COUNT_CHANGES:
+                return omega_session_get_num_changes(session_ptr);
+            case omega_edit::COUNT_UNDOS:
+                return omega_session_get_num_undone_changes(session_ptr);
+            case omega_edit::COUNT_VIEWPORTS:
+                return omega_session_get_num_viewports(session_ptr);
+            case omega_edit::COUNT_CHECKPOINTS:
+                return omega_session_get_num_checkpoints(session_ptr);
+            case omega_edit::COUNT_SEARCH_CONTEXTS:
+                return omega_session_get_num_search_contexts(session_ptr);
+            case omega_edit::COUNT_CHANGE_TRANSACTIONS:
+                return omega_session_get_num_change_transactions(session_ptr);
+            case omega_edit::COUNT_UNDO_TRANSACTIONS:
+                return omega_session_get_num_undone_change_transactions(session_ptr);
+            default:
+                return -1;
+        }
+    }
+
+    /**
+     * Read the memory of the process (committed and used, in bytes) and the physical memory of the host (max)
+     */
+    void fill_memory_(omega_edit::HeartbeatResponse &response) {
+#ifndef _WIN32
+        const auto page_size = static_cast<int64_t>(sysconf(_SC_PAGESIZE));
+        response.set_max_memory(static_cast<int64_t>(sysconf(_SC_PHYS_PAGES)) * page_size);
+        int64_t size = 0;
+        int64_t resident = 0;
+        if (std::ifstream statm("/proc/self/statm"); statm >> size >> resident) {
+            response.set_committed_memory(size * page_size);
+            response.set_used_memory(resident * page_size);
+        }
+#else
+        (void) response;
+#endif
+    }
+}// namespace
+
+editor_service_t::editor_service_t() : started_(std::chrono::steady_clock::now()) {}
+
+editor_service_t::~editor_service_t() { destroy_sessions_(); }
+
+bool editor_service_t::wait_for_shutdown(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(shutdown_mutex_);
+    return shutdown_cv_.wait_for(lock, timeout, [this] { return shutdown_; });
+}
+
+void editor_service_t::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(shutdown_mutex_);
+        shutdown_ = true;
+    }
+    shutdown_cv_.notify_all();
+}
+
+std::shared_ptr<server_session_t> editor_service_t::find_session_(const std::string &session_id) const {
+    std::shared_lock<std::shared_mutex> lock(sessions_mutex_);
+    const auto found = sessions_.find(session_id);
+    return found == sessions_.end() ? nullptr : found->second;
+}
+
+grpc::Status editor_service_t::with_session_(const std::string &session_id, const session_op_t &op) {
+    const auto session = find_session_(session_id);
+    if (!session) { return session_not_found_(); }
+    std::lock_guard<std::mutex> lock(session->mutex);
+    // the session may have been destroyed, or have failed to be created, while waiting for it
+    if (!session->session_ptr) { return session_not_found_(); }
+    return op(*session);
+}
+
+grpc::Status editor_service_t::with_viewport_(const std::string &viewport_id, const viewport_op_t &op) {
+    std::string session_id;
+    std::string local_id;
+    if (!split_viewport_id_(viewport_id, session_id, local_id)) {
+        return {grpc::StatusCode::INVALID_ARGUMENT, "malformed viewport id '" + viewport_id + "'"};
+    }
+    const auto status = with_session_(session_id, [&](server_session_t &session) {
+        const auto found = session.viewports.find(local_id);
+        if (found == session.viewports.end()) { return grpc::Status(grpc::StatusCode::NOT_FOUND, ""); }
+        return op(session, *found->second);
+    });
+    return status.error_code() == grpc::StatusCode::NOT_FOUND
+                   ? grpc::Status(grpc::StatusCode::NOT_FOUND, "viewport not found")
+                   : status;
+}
+
+void editor_service_t::close_session_subscription_(const std::string &session_id) {
+    const auto session = find_session_(session_id);
+    if (!session) { return; }
+    std::lock_guard<std::mutex> lock(session->subscriptions_mutex);
+    if (session->events) { session->events->close(); }
+}
+
+void editor_service_t::close_viewport_subscription_(const std::string &viewport_id) {
+    std::string session_id;
+    std::string local_id;
+    if (!split_viewport_id_(viewport_id, session_id, local_id)) { return; }
+    const auto session = find_session_(session_id);
+    if (!session) { return; }
+    std::lock_guard<std::mutex> lock(session->subscriptions_mutex);
+    const auto found = session->viewports.find(local_id);
+    if (found != session->viewports.end() && found->second->events) { found->second->events->close(); }
+}
+
+grpc::Status editor_service_t::snapshot_(const std::string &session_id, snapshot_ptr_t &snapshot) {
+    return with_session_(session_id, [&](server_session_t &session) {
+        snapshot = snapshot_ptr_t(omega_session_snapshot(session.session_ptr), omega_snapshot_destroy);
+        return snapshot ? grpc::Status::OK : grpc::Status(grpc::StatusCode::INTERNAL, "failed to snapshot session");
+    });
+}
+
+bool editor_service_t::destroy_session_(const std::string &session_id) {
+    std::shared_ptr<server_session_t> session;
+    {
+        std::unique_lock<std::shared_mutex> lock(sessions_mutex_);
+        const auto found = sessions_.find(session_id);
+        if (found == sessions_.end()) { return false; }
+        session = found->second;
+        sessions_.erase(found);
+    }
+    // close the queues before waiting for the session, which an editing thread held back by a subscriber may hold
+    close_subscriptions_(*session);
+    std::lock_guard<std::mutex> lock(session->mutex);
+    if (session->session_ptr) {
+        // and again, for subscriptions made while waiting, so no callback is held back while the session is destroyed
+        close_subscriptions_(*session);
+        omega_edit_destroy_session(session->session_ptr);
+        session->session_ptr = nullptr;
+        std::lock_guard<std::mutex> subscriptions_lock(session->subscriptions_mutex);
+        session->viewports.clear();
+    }
+    return true;
+}
+
+void editor_service_t::destroy_sessions_() {
+    std::vector<std::string> session_ids;
+    {
+        std::shared_lock<std::shared_mutex> lock(sessions_mutex_);
+        for (const auto &entry: sessions_) { session_ids.push_back(entry.first); }
+    }
+    for (const auto &session_id: session_ids) { destroy_session_(session_id); }
+}
+
+size_t editor_service_t::session_count_() const {
+    std::shared_lock<std::shared_mutex> lock(sessions_mutex_);
+    return sessions_.size();
+}
+
+bool editor_service_t::check_graceful_shutdown_() {
+    if (graceful_shutdown_ && 0 == session_count_()) {
+        shutdown();
+        return true;
+    }
+    return false;
+}
+
+grpc::Status editor_service_t::GetServerInfo(grpc::ServerContext *, const google::protobuf::Empty *,
+                                             omega_edit::ServerInfoResponse *response) {
+    response->set_hostname(get_hostname_());
+    response->set_process_id(get_pid_());
+    response->set_server_version(get_version_());
+    response->set_available_processors(get_cpu_count_());
+    return grpc::Status::OK;
+}
+
+grpc::Status editor_service_t::CreateSession(grpc::ServerContext *, const omega_edit::CreateSessionRequest *request,
+                                             omega_edit::CreateSessionResponse *response) {
+    // if the server is to shut down gracefully, don't create new sessions
+    if (graceful_shutdown_) { return grpc::Status::OK; }
+    const auto session_id = request->has_session_id_desired() ? request->session_id_desired()
+                            : request->has_file_path()        ? base64url_(request->file_path())
+                                                              : uuid_();
+    const auto session = std::make_shared<server_session_t>(session_id);
+    // hold the new session while it is created, so requests for it wait until it is ready
+    std::lock_guard<std::mutex> session_lock(session->mutex);
+    {
+        std::unique_lock<std::shared_mutex> lock(sessions_mutex_);
+        if (!sessions_.emplace(session_id, session).second) { return {grpc::StatusCode::ALREADY_EXISTS, ""}; }
+    }
+    session->session_ptr = omega_edit_create_session(
+            request->has_file_path() ? request->file_path().c_str() : nullptr, session_event_cbk_, session.get(),
+            NO_EVENTS, request->has_checkpoint_directory() ? request->checkpoint_directory().c_str() : nullptr);
+    if (!session->session_ptr) {
+        std::unique_lock<std::shared_mutex> lock(sessions_mutex_);
+        const auto found = sessions_.find(session_id);
+        if (found != sessions_.end() && found->second == session) { sessions_.erase(found); }
+        return {grpc::StatusCode::INTERNAL, "Failed to create session"};
+    }
+    response->set_session_id(session_id);
+    response->set_checkpoint_directory(omega_session_get_checkpoint_directory(session->session_ptr));
+    // if a file path is provided, add the file size to the response
+    if (request->has_file_path()) {
+        response->set_file_size(omega_session_get_computed_file_size(session->session_ptr));
+    }
+    return grpc::Status::OK;
+}
+
+grpc::Status editor_service_t::SaveSession(grpc::ServerContext *, const omega_edit::SaveSessionRequest *request,
+                                           omega_edit::SaveSessionResponse *response) {
+    return with_session_(request->session_id(), [&](server_session_t &session) {
+        std::vector<char> saved_file_path(FILENAME_MAX + 1);
+        const auto save_status =
+                omega_edit_save_segment(session.session_ptr, request->file_path().c_str(), request->io_flags(),
+                                        saved_file_path.data(), request->offset(), request->length());
+        if (0 != save_status && ORIGINAL_MODIFIED != save_status) {
+            return grpc::Status(grpc::StatusCode::UNKNOWN,
+                                "Failed to save session to file: " + std::to_string(save_status));
+        }
+        response->set_session_id(session.id);
+        response->set_file_path(saved_file_path.data());
+        response->set_save_status(save_status);
+        return grpc::Status::OK;
+    });
+}
+
+grpc::Status editor_service_t::DestroySession(grpc::ServerContext *, const omega_edit::ObjectId *request,
+                                              omega_edit::ObjectId *response) {
+    if (!destroy_session_(request->id())) { return session_not_found_(); }
+    // if the server is to shut down gracefully, stop it once the last session is destroyed
+    check_graceful_shutdown_();
+    *response = *request;
+    return grpc::Status::OK;
+}
+
+grpc::Status editor_service_t::SubmitChange(grpc::ServerContext *, const omega_edit::ChangeRequest *request,
+                                            omega_edit::ChangeResponse *response) {
+    if (!is_defined_change_(*request)) { return undefined_change_kind_(); }
+    return with_session_(request->session_id(), [&](server_session_t &session) {
+        response->set_session_id(session.id);
+        response->set_serial(apply_change_(session.session_ptr, *request));
+        return grpc::Status::OK;
+    });
+}
+
+grpc::Status editor_service_t::SubmitChanges(grpc::ServerContext *,
+                                             grpc::ServerReader<omega_edit::ChangeRequest> *reader,
+                                             omega_edit::ChangesResponse *response) {
+    // changes are applied in batches as they are read, so a large import holds the session once per batch
+    std::vector<omega_edit::ChangeRequest> batch;
+    batch.reserve(change_batch_size);
+    const auto submit_batch = [&] {
+        return with_session_(response->session_id(), [&](server_session_t &session) {
+            return apply_batch_(session.session_ptr, batch, *response);
+        });
+    };
+    for (omega_edit::ChangeRequest change; reader->Read(&change);) {
+        if (!is_defined_change_(change)) { return undefined_change_kind_(); }
+        if (response->session_id().empty()) { response->set_session_id(change.session_id()); }
+        if (change.session_id() != response->session_id()) {
+            return {grpc::StatusCode::INVALID_ARGUMENT, "all changes must be submitted to the same session"};
+        }
+        batch.push_back(std::move(change));
+        if (batch.size() == change_batch_size) {
+            if (const auto status = submit_batch(); !status.ok()) { return status; }
+            batch.clear();
+        }
+    }
+    if (!batch.empty()) {
+        if (const auto status = submit_batch(); !status.ok()) { return status; }
+    }
+    if (0 == response->batch_count()) { return {grpc::StatusCode::INVALID_ARGUMENT, "no changes submitted"}; }
+    return grpc::Status::OK;
+}
+
+grpc::Status editor_service_t::UndoLastChange(grpc::ServerContext *, const omega_edit::ObjectId *request,
+                                              omega_edit::ChangeResponse *response) {
+    return with_session_(request->id(), [&](server_session_t &session) {
+        response->set_session_id(session.id);
+        response->set_serial(omega_edit_undo_last_change(session.session_ptr));
+        return grpc::Status::OK;
+    });
+}
+
+grpc::Status editor_service_t::RedoLastUndo(grpc::ServerContext *, const omega_edit::ObjectId *request,
+                                            omega_edit::ChangeResponse *response) {
+    return with_session_(request->id(), [&](server_session_t &session) {
+        response->set_session_id(session.id);
+        response->set_serial(omega_edit_redo_last_undo(session.session_ptr));
+        return grpc::Status::OK;
+    });
+}
+
+grpc::Status editor_service_t::ClearChanges(grpc::ServerContext *, const omega_edit::ObjectId *request,
+                                            omega_edit::ObjectId *response) {
+    return with_session_(request->id(), [&](server_session_t &session) {
+        omega_edit_clear_changes(session.session_ptr);
+        response->set_id(session.id);
+        return grpc::Status::OK;
+    });
+}
+
+grpc::Status editor_service_t::PauseSessionChanges(grpc::ServerContext *, const omega_edit::ObjectId *request,
+                                                   omega_edit::ObjectId *response) {
+    return with_session_(request->id(), [&](server_session_t &session) {
+        omega_session_pause_changes(session.session_ptr);
+        response->set_id(session.id);
+        return grpc::Status::OK;
+    });
+}
+
+grpc::Status editor_service_t::ResumeSessionChanges(grpc::ServerContext *, const omega_edit::ObjectId *request,
+                                                    omega_edit::ObjectId *response) {
+    return with_session_(request->id(), [&](server_session_t &session) {
+        omega_session_resume_changes(session.session_ptr);
+        response->set_id(session.id);
+        return grpc::Status::OK;
+    });
+}
+
+grpc::Status editor_service_t::PauseViewportEvents(grpc::ServerContext *, const omega_edit::ObjectId *request,
+                                                   omega_edit::ObjectId *response) {
+    return with_session_(request->id(), [&](server_session_t &session) {
+        omega_session_pause_viewport_event_callbacks(session.session_ptr);
+        response->set_id(session.id);
+        return grpc::Status::OK;
+    });
+}
+
+grpc::Status editor_service_t::ResumeViewportEvents(grpc::ServerContext *, const omega_edit::ObjectId *request,
+                                                    omega_edit::ObjectId *response) {
+    return with_session_(request->id(), [&](server_session_t &session) {
+        omega_session_resume_viewport_event_callbacks(session.session_ptr);
+        response->set_id(session.id);
+        return grpc::Status::OK;
+    });
+}
+
+grpc::Status editor_service_t::SessionBeginTransaction(grpc::ServerContext *, const omega_edit::ObjectId *request,
+                                                       omega_edit::ObjectId *response) {
+    return with_session_(request->id(), [&](server_session_t &session) {
+        omega_session_begin_transaction(session.session_ptr);
+        response->set_id(session.id);
+        return grpc::Status::OK;
+    });
+}
+
+grpc::Status editor_service_t::SessionEndTransaction(grpc::ServerContext *, const omega_edit::ObjectId *request,
+                                                     omega_edit::ObjectId *response) {
+    return with_session_(request->id(), [&](server_session_t &session) {
+        omega_session_end_transaction(session.session_ptr);
+        response->set_id(session.id);
+        return grpc::Status::OK;
+    });
+}
+
+grpc::Status editor_service_t::NotifyChangedViewports(grpc::ServerContext *, const omega_edit::ObjectId *request,
+                                                      omega_edit::IntResponse *response) {
+    return with_session_(request->id(), [&](server_session_t &session) {
+        response->set_response(omega_session_notify_changed_viewports(session.session_ptr));
+        return grpc::Status::OK;
+    });
+}
+
+grpc::Status editor_service_t::CreateViewport(grpc::ServerContext *, const omega_edit::CreateViewportRequest *request,
+                                              omega_edit::ViewportDataResponse *response) {
+    return with_session_(request->session_id(), [&](server_session_t &session) {
+        const auto viewport_id = request->has_viewport_id_desired() ? request->viewport_id_desired() : uuid_();
+        if (session.viewports.count(viewport_id)) { return grpc::Status(grpc::StatusCode::ALREADY_EXISTS, ""); }
+        auto viewport = std::make_unique<server_viewport_t>();
+        viewport->session_id = session.id;
+        viewport->viewport_id = session.id + ":" + viewport_id;
+        if (request->shared_memory()) {
+            // without a region, the data is sent in responses and events as usual
+            std::string error;
+            viewport->shared = shared_viewport_t::create(OMEGA_VIEWPORT_CAPACITY_LIMIT, error);
+        }
+        viewport->viewport_ptr =
+                omega_edit_create_viewport(session.session_ptr, request->offset(), request->capacity(),
+                                           request->is_floating() ? 1 : 0, viewport_event_cbk_, viewport.get(),
+                                           viewport->shared ? ALL_EVENTS : NO_EVENTS);
+        if (!viewport->viewport_ptr) {
+            return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "Failed to create viewport");
+        }
+        fill_viewport_data_(*viewport, *response);
+        std::lock_guard<std::mutex> lock(session.subscriptions_mutex);
+        session.viewports.emplace(viewport_id, std::move(viewport));
+        return grpc::Status::OK;
+    });
+}
+
+grpc::Status editor_service_t::ModifyViewport(grpc::ServerContext *, const omega_edit::ModifyViewportRequest *request,
+                                              omega_edit::ViewportDataResponse *response) {
+    return with_viewport_(request->viewport_id(), [&](server_session_t &, server_viewport_t &viewport) {
+        if (0 != omega_viewport_modify(viewport.viewport_ptr, request->offset(), request->capacity(),
+                                       request->is_floating() ? 1 : 0)) {
+            return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "Failed to modify viewport");
+        }
+        fill_viewport_data_(viewport, *response);
+        return grpc::Status::OK;
+    });
+}
+
+grpc::Status editor_service_t::ViewportHasChanges(grpc::ServerContext *, const omega_edit::ObjectId *request,
+                                                  omega_edit::BooleanResponse *response) {
+    return with_viewport_(request->id(), [&](server_session_t &, server_viewport_t &viewport) {
+        response->set_response(0 != omega_viewport_has_changes(viewport.viewport_ptr));
+        return grpc::Status::OK;
+    });
+}
+
+grpc::Status editor_service_t::GetViewportData(grpc::ServerContext *, const omega_edit::ViewportDataRequest *request,
+                                               omega_edit::ViewportDataResponse *response) {
+    return with_viewport_(request->viewport_id(), [&](server_session_t &, server_viewport_t &viewport) {
+        fill_viewport_data_(viewport, *response);
+        return grpc::Status::OK;
+    });
+}
+
+grpc::Status editor_service_t::DestroyViewport(grpc::ServerContext *, const omega_edit::ObjectId *request,
+                                               omega_edit::ObjectId *response) {
+    close_viewport_subscription_(request->id());
+    return with_viewport_(request->id(), [&](server_session_t &session, server_viewport_t &viewport) {
+        {
+            std::lock_guard<std::mutex> lock(session.subscriptions_mutex);
+            if (viewport.events) { viewport.events->close(); }
+        }
+        omega_edit_destroy_viewport(viewport.viewport_ptr);
+        std::lock_guard<std::mutex> lock(session.subscriptions_mutex);
+        session.viewports.erase(viewport.viewport_id.substr(session.id.size() + 1));
+        *response = *request;
+        return grpc::Status::OK;
+    });
+}
+
+grpc::Status editor_service_t::GetChangeDetails(grpc::ServerContext *, const omega_edit::SessionEvent *request,
+                                                omega_edit::ChangeDetailsResponse *response) {
+    if (!request->has_serial()) { return {grpc::StatusCode::INVALID_ARGUMENT, "change serial id required"}; }
+    return with_session_(request->session_id(), [&](server_session_t &session) {
+        const auto *change_ptr = omega_session_get_change(session.session_ptr, request->serial());
+        if (!change_ptr) { return grpc::Status(grpc::StatusCode::NOT_FOUND, "change not found"); }
+        fill_change_details_(session.id, change_ptr, *response);
+        return grpc::Status::OK;
+    });
+}
+
+grpc::Status editor_service_t::GetLastChange(grpc::ServerContext *, const omega_edit::ObjectId *request,
+                                             omega_edit::ChangeDetailsResponse *response) {
+    return with_session_(request->id(), [&](server_session_t &session) {
+        const auto *change_ptr = omega_session_get_last_change(session.session_ptr);
+        if (!change_ptr) { return grpc::Status(grpc::StatusCode::NOT_FOUND, "no last change"); }
+        fill_change_details_(session.id, change_ptr, *response);
+        return grpc::Status::OK;
+    });
+}
+
+grpc::Status editor_service_t::GetLastUndo(grpc::ServerContext *, const omega_edit::ObjectId *request,
+                                           omega_edit::ChangeDetailsResponse *response) {
+    return with_session_(request->id(), [&](server_session_t &session) {
+        const auto *change_ptr = omega_session_get_last_undo(session.session_ptr);
+        if (!change_ptr) { return grpc::Status(grpc::StatusCode::NOT_FOUND, "no last undo"); }
+        fill_change_details_(session.id, change_ptr, *response);
+        return grpc::Status::OK;
+    });
+}
+
+grpc::Status editor_service_t::GetComputedFileSize(grpc::ServerContext *, const omega_edit::ObjectId *request,
+                                                   omega_edit::ComputedFileSizeResponse *response) {
+    return with_session_(request->id(), [&](server_session_t &session) {
+        response->set_session_id(session.id);
+        response->set_computed_file_size(omega_session_get_computed_file_size(session.session_ptr));
+        return grpc::Status::OK;
+    });
+}
+
+grpc::Status editor_service_t::GetByteOrderMark(grpc::ServerContext *, const omega_edit::SegmentRequest *request,
+                                                omega_edit::ByteOrderMarkResponse *response) {
+    return with_session_(request->session_id(), [&](server_session_t &session) {
+        const auto bom = omega_session_detect_BOM(session.session_ptr, request->offset());
+        response->set_session_id(session.id);
+        response->set_offset(request->offset());
+        response->set_length(static_cast<int64_t>(omega_util_BOM_size(bom)));
+        response->set_byte_order_mark(omega_util_BOM_to_cstring(bom));
+        return grpc::Status::OK;
+    });
+}
+
+grpc::Status editor_service_t::GetContentType(grpc::ServerContext *, const omega_edit::SegmentRequest *,
+                                              omega_edit::ContentTypeResponse *) {
+    // the JVM server detects content types with Apache Tika, which has no native counterpart
+    return {grpc::StatusCode::UNIMPLEMENTED, "content type detection is not supported by the native server"};
+}
+
+grpc::Status editor_service_t::GetLanguage(grpc::ServerContext *, const omega_edit::TextRequest *,
+                                           omega_edit::LanguageResponse *) {
+    // the JVM server detects languages with the Tika Optimaize detector, which has no native counterpart
+    return {grpc::StatusCode::UNIMPLEMENTED, "language detection is not supported by the native server"};
+}
+
+grpc::Status editor_service_t::GetCount(grpc::ServerContext *, const omega_edit::CountRequest *request,
+                                        omega_edit::CountResponse *response) {
+    return with_session_(request->session_id(), [&](server_session_t &session) {
+        response->set_session_id(session.id);
+        for (const auto kind: request->kind()) {
+            const auto count = get_count_(session.session_ptr, static_cast<omega_edit::CountKind>(kind));
+            if (count < 0) {
+                return grpc::Status(grpc::StatusCode::UNKNOWN, "undefined kind: " + std::to_string(kind));
+            }
+            auto *single_count = response->add_counts();
+            single_count->set_kind(static_cast<omega_edit::CountKind>(kind));
+            single_count->set_count(count);
+        }
+        return grpc::Status::OK;
+    });
+}
+
+grpc::Status editor_service_t::GetSessionCount(grpc::ServerContext *, const google::protobuf::Empty *,
+                                               omega_edit::SessionCountResponse *response) {
+    response->set_count(static_cast<int64_t>(session_count_()));
+    return grpc::Status::OK;
+}
+
+grpc::Status editor_service_t::GetSegment(grpc::ServerContext *, const omega_edit::SegmentRequest *request,
+                                          omega_edit::SegmentResponse *response) {
+    snapshot_ptr_t snapshot;
+    if (const auto status = snapshot_(request->session_id(), snapshot); !status.ok()) { return status; }
+    const omega_scoped_ptr<omega_segment_t> segment(omega_segment_create(request->length()), omega_segment_destroy);
+    if (!segment || 0 != omega_snapshot_get_segment(snapshot.get(), segment.get(), request->offset())) {
+        return {grpc::StatusCode::NOT_FOUND, "couldn't find segment"};
+    }
+    response->set_session_id(request->session_id());
+    response->set_offset(omega_segment_get_offset(segment.get()));
+    response->set_data(reinterpret_cast<const char *>(omega_segment_get_data(segment.get())),
+                       static_cast<size_t>(omega_segment_get_length(segment.get())));
+    return grpc::Status::OK;
+}
+
+grpc::Status editor_service_t::StreamSegment(grpc::ServerContext *context,
+                                             const omega_edit::StreamSegmentRequest *request,
+                                             grpc::ServerWriter<omega_edit::SegmentResponse> *writer) {
+    const auto chunk_size = request->has_chunk_size() ? request->chunk_size() : default_stream_chunk_size;
+    if (chunk_size <= 0 || max_stream_chunk_size < chunk_size) {
+        return {grpc::StatusCode::INVALID_ARGUMENT, "chunk size out of range: " + std::to_string(chunk_size)};
+    }
+    // read from a snapshot taken when the request arrives, so later edits neither block nor tear the stream
+    snapshot_ptr_t snapshot;
+    if (const auto status = snapshot_(request->session_id(), snapshot); !status.ok()) { return status; }
+    const auto size = omega_snapshot_get_computed_file_size(snapshot.get());
+    const auto end = 0 == request->length() ? size : request->offset() + request->length();
+    if (request->offset() < 0 || request->length() < 0 || size < end) {
+        return {grpc::StatusCode::OUT_OF_RANGE, "range out of bounds"};
+    }
+    const omega_scoped_ptr<omega_segment_t> segment(omega_segment_create(chunk_size), omega_segment_destroy);
+    omega_edit::SegmentResponse chunk;
+    chunk.set_session_id(request->session_id());
+    for (auto offset = request->offset(); offset < end && !context->IsCancelled(); offset += chunk_size) {
+        if (0 != omega_snapshot_get_segment(snapshot.get(), segment.get(), offset)) {
+            return {grpc::StatusCode::INTERNAL, "failed to read segment at offset " + std::to_string(offset)};
+        }
+        chunk.set_offset(offset);
+        chunk.set_data(reinterpret_cast<const char *>(omega_segment_get_data(segment.get())),
+                       static_cast<size_t>(std::min(omega_segment_get_length(segment.get()), end - offset)));
+        if (!writer->Write(chunk)) { break; }
+    }
+    return grpc::Status::OK;
+}
+
+grpc::Status editor_service_t::SearchSession(grpc::ServerContext *, const omega_edit::SearchRequest *request,
+                                             omega_edit::SearchResponse *response) {
+    const auto *pattern = reinterpret_cast<const omega_byte_t *>(request->pattern().data());
+    const auto pattern_length = static_cast<int64_t>(request->pattern().size());
+    const auto offset = request->offset();
+    const auto length = request->length();
+    const auto is_limited = [&] {
+        return request->has_limit() && request->limit() <= response->match_offset_size();
+    };
+    response->set_session_id(request->session_id());
+    response->set_pattern(request->pattern());
+    response->set_is_case_insensitive(request->is_case_insensitive());
+    response->set_is_reverse(request->is_reverse());
+    response->set_offset(offset);
+    response->set_length(length);
+    // snapshots only search forward for exact matches, so other searches stay on the session
+    if (request->is_case_insensitive() || request->is_reverse()) {
+        return with_session_(request->session_id(), [&](server_session_t &session) {
+            const omega_scoped_ptr<omega_search_context_t> search_context(
+                    omega_search_create_context_bytes(session.session_ptr, pattern, pattern_length, offset, length,
+                                                      request->is_case_insensitive() ? 1 : 0,
+                                                      request->is_reverse() ? 1 : 0),
+                    omega_search_destroy_context);
+            while (search_context && !is_limited() && 0 < omega_search_next_match(search_context.get(), 1)) {
+                response->add_match_offset(omega_search_context_get_match_offset(search_context.get()));
+            }
+            return grpc::Status::OK;
+        });
+    }
+    snapshot_ptr_t snapshot;
+    if (const auto status = snapshot_(request->session_id(), snapshot); !status.ok()) { return status; }
+    // one search context finds every match, so the snapshot range is read once rather than once per match
+    const omega_scoped_ptr<omega_snapshot_search_context_t> search_context(
+            omega_snapshot_search_create_context(snapshot.get(), pattern, pattern_length, offset, length),
+            omega_snapshot_search_destroy_context);
+    while (search_context && !is_limited()) {
+        const auto found = omega_snapshot_search_next_match(search_context.get());
+        if (found < 0) { break; }
+        response->add_match_offset(found);
+    }
+    return grpc::Status::OK;
+}
+
+grpc::Status editor_service_t::GetByteFrequencyProfile(grpc::ServerContext *,
+                                                       const omega_edit::SegmentRequest *request,
+                                                       omega_edit::ByteFrequencyProfileResponse *response) {
+    snapshot_ptr_t snapshot;
+    if (const auto status = snapshot_(request->session_id(), snapshot); !status.ok()) { return status; }
+    omega_byte_frequency_profile_t profile;
+    if (const auto rc = omega_snapshot_byte_frequency_profile(snapshot.get(), &profile, request->offset(),
+                                                              request->length())) {
+        return {grpc::StatusCode::UNKNOWN, "Profile function failed with error code: " + std::to_string(rc)};
+    }
+    response->set_session_id(request->session_id());
+    response->set_offset(request->offset());
+    response->set_length(request->length());
+    response->mutable_frequency()->Add(std::begin(profile), std::end(profile));
+    return grpc::Status::OK;
+}
+
+grpc::Status editor_service_t::GetCharacterCounts(grpc::ServerContext *, const omega_edit::TextRequest *request,
+                                                  omega_edit::CharacterCountResponse *response) {
+    snapshot_ptr_t snapshot;
+    if (const auto status = snapshot_(request->session_id(), snapshot); !status.ok()) { return status; }
+    const omega_scoped_ptr<omega_character_counts_t> counts(omega_character_counts_create(),
+                                                            omega_character_counts_destroy);
+    const auto bom = omega_util_cstring_to_BOM(request->byte_order_mark().c_str());
+    if (const auto rc = omega_snapshot_character_counts(snapshot.get(), counts.get(), request->offset(),
+                                                        request->length(), bom)) {
+        return {grpc::StatusCode::UNKNOWN, "CharCount function failed with error code: " + std::to_string(rc)};
+    }
+    response->set_session_id(request->session_id());
+    response->set_offset(request->offset());
+    response->set_length(request->length());
+    response->set_byte_order_mark(omega_util_BOM_to_cstring(omega_character_counts_get_BOM(counts.get())));
+    response->set_byte_order_mark_bytes(omega_character_counts_bom_bytes(counts.get()));
+    response->set_single_byte_chars(omega_character_counts_single_byte_chars(counts.get()));
+    response->set_double_byte_chars(omega_character_counts_double_byte_chars(counts.get()));
+    response->set_triple_byte_chars(omega_character_counts_triple_byte_chars(counts.get()));
+    response->set_quad_byte_chars(omega_character_counts_quad_byte_chars(counts.get()));
+    response->set_invalid_bytes(omega_character_counts_invalid_bytes(counts.get()));
+    return grpc::Status::OK;
+}
+
+grpc::Status editor_service_t::ServerControl(grpc::ServerContext *, const omega_edit::ServerControlRequest *request,
+                                             omega_edit::ServerControlResponse *response) {
+    response->set_kind(request->kind());
+    response->set_pid(get_pid_());
+    switch (request->kind()) {
+        case omega_edit::SERVER_CONTROL_GRACEFUL_SHUTDOWN:
+            graceful_shutdown_ = true;
+            response->set_response_code(check_graceful_shutdown_() ? 0 : 1);
+            return grpc::Status::OK;
+        case omega_edit::SERVER_CONTROL_IMMEDIATE_SHUTDOWN:
+            destroy_sessions_();
+            shutdown();
+            response->set_response_code(0);
+            return grpc::Status::OK;
+        default:
+            return {grpc::StatusCode::UNKNOWN, "undefined kind: " + std::to_string(request->kind())};
+    }
+}
+
+grpc::Status editor_service_t::GetHeartbeat(grpc::ServerContext *, const omega_edit::HeartbeatRequest *,
+                                            omega_edit::HeartbeatResponse *response) {
+    using std::chrono::duration_cast;
+    using std::chrono::milliseconds;
+    response->set_session_count(static_cast<int32_t>(session_count_()));
+    response->set_timestamp(duration_cast<milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+    response->set_uptime(duration_cast<milliseconds>(std::chrono::steady_clock::now() - started_).count());
+    response->set_cpu_count(get_cpu_count_());
+#ifndef _WIN32
+    double load_average = -1.0;
+    response->set_cpu_load_average(1 == getloadavg(&load_average, 1) ? load_average : -1.0);
+#else
+    response->set_cpu_load_average(-1.0);
+#endif
+    fill_memory_(*response);
+    return grpc::Status::OK;
+}
+
+grpc::Status editor_service_t::SubscribeToSessionEvents(grpc::ServerContext *context,
+                                                        const omega_edit::EventSubscriptionRequest *request,
+                                                        grpc::ServerWriter<omega_edit::SessionEvent> *writer) {
+    std::string error;
+    const auto events = event_queue_t<omega_edit::SessionEvent>::create(*request, error);
+    if (!events) { return {grpc::StatusCode::INVALID_ARGUMENT, error}; }
+    // a new subscription ends the one it replaces, which may be holding back an editing thread that holds the session
+    close_session_subscription_(request->id());
+    const auto status = with_session_(request->id(), [&](server_session_t &session) {
+        {
+            std::lock_guard<std::mutex> lock(session.subscriptions_mutex);
+            if (session.events) { session.events->close(); }
+            session.events = events;
+        }
+        omega_session_set_event_interest(session.session_ptr,
+                                         request->has_interest() ? request->interest() : ALL_EVENTS);
+        return grpc::Status::OK;
+    });
+    return status.ok() ? stream_events_(*context, *events, *writer) : status;
+}
+
+grpc::Status editor_service_t::SubscribeToViewportEvents(grpc::ServerContext *context,
+                                                         const omega_edit::EventSubscriptionRequest *request,
+                                                         grpc::ServerWriter<omega_edit::ViewportEvent> *writer) {
+    std::string error;
+    const auto events = event_queue_t<omega_edit::ViewportEvent>::create(*request, error);
+    if (!events) { return {grpc::StatusCode::INVALID_ARGUMENT, error}; }
+    // a new subscription ends the one it replaces, which may be holding back an editing thread that holds the session
+    close_viewport_subscription_(request->id());
+    const auto status = with_viewport_(request->id(), [&](server_session_t &session, server_viewport_t &viewport) {
+        {
+            std::lock_guard<std::mutex> lock(session.subscriptions_mutex);
+            if (viewport.events) { viewport.events->close(); }
+            viewport.events = events;
+        }
+        viewport.interest = request->has_interest() ? request->interest() : ALL_EVENTS;
+        omega_viewport_set_event_interest(viewport.viewport_ptr, viewport.shared ? ALL_EVENTS : viewport.interest);
+        return grpc::Status::OK;
+    });
+    return status.ok() ? stream_events_(*context, *events, *writer) : status;
+}
+
+grpc::Status editor_service_t::UnsubscribeToSessionEvents(grpc::ServerContext *, const omega_edit::ObjectId *request,
+                                                          omega_edit::ObjectId *response) {
+    // closing the queue ends the subscription, and releases an editing thread it may be holding back
+    close_session_subscription_(request->id());
+    return with_session_(request->id(), [&](server_session_t &session) {
+        omega_session_set_event_interest(session.session_ptr, NO_EVENTS);
+        {
+            std::lock_guard<std::mutex> lock(session.subscriptions_mutex);
+            if (session.events) { session.events->close(); }
+            session.events.reset();
+        }
+        response->set_id(session.id);
+        return grpc::Status::OK;
+    });
+}
+
+grpc::Status editor_service_t::UnsubscribeToViewportEvents(grpc::ServerContext *,
+                                                           const omega_edit::ObjectId *request,
+                                                           omega_edit::ObjectId *response) {
+    // closing the queue ends the subscription, and releases an editing thread it may be holding back
+    close_viewport_subscription_(request->id());
+    return with_viewport_(request->id(), [&](server_session_t &session, server_viewport_t &viewport) {
+        viewport.interest = NO_EVENTS;
+        omega_viewport_set_event_interest(viewport.viewport_ptr, viewport.shared ? ALL_EVENTS : NO_EVENTS);
+        {
+            std::lock_guard<std::mutex> lock(session.subscriptions_mutex);
+            if (viewport.events) { viewport.events->close(); }
+            viewport.events.reset();
+        }
+        *response = *request;
+        return grpc::Status::OK;
+    });
+}
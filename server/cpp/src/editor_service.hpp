@@ -0,0 +1,305 @@
+/**********************************************************************************************************************
+ * Copyright (c) 2021 Concurrent Technologies Corporation.                                                            *
+ *                                                                                                                    *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance     *
+ * with the License.  You may obtain a copy of the License at                                                         *
+ *                                                                                                                    *
+ *     http://www.apache.org/licenses/LICENSE-2.0                                                                     *
+ *                                                                                                                    *
+ * Unless required by applicable law or agreed to in writing, software is distributed under the License is            *
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or                   *
+ * implied.  See the License for the specific language governing permissions and limitations under the License.       *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+
+/**
+ * @file editor_service.hpp
+ * @brief Native implementation of the Editor gRPC service, linked directly against the omega-edit library.
+ */
+
+#ifndef OMEGA_EDIT_SERVER_EDITOR_SERVICE_HPP
+#define OMEGA_EDIT_SERVER_EDITOR_SERVICE_HPP
+
+#include "event_queue.hpp"
+#include "omega_edit.grpc.pb.h"
+#include "shared_viewport.hpp"
+#include <omega_edit/fwd_defs.h>
+#include <omega_edit/scoped_ptr.hpp>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+
+/**
+ * Viewport of a session served to clients
+ */
+struct server_viewport_t {
+    std::string session_id;                                            ///< Id of the session the viewport belongs to
+    std::string viewport_id;                                           ///< Fully qualified id (session:viewport)
+    omega_viewport_t *viewport_ptr{};                                  ///< Native viewport
+    std::shared_ptr<event_queue_t<omega_edit::ViewportEvent>> events{};///< Queue of the current subscriber, if any
+    int32_t interest{};                                                ///< Events the subscriber is interested in
+    int64_t sequence{};                                                ///< Sequence of the last viewport event
+    std::unique_ptr<shared_viewport_t> shared{};                       ///< Shared-memory copy of the data, if any
+};
+
+/**
+ * Editing session served to clients.  Native calls on a session are serialized by its mutex, so the callbacks they
+ * make run with the mutex held.  A callback offering an event to a backpressure subscriber can hold the session until
+ * the subscriber catches up, so the queues of the subscribers of the session and its viewports are guarded by the
+ * subscriptions mutex instead, and can be closed without waiting for the session.  The subscriptions mutex is taken
+ * after the session mutex, never before it, and is not held while an event is offered.
+ */
+struct server_session_t {
+    explicit server_session_t(std::string session_id) : id(std::move(session_id)) {}
+
+    const std::string id;                                                 ///< Session id
+    std::mutex mutex;                                                     ///< Serializes native calls on the session
+    std::mutex subscriptions_mutex;                                       ///< Guards the subscriber queues
+    omega_session_t *session_ptr{};                                       ///< Native session, or nullptr if destroyed
+    std::shared_ptr<event_queue_t<omega_edit::SessionEvent>> events{};    ///< Queue of the current subscriber, if any
+    std::map<std::string, std::unique_ptr<server_viewport_t>> viewports{};///< Viewports by id (both mutexes to change)
+};
+
+/**
+ * Editor service that calls the omega-edit library in process.  It implements the Editor service of the JVM server,
+ * except for content type and language detection, which answer UNIMPLEMENTED because they rely on Apache Tika.
+ * Requests on different sessions run in parallel, and read-only requests are answered from snapshots, so they hold a
+ * session only for as long as it takes to snapshot it.
+ */
+class editor_service_t final : public omega_edit::Editor::Service {
+public:
+    editor_service_t();
+
+    /**
+     * Destroy the sessions that are still open
+     */
+    ~editor_service_t() override;
+
+    /**
+     * Wait for a client to ask the server to shut down
+     * @param timeout how long to wait
+     * @return true if the server has been asked to shut down
+     */
+    bool wait_for_shutdown(std::chrono::milliseconds timeout);
+
+    /**
+     * Ask the server to shut down, releasing anything waiting in wait_for_shutdown
+     */
+    void shutdown();
+
+    grpc::Status GetServerInfo(grpc::ServerContext *context, const google::protobuf::Empty *request,
+                               omega_edit::ServerInfoResponse *response) override;
+
+    grpc::Status CreateSession(grpc::ServerContext *context, const omega_edit::CreateSessionRequest *request,
+                               omega_edit::CreateSessionResponse *response) override;
+
+    grpc::Status SaveSession(grpc::ServerContext *context, const omega_edit::SaveSessionRequest *request,
+                             omega_edit::SaveSessionResponse *response) override;
+
+    grpc::Status DestroySession(grpc::ServerContext *context, const omega_edit::ObjectId *request,
+                                omega_edit::ObjectId *response) override;
+
+    grpc::Status SubmitChange(grpc::ServerContext *context, const omega_edit::ChangeRequest *request,
+                              omega_edit::ChangeResponse *response) override;
+
+    grpc::Status SubmitChanges(grpc::ServerContext *context, grpc::ServerReader<omega_edit::ChangeRequest> *reader,
+                               omega_edit::ChangesResponse *response) override;
+
+    grpc::Status UndoLastChange(grpc::ServerContext *context, const omega_edit::ObjectId *request,
+                                omega_edit::ChangeResponse *response) override;
+
+    grpc::Status RedoLastUndo(grpc::ServerContext *context, const omega_edit::ObjectId *request,
+                              omega_edit::ChangeResponse *response) override;
+
+    grpc::Status ClearChanges(grpc::ServerContext *context, const omega_edit::ObjectId *request,
+                              omega_edit::ObjectId *response) override;
+
+    grpc::Status PauseSessionChanges(grpc::ServerContext *context, const omega_edit::ObjectId *request,
+                                     omega_edit::ObjectId *response) override;
+
+    grpc::Status ResumeSessionChanges(grpc::ServerContext *context, const omega_edit::ObjectId *request,
+                                      omega_edit::ObjectId *response) override;
+
+    grpc::Status PauseViewportEvents(grpc::ServerContext *context, const omega_edit::ObjectId *request,
+                                     omega_edit::ObjectId *response) override;
+
+    grpc::Status ResumeViewportEvents(grpc::ServerContext *context, const omega_edit::ObjectId *request,
+                                      omega_edit::ObjectId *response) override;
+
+    grpc::Status SessionBeginTransaction(grpc::ServerContext *context, const omega_edit::ObjectId *request,
+                                         omega_edit::ObjectId *response) override;
+
+    grpc::Status SessionEndTransaction(grpc::ServerContext *context, const omega_edit::ObjectId *request,
+                                       omega_edit::ObjectId *response) override;
+
+    grpc::Status NotifyChangedViewports(grpc::ServerContext *context, const omega_edit::ObjectId *request,
+                                        omega_edit::IntResponse *response) override;
+
+    grpc::Status CreateViewport(grpc::ServerContext *context, const omega_edit::CreateViewportRequest *request,
+                                omega_edit::ViewportDataResponse *response) override;
+
+    grpc::Status ModifyViewport(grpc::ServerContext *context, const omega_edit::ModifyViewportRequest *request,
+                                omega_edit::ViewportDataResponse *response) override;
+
+    grpc::Status ViewportHasChanges(grpc::ServerContext *context, const omega_edit::ObjectId *request,
+                                    omega_edit::BooleanResponse *response) override;
+
+    grpc::Status GetViewportData(grpc::ServerContext *context, const omega_edit::ViewportDataRequest *request,
+                                 omega_edit::ViewportDataResponse *response) override;
+
+    grpc::Status DestroyViewport(grpc::ServerContext *context, const omega_edit::ObjectId *request,
+                                 omega_edit::ObjectId *response) override;
+
+    grpc::Status GetChangeDetails(grpc::ServerContext *context, const omega_edit::SessionEvent *request,
+                                  omega_edit::ChangeDetailsResponse *response) override;
+
+    grpc::Status GetLastChange(grpc::ServerContext *context, const omega_edit::ObjectId *request,
+                               omega_edit::ChangeDetailsResponse *response) override;
+
+    grpc::Status GetLastUndo(grpc::ServerContext *context, const omega_edit::ObjectId *request,
+                             omega_edit::ChangeDetailsResponse *response) override;
+
+    grpc::Status GetComputedFileSize(grpc::ServerContext *context, const omega_edit::ObjectId *request,
+                                     omega_edit::ComputedFileSizeResponse *response) override;
+
+    grpc::Status GetByteOrderMark(grpc::ServerContext *context, const omega_edit::SegmentRequest *request,
+                                  omega_edit::ByteOrderMarkResponse *response) override;
+
+    grpc::Status GetContentType(grpc::ServerContext *context, const omega_edit::SegmentRequest *request,
+                                omega_edit::ContentTypeResponse *response) override;
+
+    grpc::Status GetLanguage(grpc::ServerContext *context, const omega_edit::TextRequest *request,
+                             omega_edit::LanguageResponse *response) override;
+
+    grpc::Status GetCount(grpc::ServerContext *context, const omega_edit::CountRequest *request,
+                          omega_edit::CountResponse *response) override;
+
+    grpc::Status GetSessionCount(grpc::ServerContext *context, const google::protobuf::Empty *request,
+                                 omega_edit::SessionCountResponse *response) override;
+
+    grpc::Status GetSegment(grpc::ServerContext *context, const omega_edit::SegmentRequest *request,
+                            omega_edit::SegmentResponse *response) override;
+
+    grpc::Status StreamSegment(grpc::ServerContext *context, const omega_edit::StreamSegmentRequest *request,
+                               grpc::ServerWriter<omega_edit::SegmentResponse> *writer) override;
+
+    grpc::Status SearchSession(grpc::ServerContext *context, const omega_edit::SearchRequest *request,
+                               omega_edit::SearchResponse *response) override;
+
+    grpc::Status GetByteFrequencyProfile(grpc::ServerContext *context, const omega_edit::SegmentRequest *request,
+                                         omega_edit::ByteFrequencyProfileResponse *response) override;
+
+    grpc::Status GetCharacterCounts(grpc::ServerContext *context, const omega_edit::TextRequest *request,
+                                    omega_edit::CharacterCountResponse *response) override;
+
+    grpc::Status ServerControl(grpc::ServerContext *context, const omega_edit::ServerControlRequest *request,
+                               omega_edit::ServerControlResponse *response) override;
+
+    grpc::Status GetHeartbeat(grpc::ServerContext *context, const omega_edit::HeartbeatRequest *request,
+                              omega_edit::HeartbeatResponse *response) override;
+
+    grpc::Status SubscribeToSessionEvents(grpc::ServerContext *context,
+                                          const omega_edit::EventSubscriptionRequest *request,
+                                          grpc::ServerWriter<omega_edit::SessionEvent> *writer) override;
+
+    grpc::Status SubscribeToViewportEvents(grpc::ServerContext *context,
+                                           const omega_edit::EventSubscriptionRequest *request,
+                                           grpc::ServerWriter<omega_edit::ViewportEvent> *writer) override;
+
+    grpc::Status UnsubscribeToSessionEvents(grpc::ServerContext *context, const omega_edit::ObjectId *request,
+                                            omega_edit::ObjectId *response) override;
+
+    grpc::Status UnsubscribeToViewportEvents(grpc::ServerContext *context, const omega_edit::ObjectId *request,
+                                             omega_edit::ObjectId *response) override;
+
+private:
+    using session_op_t = std::function<grpc::Status(server_session_t &)>;
+    using viewport_op_t = std::function<grpc::Status(server_session_t &, server_viewport_t &)>;
+    using snapshot_ptr_t = omega_scoped_ptr<omega_snapshot_t>;
+
+    /**
+     * Find the given session
+     * @param session_id id of the session
+     * @return session, or nullptr if there is no such session
+     */
+    std::shared_ptr<server_session_t> find_session_(const std::string &session_id) const;
+
+    /**
+     * Run the given operation with the given session locked
+     * @param session_id id of the session
+     * @param op operation to run
+     * @return status of the operation, or NOT_FOUND if there is no such session
+     */
+    grpc::Status with_session_(const std::string &session_id, const session_op_t &op);
+
+    /**
+     * Run the given operation with the session of the given viewport locked
+     * @param viewport_id fully qualified viewport id
+     * @param op operation to run
+     * @return status of the operation, INVALID_ARGUMENT if the viewport id is malformed, or NOT_FOUND if there is no
+     * such viewport
+     */
+    grpc::Status with_viewport_(const std::string &viewport_id, const viewport_op_t &op);
+
+    /**
+     * Close the queue of the subscriber of the given session without holding the session, so an editing thread held
+     * back by the subscriber is released
+     * @param session_id id of the session
+     */
+    void close_session_subscription_(const std::string &session_id);
+
+    /**
+     * Close the queue of the subscriber of the given viewport without holding its session, so an editing thread held
+     * back by the subscriber is released
+     * @param viewport_id fully qualified viewport id
+     */
+    void close_viewport_subscription_(const std::string &viewport_id);
+
+    /**
+     * Take a snapshot of the given session, so it can be read without holding the session
+     * @param session_id id of the session
+     * @param snapshot set to the snapshot, on success
+     * @return status, NOT_FOUND if there is no such session
+     */
+    grpc::Status snapshot_(const std::string &session_id, snapshot_ptr_t &snapshot);
+
+    /**
+     * Destroy the given session and remove it from the sessions being served
+     * @param session_id id of the session
+     * @return true if the session was destroyed, false if there is no such session
+     */
+    bool destroy_session_(const std::string &session_id);
+
+    /**
+     * Destroy all the sessions being served
+     */
+    void destroy_sessions_();
+
+    /**
+     * Get the number of sessions being served
+     * @return number of sessions
+     */
+    size_t session_count_() const;
+
+    /**
+     * Stop the server once the last session is destroyed, if it has been asked to shut down gracefully
+     * @return true if the server is shutting down
+     */
+    bool check_graceful_shutdown_();
+
+    mutable std::shared_mutex sessions_mutex_;                          ///< Guards the sessions map
+    std::map<std::string, std::shared_ptr<server_session_t>> sessions_{};///< Sessions being served, by session id
+    std::mutex shutdown_mutex_;                                         ///< Guards the shutdown flag
+    std::condition_variable shutdown_cv_;                               ///< Signalled when shutdown is requested
+    bool shutdown_{};                                                   ///< Whether shutdown has been requested
+    std::atomic<bool> graceful_shutdown_{};                             ///< Whether to stop after the last session
+    const std::chrono::steady_clock::time_point started_;               ///< When the service was started
+};
+
+#endif//OMEGA_EDIT_SERVER_EDITOR_SERVICE_HPP
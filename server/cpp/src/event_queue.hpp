@@ -0,0 +1,150 @@
+/**********************************************************************************************************************
+ * Copyright (c) 2021 Concurrent Technologies Corporation.                                                            *
+ *                                                                                                                    *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance     *
+ * with the License.  You may obtain a copy of the License at                                                         *
+ *                                                                                                                    *
+ *     http://www.apache.org/licenses/LICENSE-2.0                                                                     *
+ *                                                                                                                    *
+ * Unless required by applicable law or agreed to in writing, software is distributed under the License is            *
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or                   *
+ * implied.  See the License for the specific language governing permissions and limitations under the License.       *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+
+/**
+ * @file event_queue.hpp
+ * @brief Bounded queue of the events of a session or viewport for its subscriber.
+ */
+
+#ifndef OMEGA_EDIT_SERVER_EVENT_QUEUE_HPP
+#define OMEGA_EDIT_SERVER_EVENT_QUEUE_HPP
+
+#include "omega_edit.pb.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+
+/**
+ * Queues the events of a session or viewport for its subscriber.  Native callbacks offer events on the thread that
+ * edits the session, and the subscription drains them on its own thread.  Every subscription gets a queue of its own,
+ * with the depth and overflow policy it asked for, so a slow subscriber only loses or holds back its own events.
+ * @tparam T event message type
+ */
+template<typename T>
+class event_queue_t {
+public:
+    static constexpr int32_t default_depth = 8;///< Number of events held for a subscriber that does not ask for more
+    static constexpr int32_t max_depth = 4096; ///< Largest number of events a subscriber can ask to have held
+
+    /**
+     * Create the queue a subscription request asks for
+     * @param request subscription request with the queue depth and overflow policy
+     * @param error set to why the request is invalid, on failure
+     * @return event queue, or nullptr if the request is invalid
+     */
+    static std::shared_ptr<event_queue_t> create(const omega_edit::EventSubscriptionRequest &request,
+                                                 std::string &error) {
+        const auto policy =
+                request.has_overflow_policy() ? request.overflow_policy() : omega_edit::EVENT_OVERFLOW_BACKPRESSURE;
+        const auto depth = request.has_queue_depth() ? request.queue_depth() : default_depth;
+        if (!omega_edit::EventOverflowPolicy_IsValid(policy)) {
+            error = "unknown overflow policy: " + std::to_string(policy);
+            return nullptr;
+        }
+        // conflating subscribers only ever get the latest event
+        if (policy == omega_edit::EVENT_OVERFLOW_CONFLATE) {
+            return std::shared_ptr<event_queue_t>(new event_queue_t(1, policy));
+        }
+        if (depth <= 0 || depth > max_depth) {
+            error = "queue depth out of range: " + std::to_string(depth);
+            return nullptr;
+        }
+        return std::shared_ptr<event_queue_t>(new event_queue_t(depth, policy));
+    }
+
+    event_queue_t(const event_queue_t &) = delete;
+
+    event_queue_t &operator=(const event_queue_t &) = delete;
+
+    /**
+     * Offer an event to the subscriber.  When the queue is full, a backpressure queue holds the offering thread back
+     * until the subscriber catches up or the queue is closed, and other queues drop their oldest event to make room.
+     * @param event event to offer
+     * @return true if the event was queued, false if the queue is closed
+     */
+    bool offer(T event) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (is_lossy()) {
+            if (depth_ <= events_.size()) { events_.pop_front(); }
+        } else {
+            not_full_.wait(lock, [this] { return closed_ || events_.size() < depth_; });
+        }
+        if (closed_) { return false; }
+        events_.push_back(std::move(event));
+        not_empty_.notify_one();
+        return true;
+    }
+
+    /**
+     * Take the oldest event, waiting for one to be offered
+     * @param event set to the oldest event, on success
+     * @param timeout how long to wait for an event
+     * @return true if an event was taken, false if none was offered in time or the queue is closed and drained
+     */
+    bool pop(T &event, std::chrono::milliseconds timeout) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (!not_empty_.wait_for(lock, timeout, [this] { return closed_ || !events_.empty(); }) || events_.empty()) {
+            return false;
+        }
+        event = std::move(events_.front());
+        events_.pop_front();
+        not_full_.notify_one();
+        return true;
+    }
+
+    /**
+     * Close the queue, so that no more events are queued and threads held back by it are released
+     */
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closed_ = true;
+        }
+        not_full_.notify_all();
+        not_empty_.notify_all();
+    }
+
+    /**
+     * Determine if the queue has been closed
+     * @return true if the queue is closed
+     */
+    bool is_closed() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return closed_;
+    }
+
+    /**
+     * Determine if the subscriber can miss events, in which case events should not depend on the ones before them
+     * @return true if the queue drops events when it is full
+     */
+    bool is_lossy() const { return policy_ != omega_edit::EVENT_OVERFLOW_BACKPRESSURE; }
+
+private:
+    event_queue_t(int32_t depth, omega_edit::EventOverflowPolicy policy)
+        : depth_(static_cast<size_t>(depth)), policy_(policy) {}
+
+    const size_t depth_;                          ///< Number of events held for the subscriber
+    const omega_edit::EventOverflowPolicy policy_;///< What to do with new events when the queue is full
+    mutable std::mutex mutex_;                    ///< Guards the events and the closed flag
+    std::condition_variable not_empty_;           ///< Signalled when an event is queued or the queue is closed
+    std::condition_variable not_full_;            ///< Signalled when an event is taken or the queue is closed
+    std::deque<T> events_{};                      ///< Queued events, oldest first
+    bool closed_{};                               ///< Whether the queue has been closed
+};
+
+#endif//OMEGA_EDIT_SERVER_EVENT_QUEUE_HPP
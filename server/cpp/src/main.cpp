@@ -0,0 +1,120 @@
+/**********************************************************************************************************************
+ * Copyright (c) 2021 Concurrent Technologies Corporation.                                                            *
+ *                                                                                                                    *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance     *
+ * with the License.  You may obtain a copy of the License at                                                         *
+ *                                                                                                                    *
+ *     http://www.apache.org/licenses/LICENSE-2.0                                                                     *
+ *                                                                                                                    *
+ * Unless required by applicable law or agreed to in writing, software is distributed under the License is            *
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or                   *
+ * implied.  See the License for the specific language governing permissions and limitations under the License.       *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+
+#include "editor_service.hpp"
+#include <grpcpp/grpcpp.h>
+#include <omega_edit/version.h>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace {
+    volatile sig_atomic_t signalled = 0;
+
+    void handle_signal(int) { signalled = 1; }
+
+    string env_or(const char *name, const string &default_value) {
+        const auto *value = getenv(name);
+        return value ? value : default_value;
+    }
+
+    string version() {
+        return "v" + to_string(omega_version_major()) + "." + to_string(omega_version_minor()) + "." +
+               to_string(omega_version_patch());
+    }
+
+    void usage(const char *program, const string &interface, const string &port, const string &pidfile) {
+        cout << "Native Ωedit gRPC server\n\nUSAGE: " << program << " [options]\n\n"
+             << "  -i, --interface <interface_str>  Set the gRPC interface to bind to. Default: " << interface << "\n"
+             << "  -p, --port <port_num>            Set the gRPC port to listen on. Default: " << port << "\n"
+             << "  -f, --pidfile <pidfile_str>      Set the pidfile to write the PID to. Default: "
+             << (pidfile.empty() ? "null" : pidfile) << "\n"
+             << "  -v, --version                    Print the version and exit\n"
+             << "  -h, --help                       Print this help and exit" << endl;
+    }
+}// namespace
+
+int main(int argc, char **argv) {
+    auto interface = env_or("OMEGA_EDIT_SERVER_HOST", "127.0.0.1");
+    auto port = env_or("OMEGA_EDIT_SERVER_PORT", "9000");
+    auto pidfile = env_or("OMEGA_EDIT_SERVER_PIDFILE", "");
+    for (int i = 1; i < argc; ++i) {
+        const string arg = argv[i];
+        const auto value = [&](const string &short_name, const string &long_name, string &option) {
+            if (arg == short_name || arg == long_name) {
+                if (argc <= i + 1) { return false; }
+                option = argv[++i];
+                return true;
+            }
+            if (0 == arg.rfind(long_name + "=", 0)) {
+                option = arg.substr(long_name.size() + 1);
+                return true;
+            }
+            return false;
+        };
+        if (value("-i", "--interface", interface) || value("-p", "--port", port) ||
+            value("-f", "--pidfile", pidfile)) {
+            continue;
+        }
+        if (arg == "-v" || arg == "--version") {
+            cout << version() << endl;
+            return 0;
+        }
+        usage(argv[0], interface, port, pidfile);
+        return arg == "-h" || arg == "--help" ? 0 : 1;
+    }
+
+    const auto pid = static_cast<int>(getpid());
+    const auto serv_info = "Ωedit native gRPC server (" + version() + ") with PID " + to_string(pid);
+
+    // write the PID to the pidfile (if specified)
+    if (!pidfile.empty()) { ofstream(pidfile) << pid; }
+
+    editor_service_t service;
+    const auto address = interface + ":" + port;
+    int selected_port = 0;
+    grpc::ServerBuilder builder;
+    builder.AddListeningPort(address, grpc::InsecureServerCredentials(), &selected_port);
+    builder.RegisterService(&service);
+    const auto server = builder.BuildAndStart();
+    if (!server || 0 == selected_port) {
+        cerr << serv_info << " failed to bind to " << address << endl;
+        return 1;
+    }
+    cout << serv_info << " bound to " << address << ": ready..." << endl;
+
+    signal(SIGINT, handle_signal);
+    signal(SIGTERM, handle_signal);
+    while (!signalled && !service.wait_for_shutdown(chrono::milliseconds(200))) {}
+
+    // give in-flight requests, such as the one asking for the shutdown, a moment to complete
+    server->Shutdown(chrono::system_clock::now() + chrono::seconds(1));
+    cout << serv_info << " bound to " << address << ": exiting..." << endl;
+
+    // delete the pidfile (if specified)
+    if (!pidfile.empty()) { remove(pidfile.c_str()); }
+    return 0;
+}
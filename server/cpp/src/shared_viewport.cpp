@@ -0,0 +1,171 @@
+/**********************************************************************************************************************
+ * Copyright (c) 2021 Concurrent Technologies Corporation.                                                            *
+ *                                                                                                                    *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance     *
+ * with the License.  You may obtain a copy of the License at                                                         *
+ *                                                                                                                    *
+ *     http://www.apache.org/licenses/LICENSE-2.0                                                                     *
+ *                                                                                                                    *
+ * Unless required by applicable law or agreed to in writing, software is distributed under the License is            *
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or                   *
+ * implied.  See the License for the specific language governing permissions and limitations under the License.       *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+
+#include "shared_viewport.hpp"
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+std::unique_ptr<shared_viewport_t> shared_viewport_t::create(int64_t, std::string &error) {
+    error = "shared memory is not supported on this platform";
+    return nullptr;
+}
+
+shared_viewport_t::~shared_viewport_t() = default;
+
+std::unique_ptr<shared_viewport_reader_t> shared_viewport_reader_t::open(const omega_edit::SharedViewport &,
+                                                                         std::string &error) {
+    error = "shared memory is not supported on this platform";
+    return nullptr;
+}
+
+shared_viewport_reader_t::~shared_viewport_reader_t() = default;
+
+#else
+
+std::unique_ptr<shared_viewport_t> shared_viewport_t::create(int64_t data_capacity, std::string &error) {
+    static std::atomic<uint64_t> next_region{};
+    const auto name = "/omega_edit-" + std::to_string(getpid()) + "-" + std::to_string(++next_region);
+    const auto size = shared_viewport_data_offset + data_capacity;
+    // only the user running the server can map the region
+    const auto fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        error = "failed to create shared memory " + name + ": " + std::strerror(errno);
+        return nullptr;
+    }
+    // pages are only allocated as they are written, so sizing the region for the largest viewport costs nothing
+    auto *region_ptr = 0 == ftruncate(fd, size) ? mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)
+                                                 : MAP_FAILED;
+    if (region_ptr == MAP_FAILED) {
+        error = "failed to map shared memory " + name + ": " + std::strerror(errno);
+        close(fd);
+        shm_unlink(name.c_str());
+        return nullptr;
+    }
+    close(fd);
+    auto shared_viewport = std::unique_ptr<shared_viewport_t>(new shared_viewport_t(name, region_ptr, size));
+    shared_viewport->header_->magic = shared_viewport_magic;
+    shared_viewport->header_->version = shared_viewport_version;
+    shared_viewport->header_->data_capacity = data_capacity;
+    return shared_viewport;
+}
+
+shared_viewport_t::~shared_viewport_t() {
+    munmap(region_ptr_, size_);
+    shm_unlink(name_.c_str());
+}
+
+std::unique_ptr<shared_viewport_reader_t>
+shared_viewport_reader_t::open(const omega_edit::SharedViewport &shared_viewport, std::string &error) {
+    const auto &name = shared_viewport.name();
+    const auto size = shared_viewport.size();
+    if (size < shared_viewport_data_offset) {
+        error = "shared memory " + name + " is too small";
+        return nullptr;
+    }
+    const auto fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        error = "failed to open shared memory " + name + ": " + std::strerror(errno);
+        return nullptr;
+    }
+    const auto *region_ptr = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (region_ptr == MAP_FAILED) {
+        error = "failed to map shared memory " + name + ": " + std::strerror(errno);
+        return nullptr;
+    }
+    auto reader = std::unique_ptr<shared_viewport_reader_t>(new shared_viewport_reader_t(region_ptr, size));
+    if (reader->header_->magic != shared_viewport_magic || reader->header_->version != shared_viewport_version ||
+        reader->header_->data_capacity > size - shared_viewport_data_offset) {
+        error = "shared memory " + name + " does not hold a viewport of this version";
+        return nullptr;
+    }
+    return reader;
+}
+
+shared_viewport_reader_t::~shared_viewport_reader_t() { munmap(const_cast<void *>(region_ptr_), size_); }
+
+#endif
+
+shared_viewport_t::shared_viewport_t(std::string name, void *region_ptr, int64_t size)
+    : name_(std::move(name)), region_ptr_(region_ptr), size_(size),
+      header_(static_cast<shared_viewport_header_t *>(region_ptr)),
+      data_(static_cast<char *>(region_ptr) + shared_viewport_data_offset) {}
+
+omega_edit::SharedViewportUpdate shared_viewport_t::update(int64_t offset, const char *data, int64_t length,
+                                                           int64_t following_byte_count, int64_t event_sequence) {
+    length = std::min(length, header_->data_capacity);
+    const auto previous_length = header_->length;
+    const auto common_length = std::min(previous_length, length);
+    auto dirty_start = int64_t{};
+    while (dirty_start < common_length && data_[dirty_start] == data[dirty_start]) { ++dirty_start; }
+    auto dirty_end = std::max(previous_length, length);
+    if (previous_length == length) {
+        while (dirty_end > dirty_start && data_[dirty_end - 1] == data[dirty_end - 1]) { --dirty_end; }
+    }
+
+    const auto sequence = header_->sequence.load(std::memory_order_relaxed);
+    header_->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    header_->offset = offset;
+    header_->length = length;
+    header_->following_byte_count = following_byte_count;
+    header_->event_sequence = event_sequence;
+    if (dirty_start < length) {
+        std::memcpy(data_ + dirty_start, data + dirty_start, std::min(dirty_end, length) - dirty_start);
+    }
+    header_->sequence.store(sequence + 2, std::memory_order_release);
+
+    omega_edit::SharedViewportUpdate shared_update;
+    shared_update.set_generation(static_cast<int64_t>((sequence + 2) / 2));
+    shared_update.set_dirty_start(dirty_start);
+    shared_update.set_dirty_end(dirty_end);
+    return shared_update;
+}
+
+void shared_viewport_t::describe(omega_edit::SharedViewport &shared_viewport) const {
+    shared_viewport.set_name(name_);
+    shared_viewport.set_size(size_);
+    shared_viewport.set_generation(static_cast<int64_t>(header_->sequence.load(std::memory_order_acquire) / 2));
+}
+
+shared_viewport_reader_t::shared_viewport_reader_t(const void *region_ptr, int64_t size)
+    : region_ptr_(region_ptr), size_(size), header_(static_cast<const shared_viewport_header_t *>(region_ptr)),
+      data_(static_cast<const char *>(region_ptr) + shared_viewport_data_offset) {}
+
+int64_t shared_viewport_reader_t::read(int64_t &offset, std::string &data) const {
+    for (;;) {
+        const auto sequence = header_->sequence.load(std::memory_order_acquire);
+        if (sequence % 2) {
+            std::this_thread::yield();
+            continue;
+        }
+        offset = header_->offset;
+        // a torn length is discarded below, but must not read past the region in the meantime
+        data.assign(data_, static_cast<size_t>(std::clamp<int64_t>(header_->length, 0, header_->data_capacity)));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence == header_->sequence.load(std::memory_order_relaxed)) {
+            return static_cast<int64_t>(sequence / 2);
+        }
+    }
+}
@@ -0,0 +1,138 @@
+/**********************************************************************************************************************
+ * Copyright (c) 2021 Concurrent Technologies Corporation.                                                            *
+ *                                                                                                                    *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance     *
+ * with the License.  You may obtain a copy of the License at                                                         *
+ *                                                                                                                    *
+ *     http://www.apache.org/licenses/LICENSE-2.0                                                                     *
+ *                                                                                                                    *
+ * Unless required by applicable law or agreed to in writing, software is distributed under the License is            *
+ * distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or                   *
+ * implied.  See the License for the specific language governing permissions and limitations under the License.       *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+
+/**
+ * @file shared_viewport.hpp
+ * @brief Viewport data in shared memory, for clients on the same host as the server.
+ */
+
+#ifndef OMEGA_EDIT_SERVER_SHARED_VIEWPORT_HPP
+#define OMEGA_EDIT_SERVER_SHARED_VIEWPORT_HPP
+
+#include "omega_edit.pb.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+constexpr uint32_t shared_viewport_magic = 0x50564d4f;///< "OMVP", marks a shared viewport region
+constexpr uint32_t shared_viewport_version = 1;       ///< Version of the region layout
+constexpr int64_t shared_viewport_data_offset = 64;   ///< Where the viewport data starts in the region
+
+/**
+ * Header at the start of a shared viewport region, followed by the viewport data at shared_viewport_data_offset.  The
+ * server bumps the sequence to an odd number before it updates the region and to the next even number after, so a
+ * reader that sees the same even sequence before and after copying the region has copied a consistent generation
+ * (the sequence divided by two).
+ */
+struct shared_viewport_header_t {
+    uint32_t magic;                ///< shared_viewport_magic
+    uint32_t version;              ///< shared_viewport_version
+    std::atomic<uint64_t> sequence;///< Twice the generation, plus one while the region is being updated
+    int64_t data_capacity;         ///< Number of bytes of viewport data the region can hold
+    int64_t offset;                ///< Offset of the viewport in the session
+    int64_t length;                ///< Length of the viewport data
+    int64_t following_byte_count;  ///< Number of bytes in the session after the viewport
+    int64_t event_sequence;        ///< Sequence of the last viewport event the data reflects
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "the sequence must be usable across processes");
+static_assert(sizeof(shared_viewport_header_t) <= shared_viewport_data_offset, "the header overlaps the data");
+
+/**
+ * Shared-memory region that the server updates in place with the data of a viewport.  The region is unlinked when it
+ * is destroyed, and clients that still map it keep their mapping until they unmap it.
+ */
+class shared_viewport_t {
+public:
+    /**
+     * Create a shared viewport region
+     * @param data_capacity number of bytes of viewport data the region must hold
+     * @param error set to why the region could not be created, on failure
+     * @return shared viewport region, or nullptr on failure
+     */
+    static std::unique_ptr<shared_viewport_t> create(int64_t data_capacity, std::string &error);
+
+    shared_viewport_t(const shared_viewport_t &) = delete;
+
+    shared_viewport_t &operator=(const shared_viewport_t &) = delete;
+
+    ~shared_viewport_t();
+
+    /**
+     * Publish a new generation of the viewport data, only writing the bytes that changed
+     * @param offset offset of the viewport in the session
+     * @param data viewport data
+     * @param length length of the viewport data, at most the data capacity of the region
+     * @param following_byte_count number of bytes in the session after the viewport
+     * @param event_sequence sequence of the viewport event the data reflects
+     * @return generation published and the range of the viewport data that changed since the previous generation
+     */
+    omega_edit::SharedViewportUpdate update(int64_t offset, const char *data, int64_t length,
+                                            int64_t following_byte_count, int64_t event_sequence);
+
+    /**
+     * Describe the region to clients
+     * @param shared_viewport set to the name, size and current generation of the region
+     */
+    void describe(omega_edit::SharedViewport &shared_viewport) const;
+
+private:
+    shared_viewport_t(std::string name, void *region_ptr, int64_t size);
+
+    const std::string name_;            ///< Name of the shared-memory object
+    void *const region_ptr_;            ///< Mapping of the region
+    const int64_t size_;                ///< Size of the region in bytes
+    shared_viewport_header_t *header_{};///< Header at the start of the region
+    char *data_{};                      ///< Viewport data after the header
+};
+
+/**
+ * Read-only mapping of a shared viewport region, for clients on the same host as the server
+ */
+class shared_viewport_reader_t {
+public:
+    /**
+     * Map a shared viewport region read-only
+     * @param shared_viewport region described by the server
+     * @param error set to why the region could not be mapped, on failure
+     * @return reader of the region, or nullptr on failure
+     */
+    static std::unique_ptr<shared_viewport_reader_t> open(const omega_edit::SharedViewport &shared_viewport,
+                                                          std::string &error);
+
+    shared_viewport_reader_t(const shared_viewport_reader_t &) = delete;
+
+    shared_viewport_reader_t &operator=(const shared_viewport_reader_t &) = delete;
+
+    ~shared_viewport_reader_t();
+
+    /**
+     * Copy a consistent generation of the viewport data, retrying while the server is updating the region
+     * @param offset set to the offset of the viewport in the session
+     * @param data set to the viewport data
+     * @return generation copied
+     */
+    int64_t read(int64_t &offset, std::string &data) const;
+
+private:
+    shared_viewport_reader_t(const void *region_ptr, int64_t size);
+
+    const void *const region_ptr_;            ///< Read-only mapping of the region
+    const int64_t size_;                      ///< Size of the region in bytes
+    const shared_viewport_header_t *header_{};///< Header at the start of the region
+    const char *data_{};                      ///< Viewport data after the header
+};
+
+#endif//OMEGA_EDIT_SERVER_SHARED_VIEWPORT_HPP
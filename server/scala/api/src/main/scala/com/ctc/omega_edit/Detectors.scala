@@ -0,0 +1,63 @@
+/*
+ * Copyright 2021 Concurrent Technologies Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package com.ctc.omega_edit
+
+import org.apache.tika.detect.{DefaultDetector, Detector}
+import org.apache.tika.language.detect.LanguageDetector
+import org.apache.tika.langdetect.optimaize.OptimaizeLangDetector
+import org.apache.tika.metadata.Metadata
+
+import java.io.ByteArrayInputStream
+import java.util.concurrent.ConcurrentLinkedQueue
+
+/** Content type and language detectors shared by all sessions. Loading the language models dominates the cost of
+  * language detection, so loaded detectors are pooled and reused rather than created per request.
+  */
+private[omega_edit] object Detectors {
+
+  /** Number of leading bytes content type detection looks at, matching the magic window of the Tika MIME types */
+  val ContentTypeDetectionLimit: Long = 64L * 1024L
+
+  /** Number of leading bytes language detection looks at, well beyond what the language models need to be certain */
+  val LanguageDetectionLimit: Long = 64L * 1024L
+
+  // Tika detectors are stateless and thread-safe
+  lazy val contentTypeDetector: Detector = new DefaultDetector()
+
+  // language detectors accumulate text as they detect, so each is only used by one thread at a time
+  private val languageDetectors = new ConcurrentLinkedQueue[LanguageDetector]()
+
+  def detectContentType(data: Array[Byte]): String =
+    contentTypeDetector.detect(new ByteArrayInputStream(data), new Metadata()).toString
+
+  def withLanguageDetector[A](f: LanguageDetector => A): A = {
+    val detector = Option(languageDetectors.poll()).getOrElse(new OptimaizeLangDetector().loadModels())
+    try f(detector)
+    finally {
+      detector.reset()
+      languageDetectors.offer(detector)
+    }
+  }
+
+  /** Load the detectors ahead of the first request that needs them
+    */
+  def warmup(): Unit = {
+    detectContentType("warmup".getBytes)
+    withLanguageDetector(_.detect("warmup"))
+    ()
+  }
+}
@@ -70,6 +70,7 @@ private[omega_edit] trait FFI {
   def omega_edit_delete(p: Pointer, offset: Long, len: Long): Long
   def omega_edit_undo_last_change(p: Pointer): Long
   def omega_edit_redo_last_undo(p: Pointer): Long
+  def omega_edit_discard_undone_changes(p: Pointer): Long
   def omega_edit_clear_changes(p: Pointer): Long
 
   def omega_edit_create_viewport(
@@ -99,6 +100,7 @@ private[omega_edit] trait FFI {
   def omega_session_get_num_undone_changes(p: Pointer): Long
   def omega_session_get_num_viewports(p: Pointer): Long
   def omega_session_get_num_search_contexts(p: Pointer): Long
+  def omega_session_classify_content(p: Pointer, offset: Long, length: Long): Int
   def omega_session_get_segment(
       session: Pointer,
       segment: Pointer,
@@ -108,6 +110,7 @@ private[omega_edit] trait FFI {
   def omega_session_pause_changes(p: Pointer): Unit
   def omega_session_resume_changes(p: Pointer): Unit
   def omega_session_pause_viewport_event_callbacks(p: Pointer): Unit
+  def omega_session_viewport_event_callbacks_paused(p: Pointer): Int
   def omega_session_resume_viewport_event_callbacks(p: Pointer): Unit
   def omega_session_notify_changed_viewports(p: Pointer): Int
   def omega_session_begin_transaction(p: Pointer): Int
@@ -210,6 +213,47 @@ private[omega_edit] trait FFI {
   def omega_search_next_match(p: Pointer, advanceContext: Long): Int
   def omega_search_destroy_context(p: Pointer): Unit
 
+  // snapshot
+
+  def omega_session_snapshot(p: Pointer): Pointer
+  def omega_snapshot_get_computed_file_size(p: Pointer): Long
+  def omega_snapshot_get_num_changes(p: Pointer): Long
+  def omega_snapshot_get_segment(
+      snapshot: Pointer,
+      segment: Pointer,
+      offset: Long
+  ): Int
+  def omega_snapshot_byte_frequency_profile(
+      snapshot: Pointer,
+      profile: Pointer,
+      offset: Long,
+      length: Long
+  ): Int
+  def omega_snapshot_character_counts(
+      snapshot: Pointer,
+      counts: Pointer,
+      offset: Long,
+      length: Long,
+      bom: Int
+  ): Int
+  def omega_snapshot_search(
+      snapshot: Pointer,
+      pattern: Array[Byte],
+      patternLength: Long,
+      offset: Long,
+      length: Long
+  ): Long
+  def omega_snapshot_search_create_context(
+      snapshot: Pointer,
+      pattern: Array[Byte],
+      patternLength: Long,
+      offset: Long,
+      length: Long
+  ): Pointer
+  def omega_snapshot_search_next_match(p: Pointer): Long
+  def omega_snapshot_search_destroy_context(p: Pointer): Unit
+  def omega_snapshot_destroy(p: Pointer): Unit
+
   // segment
 
   def omega_segment_create(capacity: Long): Pointer
@@ -24,9 +24,6 @@ import java.nio.ByteBuffer
 import java.nio.charset.StandardCharsets
 import java.nio.file.{Path, Paths}
 import scala.util.{Failure, Success, Try}
-import org.apache.tika.detect.DefaultDetector
-import org.apache.tika.langdetect.optimaize.OptimaizeLangDetector
-import org.apache.tika.metadata.Metadata
 
 private[omega_edit] class SessionImpl(p: Pointer, i: FFI) extends Session {
 
@@ -74,6 +71,9 @@ private[omega_edit] class SessionImpl(p: Pointer, i: FFI) extends Session {
   def pauseViewportEvents(): Unit =
     i.omega_session_pause_viewport_event_callbacks(p)
 
+  def viewportEventsPaused: Boolean =
+    i.omega_session_viewport_event_callbacks_paused(p) != 0
+
   def resumeViewportEvents(): Unit =
     i.omega_session_resume_viewport_event_callbacks(p)
 
@@ -109,6 +109,9 @@ private[omega_edit] class SessionImpl(p: Pointer, i: FFI) extends Session {
   def redoUndo(): Result =
     Edit(i.omega_edit_redo_last_undo(p))
 
+  def discardUndone(): Long =
+    i.omega_edit_discard_undone_changes(p)
+
   def clearChanges(): Result =
     Edit(i.omega_edit_clear_changes(p))
 
@@ -289,31 +292,46 @@ private[omega_edit] class SessionImpl(p: Pointer, i: FFI) extends Session {
     } finally i.omega_segment_destroy(sp)
   }
 
-  def detectContentType(offset: Long, length: Long): String =
-    getSegment(offset, length) match {
-      case Some(segment) =>
-        val detector = new DefaultDetector()
-        val metadata = new Metadata()
-        val stream = new java.io.ByteArrayInputStream(segment.data)
-        val mediaType = detector.detect(stream, metadata)
-        mediaType.toString
-      case None => throw new RuntimeException(s"Failed to get segment at offset $offset and length $length")
-    }
-
-  def detectLanguage(offset: Long, length: Long, bom: String): String =
-    getSegment(offset, length) match {
-      case Some(segment) =>
-        val detector = new OptimaizeLangDetector()
-        detector.loadModels()
+  def snapshot(): Snapshot =
+    new SnapshotImpl(i.omega_session_snapshot(p), i)
 
-        // Convert byte array to String
-        val content = new String(segment.data, if (bom == "none" || bom == "unknown") "UTF-8" else bom)
+  def classifyContent(offset: Long, length: Long): ContentClass =
+    ContentClass.withValue(i.omega_session_classify_content(p, offset, length))
 
-        val languageResult = detector.detect(content) // Noq metadata argument
-        if (languageResult.isReasonablyCertain) languageResult.getLanguage.toString else "unknown"
+  def detectContentType(offset: Long, length: Long): String = {
+    // only the leading bytes are needed to detect the content type
+    val limit = math.min(length, Detectors.ContentTypeDetectionLimit)
+    getSegment(offset, limit) match {
+      case Some(segment) => Detectors.detectContentType(segment.data)
+      case None          => throw new RuntimeException(s"Failed to get segment at offset $offset and length $length")
+    }
+  }
 
-      case None => throw new RuntimeException(s"Failed to get segment at offset $offset and length $length")
+  def detectLanguage(offset: Long, length: Long, bom: String): String = {
+    val limit = math.min(length, Detectors.LanguageDetectionLimit)
+    val charset =
+      if (limit <= 0) None
+      // wide encodings are full of NUL bytes, so trust the given byte order mark over the byte-level classification
+      else if (bom != "none" && bom != "unknown" && bom != "UTF-8") Some(bom)
+      else
+        // the byte-level classification short-circuits content that cannot be text
+        classifyContent(offset, limit) match {
+          case ContentClass.Empty | ContentClass.Binary | ContentClass.Unknown => None
+          case ContentClass.TextUtf16                                           => Some("UTF-16")
+          case ContentClass.TextUtf32                                           => Some("UTF-32")
+          case ContentClass.TextOther                                           => Some("ISO-8859-1")
+          case _                                                                => Some("UTF-8")
+        }
+    charset.fold("unknown") { cs =>
+      getSegment(offset, limit) match {
+        case Some(segment) =>
+          val content = new String(segment.data, cs)
+          val languageResult = Detectors.withLanguageDetector(_.detect(content))
+          if (languageResult.isReasonablyCertain) languageResult.getLanguage.toString else "unknown"
+        case None => throw new RuntimeException(s"Failed to get segment at offset $offset and length $length")
+      }
     }
+  }
 
   def destroy(): Unit =
     i.omega_edit_destroy_session(p)
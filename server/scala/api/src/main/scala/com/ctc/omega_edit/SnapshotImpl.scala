@@ -0,0 +1,140 @@
+/*
+ * Copyright 2021 Concurrent Technologies Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package com.ctc.omega_edit
+
+import com.ctc.omega_edit.api.{CharCounts, Segment, SegmentReader, Snapshot}
+import jnr.ffi.{Memory, Pointer}
+
+private[omega_edit] class SnapshotImpl(p: Pointer, i: FFI) extends Snapshot {
+  require(p != null, "native snapshot pointer was null")
+
+  def size: Long =
+    i.omega_snapshot_get_computed_file_size(p)
+
+  def numChanges: Long =
+    i.omega_snapshot_get_num_changes(p)
+
+  def reader(offset: Long, length: Long, chunkSize: Int): SegmentReader = {
+    require(chunkSize > 0, s"chunk size must be positive: $chunkSize")
+    require(0 <= offset && offset <= size, s"offset out of range: $offset")
+    val end = if (length == 0) size else offset + length
+    require(offset <= end && end <= size, s"length out of range: $length")
+    new SegmentReaderImpl(p, i, offset, end, chunkSize)
+  }
+
+  def getSegment(offset: Long, length: Long): Option[Segment] = {
+    val sp = i.omega_segment_create(length)
+    try
+      Option.when(i.omega_snapshot_get_segment(p, sp, offset) == 0) {
+        val out = Array.ofDim[Byte](i.omega_segment_get_length(sp).toInt)
+        i.omega_segment_get_data(sp).get(0, out, 0, out.length)
+        Segment(offset, out)
+      }
+    finally i.omega_segment_destroy(sp)
+  }
+
+  def profile(offset: Long, length: Long): Either[Int, Array[Long]] = {
+    val profileSize = i.omega_session_byte_frequency_profile_size()
+    val profilePtr = Memory.allocateDirect(p.getRuntime, profileSize * 8)
+    i.omega_snapshot_byte_frequency_profile(p, profilePtr, offset, length) match {
+      case 0 =>
+        val profile = new Array[Long](profileSize)
+        profilePtr.get(0, profile, 0, profileSize)
+        Right(profile)
+      case result => Left(result)
+    }
+  }
+
+  def charCount(offset: Long, length: Long, bom: String): Either[Int, CharCounts] = {
+    val bomValue = i.omega_util_cstring_to_BOM(bom)
+    val pCounts = i.omega_character_counts_create()
+    try
+      i.omega_snapshot_character_counts(p, pCounts, offset, length, bomValue) match {
+        case 0 =>
+          Right(
+            CharCounts(
+              i.omega_util_BOM_to_cstring(i.omega_character_counts_get_BOM(pCounts)).getString(0),
+              i.omega_character_counts_bom_bytes(pCounts),
+              i.omega_character_counts_single_byte_chars(pCounts),
+              i.omega_character_counts_double_byte_chars(pCounts),
+              i.omega_character_counts_triple_byte_chars(pCounts),
+              i.omega_character_counts_quad_byte_chars(pCounts),
+              i.omega_character_counts_invalid_bytes(pCounts)
+            )
+          )
+        case result => Left(result)
+      }
+    finally i.omega_character_counts_destroy(pCounts)
+  }
+
+  def detectContentType(offset: Long, length: Long): String =
+    getSegment(offset, math.min(length, Detectors.ContentTypeDetectionLimit)) match {
+      case Some(segment) => Detectors.detectContentType(segment.data)
+      case None          => throw new RuntimeException(s"Failed to get segment at offset $offset and length $length")
+    }
+
+  def search(pattern: Array[Byte], offset: Long, length: Long, limit: Option[Long] = None): List[Long] =
+    // one search context finds every match, so the snapshot range is read once rather than once per match
+    i.omega_snapshot_search_create_context(p, pattern, pattern.length.toLong, offset, length) match {
+      case null => List.empty[Long]
+      case context =>
+        try
+          Iterator
+            .unfold(0L) { numMatches =>
+              if (limit.exists(numMatches >= _)) None
+              else
+                i.omega_snapshot_search_next_match(context) match {
+                  case found if found >= 0 => Some(found -> (numMatches + 1))
+                  case _                   => None
+                }
+            }
+            .toList
+        finally i.omega_snapshot_search_destroy_context(context)
+    }
+
+  def destroy(): Unit =
+    i.omega_snapshot_destroy(p)
+}
+
+private[omega_edit] class SegmentReaderImpl(snapshot: Pointer, i: FFI, offset: Long, end: Long, chunkSize: Int)
+    extends SegmentReader {
+  private var position = offset
+  private var sp = i.omega_segment_create(chunkSize.toLong)
+  require(sp != null, "native segment pointer was null")
+
+  def next(): Option[Segment] =
+    if (sp == null || position >= end) None
+    else {
+      val result = i.omega_snapshot_get_segment(snapshot, sp, position)
+      if (result != 0)
+        throw new RuntimeException(s"Failed to read snapshot segment at offset $position")
+      val len = math.min(i.omega_segment_get_length(sp), end - position).toInt
+      if (len <= 0)
+        throw new RuntimeException(s"Snapshot segment at offset $position was empty")
+      val out = Array.ofDim[Byte](len)
+      i.omega_segment_get_data(sp).get(0, out, 0, len)
+      val segment = Segment(position, out)
+      position += len
+      Some(segment)
+    }
+
+  def close(): Unit =
+    if (sp != null) {
+      i.omega_segment_destroy(sp)
+      sp = null
+    }
+}
@@ -38,6 +38,15 @@ private[omega_edit] class ViewportImpl(p: Pointer, i: FFI) extends Viewport {
     out
   }
 
+  def data(offset: Long, length: Long): Array[Byte] = {
+    require(0 <= offset && 0 <= length && offset + length <= this.length, "range is outside the viewport data")
+    // getting the data refreshes the viewport, even if no bytes are copied
+    val data = i.omega_viewport_get_data(p)
+    val out = Array.ofDim[Byte](length.toInt)
+    if (0 < length) data.get(offset, out, 0, length.toInt)
+    out
+  }
+
   def callback: Option[ViewportCallback] =
     Option(i.omega_viewport_get_event_cbk(p))
 
@@ -0,0 +1,36 @@
+/*
+ * Copyright 2021 Concurrent Technologies Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package com.ctc.omega_edit.api
+
+import enumeratum.values.IntEnumEntry
+import enumeratum.values.IntEnum
+
+/** Defines the classes of content that can be determined cheaply from the bytes alone
+  */
+sealed abstract class ContentClass(val value: Int) extends IntEnumEntry
+object ContentClass extends IntEnum[ContentClass] {
+  // must match content classes defined in fwd_defs.h
+  case object Unknown extends ContentClass(0)
+  case object Empty extends ContentClass(1)
+  case object Binary extends ContentClass(2)
+  case object TextUtf8 extends ContentClass(3)
+  case object TextUtf16 extends ContentClass(4)
+  case object TextUtf32 extends ContentClass(5)
+  case object TextOther extends ContentClass(6)
+
+  val values: IndexedSeq[ContentClass] = findValues
+}
@@ -17,7 +17,7 @@
 package com.ctc.omega_edit.api
 
 import com.ctc.omega_edit.FFI.{i => ffi}
-import com.ctc.omega_edit.SessionImpl
+import com.ctc.omega_edit.{Detectors, SessionImpl}
 
 import java.nio.file.Path
 import scala.util.Try
@@ -53,6 +53,11 @@ object OmegaEdit extends OmegaEdit {
   def initialize(): Try[Version] =
     Try(version())
 
+  /** Load the shared content type and language detectors now, rather than on the first request that needs them
+    */
+  def warmupDetectors(): Unit =
+    Detectors.warmup()
+
   def version(): Version =
     Version(
       ffi.omega_version_major(),
@@ -50,6 +50,12 @@ trait Session {
   def undoLast(): Result
   def redoUndo(): Result
 
+  /** Discard the undone changes, so they can no longer be redone
+    * @return
+    *   number of undone changes discarded, or -1 if changes are paused
+    */
+  def discardUndone(): Long
+
   def clearChanges(): Result
 
   def getLastChange(): Option[Change]
@@ -76,6 +82,7 @@ trait Session {
   def charCount(offset: Long, length: Long, bom: Int): Either[Int, CharCounts]
   def charCount(offset: Long, length: Long, bom: String): Either[Int, CharCounts]
 
+  def classifyContent(offset: Long, length: Long): ContentClass
   def detectContentType(offset: Long, length: Long): String
   def detectLanguage(offset: Long, length: Long, bom: String): String
   def search(
@@ -89,9 +96,16 @@ trait Session {
 
   def getSegment(offset: Long, length: Long): Option[Segment]
 
+  /** Take a copy-on-write snapshot of the session, which can be read from any thread while the session keeps changing
+    * @return
+    *   snapshot that must be destroyed when no longer needed
+    */
+  def snapshot(): Snapshot
+
   def pauseSessionChanges(): Unit
   def resumeSessionChanges(): Unit
   def pauseViewportEvents(): Unit
+  def viewportEventsPaused: Boolean
   def resumeViewportEvents(): Unit
   def notifyChangedViewports: Int
   def beginTransaction: Int
@@ -0,0 +1,58 @@
+/*
+ * Copyright 2021 Concurrent Technologies Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package com.ctc.omega_edit.api
+
+/** A point-in-time, read-only view of a Session that is safe to read from threads other than the session owner
+  */
+trait Snapshot {
+  def size: Long
+  def numChanges: Long
+
+  /** Read the given range in chunks, reusing a single native segment so memory stays bounded by the chunk size
+    * @param offset
+    *   offset of the range in the snapshot
+    * @param length
+    *   length of the range, zero reads to the end of the snapshot
+    * @param chunkSize
+    *   maximum number of bytes in each chunk
+    * @return
+    *   chunk reader that must be closed when no longer needed
+    */
+  def reader(offset: Long, length: Long, chunkSize: Int): SegmentReader
+
+  def getSegment(offset: Long, length: Long): Option[Segment]
+  def profile(offset: Long, length: Long): Either[Int, Array[Long]]
+  def charCount(offset: Long, length: Long, bom: String): Either[Int, CharCounts]
+  def detectContentType(offset: Long, length: Long): String
+
+  /** Find the offsets of case-sensitive matches of the pattern, in order, including overlapping matches
+    */
+  def search(pattern: Array[Byte], offset: Long, length: Long, limit: Option[Long] = None): List[Long]
+
+  def destroy(): Unit
+}
+
+/** Sequential chunked reader over a range of a Snapshot
+  */
+trait SegmentReader extends AutoCloseable {
+
+  /** Read the next chunk of the range
+    * @return
+    *   next chunk, or None once the range has been exhausted
+    */
+  def next(): Option[Segment]
+}
@@ -22,6 +22,16 @@ trait Viewport {
   def length: Long
   def data: Array[Byte]
 
+  /** Copy only the given range of the viewport data
+    * @param offset
+    *   offset in the viewport data
+    * @param length
+    *   number of bytes to copy
+    * @return
+    *   copied bytes
+    */
+  def data(offset: Long, length: Long): Array[Byte]
+
   def callback: Option[ViewportCallback]
   def eventInterest: Int
   def eventInterest_=(eventInterest: Int): Unit
@@ -277,6 +277,24 @@ class SessionImplSpec extends AnyWordSpec with Matchers with SessionSupport {
     }
   }
 
+  "content" should {
+    "be classified from its bytes" in session(binary) { s =>
+      s.classifyContent(0, 0) shouldBe ContentClass.Binary
+      s.classifyContent(5, 2) shouldBe ContentClass.Binary
+      s.insert("text ".getBytes(), 0)
+      s.classifyContent(0, 5) shouldBe ContentClass.TextUtf8
+      s.detectLanguage(5, binary.length.toLong, "none") shouldBe "unknown"
+    }
+
+    "be classified as UTF-8 when the detection limit cuts a character" in emptySession { s =>
+      val text = ("a" + "\u00e9\u20ac\ud83d\ude00" * 8000).getBytes("UTF-8")
+      s.insert(text, 0)
+      (0L until 9L).foreach { extra =>
+        s.classifyContent(0, Detectors.LanguageDetectionLimit + extra) shouldBe ContentClass.TextUtf8
+      }
+    }
+  }
+
   "segments" should {
     "find stuff" in session(numbers) { s =>
       s.getSegment(3, 4) match {
@@ -285,5 +303,32 @@ class SessionImplSpec extends AnyWordSpec with Matchers with SessionSupport {
         case _ => fail()
       }
     }
+
+    "stream in chunks from a snapshot" in session(numbers) { s =>
+      val snapshot = s.snapshot()
+      try {
+        s.insert("abc".getBytes(), 0)
+        snapshot.size shouldBe numbers.length.toLong
+        val reader = snapshot.reader(1, 0, 3)
+        val chunks =
+          try Iterator.continually(reader.next()).takeWhile(_.isDefined).flatten.toList
+          finally reader.close()
+        chunks.map(_.offset) shouldBe List(1L, 4L, 7L)
+        chunks.map(c => new String(c.data)) shouldBe List("234", "567", "89")
+      } finally snapshot.destroy()
+    }
+
+    "be read from a snapshot" in session("abcabcabc".getBytes()) { s =>
+      val snapshot = s.snapshot()
+      try {
+        s.delete(0, 3)
+        snapshot.getSegment(3, 3).map(seg => new String(seg.data)) shouldBe Some("abc")
+        snapshot.search("abc".getBytes(), 0, 0) shouldBe List(0L, 3L, 6L)
+        snapshot.search("abc".getBytes(), 1, 7, Some(1)) shouldBe List(3L)
+        snapshot.profile(0, 0).map(_('a'.toInt)) shouldBe Right(3L)
+        snapshot.charCount(0, 0, "none").map(_.singleByteChars) shouldBe Right(9L)
+        s.search("abc".getBytes(), 0, 0) shouldBe List(0L, 3L)
+      } finally snapshot.destroy()
+    }
   }
 }
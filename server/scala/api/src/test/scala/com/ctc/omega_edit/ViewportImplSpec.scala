@@ -51,6 +51,13 @@ class ViewportImplSpec extends AnyWordSpec with Matchers with TestSupport {
       s.notifyChangedViewports shouldBe 0
     })
 
+    "copy a range" in session("abcdef")(view(1, 4, false, _) { (_, v) =>
+      v.data(0, 4) shouldBe "bcde".getBytes()
+      v.data(1, 2) shouldBe "cd".getBytes()
+      v.data(4, 0) shouldBe empty
+      an[IllegalArgumentException] should be thrownBy v.data(3, 2)
+    })
+
     "move" in session("abc")(view(1, 1, false, _) { (_, v) =>
       v.hasChanges shouldBe true
       v.data shouldBe "b".getBytes()
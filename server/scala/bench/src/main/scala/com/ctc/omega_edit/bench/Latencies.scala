@@ -0,0 +1,61 @@
+/*
+ * Copyright 2021 Concurrent Technologies Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package com.ctc.omega_edit.bench
+
+import java.util.Arrays
+
+/** Latencies of the calls made to one RPC, kept in full so percentiles are exact
+  */
+final class Latencies {
+  private var nanos = new Array[Long](1024)
+  private var count = 0
+  private var errors = 0
+
+  def record(elapsedNanos: Long): Unit = synchronized {
+    if (count == nanos.length) nanos = Arrays.copyOf(nanos, 2 * count)
+    nanos(count) = elapsedNanos
+    count += 1
+  }
+
+  def recordError(): Unit = synchronized {
+    errors += 1
+  }
+
+  def summary: Latencies.Summary = synchronized {
+    val sorted = Arrays.copyOf(nanos, count)
+    Arrays.sort(sorted)
+    Latencies.Summary(
+      count,
+      errors,
+      Latencies.percentile(sorted, 0.5),
+      Latencies.percentile(sorted, 0.99),
+      Latencies.percentile(sorted, 0.999),
+      if (count == 0) 0 else sorted(count - 1)
+    )
+  }
+}
+
+object Latencies {
+
+  /** Summary of the latencies of an RPC, in nanoseconds
+    */
+  final case class Summary(count: Int, errors: Int, p50: Long, p99: Long, p999: Long, max: Long)
+
+  // nearest-rank percentile of sorted latencies
+  private def percentile(sorted: Array[Long], p: Double): Long =
+    if (sorted.isEmpty) 0 else sorted(math.max(0, math.ceil(p * sorted.length).toInt - 1))
+}
@@ -0,0 +1,197 @@
+/*
+ * Copyright 2021 Concurrent Technologies Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package com.ctc.omega_edit.bench
+
+import org.apache.pekko
+import pekko.actor.ActorSystem
+import pekko.grpc.GrpcClientSettings
+import com.google.protobuf.ByteString
+import omega_edit._
+
+import java.util.concurrent.atomic.LongAdder
+import scala.collection.concurrent.TrieMap
+import scala.concurrent.duration._
+import scala.concurrent.{Await, ExecutionContext, Future}
+import scala.util.{Failure, Random, Success}
+
+object LoadTest {
+
+  /** Load test parameters
+    * @param clients
+    *   number of simulated clients, each with a session and a connection of its own
+    * @param viewports
+    *   number of viewports each client creates and scrolls
+    * @param duration
+    *   how long each client runs the workload
+    * @param size
+    *   initial size of each session, in bytes
+    * @param seed
+    *   seed of the random workload, so runs with the same parameters make the same calls
+    */
+  final case class Config(clients: Int, viewports: Int, duration: FiniteDuration, size: Int, seed: Long)
+
+  val ViewportCapacity: Long = 1024
+  val MaxEditLength: Int = 16
+  val MaxSearchMatches: Long = 16
+}
+
+/** Simulates clients that each make one call at a time: edits (inserts, overwrites and deletes), viewport data reads,
+  * viewport scrolls, and searches, in a 40/20/20/20 mix, while subscribed to the events of their session and viewports.
+  * Reports latency percentiles per RPC and the rate of calls and events.
+  */
+class LoadTest(iface: String, port: Int, config: LoadTest.Config) {
+  import LoadTest._
+
+  implicit val sys: ActorSystem = ActorSystem("omega-edit-grpc-bench")
+  implicit val ec: ExecutionContext = sys.dispatcher
+
+  private val latencies = TrieMap.empty[String, Latencies]
+  private val sessionEvents = new LongAdder
+  private val viewportEvents = new LongAdder
+
+  def run(): Unit = {
+    val clients = List.fill(config.clients)(
+      EditorClient(GrpcClientSettings.connectToServiceAt(iface, port).withTls(false))
+    )
+    val start = System.nanoTime()
+    val done = Future.traverse(clients.zipWithIndex) { case (client, n) =>
+      simulate(client, new Random(config.seed + n))
+    }
+    try Await.result(done, config.duration + 1.minute)
+    finally {
+      val elapsed = (System.nanoTime() - start).nanos
+      report(elapsed)
+      Await.result(Future.traverse(clients)(_.close()), 10.seconds)
+      Await.result(sys.terminate(), 10.seconds)
+    }
+    ()
+  }
+
+  private def timed[A](rpc: String)(call: => Future[A]): Future[A] = {
+    val recorder = latencies.getOrElseUpdate(rpc, new Latencies)
+    val start = System.nanoTime()
+    call.andThen {
+      case Success(_) => recorder.record(System.nanoTime() - start)
+      case Failure(_) => recorder.recordError()
+    }
+  }
+
+  private def printable(random: Random, length: Int): ByteString =
+    ByteString.copyFrom(Array.fill(length)((' ' + random.nextInt(95)).toByte))
+
+  private def simulate(client: EditorClient, random: Random): Future[Unit] =
+    for {
+      session <- timed("CreateSession")(client.createSession(CreateSessionRequest()))
+      sid = session.sessionId
+      _ <- timed("SubmitChange")(
+        client.submitChange(
+          ChangeRequest(sid, ChangeKind.CHANGE_INSERT, 0, config.size.toLong, Some(printable(random, config.size)))
+        )
+      )
+      _ = client.subscribeToSessionEvents(EventSubscriptionRequest(sid)).runForeach(_ => sessionEvents.increment())
+      viewports <- Future.traverse((0 until config.viewports).toList) { _ =>
+        timed("CreateViewport")(
+          client.createViewport(
+            CreateViewportRequest(sid, ViewportCapacity, random.nextLong(config.size.toLong + 1), isFloating = false)
+          )
+        )
+      }
+      viewportIds = viewports.map(_.viewportId).toVector
+      _ = viewportIds.foreach { vid =>
+        client.subscribeToViewportEvents(EventSubscriptionRequest(vid)).runForeach(_ => viewportEvents.increment())
+      }
+      _ <- workload(client, sid, viewportIds, random, config.duration.fromNow, config.size.toLong)
+      _ <- Future.traverse(viewportIds)(vid => timed("DestroyViewport")(client.destroyViewport(ObjectId(vid))))
+      _ <- timed("DestroySession")(client.destroySession(ObjectId(sid)))
+    } yield ()
+
+  /* Make one call after another until the deadline, keeping the session between half and twice its initial size.
+   * Calls that fail are counted as errors and the workload goes on.
+   */
+  private def workload(
+      client: EditorClient,
+      sid: String,
+      viewportIds: Vector[String],
+      random: Random,
+      deadline: Deadline,
+      size: Long
+  ): Future[Unit] =
+    if (deadline.isOverdue()) Future.unit
+    else {
+      val length = 1 + random.nextInt(MaxEditLength)
+      val dice = random.nextInt(100)
+      val call: Future[Long] =
+        if (dice < 40) {
+          val kind =
+            if (size < config.size / 2) ChangeKind.CHANGE_INSERT
+            else if (size > 2L * config.size) ChangeKind.CHANGE_DELETE
+            else
+              random.nextInt(3) match {
+                case 0 => ChangeKind.CHANGE_INSERT
+                case 1 => ChangeKind.CHANGE_OVERWRITE
+                case _ => ChangeKind.CHANGE_DELETE
+              }
+          val (offset, data, newSize) = kind match {
+            case ChangeKind.CHANGE_INSERT =>
+              (random.nextLong(size + 1), Some(printable(random, length)), size + length)
+            case ChangeKind.CHANGE_OVERWRITE =>
+              (random.nextLong(size - length + 1), Some(printable(random, length)), size)
+            case _ =>
+              (random.nextLong(size - length + 1), None, size - length)
+          }
+          timed("SubmitChange")(client.submitChange(ChangeRequest(sid, kind, offset, length.toLong, data)))
+            .map(_ => newSize)
+        } else if (dice < 60 && viewportIds.nonEmpty) {
+          // clients poll the data of their viewports, which only goes through the viewport routing of the server
+          val vid = viewportIds(random.nextInt(viewportIds.length))
+          timed("GetViewportData")(client.getViewportData(ViewportDataRequest(vid))).map(_ => size)
+        } else if (dice < 80 && viewportIds.nonEmpty) {
+          val vid = viewportIds(random.nextInt(viewportIds.length))
+          val offset = random.nextLong(math.max(0L, size - ViewportCapacity) + 1)
+          timed("ModifyViewport")(client.modifyViewport(ModifyViewportRequest(vid, offset, ViewportCapacity)))
+            .map(_ => size)
+        } else {
+          val pattern = printable(random, 2)
+          val offset = random.nextLong(size + 1)
+          timed("SearchSession")(
+            client.searchSession(
+              SearchRequest(sid, pattern, offset = Some(offset), limit = Some(MaxSearchMatches))
+            )
+          ).map(_ => size)
+        }
+      call
+        .recover { case _ => size }
+        .flatMap(workload(client, sid, viewportIds, random, deadline, _))
+    }
+
+  private def report(elapsed: FiniteDuration): Unit = {
+    val seconds = elapsed.toNanos / 1e9
+    def ms(nanos: Long): Double = nanos / 1e6
+
+    println(f"${config.clients}%d clients with ${config.viewports}%d viewports each for $seconds%.1f s")
+    println(f"${"rpc"}%-16s ${"calls"}%9s ${"errors"}%7s ${"p50 ms"}%9s ${"p99 ms"}%9s ${"p999 ms"}%9s ${"max ms"}%9s")
+    val summaries = latencies.toList.sortBy(_._1).map { case (rpc, l) => rpc -> l.summary }
+    summaries.foreach { case (rpc, s) =>
+      val row = List(s.p50, s.p99, s.p999, s.max).map(nanos => f"${ms(nanos)}%9.3f").mkString(" ")
+      println(f"$rpc%-16s ${s.count}%9d ${s.errors}%7d $row")
+    }
+    val calls = summaries.map(_._2.count.toLong).sum
+    println(f"calls: $calls%d (${calls / seconds}%.1f/s)")
+    println(f"session events: ${sessionEvents.sum()}%d (${sessionEvents.sum() / seconds}%.1f/s)")
+    println(f"viewport events: ${viewportEvents.sum()}%d (${viewportEvents.sum() / seconds}%.1f/s)")
+  }
+}
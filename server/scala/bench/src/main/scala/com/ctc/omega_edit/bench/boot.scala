@@ -0,0 +1,76 @@
+/*
+ * Copyright 2021 Concurrent Technologies Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package com.ctc.omega_edit.bench
+
+import cats.implicits.catsSyntaxTuple7Semigroupal
+import com.monovore.decline._
+
+import scala.concurrent.duration.DurationInt
+
+object boot
+    extends CommandApp(
+      name = "omega-edit-grpc-bench",
+      header = "Ωedit gRPC server load test",
+      main = {
+        val default_interface =
+          scala.util.Properties.envOrElse("OMEGA_EDIT_SERVER_HOST", "127.0.0.1")
+        val interface_opt = Opts
+          .option[String](
+            "interface",
+            short = "i",
+            metavar = "interface_str",
+            help = s"Set the gRPC interface of the server. Default: $default_interface"
+          )
+          .withDefault(default_interface)
+
+        val default_port =
+          scala.util.Properties.envOrElse("OMEGA_EDIT_SERVER_PORT", "9000")
+        val port_opt = Opts
+          .option[Int](
+            "port",
+            short = "p",
+            metavar = "port_num",
+            help = s"Set the gRPC port of the server. Default: $default_port"
+          )
+          .withDefault(default_port.toInt)
+
+        val clients_opt = Opts
+          .option[Int]("clients", short = "c", metavar = "count", help = "Number of simulated clients. Default: 4")
+          .withDefault(4)
+
+        val viewports_opt = Opts
+          .option[Int]("viewports", short = "v", metavar = "count", help = "Number of viewports per client. Default: 4")
+          .withDefault(4)
+
+        val duration_opt = Opts
+          .option[Int]("duration", short = "d", metavar = "seconds", help = "Seconds to run the workload. Default: 30")
+          .withDefault(30)
+
+        val size_opt = Opts
+          .option[Int]("size", short = "s", metavar = "bytes", help = "Initial size of each session. Default: 1048576")
+          .withDefault(1024 * 1024)
+
+        val seed_opt = Opts
+          .option[Long]("seed", metavar = "seed", help = "Seed of the random workload. Default: 0")
+          .withDefault(0L)
+
+        (interface_opt, port_opt, clients_opt, viewports_opt, duration_opt, size_opt, seed_opt).mapN {
+          (interface, port, clients, viewports, duration, size, seed) =>
+            new LoadTest(interface, port, LoadTest.Config(clients, viewports, duration.seconds, size, seed)).run()
+        }
+      }
+    )
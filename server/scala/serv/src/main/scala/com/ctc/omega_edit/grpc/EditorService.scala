@@ -21,7 +21,7 @@ import com.ctc.omega_edit.api.{OmegaEdit, Version}
 import com.ctc.omega_edit.grpc.EditorService._
 import com.ctc.omega_edit.grpc.Editors._
 import com.ctc.omega_edit.grpc.Session._
-import com.google.protobuf.ByteString
+import com.google.protobuf.{ByteString, UnsafeByteOperations}
 import com.google.protobuf.empty.Empty
 import io.grpc.Status
 import omega_edit._
@@ -36,9 +36,9 @@ import org.apache.pekko.util.Timeout
 import java.lang.management.ManagementFactory
 import java.nio.file.Paths
 import scala.concurrent.ExecutionContext.Implicits.global
-import scala.concurrent.duration.DurationInt
-import scala.concurrent.{Await, ExecutionContext, Future}
-import scala.util.{Failure, Success}
+import scala.concurrent.duration.{Duration, DurationInt, FiniteDuration}
+import scala.concurrent.{Await, ExecutionContext, Future, Promise}
+import scala.util.{Failure, Success, Try}
 
 class EditorService(implicit val system: ActorSystem) extends Editor {
   private implicit val timeout: Timeout = Timeout(20.seconds)
@@ -214,7 +214,8 @@ class EditorService(implicit val system: ActorSystem) extends Editor {
                 offset = ok.offset,
                 length = ok.data.size.toLong,
                 data = ok.data,
-                followingByteCount = ok.followingByteCount
+                followingByteCount = ok.followingByteCount,
+                sequence = Some(ok.sequence)
               )
           case Ok(id) =>
             throw grpcFailure(
@@ -250,7 +251,8 @@ class EditorService(implicit val system: ActorSystem) extends Editor {
                 offset = ok.offset,
                 length = ok.data.size.toLong,
                 data = ok.data,
-                followingByteCount = ok.followingByteCount
+                followingByteCount = ok.followingByteCount,
+                sequence = Some(ok.sequence)
               )
           case Ok(id) =>
             throw grpcFailure(
@@ -320,6 +322,49 @@ class EditorService(implicit val system: ActorSystem) extends Editor {
         grpcFailFut(Status.INVALID_ARGUMENT, "undefined change kind")
     }
 
+  /** Apply a stream of changes to a session, in order, in batches of up to ChangeBatchSize changes. Each batch is
+    * applied by the session actor as a single change transaction, so a large import costs one actor round trip per
+    * batch rather than per change.
+    */
+  def submitChanges(in: Source[ChangeRequest, NotUsed]): Future[ChangesResponse] =
+    in.groupedWithin(ChangeBatchSize, ChangeBatchWindow)
+      .mapAsync(1)(submitBatch)
+      .runFold(Option.empty[ChangesResponse]) {
+        case (None, batch) => Some(batch)
+        case (Some(acc), batch) if acc.sessionId != batch.sessionId =>
+          throw grpcFailure(Status.INVALID_ARGUMENT, "all changes must be submitted to the same session")
+        case (Some(acc), batch) =>
+          Some(
+            acc.copy(
+              lastSerial = batch.lastSerial,
+              changeCount = acc.changeCount + batch.changeCount,
+              batchCount = acc.batchCount + batch.batchCount
+            )
+          )
+      }
+      .flatMap {
+        case Some(res) => Future.successful(res)
+        case None      => grpcFailFut(Status.INVALID_ARGUMENT, "no changes submitted")
+      }
+
+  private def submitBatch(batch: Seq[ChangeRequest]): Future[ChangesResponse] = {
+    val sessionId = batch.head.sessionId
+    if (batch.exists(_.sessionId != sessionId))
+      grpcFailFut(Status.INVALID_ARGUMENT, "all changes must be submitted to the same session")
+    else
+      batch.map(Session.Op.unapply) match {
+        case ops if ops.forall(_.isDefined) =>
+          (editors ? SessionOp(sessionId, Session.SubmitBatch(ops.flatten))).mapTo[Result].flatMap {
+            case ok: Ok with SerialRange =>
+              Future.successful(ChangesResponse(ok.id, ok.firstSerial, ok.lastSerial, ok.count, 1))
+            case Err(c) => grpcFailFut(c)
+            case _      => grpcFailFut(Status.UNKNOWN, s"unable to submit changes to session '$sessionId'")
+          }
+        case _ =>
+          grpcFailFut(Status.INVALID_ARGUMENT, "undefined change kind")
+      }
+  }
+
   def getChangeDetails(in: SessionEvent): Future[ChangeDetailsResponse] =
     in.serial match {
       case None =>
@@ -413,23 +458,27 @@ class EditorService(implicit val system: ActorSystem) extends Editor {
     */
   def subscribeToSessionEvents(
       in: EventSubscriptionRequest
-  ): Source[SessionEvent, NotUsed] = {
-    val f = (editors ? SessionOp(in.id, Session.Watch(in.interest)))
-      .mapTo[Result]
-      .map {
-        case ok: Ok with Session.Events => ok.stream
-        case _                          => Source.failed(grpcFailure(Status.UNKNOWN))
-      }
-    Await.result(f, 1.second)
-  }
+  ): Source[SessionEvent, NotUsed] =
+    EventQueue.Options.of(in) match {
+      case Left(reason) => Source.failed(grpcFailure(Status.INVALID_ARGUMENT, reason))
+      case Right(options) =>
+        val f = (editors ? SessionOp(in.id, Session.Watch(in.interest, options)))
+          .mapTo[Result]
+          .map {
+            case ok: Ok with Session.Events => ok.stream
+            case _                          => Source.failed(grpcFailure(Status.UNKNOWN))
+          }
+        Await.result(f, 1.second)
+    }
 
   def subscribeToViewportEvents(
       in: EventSubscriptionRequest
   ): Source[ViewportEvent, NotUsed] =
-    ObjectId(in.id) match {
-      case Viewport.Id(sid, vid) =>
+    (ObjectId(in.id), EventQueue.Options.of(in)) match {
+      case (_, Left(reason)) => Source.failed(grpcFailure(Status.INVALID_ARGUMENT, reason))
+      case (Viewport.Id(sid, vid), Right(options)) =>
         val f =
-          (editors ? ViewportOp(sid, vid, Viewport.Watch(in.interest)))
+          (editors ? ViewportOp(sid, vid, Viewport.Watch(in.interest, options, in.viewportDeltas.getOrElse(false))))
             .mapTo[Result]
             .map {
               case ok: Ok with Viewport.Events => ok.stream
@@ -572,6 +621,63 @@ class EditorService(implicit val system: ActorSystem) extends Editor {
           )
       }
 
+  /** Stream a range of the session in chunks, read from a snapshot taken when the request arrives so that later edits
+    * neither block nor tear the stream. Chunks are only read as the client demands them, so memory stays bounded by
+    * the chunk size regardless of the length of the range.
+    */
+  def streamSegment(in: StreamSegmentRequest): Source[SegmentResponse, NotUsed] = {
+    val chunkSize = in.chunkSize.getOrElse(DefaultStreamChunkSize)
+    if (chunkSize <= 0 || chunkSize > MaxStreamChunkSize)
+      Source.failed(grpcFailure(Status.INVALID_ARGUMENT, s"chunk size out of range: $chunkSize"))
+    else
+      // the snapshot is taken inside create, which runs on the blocking IO dispatcher, so that close releases it
+      // however the stream ends, including cancellation before the first chunk is pulled
+      Source.unfoldResource[SegmentResponse, (api.Snapshot, api.SegmentReader)](
+        () => {
+          val snapshot = takeSnapshot(in.sessionId)
+          try {
+            val end = if (in.length == 0) snapshot.size else in.offset + in.length
+            if (in.offset < 0 || in.length < 0 || end > snapshot.size)
+              throw grpcFailure(Status.OUT_OF_RANGE, s"range out of bounds: $in")
+            (snapshot, snapshot.reader(in.offset, end - in.offset, chunkSize.toInt))
+          } catch {
+            case e: Throwable =>
+              snapshot.destroy()
+              throw e
+          }
+        },
+        // the chunk array is freshly allocated and never mutated, so it can be wrapped without a copy
+        _._2.next().map { case api.Segment(offset, data) =>
+          SegmentResponse.of(in.sessionId, offset, UnsafeByteOperations.unsafeWrap(data))
+        },
+        { case (snapshot, reader) =>
+          try reader.close()
+          finally snapshot.destroy()
+        }
+      )
+  }
+
+  /** Block until the session has taken a snapshot, for use on a dispatcher that may block; the ask timeout bounds the
+    * wait. If the ask fails, the session is told to destroy any snapshot it takes afterwards, and one that raced in is
+    * destroyed here.
+    */
+  private def takeSnapshot(sessionId: String): api.Snapshot = {
+    val into = Promise[api.Snapshot]()
+    val reply =
+      Try(Await.result((editors ? SessionOp(sessionId, Session.TakeSnapshot(into))).mapTo[Result], Duration.Inf))
+    into.tryFailure(grpcFailure(Status.CANCELLED, s"snapshot of session '$sessionId' abandoned"))
+    (reply, into.future.value) match {
+      case (Success(Ok(_)), Some(Success(snapshot))) => snapshot
+      case (_, taken) =>
+        taken.foreach(_.foreach(_.destroy()))
+        reply match {
+          case Success(Err(c)) => throw grpcFailure(c)
+          case Failure(e)      => throw e
+          case _               => throw grpcFailure(Status.UNKNOWN, s"unable to snapshot session '$sessionId'")
+        }
+    }
+  }
+
   def serverControl(in: ServerControlRequest): Future[ServerControlResponse] =
     in.kind match {
       case ServerControlKind.SERVER_CONTROL_GRACEFUL_SHUTDOWN =>
@@ -611,6 +717,13 @@ object EditorService {
         system.terminate()
       }
 
+  val ChangeBatchSize: Int = 1024
+  val ChangeBatchWindow: FiniteDuration = 50.millis
+
+  val DefaultStreamChunkSize: Long = 1024L * 1024L
+  // stay below the default gRPC maximum message size of 4 MiB
+  val MaxStreamChunkSize: Long = 3L * 1024L * 1024L
+
   def getServerPID(): Int =
     ManagementFactory.getRuntimeMXBean().getName().split('@')(0).toInt
 
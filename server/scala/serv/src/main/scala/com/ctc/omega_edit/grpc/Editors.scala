@@ -19,8 +19,6 @@ package com.ctc.omega_edit.grpc
 import org.apache.pekko
 import pekko.actor.{Actor, ActorLogging, Props}
 import pekko.pattern.gracefulStop
-import pekko.stream.OverflowStrategy
-import pekko.stream.scaladsl.Source
 import pekko.util.Timeout
 import com.ctc.omega_edit.api.{OmegaEdit, SessionCallback}
 import com.ctc.omega_edit.grpc.Session.CheckpointDirectory
@@ -31,7 +29,6 @@ import omega_edit._
 import java.nio.file.Path
 import java.util.{Base64, UUID}
 import scala.concurrent.duration.DurationInt
-import scala.util.{Failure, Success}
 import scala.concurrent.Future
 
 /** The Editors actor manages the backend Sessions
@@ -64,6 +61,7 @@ object Editors {
     def data: ByteString
     def offset: Long
     def followingByteCount: Long
+    def sequence: Long
   }
 
   trait BooleanResult {
@@ -81,6 +79,8 @@ class Editors extends Actor with ActorLogging {
   import Editors._
   implicit val timeout: Timeout = Timeout(20.seconds)
 
+  private val viewports = new ViewportRegistry
+
   def receive: Receive = {
     case Create(sid, path, chkptDir) =>
       val id = sid.getOrElse(idFor(path))
@@ -94,11 +94,9 @@ class Editors extends Actor with ActorLogging {
           val originalSender = sender()
 
           Future {
-            val (input, stream) = Source
-              .queue[SessionEvent](8, OverflowStrategy.backpressure)
-              .preMaterialize()
+            val events = new EventQueue[SessionEvent]
             val cb = SessionCallback { (session, event, change) =>
-              input.queue.offer(
+              events.offer(
                 SessionEvent.defaultInstance
                   .copy(
                     sessionId = id,
@@ -109,18 +107,18 @@ class Editors extends Actor with ActorLogging {
                     undoCount = session.numUndos
                   )
               )
-              ()
             }
 
             val session = OmegaEdit.newSessionCb(path, chkptDir, cb)
 
-            (session, stream, cb)
-          }.map { case (session, stream, cb) =>
+            (session, events, cb)
+          }.map { case (session, events, cb) =>
             context.actorOf(
               Session.props(
                 session,
-                stream,
-                cb
+                events,
+                cb,
+                viewports
               ),
               id
             )
@@ -158,17 +156,9 @@ class Editors extends Actor with ActorLogging {
       }
 
     case ViewportOp(sid, vid, op) =>
-      val replyTo = sender()
-      context.child(sid) match {
-        case None =>
-        case Some(s) =>
-          context
-            .actorSelection(s.path / vid)
-            .resolveOne()
-            .onComplete {
-              case Success(v) => v.tell(op, replyTo)
-              case Failure(_) => replyTo ! Err(Status.NOT_FOUND)
-            }(context.dispatcher)
+      viewports.lookup(s"$sid:$vid") match {
+        case None    => sender() ! Err(Status.NOT_FOUND.withDescription("viewport not found"))
+        case Some(v) => v forward op
       }
 
     case LogOp(logType, error) =>
@@ -0,0 +1,129 @@
+/*
+ * Copyright 2021 Concurrent Technologies Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package com.ctc.omega_edit.grpc
+
+import org.apache.pekko
+import pekko.NotUsed
+import pekko.grpc.GrpcServiceException
+import pekko.stream.{Materializer, OverflowStrategy}
+import pekko.stream.scaladsl.{Source, SourceQueueWithComplete}
+import io.grpc.Status
+import omega_edit.{EventOverflowPolicy, EventSubscriptionRequest}
+
+import java.util.concurrent.atomic.AtomicInteger
+import scala.concurrent.{ExecutionContext, Future}
+
+/** Queues the events of a session or viewport for its subscriber. Native callbacks offer events without waiting, and
+  * every subscription gets a queue of its own, with the depth and overflow policy it asked for, so a slow subscriber
+  * only loses or holds back its own events. A new subscription completes the stream of the one it replaces, once the
+  * events offered to it are in.
+  *
+  * A queue that backpressures takes one offer at a time, so each offer is chained on the one before it, and events
+  * held back wait in the chain rather than being dropped. The chain is capped at `MaxPendingOffers`: a subscriber that
+  * falls further behind has its stream failed with `RESOURCE_EXHAUSTED` and stops receiving events until it subscribes
+  * again.
+  */
+final class EventQueue[A] {
+  private var queue: Option[SourceQueueWithComplete[A]] = None
+  private var lastOffer: Future[Any] = Future.unit
+  private var pendingOffers = new AtomicInteger
+
+  def subscribe(options: EventQueue.Options)(implicit mat: Materializer): Source[A, NotUsed] = {
+    val (input, stream) = Source
+      .queue[A](options.depth, options.overflowStrategy)
+      .preMaterialize() // preMaterialize the queue so events can be offered before the stream is run
+    synchronized {
+      completeQueue()
+      queue = Some(input)
+    }
+    stream
+  }
+
+  def offer(event: A): Unit = synchronized {
+    queue.foreach { q =>
+      if (pendingOffers.incrementAndGet() > EventQueue.MaxPendingOffers) {
+        q.fail(
+          new GrpcServiceException(
+            Status.RESOURCE_EXHAUSTED.withDescription("subscriber fell too far behind the events offered to it")
+          )
+        )
+        queue = None
+        lastOffer = Future.unit
+      } else {
+        val pending = pendingOffers
+        // the offer goes ahead whatever became of the previous one, which only fails once the queue is completed
+        lastOffer = lastOffer.transformWith(_ => q.offer(event))(ExecutionContext.parasitic)
+        lastOffer.onComplete(_ => pending.decrementAndGet())(ExecutionContext.parasitic)
+      }
+    }
+  }
+
+  def complete(): Unit = synchronized {
+    completeQueue()
+    queue = None
+  }
+
+  // the queue is completed once the events offered to it are in, so the subscriber gets them before its stream ends
+  private def completeQueue(): Unit = {
+    queue.foreach(q => lastOffer.onComplete(_ => q.complete())(ExecutionContext.parasitic))
+    lastOffer = Future.unit
+    pendingOffers = new AtomicInteger
+  }
+}
+
+object EventQueue {
+  val DefaultDepth: Int = 8
+  val MaxDepth: Int = 4096
+
+  /** Number of offers a queue holds back before failing its subscription */
+  val MaxPendingOffers: Int = 4096
+
+  /** How events are queued for a subscriber
+    * @param depth
+    *   number of events held for the subscriber
+    * @param policy
+    *   what to do with new events when the queue is full
+    */
+  final case class Options(depth: Int, policy: EventOverflowPolicy) {
+    def overflowStrategy: OverflowStrategy =
+      policy match {
+        case EventOverflowPolicy.EVENT_OVERFLOW_BACKPRESSURE => OverflowStrategy.backpressure
+        case _                                               => OverflowStrategy.dropHead
+      }
+
+    /** Whether the subscriber can miss events, in which case events should not depend on the ones before them */
+    def isLossy: Boolean = policy != EventOverflowPolicy.EVENT_OVERFLOW_BACKPRESSURE
+  }
+
+  object Options {
+    val Default: Options = Options(DefaultDepth, EventOverflowPolicy.EVENT_OVERFLOW_BACKPRESSURE)
+
+    /** Read the options of a subscription request
+      * @return
+      *   options of the subscription, or why they are invalid
+      */
+    def of(in: EventSubscriptionRequest): Either[String, Options] = {
+      val depth = in.queueDepth.getOrElse(DefaultDepth)
+      in.overflowPolicy.getOrElse(EventOverflowPolicy.EVENT_OVERFLOW_BACKPRESSURE) match {
+        case EventOverflowPolicy.Unrecognized(value)                => Left(s"unknown overflow policy: $value")
+        case conflate @ EventOverflowPolicy.EVENT_OVERFLOW_CONFLATE => Right(Options(1, conflate))
+        case _ if depth <= 0 || depth > MaxDepth                    => Left(s"queue depth out of range: $depth")
+        case policy                                                 => Right(Options(depth, policy))
+      }
+    }
+  }
+}
@@ -19,7 +19,7 @@ package com.ctc.omega_edit.grpc
 import org.apache.pekko
 import pekko.NotUsed
 import pekko.actor.{Actor, Props}
-import pekko.stream.OverflowStrategy
+import pekko.pattern.pipe
 import pekko.stream.scaladsl.Source
 import io.grpc.Status
 import com.ctc.omega_edit.grpc.Session._
@@ -30,10 +30,10 @@ import omega_edit._
 
 import java.nio.file.Path
 import scala.collection.immutable.ArraySeq
+import scala.concurrent.{ExecutionContext, Future, Promise}
 import scala.util.{Failure, Success}
 import com.google.protobuf.ByteString
 
-import scala.annotation.unused
 
 object Session {
   type EventStream = Source[SessionEvent, NotUsed]
@@ -52,10 +52,11 @@ object Session {
 
   def props(
       session: api.Session,
-      events: EventStream,
-      cb: SessionCallback
+      events: EventQueue[SessionEvent],
+      cb: SessionCallback,
+      viewports: ViewportRegistry
   ): Props =
-    Props(new Session(session, events, cb))
+    Props(new Session(session, events, cb, viewports))
 
   sealed trait Op
   object Op {
@@ -83,7 +84,7 @@ object Session {
 
   case object Destroy extends Op
 
-  case class Watch(eventInterest: Option[Int]) extends Op
+  case class Watch(eventInterest: Option[Int], options: EventQueue.Options = EventQueue.Options.Default) extends Op
   case object Unwatch extends Op
 
   case object GetSize extends Op
@@ -116,6 +117,7 @@ object Session {
   case class Search(request: SearchRequest) extends Op
 
   case class Segment(request: SegmentRequest) extends Op
+  case class TakeSnapshot(into: Promise[api.Snapshot]) extends Op
 
   case class PauseSession() extends Op
   case class ResumeSession() extends Op
@@ -123,6 +125,8 @@ object Session {
   case class PauseViewportEvents() extends Op
   case class ResumeViewportEvents() extends Op
 
+  case class SubmitBatch(changes: Seq[Op]) extends Op
+
   case class BeginTransaction() extends Op
   case class EndTransaction() extends Op
 
@@ -139,6 +143,21 @@ object Session {
       }
   }
 
+  trait SerialRange {
+    def firstSerial: Long
+    def lastSerial: Long
+    def count: Long
+  }
+
+  object SerialRange {
+    def ok(sessionId: String, serials: Seq[Long]): Ok with SerialRange =
+      new Ok(sessionId) with SerialRange {
+        val firstSerial: Long = serials.headOption.getOrElse(0L)
+        val lastSerial: Long = serials.lastOption.getOrElse(0L)
+        val count: Long = serials.length.toLong
+      }
+  }
+
   trait CheckpointDirectory {
     def checkpointDirectory: Path
     def fileSize: Long
@@ -182,15 +201,85 @@ object Session {
 
 class Session(
     session: api.Session,
-    events: EventStream,
-    @unused cb: SessionCallback // need to keep a reference to the callback to prevent it from being GC'd
+    events: EventQueue[SessionEvent],
+    cb: SessionCallback, // need to keep a reference to the callback to prevent it from being GC'd
+    viewports: ViewportRegistry
 ) extends Actor {
   val sessionId: String = self.path.name
 
+  override def postStop(): Unit =
+    events.complete()
+
+  private val readers: ExecutionContext = context.system.dispatchers.lookup("omega-edit.reader-dispatcher")
+
+  /** Answer a read-only request from a snapshot on the reader dispatcher. The snapshot is taken here, in message order,
+    * so the reply reflects every change received before the request, while the read itself neither waits for nor holds
+    * up the edits that follow it.
+    */
+  private def read(f: api.Snapshot => Any): Unit = {
+    val snapshot = session.snapshot()
+    pipe(Future(try f(snapshot) finally snapshot.destroy())(readers))(readers).to(sender())
+    ()
+  }
+
+  /** Apply a single change, returning its serial, or a non-positive value if it could not be applied
+    */
+  private def applyChange(op: Op): Long =
+    (op match {
+      case Insert(data, offset)    => session.insert(data.toByteArray, offset)
+      case Overwrite(data, offset) => session.overwrite(data.toByteArray, offset)
+      case Delete(offset, length)  => session.delete(offset, length)
+      case _                       => Change.Changed(0)
+    }) match {
+      case Change.Changed(serial) => serial
+    }
+
+  /** Apply a batch of changes as one change transaction. Per-change edit events and viewport events are held back
+    * while the batch is applied, then a single edit event is emitted for the batch and changed viewports are notified
+    * once. If any change fails, the changes already applied from the batch are rolled back, and cannot be redone. A
+    * batch is rejected while the client has a transaction of its own open, because rolling back the batch would undo
+    * the whole client transaction.
+    */
+  private def applyBatch(changes: Seq[Op]): Result =
+    // beginning a transaction fails if the client already has one open
+    if (session.beginTransaction != 0)
+      Err(Status.FAILED_PRECONDITION.withDescription("a batch cannot be submitted inside a change transaction"))
+    else {
+      val interest = session.eventInterest
+      val viewportEventsPaused = session.viewportEventsPaused
+      session.eventInterest = interest & ~(api.SessionEvent.Edit.value | api.SessionEvent.Undo.value)
+      if (!viewportEventsPaused) session.pauseViewportEvents()
+      val serials = Vector.newBuilder[Long]
+      val failedAt =
+        try
+          changes.indexWhere { op =>
+            val serial = applyChange(op)
+            if (serial > 0) serials += serial
+            serial <= 0
+          }
+        finally session.endTransaction
+      val applied = serials.result()
+      if (failedAt >= 0 && applied.nonEmpty) {
+        session.undoLast()
+        session.discardUndone()
+      }
+      session.eventInterest = interest
+      if (!viewportEventsPaused) {
+        session.resumeViewportEvents()
+        session.notifyChangedViewports
+      }
+      if (failedAt >= 0)
+        Err(Status.INVALID_ARGUMENT.withDescription(s"change $failedAt of the batch could not be applied"))
+      else {
+        if (applied.nonEmpty && (interest & api.SessionEvent.Edit.value) != 0)
+          cb.handle(session, api.SessionEvent.Edit, session.getLastChange())
+        SerialRange.ok(sessionId, applied)
+      }
+    }
+
   def receive: Receive = {
 
     case View(off, cap, isFloating, id) =>
-      import context.system
       val vid = id.getOrElse(Viewport.Id.uuid())
       val fqid = s"$sessionId:$vid"
 
@@ -198,28 +287,15 @@ class Session(
         case Some(_) =>
           sender() ! Err(Status.ALREADY_EXISTS)
         case None =>
-          val (input, stream) = Source
-            .queue[ViewportEvent](8, OverflowStrategy.backpressure)
-            .preMaterialize() // preMaterialize the queue to obtain the input and stream objects
-          val cb = ViewportCallback { (v, e, c) =>
-            input.queue.offer(
-              ViewportEvent(
-                sessionId = sessionId,
-                viewportId = fqid,
-                serial = c.map(_.id),
-                data = Option(ByteString.copyFrom(v.data)),
-                length = Some(v.data.size.toLong),
-                offset = Some(off),
-                viewportEventKind = ViewportEventKind.fromValue(e.value)
-              )
-            )
-            ()
-          }
-          context.actorOf(
+          val events = new EventQueue[ViewportEvent]
+          val viewportEvents = new ViewportEvents(sessionId, fqid)
+          val cb = ViewportCallback((v, e, c) => viewportEvents(v, e, c).foreach(events.offer))
+          val viewport = context.actorOf(
             Viewport
-              .props(session.viewCb(off, cap, isFloating, cb), stream, cb),
+              .props(session.viewCb(off, cap, isFloating, cb), events, viewportEvents, cb, fqid, viewports),
             vid
           )
+          viewports.register(fqid, viewport)
           sender() ! Ok(fqid)
       }
 
@@ -296,6 +372,9 @@ class Session(
       session.resumeViewportEvents()
       sender() ! Ok(sessionId)
 
+    case SubmitBatch(changes) =>
+      sender() ! applyBatch(changes)
+
     case BeginTransaction() =>
       session.beginTransaction
       sender() ! Ok(sessionId)
@@ -309,10 +388,13 @@ class Session(
         def count: Long = session.notifyChangedViewports.toLong
       }
 
-    case Watch(eventInterest) =>
+    case Watch(eventInterest, options) =>
+      import context.system
+      // subscribe first so the events the interest lets through reach the new queue
+      val stream0 = events.subscribe(options)
       session.eventInterest = eventInterest.getOrElse(api.SessionEvent.Interest.All)
       sender() ! new Ok(sessionId) with Events {
-        def stream: EventStream = events
+        def stream: EventStream = stream0
       }
 
     case Unwatch =>
@@ -373,38 +455,41 @@ class Session(
     case Profile(request) =>
       val offset = request.offset
       val length = request.length
-      // emit log message before calling profile function
-      session.profile(offset, length) match {
-        case Right(profileArray) =>
-          sender() ! ByteFrequencyProfileResponse.of(
-            sessionId,
-            offset,
-            length,
-            ArraySeq.unsafeWrapArray(profileArray)
-          )
-        case Left(errorCode) =>
-          sender() ! Err(Status.UNKNOWN.withDescription(s"Profile function failed with error code: $errorCode"))
+      read { snapshot =>
+        snapshot.profile(offset, length) match {
+          case Right(profileArray) =>
+            ByteFrequencyProfileResponse.of(
+              sessionId,
+              offset,
+              length,
+              ArraySeq.unsafeWrapArray(profileArray)
+            )
+          case Left(errorCode) =>
+            Err(Status.UNKNOWN.withDescription(s"Profile function failed with error code: $errorCode"))
+        }
       }
 
     case CharCount(request) =>
       val offset = request.offset
       val length = request.length
-      session.charCount(offset, length, request.byteOrderMark) match {
-        case Right(charCounts) =>
-          sender() ! CharacterCountResponse.of(
-            sessionId,
-            offset,
-            length,
-            charCounts.bom,
-            charCounts.bomBytes,
-            charCounts.singleByteChars,
-            charCounts.doubleByteChars,
-            charCounts.tripleByteChars,
-            charCounts.quadByteChars,
-            charCounts.invalidBytes
-          )
-        case Left(errorCode) =>
-          sender() ! Err(Status.UNKNOWN.withDescription(s"CharCount function failed with error code: $errorCode"))
+      read { snapshot =>
+        snapshot.charCount(offset, length, request.byteOrderMark) match {
+          case Right(charCounts) =>
+            CharacterCountResponse.of(
+              sessionId,
+              offset,
+              length,
+              charCounts.bom,
+              charCounts.bomBytes,
+              charCounts.singleByteChars,
+              charCounts.doubleByteChars,
+              charCounts.tripleByteChars,
+              charCounts.quadByteChars,
+              charCounts.invalidBytes
+            )
+          case Left(errorCode) =>
+            Err(Status.UNKNOWN.withDescription(s"CharCount function failed with error code: $errorCode"))
+        }
       }
 
     case ByteOrderMark(request) =>
@@ -412,12 +497,14 @@ class Session(
       sender() ! ByteOrderMarkResponse.of(sessionId, request.offset, session.byteOrderMarkSize(bom), bom)
 
     case ContentType(request) =>
-      sender() ! ContentTypeResponse.of(
-        sessionId,
-        request.offset,
-        request.length,
-        session.detectContentType(request.offset, request.length)
-      )
+      read { snapshot =>
+        ContentTypeResponse.of(
+          sessionId,
+          request.offset,
+          request.length,
+          snapshot.detectContentType(request.offset, request.length)
+        )
+      }
 
     case Language(request) =>
       sender() ! LanguageResponse.of(
@@ -436,24 +523,44 @@ class Session(
       val isReverse = request.isReverse.getOrElse(false)
       val offset = request.offset.getOrElse(0L)
       val length = request.length.getOrElse(0L)
-      sender() ! SearchResponse.of(
-        sessionId,
-        request.pattern,
-        isCaseInsensitive,
-        isReverse,
-        offset,
-        length,
-        session.search(
-          request.pattern.toByteArray,
-          offset,
-          length,
+      // snapshots only search forward for exact matches, so other searches stay on the session
+      if (isCaseInsensitive || isReverse)
+        sender() ! SearchResponse.of(
+          sessionId,
+          request.pattern,
           isCaseInsensitive,
           isReverse,
-          request.limit
+          offset,
+          length,
+          session.search(
+            request.pattern.toByteArray,
+            offset,
+            length,
+            isCaseInsensitive,
+            isReverse,
+            request.limit
+          )
         )
-      )
+      else
+        read { snapshot =>
+          SearchResponse.of(
+            sessionId,
+            request.pattern,
+            isCaseInsensitive,
+            isReverse,
+            offset,
+            length,
+            snapshot.search(request.pattern.toByteArray, offset, length, request.limit)
+          )
+        }
 
     case Segment(request) =>
-      sender() ! session.getSegment(request.offset, request.length)
+      read(_.getSegment(request.offset, request.length))
+
+    case TakeSnapshot(into) =>
+      val taken = session.snapshot()
+      // a requester that gave up has already failed `into`, and nothing else would ever destroy the snapshot
+      if (!into.trySuccess(taken)) taken.destroy()
+      sender() ! Ok(sessionId)
   }
 }
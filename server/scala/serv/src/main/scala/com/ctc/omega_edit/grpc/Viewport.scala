@@ -40,10 +40,13 @@ object Viewport {
 
   def props(
       view: api.Viewport,
-      stream: EventStream,
-      cb: ViewportCallback
+      events: EventQueue[ViewportEvent],
+      viewportEvents: ViewportEvents,
+      cb: ViewportCallback,
+      fqid: String,
+      viewports: ViewportRegistry
   ): Props =
-    Props(new Viewport(view, stream, cb))
+    Props(new Viewport(view, events, viewportEvents, cb, fqid, viewports))
 
   case class Id(session: String, view: String)
   object Id {
@@ -61,26 +64,45 @@ object Viewport {
   case object Get extends Op
   case object HasChanges extends Op
   case object Destroy extends Op
-  case class Watch(eventInterest: Option[Int]) extends Op
+  case class Watch(
+      eventInterest: Option[Int],
+      options: EventQueue.Options = EventQueue.Options.Default,
+      deltas: Boolean = false
+  ) extends Op
   case object Unwatch extends Op
 
 }
 
 class Viewport(
     view: api.Viewport,
-    events: EventStream,
-    @unused cb: ViewportCallback // need to keep a reference to the callback to prevent it from being GC'd
+    events: EventQueue[ViewportEvent],
+    viewportEvents: ViewportEvents,
+    @unused cb: ViewportCallback, // need to keep a reference to the callback to prevent it from being GC'd
+    fqid: String,
+    viewports: ViewportRegistry
 ) extends Actor
     with ActorLogging {
   val viewportId: String = self.path.name
 
+  override def postStop(): Unit = {
+    viewports.unregister(fqid, self)
+    events.complete()
+  }
+
   private def generateViewportData(
       viewport: api.Viewport,
       id: String
-  ): Ok with ViewportData = new Ok(id) with ViewportData {
-    def data: ByteString = ByteString.copyFrom(viewport.data)
-    def offset: Long = viewport.offset
-    def followingByteCount: Long = viewport.followingByteCount
+  ): Ok with ViewportData = {
+    val data0 = ByteString.copyFrom(viewport.data)
+    val offset0 = viewport.offset
+    // Viewport event deltas that follow are based on the data sent here
+    val sequence0 = viewportEvents.resync(offset0, data0.size.toLong)
+    new Ok(id) with ViewportData {
+      def data: ByteString = data0
+      def offset: Long = offset0
+      def followingByteCount: Long = viewport.followingByteCount
+      def sequence: Long = sequence0
+    }
   }
 
   def receive: Receive = {
@@ -98,13 +120,22 @@ class Viewport(
       }
 
     case Destroy =>
+      // unregister before replying so no operation is routed to the destroyed viewport
+      viewports.unregister(fqid, self)
       view.destroy()
       sender() ! Ok(viewportId)
-
-    case Watch(eventInterest) =>
-      view.eventInterest = eventInterest.getOrElse(api.ViewportEvent.Interest.All)
+      context.stop(self)
+
+    case Watch(eventInterest, options, deltas) =>
+      import context.system
+      // deltas are opt-in, and subscribers that can miss events get the full viewport data in every event regardless
+      viewportEvents.deltas = deltas && !options.isLossy
+      viewportEvents.interest = eventInterest.getOrElse(api.ViewportEvent.Interest.All)
+      val stream0 = events.subscribe(options)
+      // deltas need every change to the viewport data, including those of the events the subscriber leaves out
+      view.eventInterest = if (viewportEvents.deltas) api.ViewportEvent.Interest.All else viewportEvents.interest
       sender() ! new Ok(viewportId) with Events {
-        def stream: EventStream = events
+        def stream: EventStream = stream0
       }
 
     case Unwatch =>
@@ -0,0 +1,177 @@
+/*
+ * Copyright 2021 Concurrent Technologies Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package com.ctc.omega_edit.grpc
+
+import com.ctc.omega_edit.api
+import com.google.protobuf.ByteString
+import omega_edit.{ViewportDelta, ViewportDeltaCopy, ViewportDeltaPiece, ViewportEvent, ViewportEventKind}
+
+import scala.collection.mutable.ListBuffer
+
+/** Builds the events of a viewport. Events carry the full viewport data, unless the subscriber asked for deltas, in
+  * which case edits and undos are sent as deltas that reuse the viewport data of the previous event, so only the bytes
+  * a change brought into the viewport are copied out of the session and sent. The full viewport data is still sent for
+  * every other event, and whenever a delta would not save much. A subscriber that asked for deltas has the viewport
+  * watched for every event, so the data its deltas are based on cannot change without the server seeing it; the events
+  * it left out of its interest are not sent, and the event that follows them carries the full viewport data.
+  *
+  * @param sessionId
+  *   session the viewport belongs to
+  * @param viewportId
+  *   fully qualified viewport id
+  */
+class ViewportEvents(sessionId: String, viewportId: String) {
+  private var sequence = 0L
+  private var baseOffset = 0L
+  private var baseLength = -1L // negative until the client has the viewport data
+
+  /** Whether edits and undos are sent as deltas, which a subscriber that can miss events would be unable to apply */
+  @volatile var deltas: Boolean = false
+
+  /** Events the subscriber asked for, which can be fewer than the viewport is watched for */
+  @volatile var interest: Int = api.ViewportEvent.Interest.All
+
+  /** Note that the full viewport data was sent outside the event stream, so later deltas can be based on it
+    * @param offset
+    *   offset of the viewport data that was sent
+    * @param length
+    *   length of the viewport data that was sent
+    * @return
+    *   sequence of the last event, which the viewport data reflects
+    */
+  def resync(offset: Long, length: Long): Long = synchronized {
+    baseOffset = offset
+    baseLength = length
+    sequence
+  }
+
+  /** Build the event for the given viewport callback
+    * @param v
+    *   viewport the event occurred on
+    * @param e
+    *   viewport event
+    * @param change
+    *   change that caused the event, for edits and undos
+    * @return
+    *   viewport event to send, if the subscriber is interested in it
+    */
+  def apply(v: api.Viewport, e: api.ViewportEvent, change: Option[api.Change]): Option[ViewportEvent] = synchronized {
+    if ((interest & e.value) == 0) {
+      // the subscriber keeps the data it has, which the viewport data no longer matches
+      baseLength = -1
+      None
+    } else Some(event(v, e, change))
+  }
+
+  private def event(v: api.Viewport, e: api.ViewportEvent, change: Option[api.Change]): ViewportEvent = {
+    val offset = v.offset
+    val length = v.length
+    // Undoing a change has the opposite effect on the viewport data
+    val pieces = (e, change) match {
+      case _ if !deltas                      => None
+      case (api.ViewportEvent.Edit, Some(c)) => deltaPieces(v, offset, length, c.operation, c.offset, c.length)
+      case (api.ViewportEvent.Undo, Some(c)) =>
+        val undone = c.operation match {
+          case api.Change.Insert => api.Change.Delete
+          case api.Change.Delete => api.Change.Insert
+          case op                => op
+        }
+        deltaPieces(v, offset, length, undone, c.offset, c.length)
+      case _ => None
+    }
+    val delta = pieces.map(ViewportDelta(sequence, baseLength, offset - baseOffset, _))
+    sequence += 1
+    baseOffset = offset
+    baseLength = length
+    ViewportEvent(
+      sessionId = sessionId,
+      viewportId = viewportId,
+      viewportEventKind = ViewportEventKind.fromValue(e.value),
+      serial = change.map(_.id),
+      offset = Some(offset),
+      length = Some(length),
+      data = if (delta.isEmpty) Some(ByteString.copyFrom(v.data)) else None,
+      delta = delta,
+      sequence = Some(sequence)
+    )
+  }
+
+  /* The viewport data after a change is made of the bytes before the change, the bytes of the change, and the bytes
+   * after the change, which moved by the length of the change if it was an insert or a delete.  Bytes that the base
+   * data already has are copied from it, and the rest are copied out of the viewport.
+   */
+  private def deltaPieces(
+      v: api.Viewport,
+      offset: Long,
+      length: Long,
+      operation: api.Change.Op,
+      changeOffset: Long,
+      changeLength: Long
+  ): Option[Seq[ViewportDeltaPiece]] = {
+    if (baseLength < 0) return None
+    val (changeEnd, shift) = operation match {
+      case api.Change.Insert    => (changeOffset + changeLength, -changeLength)
+      case api.Change.Delete    => (changeOffset, changeLength)
+      case api.Change.Overwrite => (changeOffset + changeLength, 0L)
+      case api.Change.Undefined => return None
+    }
+    val end = offset + length
+    val pieces = ListBuffer.empty[ViewportDeltaPiece]
+    var pendingStart = 0L // start of the bytes to copy out of the viewport, relative to the viewport offset
+    var pendingLength = 0L
+    var dataLength = 0L
+
+    def flush(): Unit =
+      if (0 < pendingLength) {
+        pieces += ViewportDeltaPiece(
+          ViewportDeltaPiece.Piece.Data(ByteString.copyFrom(v.data(pendingStart, pendingLength)))
+        )
+        dataLength += pendingLength
+        pendingLength = 0
+      }
+
+    def data(start: Long, stop: Long): Unit =
+      if (start < stop) {
+        if (0 == pendingLength) pendingStart = start - offset
+        pendingLength += stop - start
+      }
+
+    // Bytes in [start, stop) of the session were at [start + shift, stop + shift) in the base
+    def moved(start: Long, stop: Long, shift: Long): Unit =
+      if (start < stop) {
+        val copyStart = math.max(start + shift, baseOffset) - shift
+        val copyStop = math.min(stop + shift, baseOffset + baseLength) - shift
+        if (copyStart < copyStop) {
+          data(start, copyStart)
+          flush()
+          pieces += ViewportDeltaPiece(
+            ViewportDeltaPiece.Piece.Copy(ViewportDeltaCopy(copyStart + shift - baseOffset, copyStop - copyStart))
+          )
+          data(copyStop, stop)
+        } else data(start, stop)
+      }
+
+    moved(offset, math.min(changeOffset, end), 0)
+    data(math.max(changeOffset, offset), math.min(changeEnd, end))
+    moved(math.max(changeEnd, offset), end, shift)
+    flush()
+    // The viewport is refreshed by reading its data, which a delta made only of copies would otherwise skip
+    if (0 == dataLength) v.data(0, 0)
+    // Deltas that copy most of the viewport out of the session are sent as the full viewport data instead
+    if (length <= 2 * dataLength) None else Some(pieces.toList)
+  }
+}
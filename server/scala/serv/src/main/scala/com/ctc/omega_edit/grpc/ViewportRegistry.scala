@@ -0,0 +1,43 @@
+/*
+ * Copyright 2021 Concurrent Technologies Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package com.ctc.omega_edit.grpc
+
+import org.apache.pekko.actor.ActorRef
+
+import scala.collection.concurrent.TrieMap
+
+/** Routes viewport operations straight to viewport actors by fully qualified viewport id (session id:viewport id).
+  * Sessions register viewports as they create them and viewports unregister themselves when destroyed or stopped, so
+  * routing an operation is a map lookup rather than an asynchronous actor selection.
+  */
+final class ViewportRegistry {
+  private val viewports = TrieMap.empty[String, ActorRef]
+
+  def register(fqid: String, viewport: ActorRef): Unit =
+    viewports.update(fqid, viewport)
+
+  def unregister(fqid: String, viewport: ActorRef): Unit = {
+    viewports.remove(fqid, viewport)
+    ()
+  }
+
+  def lookup(fqid: String): Option[ActorRef] =
+    viewports.get(fqid)
+
+  def size: Int =
+    viewports.size
+}
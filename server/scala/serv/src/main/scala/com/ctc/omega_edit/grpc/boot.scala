@@ -18,7 +18,7 @@ package com.ctc.omega_edit.grpc
 
 import org.apache.pekko
 import pekko.actor.ActorSystem
-import cats.implicits.catsSyntaxTuple3Semigroupal
+import cats.implicits.catsSyntaxTuple4Semigroupal
 import com.ctc.omega_edit.api.OmegaEdit
 import com.ctc.omega_edit.grpc.EditorService.getServerPID
 import com.monovore.decline._
@@ -70,13 +70,24 @@ object boot
           )
           .withDefault(default_pidfile)
 
-        (interface_opt, port_opt, pidfile_opt).mapN { (interface, port, pidfile) =>
-          new boot(interface, port, pidfile).run()
+        val default_warmup =
+          scala.util.Properties.envOrElse("OMEGA_EDIT_SERVER_WARMUP_DETECTORS", "false")
+        val warmup_opt = Opts
+          .flag(
+            "warmup-detectors",
+            short = "w",
+            help = s"Load the content type and language detectors at startup. Default: $default_warmup"
+          )
+          .orFalse
+          .map(_ || default_warmup.toBoolean)
+
+        (interface_opt, port_opt, pidfile_opt, warmup_opt).mapN { (interface, port, pidfile, warmup) =>
+          new boot(interface, port, pidfile, warmup).run()
         }
       }
     )
 
-class boot(iface: String, port: Int, pidfile: String) {
+class boot(iface: String, port: Int, pidfile: String, warmupDetectors: Boolean = false) {
   implicit val sys: ActorSystem = ActorSystem("omega-edit-grpc-server")
   implicit val ec: ExecutionContext = sys.dispatcher
 
@@ -95,6 +106,9 @@ class boot(iface: String, port: Int, pidfile: String) {
         fos.close()
     }
 
+    // loading the language models takes long enough to be noticeable on the first request that needs them
+    if (warmupDetectors) OmegaEdit.warmupDetectors()
+
     val done =
       for {
         binding <- EditorService.bind(iface = iface, port = port)
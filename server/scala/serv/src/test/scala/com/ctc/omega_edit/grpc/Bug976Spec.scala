@@ -44,7 +44,7 @@ class Bug976Spec extends AsyncWordSpecLike with Matchers with OptionValues with
         unsub <- svc.unsubscribeToViewportEvents(ObjectId(vid))
       } yield {
         vid should startWith(sid)
-        evt.value should matchPattern { case ViewportEvent(`sid`, `vid`, _, _, _, _, _, _) => }
+        evt.value should matchPattern { case ViewportEvent(`sid`, `vid`, _, _, _, _, _, _, _, _) => }
         unsub.id shouldBe vid
         val Array(s, v) = vid.split(":")
         s shouldBe sid
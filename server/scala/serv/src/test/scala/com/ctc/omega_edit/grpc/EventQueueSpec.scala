@@ -0,0 +1,62 @@
+/*
+ * Copyright 2021 Concurrent Technologies Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package com.ctc.omega_edit.grpc
+
+import io.grpc.Status
+import omega_edit.EventOverflowPolicy
+import org.apache.pekko.actor.ActorSystem
+import org.apache.pekko.grpc.GrpcServiceException
+import org.apache.pekko.stream.Materializer
+import org.apache.pekko.stream.scaladsl.Sink
+import org.scalatest.BeforeAndAfterAll
+import org.scalatest.matchers.should.Matchers
+import org.scalatest.wordspec.AsyncWordSpecLike
+
+class EventQueueSpec extends AsyncWordSpecLike with Matchers with BeforeAndAfterAll {
+  private val system = ActorSystem("EventQueueSpec")
+  implicit private val mat: Materializer = Materializer.matFromSystem(system)
+
+  override def afterAll(): Unit = system.terminate()
+
+  "a backpressured event queue" should {
+    "keep every event offered while the subscriber is behind" in {
+      val events = new EventQueue[Int]
+      val stream = events.subscribe(EventQueue.Options(2, EventOverflowPolicy.EVENT_OVERFLOW_BACKPRESSURE))
+      (1 to 100).foreach(events.offer)
+      events.complete()
+      stream.runWith(Sink.seq).map(_ shouldBe (1 to 100))
+    }
+
+    "fail the subscription once too many events are held back" in {
+      val events = new EventQueue[Int]
+      val stream = events.subscribe(EventQueue.Options(1, EventOverflowPolicy.EVENT_OVERFLOW_BACKPRESSURE))
+      (0 to 2 * EventQueue.MaxPendingOffers).foreach(events.offer)
+      recoverToExceptionIf[GrpcServiceException](stream.runWith(Sink.ignore))
+        .map(_.status.getCode shouldBe Status.Code.RESOURCE_EXHAUSTED)
+    }
+  }
+
+  "a queue that drops the oldest events" should {
+    "keep the latest events" in {
+      val events = new EventQueue[Int]
+      val stream = events.subscribe(EventQueue.Options(2, EventOverflowPolicy.EVENT_OVERFLOW_DROP_OLDEST))
+      (1 to 100).foreach(events.offer)
+      events.complete()
+      stream.runWith(Sink.seq).map(_.last shouldBe 100)
+    }
+  }
+}
@@ -18,9 +18,11 @@ package com.ctc.omega_edit.grpc
 
 import org.apache.pekko
 import pekko.actor.ActorSystem
+import pekko.grpc.GrpcServiceException
 import pekko.stream.scaladsl.Sink
 import com.google.protobuf.ByteString
 import com.google.protobuf.empty.Empty
+import io.grpc.Status
 import omega_edit._
 import org.scalatest.Assertion
 import org.scalatest.matchers.should.Matchers
@@ -614,6 +616,9 @@ class ExampleSpec extends AsyncWordSpecLike with Matchers with EditorServiceSupp
         numViewports4 <- service.getCount(
           countViewportRequest
         )
+        destroyedViewportFailure <- service
+          .getViewportData(ViewportDataRequest(viewportResponse2.viewportId))
+          .failed
       } yield {
         numViewports1.sessionId shouldBe sid
         numViewports1.counts.head.kind shouldBe CountKind.COUNT_VIEWPORTS
@@ -635,6 +640,7 @@ class ExampleSpec extends AsyncWordSpecLike with Matchers with EditorServiceSupp
         numViewports3.counts.head.count shouldBe 4L
         numViewports4.counts.head.count shouldBe 3L
         destroyedViewport.id shouldBe sid + ":viewport_2"
+        destroyedViewportFailure.getMessage should startWith("NOT_FOUND")
       }
     }
 
@@ -713,6 +719,102 @@ class ExampleSpec extends AsyncWordSpecLike with Matchers with EditorServiceSupp
         contents1 = Using(Source.fromFile(saveResponse1.filePath))(source => source.mkString).get
       } yield contents1 shouldBe testString1
     }
+
+    "submit a stream of changes" in newSession { sid =>
+      val changes = (0 until 2000).map { i =>
+        ChangeRequest(
+          sid,
+          ChangeKind.CHANGE_INSERT,
+          offset = i.toLong,
+          length = 1,
+          data = Some(ByteString.copyFromUtf8((i % 10).toString))
+        )
+      } :+ ChangeRequest(sid, ChangeKind.CHANGE_DELETE, offset = 0, length = 1000)
+      for {
+        changesResponse <- service.submitChanges(pekko.stream.scaladsl.Source(changes))
+        size <- service.getComputedFileSize(ObjectId(sid)).map(_.computedFileSize)
+        segment <- service.getSegment(SegmentRequest(sid, offset = 0, length = 10))
+      } yield {
+        changesResponse.changeCount shouldBe 2001
+        changesResponse.batchCount should be >= 2L
+        size shouldBe 1000
+        segment.data.toStringUtf8 shouldBe "0123456789"
+      }
+    }
+
+    "roll back a failed stream of changes" in newSession { sid =>
+      val changes = Seq(
+        ChangeRequest(
+          sid,
+          ChangeKind.CHANGE_INSERT,
+          offset = 0,
+          length = 3,
+          data = Some(ByteString.copyFromUtf8("abc"))
+        ),
+        ChangeRequest(sid, ChangeKind.CHANGE_DELETE, offset = 100, length = 1)
+      )
+      val countUndosRequest = CountRequest(sid, Seq[CountKind](CountKind.COUNT_UNDOS))
+      for {
+        failed <- recoverToExceptionIf[GrpcServiceException](
+          service.submitChanges(pekko.stream.scaladsl.Source(changes))
+        )
+        size <- service.getComputedFileSize(ObjectId(sid)).map(_.computedFileSize)
+        numUndos <- service.getCount(countUndosRequest).map(_.counts.head.count)
+        _ <- service.sessionBeginTransaction(ObjectId(sid))
+        rejected <- recoverToExceptionIf[GrpcServiceException](
+          service.submitChanges(pekko.stream.scaladsl.Source(changes.take(1)))
+        )
+        _ <- service.sessionEndTransaction(ObjectId(sid))
+      } yield {
+        failed.status.getCode shouldBe Status.Code.INVALID_ARGUMENT
+        size shouldBe 0
+        // the rolled back batch cannot be redone
+        numUndos shouldBe 0
+        rejected.status.getCode shouldBe Status.Code.FAILED_PRECONDITION
+      }
+    }
+
+    "base viewport deltas on the events the subscriber leaves out" in newSession { sid =>
+      import service.system
+
+      def insert(data: String): Future[ChangeResponse] =
+        service.submitChange(
+          ChangeRequest(
+            sid,
+            ChangeKind.CHANGE_INSERT,
+            offset = 0,
+            length = data.length.toLong,
+            data = Some(ByteString.copyFromUtf8(data))
+          )
+        )
+
+      for {
+        viewport <- service.createViewport(
+          CreateViewportRequest(sid, capacity = 64, offset = 0, isFloating = false, viewportIdDesired = None)
+        )
+        _ <- insert("a" * 40)
+        _ <- service.getViewportData(ViewportDataRequest(viewport.viewportId))
+        events = service
+          .subscribeToViewportEvents(
+            EventSubscriptionRequest(
+              viewport.viewportId,
+              interest = Some(ViewportEventKind.VIEWPORT_EVT_EDIT.value),
+              viewportDeltas = Some(true)
+            )
+          )
+          .take(2)
+          .idleTimeout(1.second)
+          .runWith(Sink.seq)
+        _ <- insert("b")
+        // the subscriber is not told of the undo, so the edit that follows cannot be a delta on the data it has
+        _ <- service.undoLastChange(ObjectId(sid))
+        _ <- insert("c")
+        received <- events
+      } yield {
+        received.map(_.delta.isDefined) shouldBe Seq(true, false)
+        received.last.data.map(_.toStringUtf8) shouldBe Some("c" + "a" * 40)
+      }
+    }
   }
 }
 